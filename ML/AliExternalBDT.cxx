@@ -14,6 +14,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <limits>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -35,7 +36,8 @@ AliExternalBDT::AliExternalBDT(std::string name) :
   fModelPath{""},
   fModelName{""},
   fCompiler{},
-  fPredictor{}
+  fPredictor{},
+  fEntries{}
 {
 }
 
@@ -128,16 +130,36 @@ bool AliExternalBDT::LoadModelLibrary(std::string path) {
 }
 
 double AliExternalBDT::Predict(double *features, int size, bool useRawScore) {
-  std::vector<TreelitePredictorEntry> entries(size);
-  for (size_t iEntry = 0; iEntry < entries.size(); ++iEntry) {
-    entries[iEntry].fvalue = static_cast<float>(features[iEntry]);
+  fEntries.resize(size);
+  for (size_t iEntry = 0; iEntry < fEntries.size(); ++iEntry) {
+    fEntries[iEntry].fvalue = static_cast<float>(features[iEntry]);
   }
   size_t out_size{0u};
   TreelitePredictorQueryResultSizeSingleInst(fPredictor, &out_size);
   assert(out_size == 1);
   float output = 0.f;
-  TreelitePredictorPredictInst(fPredictor, entries.data(),
+  TreelitePredictorPredictInst(fPredictor, fEntries.data(),
       static_cast<int>(useRawScore), &output,
       &out_size);
   return output;
 }
+
+bool AliExternalBDT::PredictBatch(const float *features, int nRows, int nCols, float *output, bool useRawScore) {
+  if (nRows <= 0) return true;
+  DenseBatchHandle batch;
+  if (TreeliteAssembleDenseBatch(features, std::numeric_limits<float>::quiet_NaN(), nRows, nCols, &batch) != 0) {
+    std::cerr << "Batch creation failed" << std::endl;
+    return false;
+  }
+  size_t out_size{0u};
+  TreelitePredictorQueryResultSize(fPredictor, batch, 0, &out_size);
+  assert(out_size == static_cast<size_t>(nRows));
+  const int status = TreelitePredictorPredictBatch(fPredictor, batch, 0, 0,
+      static_cast<int>(useRawScore), output, &out_size);
+  TreeliteDeleteDenseBatch(batch);
+  if (status != 0) {
+    std::cerr << "Batch prediction failed" << std::endl;
+    return false;
+  }
+  return true;
+}
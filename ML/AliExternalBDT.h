@@ -30,6 +30,8 @@ public:
   bool LoadXGBoostModel(std::string path);
 
   double Predict(double *features, int size, bool useRaw = false);
+  /// predict nRows candidates at once, features stored row-wise (nRows x nCols)
+  bool PredictBatch(const float *features, int nRows, int nCols, float *output, bool useRaw = false);
 
 private:
   bool CompileAndLoadModelLibrary();
@@ -43,6 +45,7 @@ private:
   std::string fModelName;
   CompilerHandle fCompiler;
   PredictorHandle fPredictor;
+  std::vector<TreelitePredictorEntry> fEntries;   /// buffer for the single instance prediction
 };
 
 #endif
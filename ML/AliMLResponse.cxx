@@ -12,6 +12,8 @@
 
 #include "AliMLResponse.h"
 
+#include <algorithm>
+
 #include "yaml-cpp/yaml.h"
 
 #include "AliExternalBDT.h"
@@ -29,7 +31,8 @@ ClassImp(AliMLResponse);
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse()
     : TNamed(), fConfigFilePath{}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{}, fNVariables{},
-      fBinsBegin{}, fRaw{} {
+      fBinsBegin{}, fRaw{}, fInputFeatureNames{}, fFeatureIndex{}, fFeatureBuffer{}, fBatchFeatures{}, fBatchScores{},
+      fBatchCandidates{}, fBatchBinOffsets{}, fBatchCandBins{}, fBatchFillPos{} {
   //
   // Default constructor
   //
@@ -38,7 +41,8 @@ AliMLResponse::AliMLResponse()
 //_______________________________________________________________________________
 AliMLResponse::AliMLResponse(const Char_t *name, const Char_t *title)
     : TNamed(name, title), fConfigFilePath{""}, fModels{}, fCentClasses{}, fBins{}, fVariableNames{}, fNBins{},
-      fNVariables{}, fBinsBegin{}, fRaw{} {
+      fNVariables{}, fBinsBegin{}, fRaw{}, fInputFeatureNames{}, fFeatureIndex{}, fFeatureBuffer{}, fBatchFeatures{},
+      fBatchScores{}, fBatchCandidates{}, fBatchBinOffsets{}, fBatchCandBins{}, fBatchFillPos{} {
   //
   // Standard constructor
   //
@@ -55,7 +59,10 @@ AliMLResponse::~AliMLResponse() {
 AliMLResponse::AliMLResponse(const AliMLResponse &source)
     : TNamed(source.GetName(), source.GetTitle()), fConfigFilePath{source.fConfigFilePath}, fModels{source.fModels},
       fCentClasses{source.fCentClasses}, fBins{source.fBins}, fVariableNames{source.fVariableNames},
-      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{source.fBinsBegin}, fRaw{source.fRaw} {
+      fNBins{source.fNBins}, fNVariables{source.fNVariables}, fBinsBegin{}, fRaw{source.fRaw},
+      fInputFeatureNames{source.fInputFeatureNames}, fFeatureIndex{source.fFeatureIndex}, fFeatureBuffer{},
+      fBatchFeatures{}, fBatchScores{}, fBatchCandidates{}, fBatchBinOffsets{}, fBatchCandBins{}, fBatchFillPos{} {
+  fBinsBegin = fBins.begin();
   //
   // Copy constructor
   //
@@ -76,8 +83,10 @@ AliMLResponse &AliMLResponse::operator=(const AliMLResponse &source) {
   fVariableNames  = source.fVariableNames;
   fNBins          = source.fNBins;
   fNVariables     = source.fNVariables;
-  fBinsBegin      = source.fBinsBegin;
+  fBinsBegin      = fBins.begin();
   fRaw            = source.fRaw;
+  fInputFeatureNames = source.fInputFeatureNames;
+  fFeatureIndex      = source.fFeatureIndex;
 
   return *this;
 }
@@ -137,6 +146,24 @@ void AliMLResponse::MLResponseInit() {
   /// import config file from alien path
   string configLocalPath = ImportConfigFile();
   CompileModels(configLocalPath);
+  BindInputFeatures();
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::BindInputFeatures() {
+  fFeatureIndex.resize(fNVariables);
+  fFeatureBuffer.resize(fNVariables);
+  for (int iVar = 0; iVar < fNVariables; ++iVar) {
+    if (fInputFeatureNames.empty()) {
+      fFeatureIndex[iVar] = iVar;
+      continue;
+    }
+    auto found = std::find(fInputFeatureNames.begin(), fInputFeatureNames.end(), fVariableNames[iVar]);
+    if (found == fInputFeatureNames.end()) {
+      AliFatal(Form("Variable |%s| of the model not found in the input feature names! Exit", fVariableNames[iVar].data()));
+    }
+    fFeatureIndex[iVar] = found - fInputFeatureNames.begin();
+  }
 }
 
 //_______________________________________________________________________________
@@ -147,17 +174,18 @@ int AliMLResponse::FindBin(double binvar) {
 }
 
 //_______________________________________________________________________________
-double AliMLResponse::Predict(double binvar, map<string, double> varmap) {
+double AliMLResponse::Predict(double binvar, const map<string, double> &varmap) {
   if ((int)varmap.size() < fNVariables) {
     AliFatal("The variable map you provided to the predictor has a size smaller than the variable list size! Exit");
   }
 
-  vector<double> features;
-  for (const auto &varname : fVariableNames) {
-    if (varmap.find(varname) == varmap.end()) {
-      AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", varname.data()));
+  fFeatureBuffer.resize(fNVariables);
+  for (int iVar = 0; iVar < fNVariables; ++iVar) {
+    auto found = varmap.find(fVariableNames[iVar]);
+    if (found == varmap.end()) {
+      AliFatal(Form("Variable |%s| not found in variable list provided in config! Exit", fVariableNames[iVar].data()));
     }
-    features.push_back(varmap[varname]);
+    fFeatureBuffer[iVar] = found->second;
   }
 
   int bin = FindBin(binvar);
@@ -166,11 +194,11 @@ double AliMLResponse::Predict(double binvar, map<string, double> varmap) {
     return -999.;
   }
 
-  return fModels[bin - 1].GetModel()->Predict(&features[0], fNVariables, fRaw);
+  return fModels[bin - 1].GetModel()->Predict(fFeatureBuffer.data(), fNVariables, fRaw);
 }
 
 //_______________________________________________________________________________
-double AliMLResponse::Predict(double binvar, vector<double> variables) {
+double AliMLResponse::Predict(double binvar, const vector<double> &variables) {
   if ((int)variables.size() != fNVariables) {
     AliFatal(Form("Number of variables passed (%d) different from the one used in the model (%d)! Exit",
                   (int)variables.size(), fNVariables));
@@ -182,17 +210,81 @@ double AliMLResponse::Predict(double binvar, vector<double> variables) {
     return -999.;
   }
 
-  return fModels[bin - 1].GetModel()->Predict(&variables[0], fNVariables, fRaw);
+  return fModels[bin - 1].GetModel()->Predict(const_cast<double *>(variables.data()), fNVariables, fRaw);
 }
 
 //_______________________________________________________________________________
-bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap) {
+double AliMLResponse::Predict(double binvar, const double *features) {
+  if ((int)fFeatureIndex.size() != fNVariables) BindInputFeatures();
+
+  int bin = FindBin(binvar);
+  if (bin == 0 || bin == fNBins) {
+    AliWarning("Binned variable outside range, no model available!");
+    return -999.;
+  }
+
+  for (int iVar = 0; iVar < fNVariables; ++iVar) fFeatureBuffer[iVar] = features[fFeatureIndex[iVar]];
+  return fModels[bin - 1].GetModel()->Predict(fFeatureBuffer.data(), fNVariables, fRaw);
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::PredictBatch(int nCandidates, const double *features, const double *binvars, double *scores) {
+  if ((int)fFeatureIndex.size() != fNVariables) BindInputFeatures();
+  const int nInput = GetNInputFeatures();
+
+  /// counting sort of the candidates by bin, keeping the order of the candidates within each bin
+  fBatchCandidates.resize(nCandidates);
+  fBatchBinOffsets.assign(fNBins + 2, 0);
+  fBatchCandBins.resize(nCandidates);
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    int bin = FindBin(binvars[iCand]);
+    if (bin == 0 || bin >= fNBins) {
+      scores[iCand] = -999.;
+      bin = 0;
+    }
+    fBatchCandBins[iCand] = bin;
+    fBatchBinOffsets[bin + 1]++;
+  }
+  for (int iBin = 1; iBin < fNBins + 2; ++iBin) fBatchBinOffsets[iBin] += fBatchBinOffsets[iBin - 1];
+  fBatchFillPos.assign(fBatchBinOffsets.begin(), fBatchBinOffsets.end() - 1);
+  for (int iCand = 0; iCand < nCandidates; ++iCand) fBatchCandidates[fBatchFillPos[fBatchCandBins[iCand]]++] = iCand;
+
+  /// one model call per bin, bin 0 contains the candidates outside the range
+  for (int iBin = 1; iBin < fNBins; ++iBin) {
+    const int first = fBatchBinOffsets[iBin], nInBin = fBatchBinOffsets[iBin + 1] - first;
+    if (!nInBin) continue;
+    fBatchFeatures.resize(nInBin * fNVariables);
+    fBatchScores.resize(nInBin);
+    for (int iRow = 0; iRow < nInBin; ++iRow) {
+      const double *row = features + fBatchCandidates[first + iRow] * nInput;
+      float *out = &fBatchFeatures[iRow * fNVariables];
+      for (int iVar = 0; iVar < fNVariables; ++iVar) out[iVar] = static_cast<float>(row[fFeatureIndex[iVar]]);
+    }
+    if (!fModels[iBin - 1].GetModel()->PredictBatch(fBatchFeatures.data(), nInBin, fNVariables, fBatchScores.data(), fRaw)) {
+      AliFatal("Error in the batch prediction! Exit");
+    }
+    for (int iRow = 0; iRow < nInBin; ++iRow) scores[fBatchCandidates[first + iRow]] = fBatchScores[iRow];
+  }
+}
+
+//_______________________________________________________________________________
+void AliMLResponse::PredictBatch(int nCandidates, const double *features, const double *binvars, double *scores,
+                                 bool *selected) {
+  PredictBatch(nCandidates, features, binvars, scores);
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    int bin = FindBin(binvars[iCand]);
+    selected[iCand] = (bin > 0 && bin < fNBins) ? scores[iCand] >= fModels[bin - 1].GetScoreCut() : false;
+  }
+}
+
+//_______________________________________________________________________________
+bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap) {
   double score{0.};
   return IsSelected(binvar, varmap, score);
 }
 
 //_______________________________________________________________________________
-bool AliMLResponse::IsSelected(double binvar, std::vector<double> variables) {
+bool AliMLResponse::IsSelected(double binvar, const std::vector<double> &variables) {
   double score{0.};
   return IsSelected(binvar, variables, score);
-}
\ No newline at end of file
+}
@@ -49,17 +49,33 @@ public:
   /// return the bin index
   int FindBin(double binvar);
   /// return the ML model predicted score (raw or proba, depending on useraw)
-  double Predict(double binvar, std::map<std::string, double> varmap);
+  double Predict(double binvar, const std::map<std::string, double> &varmap);
   /// overload to pass directly a vector of variables
-  double Predict(double binvar, std::vector<double> variables);
+  double Predict(double binvar, const std::vector<double> &variables);
+  /// overload to pass the features in the order defined with SetInputFeatureNames (no copy, no lookup)
+  double Predict(double binvar, const double *features);
   /// return true if predicted score for map is above the threshold given in the config
-  bool IsSelected(double binvar, std::map<std::string, double> varmap);
+  bool IsSelected(double binvar, const std::map<std::string, double> &varmap);
   /// overload for getting the model score too
-  template <typename F> bool IsSelected(double binvar, std::map<std::string, double> varmap, F &score);
+  template <typename F> bool IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score);
   /// overload to pass directly a vector of variables
-  bool IsSelected(double binvar, std::vector<double> variables);
+  bool IsSelected(double binvar, const std::vector<double> &variables);
   /// overload for getting the model score too
-  template <typename F> bool IsSelected(double binvar, std::vector<double> variables, F &score);
+  template <typename F> bool IsSelected(double binvar, const std::vector<double> &variables, F &score);
+
+  /// set the names (and order) of the features passed to Predict(double, const double*) and PredictBatch,
+  /// the binding to the model variables is resolved once in MLResponseInit. If not set, the features are
+  /// expected in the order of the model variables (VAR_NAMES in the config)
+  void SetInputFeatureNames(const std::vector<std::string> &names) { fInputFeatureNames = names; }
+  /// number of features expected per candidate in Predict(double, const double*) and PredictBatch
+  int GetNInputFeatures() const { return fInputFeatureNames.empty() ? fNVariables : (int)fInputFeatureNames.size(); }
+  /// predict the scores for nCandidates candidates at once. The features are stored row-wise
+  /// (GetNInputFeatures() values per candidate), binvars contains the binned variable for each candidate.
+  /// Candidates are grouped by bin and each model is evaluated once per call. Candidates outside
+  /// the bin range get the score -999
+  void PredictBatch(int nCandidates, const double *features, const double *binvars, double *scores);
+  /// overload additionally providing the selection decision for each candidate
+  void PredictBatch(int nCandidates, const double *features, const double *binvars, double *scores, bool *selected);
 
 protected:
   std::string fConfigFilePath;    /// path of the config file
@@ -76,18 +92,31 @@ protected:
 
   bool fRaw;    /// set to true to use raw score instead of probability
 
+  std::vector<std::string> fInputFeatureNames;    /// names of the features passed to the array interfaces
+  std::vector<int> fFeatureIndex;                 //!<! position of each model variable in the input features
+  std::vector<double> fFeatureBuffer;             //!<! features of one candidate in the order of the model
+  std::vector<float> fBatchFeatures;              //!<! features of the candidates of one bin (batch)
+  std::vector<float> fBatchScores;                //!<! scores of the candidates of one bin (batch)
+  std::vector<int> fBatchCandidates;              //!<! candidate indices sorted by bin (batch)
+  std::vector<int> fBatchBinOffsets;              //!<! offsets of the bins in fBatchCandidates (batch)
+  std::vector<int> fBatchCandBins;                //!<! bin of each candidate (batch)
+  std::vector<int> fBatchFillPos;                 //!<! next free position for each bin (batch)
+
+  /// resolve the position of the model variables in the input features
+  void BindInputFeatures();
+
   /// \cond CLASSIMP
-  ClassDef(AliMLResponse, 2);    ///
+  ClassDef(AliMLResponse, 3);    ///
   /// \endcond
 };
 
-template <typename F> bool AliMLResponse::IsSelected(double binvar, std::map<std::string, double> varmap, F &score) {
+template <typename F> bool AliMLResponse::IsSelected(double binvar, const std::map<std::string, double> &varmap, F &score) {
   int bin = FindBin(binvar);
   score   = Predict(binvar, varmap);
   return score >= fModels[bin - 1].GetScoreCut();
 }
 
-template <typename F> bool AliMLResponse::IsSelected(double binvar, std::vector<double> variables, F &score) {
+template <typename F> bool AliMLResponse::IsSelected(double binvar, const std::vector<double> &variables, F &score) {
   int bin = FindBin(binvar);
   score   = Predict(binvar, variables);
   return score >= fModels[bin - 1].GetScoreCut();
@@ -0,0 +1,77 @@
+#include <TRandom3.h>
+#include <TStopwatch.h>
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+#include "AliMLModelHandler.h"
+#include "AliMLResponse.h"
+
+// Micro-benchmark of the per-candidate and batched prediction of AliMLResponse.
+// A synthetic candidate set is generated with uniformly distributed features and
+// binned variable (within the bin edges of the config), then scored
+//  - per candidate with the map interface
+//  - per candidate with the vector interface
+//  - with PredictBatch
+// The batched scores are checked against the per-candidate ones.
+// Usage: root -l -b -q benchmark_AliMLResponse.cc+'("config.yml", 100000)'
+
+int benchmark_AliMLResponse(std::string configPath, int nCandidates = 100000, double binMin = 1., double binMax = 24.) {
+
+  AliMLResponse response("benchmarkMLResponse", "benchmarkMLResponse");
+  response.SetConfigFilePath(configPath);
+  response.MLResponseInit();
+
+  const int nVars = response.GetNInputFeatures();
+  std::vector<std::string> names = YAML::LoadFile(AliMLModelHandler::ImportFile(configPath))["VAR_NAMES"].as<std::vector<std::string>>();
+
+  TRandom3 rnd(1234);
+  std::vector<double> features(nCandidates * nVars), binvars(nCandidates);
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    binvars[iCand] = rnd.Uniform(binMin, binMax);
+    for (int iVar = 0; iVar < nVars; ++iVar) features[iCand * nVars + iVar] = rnd.Uniform(-1., 1.);
+  }
+
+  std::vector<double> scoresMap(nCandidates), scoresVector(nCandidates), scoresBatch(nCandidates);
+  TStopwatch timer;
+
+  timer.Start();
+  std::map<std::string, double> varmap;
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    for (int iVar = 0; iVar < nVars; ++iVar) varmap[names[iVar]] = features[iCand * nVars + iVar];
+    scoresMap[iCand] = response.Predict(binvars[iCand], varmap);
+  }
+  timer.Stop();
+  double timeMap = timer.RealTime();
+
+  timer.Start();
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    std::vector<double> variables(features.begin() + iCand * nVars, features.begin() + (iCand + 1) * nVars);
+    scoresVector[iCand] = response.Predict(binvars[iCand], variables);
+  }
+  timer.Stop();
+  double timeVector = timer.RealTime();
+
+  timer.Start();
+  response.PredictBatch(nCandidates, features.data(), binvars.data(), scoresBatch.data());
+  timer.Stop();
+  double timeBatch = timer.RealTime();
+
+  int nMismatch = 0;
+  for (int iCand = 0; iCand < nCandidates; ++iCand) {
+    if (std::abs(scoresBatch[iCand] - scoresVector[iCand]) > 1.e-6 || std::abs(scoresMap[iCand] - scoresVector[iCand]) > 1.e-6) nMismatch++;
+  }
+
+  std::cout << "Candidates:            " << nCandidates << std::endl;
+  std::cout << "Per candidate (map):    " << timeMap << " s, " << nCandidates / timeMap << " candidates/s" << std::endl;
+  std::cout << "Per candidate (vector): " << timeVector << " s, " << nCandidates / timeVector << " candidates/s" << std::endl;
+  std::cout << "Batch:                  " << timeBatch << " s, " << nCandidates / timeBatch << " candidates/s" << std::endl;
+  std::cout << "Mismatches:             " << nMismatch << std::endl;
+
+  return nMismatch ? 1 : 0;
+}
@@ -66,6 +66,10 @@
 //           Michele Floris, CERN
 //-------------------------------------------------------------------------
 #include <vector>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 
 #include <Riostream.h>
 #include <TH1F.h>
@@ -111,6 +115,172 @@
 
 class StringToRegexp : public std::map<std::string, TPRegexp> {};
 
+// Trigger logic (e.g. "SPDGFO >= 1 && !V0ABG") compiled to a postfix program.
+// The n-th identifier of the string is the parameter n, as in the TFormula
+// built by FindForumla. Supported are numbers, identifiers, parentheses, !,
+// the comparison operators, && and ||; for anything else Compile returns
+// kFALSE and the TFormula is used.
+class TriggerLogicProgram {
+public:
+  TriggerLogicProgram() : fCode(), fStack(), fNParams(0), fPos(0) {}
+
+  Bool_t Compile(const char* logic) {
+    fCode.clear();
+    fNParams = 0;
+    fPos = logic;
+    Bool_t ok = ParseOr();
+    SkipSpaces();
+    if (!ok || *fPos) {
+      fCode.clear();
+      return kFALSE;
+    }
+    return kTRUE;
+  }
+
+  Int_t GetNParams() const { return fNParams; }
+
+  Bool_t Eval(const Double_t* paras) {
+    // same arithmetic as the TFormula: all values are doubles, booleans are 0 or 1
+    fStack.resize(fCode.size());
+    Int_t n = 0;
+    for (size_t i = 0; i < fCode.size(); i++) {
+      const Instruction& ins = fCode[i];
+      switch (ins.fOp) {
+        case kParam: fStack[n++] = paras[ins.fParam]; break;
+        case kConst: fStack[n++] = ins.fValue; break;
+        case kNot:   fStack[n-1] = (fStack[n-1] == 0); break;
+        default: {
+          Double_t b = fStack[--n];
+          Double_t& a = fStack[n-1];
+          switch (ins.fOp) {
+            case kAnd: a = (a != 0 && b != 0); break;
+            case kOr:  a = (a != 0 || b != 0); break;
+            case kEQ:  a = (a == b); break;
+            case kNE:  a = (a != b); break;
+            case kLT:  a = (a < b); break;
+            case kLE:  a = (a <= b); break;
+            case kGT:  a = (a > b); break;
+            case kGE:  a = (a >= b); break;
+            default:   break;
+          }
+        }
+      }
+    }
+    return fStack[0] != 0;
+  }
+
+private:
+  enum EOp { kParam, kConst, kNot, kAnd, kOr, kEQ, kNE, kLT, kLE, kGT, kGE };
+  struct Instruction {
+    Instruction(EOp op, Int_t param = 0, Double_t value = 0) : fOp(op), fParam(param), fValue(value) {}
+    EOp fOp;
+    Int_t fParam;
+    Double_t fValue;
+  };
+
+  void SkipSpaces() { while (*fPos == ' ' || *fPos == '\t') fPos++; }
+  Bool_t Accept(const char* token) {
+    SkipSpaces();
+    size_t len = strlen(token);
+    if (strncmp(fPos, token, len) != 0) return kFALSE;
+    fPos += len;
+    return kTRUE;
+  }
+
+  Bool_t ParseOr() {
+    if (!ParseAnd()) return kFALSE;
+    while (Accept("||")) {
+      if (!ParseAnd()) return kFALSE;
+      fCode.push_back(Instruction(kOr));
+    }
+    return kTRUE;
+  }
+  Bool_t ParseAnd() {
+    if (!ParseComparison()) return kFALSE;
+    while (Accept("&&")) {
+      if (!ParseComparison()) return kFALSE;
+      fCode.push_back(Instruction(kAnd));
+    }
+    return kTRUE;
+  }
+  Bool_t ParseComparison() {
+    if (!ParseUnary()) return kFALSE;
+    while (true) {
+      EOp op;
+      if      (Accept("==")) op = kEQ;
+      else if (Accept("!=")) op = kNE;
+      else if (Accept("<=")) op = kLE;
+      else if (Accept(">=")) op = kGE;
+      else if (Accept("<"))  op = kLT;
+      else if (Accept(">"))  op = kGT;
+      else return kTRUE;
+      if (!ParseUnary()) return kFALSE;
+      fCode.push_back(Instruction(op));
+    }
+  }
+  Bool_t ParseUnary() {
+    if (Accept("!")) {
+      if (!ParseUnary()) return kFALSE;
+      fCode.push_back(Instruction(kNot));
+      return kTRUE;
+    }
+    return ParsePrimary();
+  }
+  Bool_t ParsePrimary() {
+    if (Accept("(")) {
+      if (!ParseOr()) return kFALSE;
+      return Accept(")");
+    }
+    SkipSpaces();
+    if (isalpha(*fPos)) {
+      while (isalnum(*fPos)) fPos++;
+      fCode.push_back(Instruction(kParam, fNParams++));
+      return kTRUE;
+    }
+    if (isdigit(*fPos)) {
+      char* end = 0;
+      Double_t value = strtod(fPos, &end);
+      fPos = end;
+      if (isalpha(*fPos)) return kFALSE;
+      fCode.push_back(Instruction(kConst, 0, value));
+      return kTRUE;
+    }
+    return kFALSE;
+  }
+
+  std::vector<Instruction> fCode;
+  std::vector<Double_t> fStack;
+  Int_t fNParams;
+  const char* fPos;
+};
+
+// Trigger logic of a trigger class, set up at its first evaluation
+struct CompiledTriggerLogic {
+  CompiledTriggerLogic() : fLogic(), fFormula(0), fProgram(), fUseProgram(kFALSE), fParas() {}
+  TString fLogic;                     // trigger logic string from the OADB
+  FormulaAndBits* fFormula;           // TFormula and trigger bits (owned by fTriggerToFormula)
+  TriggerLogicProgram fProgram;       // compiled trigger logic
+  Bool_t fUseProgram;                 // fProgram is used instead of the TFormula
+  std::vector<Double_t> fParas;       // values of the trigger bits of the current event
+};
+
+// A trigger class string "+TRIGGER1,... -TRIGGER2 #BC &YY *ZZ" decoded once per run.
+// The required and rejected triggers are bit masks over the trigger class indices
+// of the run (two words: GetTriggerMask and GetTriggerMaskNext50).
+struct CompiledTriggerClass {
+  CompiledTriggerClass() : fUseMasks(kFALSE), fRequired(), fRejected(), fBCs(), fReturnCode(AliVEvent::kUserDefined), fTriggerLogic(0), fOnline(), fOffline() {}
+  Bool_t fUseMasks;                   // masks valid (trigger class names known), otherwise CheckTriggerClass is used
+  std::vector<ULong64_t> fRequired;   // for each required entry 2 words, one of the classes must be fired
+  std::vector<ULong64_t> fRejected;   // for each rejected entry 2 words, none of the classes may be fired
+  std::vector<Int_t> fBCs;            // accepted bunch crossing numbers (empty: all)
+  UInt_t fReturnCode;                 // &YY
+  Int_t fTriggerLogic;                // *ZZ
+  CompiledTriggerLogic fOnline;       // hardware trigger logic
+  CompiledTriggerLogic fOffline;      // offline trigger logic
+};
+
+class CompiledTriggerClasses : public std::vector<CompiledTriggerClass> {};
+
 ClassImp(AliPhysicsSelection)
 
 AliPhysicsSelection::AliPhysicsSelection() :
@@ -132,7 +302,9 @@ fPSOADB(0),
 fFillOADB(0),
 fTriggerOADB(0),
 fTriggerToFormula(new StringToFormula()),
-fTriggerToRegexp(new StringToRegexp())
+fTriggerToRegexp(new StringToRegexp()),
+fCompiledTriggerClasses(new CompiledTriggerClasses()),
+fCompiledRun(-1)
 {
   // constructor
   fCollTrigClasses.SetOwner(1);
@@ -162,7 +334,9 @@ AliPhysicsSelection::AliPhysicsSelection(const char *name) :
  fFillOADB(0),
  fTriggerOADB(0),
  fTriggerToFormula(new StringToFormula()),
- fTriggerToRegexp(new StringToRegexp())
+ fTriggerToRegexp(new StringToRegexp()),
+ fCompiledTriggerClasses(new CompiledTriggerClasses()),
+ fCompiledRun(-1)
  {
    // constructor
    fCollTrigClasses.SetOwner(1);
@@ -179,6 +353,7 @@ AliPhysicsSelection::~AliPhysicsSelection(){
   if (fTriggerOADB)  delete fTriggerOADB;
   delete fTriggerToFormula;
   delete fTriggerToRegexp;
+  delete fCompiledTriggerClasses;
 }
 
 UInt_t AliPhysicsSelection::CheckTriggerClass(const AliVEvent* event, const char* trigger, Int_t& triggerLogic) const {
@@ -286,6 +461,129 @@ Bool_t AliPhysicsSelection::EvaluateTriggerLogic(const AliVEvent* event,
   return trg_formula.EvalPar(dummy_val, paras.data());
 }
 
+/// Evaluate if the given event fulfills the trigger logic of a compiled trigger class
+///
+/// At the first call the TFormula is looked up and the trigger logic is compiled;
+/// the TFormula is only evaluated if the trigger logic could not be compiled.
+/// All trigger bits are evaluated, as in the evaluation of the TFormula.
+Bool_t AliPhysicsSelection::EvaluateTriggerLogic(const AliVEvent* event,
+						 AliTriggerAnalysis* triggerAnalysis,
+						 CompiledTriggerLogic& logic, Bool_t offline){
+  if (!logic.fFormula) {
+    logic.fFormula = &FindForumla(logic.fLogic.Data());
+    logic.fUseProgram = logic.fProgram.Compile(logic.fLogic.Data()) &&
+                        logic.fProgram.GetNParams() == (Int_t) logic.fFormula->second.size();
+    if (!logic.fUseProgram)
+      AliInfo(Form("Trigger logic %s is evaluated with TFormula", logic.fLogic.Data()));
+    logic.fParas.resize(logic.fFormula->second.size());
+  }
+  auto& bits = logic.fFormula->second;
+  auto offline_flag = offline ? AliTriggerAnalysis::kOfflineFlag : 0;
+  for (size_t i = 0; i < bits.size(); ++i) {
+    typedef AliTriggerAnalysis::Trigger Trigger;
+    Trigger bit = static_cast<Trigger>(bits[i] | offline_flag);
+    logic.fParas[i] = triggerAnalysis->EvaluateTrigger(event, bit);
+  }
+  if (logic.fUseProgram) return logic.fProgram.Eval(logic.fParas.data());
+  Double_t dummy_val[] = {0};
+  return logic.fFormula->first.EvalPar(dummy_val, logic.fParas.data());
+}
+
+UInt_t AliPhysicsSelection::CheckTriggerClass(const AliVEvent* event, const CompiledTriggerClass& trigger, const ULong64_t* firedMask) const {
+  // checks a trigger class decoded by CompileTriggerClasses for the current event
+  // firedMask contains GetTriggerMask() and GetTriggerMaskNext50() of the event
+  // returns the same as CheckTriggerClass for the trigger class string
+
+  const std::vector<ULong64_t>& required = trigger.fRequired;
+  for (size_t i = 0; i < required.size(); i += 2) {
+    if (!(firedMask[0] & required[i]) && !(firedMask[1] & required[i+1]))
+      return kFALSE; // required not found
+  }
+  const std::vector<ULong64_t>& rejected = trigger.fRejected;
+  for (size_t i = 0; i < rejected.size(); i += 2) {
+    if ((firedMask[0] & rejected[i]) || (firedMask[1] & rejected[i+1]))
+      return kFALSE; // rejected found
+  }
+  if (!trigger.fBCs.empty()) {
+    Int_t bc = event->GetBunchCrossNumber();
+    if (std::find(trigger.fBCs.begin(), trigger.fBCs.end(), bc) == trigger.fBCs.end())
+      return kFALSE;
+  }
+  return trigger.fReturnCode;
+}
+
+void AliPhysicsSelection::CompileTriggerClasses(const AliVEvent* event) {
+  // decodes the trigger class strings once per run
+  // the required and rejected triggers are converted into masks over the trigger classes
+  // of the run; the names of the classes are only known for ESDs, otherwise CheckTriggerClass
+  // matches them with the fired trigger classes of each event
+  // each class name is matched separately with the same regexp as in CheckTriggerClass
+
+  const Int_t kNClasses = 100; // 50 in GetTriggerMask, 50 in GetTriggerMaskNext50
+  std::vector<TString> names;
+  if (event->GetDataLayoutType() == AliVEvent::kESD && ((AliESDEvent*) event)->GetESDRun()) {
+    const AliESDRun* esdRun = ((AliESDEvent*) event)->GetESDRun();
+    names.resize(kNClasses);
+    for (Int_t j = 0; j < kNClasses; j++) {
+      ULong64_t bit = 1ull << (j % 50);
+      // the same function gives the fired classes of the event
+      names[j] = j < 50 ? esdRun->GetFiredTriggerClasses(bit, 0) : esdRun->GetFiredTriggerClasses(0, bit);
+      names[j].Strip(TString::kBoth, ' ');
+    }
+  }
+
+  Int_t nColl = fCollTrigClasses.GetEntries();
+  Int_t nBG   = fBGTrigClasses.GetEntries();
+  fCompiledTriggerClasses->clear();
+  fCompiledTriggerClasses->resize(nColl+nBG);
+  for (Int_t i=0; i<nColl+nBG; i++) {
+    const char* trigger = i<nColl ? fCollTrigClasses.At(i)->GetName() : fBGTrigClasses.At(i-nColl)->GetName();
+    CompiledTriggerClass& compiled = (*fCompiledTriggerClasses)[i];
+    compiled.fUseMasks = !names.empty();
+
+    // same syntax as in CheckTriggerClass
+    std::string str;
+    while (*trigger) {
+      if (*trigger == '+' || *trigger == '-') {
+        Bool_t flag = (*trigger == '+');
+        trigger++;
+        const char* begin = trigger;
+        while (*trigger && *trigger != ' ')
+          trigger++;
+        str.assign(begin, trigger);
+        if (!compiled.fUseMasks) continue;
+        TPRegexp& re = FindRegexp(str);
+        ULong64_t mask[2] = {0, 0};
+        for (Int_t j = 0; j < (Int_t) names.size(); j++) {
+          if (!names[j].IsNull() && re.Match(names[j], "", 0, 1) == 1)
+            mask[j / 50] |= 1ull << (j % 50);
+        }
+        std::vector<ULong64_t>& masks = flag ? compiled.fRequired : compiled.fRejected;
+        masks.push_back(mask[0]);
+        masks.push_back(mask[1]);
+        continue;
+      }
+      if (*trigger == '#' || *trigger == '&' || *trigger == '*') {
+        Char_t type = *trigger++;
+        Int_t value = 0;
+        while (*trigger && *trigger != ' ')
+          value = 10 * value + (*trigger++ - '0');
+        if (type == '#') compiled.fBCs.push_back(value);
+        else if (type == '&') compiled.fReturnCode = value;
+        else compiled.fTriggerLogic = value;
+        continue;
+      }
+      trigger++;
+    }
+
+    compiled.fOnline.fLogic = fPSOADB->GetHardwareTrigger(compiled.fTriggerLogic);
+    compiled.fOffline.fLogic = fPSOADB->GetOfflineTrigger(compiled.fTriggerLogic);
+  }
+  fCompiledRun = fCurrentRun;
+  AliInfo(Form("Compiled %d trigger classes for run %d (%s)", nColl+nBG, fCurrentRun,
+               names.empty() ? "class names not available, fired classes matched per event" : "class masks"));
+}
+
 //______________________________________________________________________________
 UInt_t AliPhysicsSelection::IsCollisionCandidate(const AliVEvent* event){
   // checks if the given event is a collision candidate
@@ -293,6 +591,7 @@ UInt_t AliPhysicsSelection::IsCollisionCandidate(const AliVEvent* event){
   if (fCurrentRun != event->GetRunNumber()) {
     if (!Initialize(event)) AliFatal(Form("Could not initialize for run %d", event->GetRunNumber()));
   }
+  if (fCompiledRun != fCurrentRun) CompileTriggerClasses(event);
   
   // check event type; should be PHYSICS = 7 for data and 0 for MC
   Int_t eventType = event->GetHeader()->GetEventType();
@@ -303,6 +602,7 @@ UInt_t AliPhysicsSelection::IsCollisionCandidate(const AliVEvent* event){
   }
   
   UInt_t accept = 0;
+  ULong64_t firedMask[2] = {event->GetTriggerMask(), event->GetTriggerMaskNext50()};
   Int_t nColl = fCollTrigClasses.GetEntries();
   Int_t nBG   = fBGTrigClasses.GetEntries();
   for (Int_t i=0; i<nColl+nBG; i++) {
@@ -312,11 +612,12 @@ UInt_t AliPhysicsSelection::IsCollisionCandidate(const AliVEvent* event){
     AliTriggerAnalysis* triggerAnalysis = static_cast<AliTriggerAnalysis*> (fTriggerAnalysis.At(i));
     triggerAnalysis->FillTriggerClasses(event);
     
+    CompiledTriggerClass& compiled = (*fCompiledTriggerClasses)[i];
     Int_t triggerLogic = 0;
-    UInt_t singleTriggerResult = CheckTriggerClass(event, triggerClass, triggerLogic);
+    UInt_t singleTriggerResult = compiled.fUseMasks ? CheckTriggerClass(event, compiled, firedMask) : CheckTriggerClass(event, triggerClass, triggerLogic);
     if (!singleTriggerResult) continue;
-    Bool_t onlineDecision  = EvaluateTriggerLogic(event, triggerAnalysis, fPSOADB->GetHardwareTrigger(triggerLogic), kFALSE);
-    Bool_t offlineDecision = EvaluateTriggerLogic(event, triggerAnalysis, fPSOADB->GetOfflineTrigger(triggerLogic), kTRUE);
+    Bool_t onlineDecision  = EvaluateTriggerLogic(event, triggerAnalysis, compiled.fOnline, kFALSE);
+    Bool_t offlineDecision = EvaluateTriggerLogic(event, triggerAnalysis, compiled.fOffline, kTRUE);
     triggerAnalysis->FillHistograms(event,onlineDecision,offlineDecision);
     if (!onlineDecision) continue;
     if (!offlineDecision) continue;
@@ -45,6 +45,9 @@ class AliOADBFillingScheme;
 class AliOADBTriggerAnalysis;
 class TPRegexp;
 class StringToRegexp;
+class CompiledTriggerClasses;
+struct CompiledTriggerClass;
+struct CompiledTriggerLogic;
 
 typedef std::pair<R5TFormula, std::vector<AliTriggerAnalysis::Trigger>> FormulaAndBits;
 typedef std::map<std::string, FormulaAndBits> StringToFormula;
@@ -102,6 +105,9 @@ public:
 protected:
   UInt_t CheckTriggerClass(const AliVEvent* event, const char* trigger, Int_t& triggerLogic) const;
   Bool_t EvaluateTriggerLogic(const AliVEvent* event, AliTriggerAnalysis* triggerAnalysis, const char* triggerLogic, Bool_t offline);
+  UInt_t CheckTriggerClass(const AliVEvent* event, const CompiledTriggerClass& trigger, const ULong64_t* firedMask) const;
+  Bool_t EvaluateTriggerLogic(const AliVEvent* event, AliTriggerAnalysis* triggerAnalysis, CompiledTriggerLogic& logic, Bool_t offline);
+  void CompileTriggerClasses(const AliVEvent* event);
   const char * GetTriggerString(TObjString * obj);
 
   TString fPassName;          // pass name for current run
@@ -128,7 +134,10 @@ protected:
   StringToRegexp* fTriggerToRegexp; //!
   TPRegexp& FindRegexp(const std::string& triggers) const;
 
-  ClassDef(AliPhysicsSelection, 24)
+  CompiledTriggerClasses* fCompiledTriggerClasses; //! trigger classes decoded for the current run
+  Int_t fCompiledRun;                              //! run for which fCompiledTriggerClasses is set up
+
+  ClassDef(AliPhysicsSelection, 25)
 private:
   AliPhysicsSelection(const AliPhysicsSelection&);
   AliPhysicsSelection& operator=(const AliPhysicsSelection&);
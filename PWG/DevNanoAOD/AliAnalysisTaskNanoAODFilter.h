@@ -58,6 +58,7 @@ public:
   void  FilterMCStack(AliAnalysisCuts* cuts = nullptr) { fReplicator->SetMCParticleCuts(cuts); if (fSaveCutsFlag && cuts) fQAOutput->Add(cuts); }
   
   AliNanoAODReplicator* GetReplicator() { return fReplicator; }
+  void  SetFillTrackColumns(Bool_t var)                   { fReplicator->SetFillTrackColumns(var); }
 
   void SetInputArrayName(TString name) {fInputArrayName=name;}
   void SetOutputArrayName(TString name) {fOutputArrayName=name;}
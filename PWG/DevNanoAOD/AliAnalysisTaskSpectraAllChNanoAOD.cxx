@@ -49,6 +49,7 @@
 #include <iostream>
 #include "AliNanoAODHeader.h"
 #include "AliNanoAODTrack.h"
+#include "AliNanoAODTrackColumns.h"
 
 using namespace AliHelperPIDNameSpace;
 using namespace std;
@@ -69,7 +70,9 @@ AliAnalysisTaskSpectraAllChNanoAOD::AliAnalysisTaskSpectraAllChNanoAOD(const cha
   fOutput(0x0),
   fnCentBins(20),
   fnQvecBins(40),
-  fnNchBins(200)
+  fnNchBins(200),
+  fNanoColumns(0x0),
+  fNanoTrackID()
 {
   // Default constructor
   DefineInput(0, TChain::Class());
@@ -235,28 +238,52 @@ void AliAnalysisTaskSpectraAllChNanoAOD::UserExec(Option_t *)
 	}
     }
   
+  //for nano tracks charge, pt, rapidity, label and PID are taken from the columns of the event
+  const Short_t * nanoCharge = 0x0;
+  const Double_t * nanoPt = 0x0;
+  const Double_t * nanoTheta = 0x0;
+  const Int_t * nanoLabel = 0x0;
+  if(isNano) {
+    if(!fNanoColumns) {
+      // only the variables used here are copied to the columns
+      AliNanoAODTrackMapping * mapping = AliNanoAODTrackMapping::GetInstance();
+      fNanoColumns = new AliNanoAODTrackColumns();
+      fNanoColumns->SelectVar(mapping->GetPt());
+      fNanoColumns->SelectVar(mapping->GetTheta());
+      const char * nsigmaVars[] = {"cstNSigmaTPCPi", "cstNSigmaTPCKa", "cstNSigmaTPCPr", "cstNSigmaTOFPi", "cstNSigmaTOFKa", "cstNSigmaTOFPr"};
+      if(!fFillOnlyEvents) for(Int_t ivar = 0; ivar < 6; ivar++) fNanoColumns->SelectVar(mapping->GetVarIndex(nsigmaVars[ivar]));
+    }
+    fNanoColumns->Fill(fAOD);
+    nanoCharge = fNanoColumns->GetCharge();
+    nanoPt = fNanoColumns->GetPt();
+    nanoTheta = fNanoColumns->GetTheta();
+    nanoLabel = fNanoColumns->GetLabel();
+    if(!fFillOnlyEvents) FillNanoTrackIDs(fNanoColumns, fNanoTrackID);
+  }
+  
   //main loop on tracks
   
   Int_t Nch = 0.;
   
   for (Int_t iTracks = 0; iTracks < fAOD->GetNumberOfTracks(); iTracks++) {
-    AliVTrack* track = (AliVTrack*) fAOD->GetTrack(iTracks);
-    if(fCharge != 0 && track->Charge() != fCharge) continue;//if fCharge != 0 only select fCharge 
+    if(isNano && fCharge != 0 && nanoCharge[iTracks] != fCharge) continue;//if fCharge != 0 only select fCharge 
+    AliVTrack* track = isNano ? 0x0 : (AliVTrack*) fAOD->GetTrack(iTracks);//nano tracks are only needed for the double counting
     if(!isNano) {
+      if(fCharge != 0 && track->Charge() != fCharge) continue;//if fCharge != 0 only select fCharge 
       if (!fTrackCuts->IsSelected((AliAODTrack*)track,kTRUE)) continue; //track selection (rapidity selection NOT in the standard cuts)
     }
     
     if(!fFillOnlyEvents){
-      Int_t IDrec=isNano ? GetNanoTrackID (track) : fHelperPID->GetParticleSpecies(track,kTRUE);//id from detector      
+      Int_t IDrec=isNano ? fNanoTrackID[iTracks] : fHelperPID->GetParticleSpecies(track,kTRUE);//id from detector      
       Double_t y= 0;
-      if(isNano) y = ((AliNanoAODTrack*)track)->Y(fHelperPID->GetMass((AliHelperParticleSpecies_t)IDrec));
+      if(isNano) y = GetNanoRapidity(nanoPt[iTracks], nanoTheta[iTracks], fHelperPID->GetMass((AliHelperParticleSpecies_t)IDrec));
       else y = ((AliAODTrack*)track)->Y(fHelperPID->GetMass((AliHelperParticleSpecies_t)IDrec));
       Int_t IDgen=kSpUndefined;//set if MC
       Int_t isph=-999;
       Int_t iswd=-999;
       
       if (arrayMC) {
-	AliAODMCParticle *partMC = (AliAODMCParticle*) arrayMC->At(TMath::Abs(track->GetLabel()));
+	AliAODMCParticle *partMC = (AliAODMCParticle*) arrayMC->At(TMath::Abs(isNano ? nanoLabel[iTracks] : track->GetLabel()));
 	if (!partMC) { 
 	  AliError("Cannot get MC particle");
 	  continue; 
@@ -268,7 +295,7 @@ void AliAnalysisTaskSpectraAllChNanoAOD::UserExec(Option_t *)
       
     //pt     cent    Q vec     IDrec     IDgen       isph           iswd      y
       Double_t varTrk[8];
-      varTrk[0]=track->Pt();
+      varTrk[0]=isNano ? nanoPt[iTracks] : track->Pt();
       varTrk[1]=Cent;
       varTrk[2]=Qvec;
       varTrk[3]=(Double_t)IDrec;
@@ -281,6 +308,7 @@ void AliAnalysisTaskSpectraAllChNanoAOD::UserExec(Option_t *)
       //for nsigma PID fill double counting of ID
       if(fHelperPID->GetPIDType()<kBayes && fDoDoubleCounting){//only nsigma
 	Bool_t *HasDC;
+	if(!track) track = (AliVTrack*) fAOD->GetTrack(iTracks);
 	HasDC=fHelperPID->GetDoubleCounting(track,kTRUE);//get the array with double counting
 	for(Int_t ipart=0;ipart<kNSpecies;ipart++){
 	  if(HasDC[ipart]==kTRUE){
@@ -333,10 +361,6 @@ Int_t AliAnalysisTaskSpectraAllChNanoAOD::GetNanoTrackID(AliVTrack * track) {
   static const Int_t kcstNSigmaTOFKa  = AliNanoAODTrackMapping::GetInstance()->GetVarIndex("cstNSigmaTOFKa");
   static const Int_t kcstNSigmaTOFPr  = AliNanoAODTrackMapping::GetInstance()->GetVarIndex("cstNSigmaTOFPr");
 
-  Double_t nSigmaPID = 3.0;
-
-
-
   //get the identity of the particle with the minimum Nsigma
   Double_t nsigmaPion=999., nsigmaKaon=999., nsigmaProton=999.;
   if(nanoTrack->Pt() > fTrackCuts->GetPtTOFMatching()) {
@@ -350,7 +374,54 @@ Int_t AliAnalysisTaskSpectraAllChNanoAOD::GetNanoTrackID(AliVTrack * track) {
     nsigmaPion   =  TMath::Abs(nanoTrack->GetVar(kcstNSigmaTPCPi));  
   }
 
-  
+  return GetNanoTrackID(nsigmaPion, nsigmaKaon, nsigmaProton);
+}
+
+void AliAnalysisTaskSpectraAllChNanoAOD::FillNanoTrackIDs(const AliNanoAODTrackColumns * columns, std::vector<Int_t> & ids) const {
+  // Applies nsigma PID to all nano tracks of the event at once, same result as GetNanoTrackID for each track
+  AliNanoAODTrackMapping * mapping = AliNanoAODTrackMapping::GetInstance();
+  const Double_t * pt = columns->GetPt();
+  const Double_t * tpcPi = columns->GetVar(mapping->GetVarIndex("cstNSigmaTPCPi"));
+  const Double_t * tpcKa = columns->GetVar(mapping->GetVarIndex("cstNSigmaTPCKa"));
+  const Double_t * tpcPr = columns->GetVar(mapping->GetVarIndex("cstNSigmaTPCPr"));
+  const Double_t * tofPi = columns->GetVar(mapping->GetVarIndex("cstNSigmaTOFPi"));
+  const Double_t * tofKa = columns->GetVar(mapping->GetVarIndex("cstNSigmaTOFKa"));
+  const Double_t * tofPr = columns->GetVar(mapping->GetVarIndex("cstNSigmaTOFPr"));
+  const Int_t ntracks = columns->GetNumberOfTracks();
+  ids.resize(ntracks);
+  if(ntracks == 0) return;
+  if(!pt || !tpcPi || !tpcKa || !tpcPr || !tofPi || !tofKa || !tofPr) AliFatal("pt or nsigma variables missing in the nano tracks");
+
+  const Double_t ptTOF = fTrackCuts->GetPtTOFMatching();
+  for(Int_t itrack = 0; itrack < ntracks; itrack++) {
+    Double_t nsigmaPion, nsigmaKaon, nsigmaProton;
+    if(pt[itrack] > ptTOF) {
+      nsigmaProton = TMath::Sqrt(tpcPr[itrack]*tpcPr[itrack]+tofPr[itrack]*tofPr[itrack]);
+      nsigmaKaon   = TMath::Sqrt(tpcKa[itrack]*tpcKa[itrack]+tofKa[itrack]*tofKa[itrack]);
+      nsigmaPion   = TMath::Sqrt(tpcPi[itrack]*tpcPi[itrack]+tofPi[itrack]*tofPi[itrack]);
+    }
+    else {
+      nsigmaProton = TMath::Abs(tpcPr[itrack]);
+      nsigmaKaon   = TMath::Abs(tpcKa[itrack]);
+      nsigmaPion   = TMath::Abs(tpcPi[itrack]);
+    }
+    ids[itrack] = GetNanoTrackID(nsigmaPion, nsigmaKaon, nsigmaProton);
+  }
+}
+
+Double_t AliAnalysisTaskSpectraAllChNanoAOD::GetNanoRapidity(Double_t pt, Double_t theta, Double_t m) {
+  // rapidity of a nano track of a given mass, same as AliNanoAODTrack::Y(m)
+  if(m < 0.) return -999.;
+  Double_t pz = pt / TMath::Tan(theta);
+  Double_t p = TMath::Sqrt(pt*pt+pz*pz);
+  Double_t e = TMath::Sqrt(p*p + m*m);
+  if(e>=0 && e!=pz) return 0.5*TMath::Log((e+pz)/(e-pz));
+  return -999.;
+}
+
+Int_t AliAnalysisTaskSpectraAllChNanoAOD::GetNanoTrackID(Double_t nsigmaPion, Double_t nsigmaKaon, Double_t nsigmaProton) const {
+  // identity of the particle with the minimum nsigma
+  Double_t nSigmaPID = 3.0;
 
   // guess the particle based on the smaller nsigma (within nSigmaPID)
   if( ( nsigmaKaon==nsigmaPion ) && ( nsigmaKaon==nsigmaProton )) return kSpUndefined;//if is the default value for the three
@@ -16,8 +16,10 @@ class AliAODEvent;
 class AliSpectraAODTrackCuts;
 class AliSpectraAODEventCuts;
 class AliHelperPID;
+class AliNanoAODTrackColumns;
 
 #include "AliAnalysisTaskSE.h"
+#include <vector>
 
 class AliAnalysisTaskSpectraAllChNanoAOD : public AliAnalysisTaskSE
 {
@@ -36,11 +38,14 @@ class AliAnalysisTaskSpectraAllChNanoAOD : public AliAnalysisTaskSE
     fOutput(0x0),
     fnCentBins(20),
     fnQvecBins(40),
-    fnNchBins(200)
+    fnNchBins(200),
+    fNanoColumns(0x0),
+    fNanoTrackID()
       {}
   AliAnalysisTaskSpectraAllChNanoAOD(const char *name);
   virtual ~AliAnalysisTaskSpectraAllChNanoAOD() {
     Printf("calling detructor of AliAnalysisTaskSpectraAllChNanoAOD - To be implemented");
+    delete fNanoColumns;
   }
   
   void SetIsMC(Bool_t isMC = kFALSE)    {fIsMC = isMC; };
@@ -76,6 +81,7 @@ class AliAnalysisTaskSpectraAllChNanoAOD : public AliAnalysisTaskSE
 
 
   Int_t GetNanoTrackID(AliVTrack * track) ;
+  void  FillNanoTrackIDs(const AliNanoAODTrackColumns * columns, std::vector<Int_t> & ids) const;
   
  private:
   
@@ -92,10 +98,15 @@ class AliAnalysisTaskSpectraAllChNanoAOD : public AliAnalysisTaskSE
   Int_t                            fnCentBins;                  // number of bins for the centrality axis
   Int_t                            fnQvecBins;                 // number of bins for the q vector axis
   Int_t                            fnNchBins;                 // number of bins for the Nch axis
+  AliNanoAODTrackColumns         * fNanoColumns;               //! columnar view of the nano tracks of the event
+  std::vector<Int_t>               fNanoTrackID;               //! PID of the nano tracks of the event
+
+  Int_t GetNanoTrackID(Double_t nsigmaPion, Double_t nsigmaKaon, Double_t nsigmaProton) const;
+  static Double_t GetNanoRapidity(Double_t pt, Double_t theta, Double_t m);
   AliAnalysisTaskSpectraAllChNanoAOD(const AliAnalysisTaskSpectraAllChNanoAOD&);
   AliAnalysisTaskSpectraAllChNanoAOD& operator=(const AliAnalysisTaskSpectraAllChNanoAOD&);
   
-  ClassDef(AliAnalysisTaskSpectraAllChNanoAOD, 6);
+  ClassDef(AliAnalysisTaskSpectraAllChNanoAOD, 7);
 };
 
 #endif
@@ -49,6 +49,7 @@ class AliAODRecoDecay;
 #include "TObjArray.h"
 #include "AliAnalysisFilter.h"
 #include "AliNanoAODTrack.h"
+#include "AliNanoAODTrackColumns.h"
 
 #include <TFile.h>
 #include <TDatabasePDG.h>
@@ -112,7 +113,9 @@ AliAODBranchReplicator(),
   fInputArrayName(""),
   fOutputArrayName("tracks"),
   fKeepDaughters(),
-  fClonedVertices()
+  fClonedVertices(),
+  fFillTrackColumns(kFALSE),
+  fTrackColumns(0x0)
   {
   // Default ctor. we need it to avoid instantiating a wrong mapping when reading from file
   }
@@ -152,7 +155,9 @@ AliNanoAODReplicator::AliNanoAODReplicator(const char* name, const char* title)
   fInputArrayName(""),
   fOutputArrayName("tracks"),
   fKeepDaughters(),
-  fClonedVertices()
+  fClonedVertices(),
+  fFillTrackColumns(kFALSE),
+  fTrackColumns(0x0)
 {
   // default ctor
 }
@@ -163,6 +168,7 @@ AliNanoAODReplicator::~AliNanoAODReplicator()
   // dtor
   delete fTrackCuts;
   delete fList;
+  delete fTrackColumns;
 }
 
 //_____________________________________________________________________________
@@ -664,6 +670,12 @@ void AliNanoAODReplicator::ReplicateAndFilter(const AliAODEvent& source)
   
   fTracks->Clear("C");
   
+  if (fFillTrackColumns) {
+    if (!fTrackColumns)
+      fTrackColumns = new AliNanoAODTrackColumns;
+    fTrackColumns->Clear();
+  }
+  
   assert(fVertices!=0x0);
   fVertices->Clear("C");
   
@@ -855,6 +867,10 @@ void AliNanoAODReplicator::ReplicateAndFilter(const AliAODEvent& source)
     for (std::list<AliNanoAODCustomSetter*>::iterator it = fCustomSetters.begin(); it != fCustomSetters.end(); ++it)
       (*it)->SetNanoAODTrack(aodtrack, nanoTrack);
     
+    // after the custom setters, so that the custom variables are in the columns
+    if (fTrackColumns)
+      fTrackColumns->AddTrack(nanoTrack);
+    
     trackAssociation[aodtrack] = nanoTrack;
   }
   
@@ -49,6 +49,7 @@ class AliAODHeader;
 class AliNanoAODHeader;
 class AliAnalysisTaskSE;
 class AliNanoAODTrack;
+class AliNanoAODTrackColumns;
 class AliAODTrack;
 class AliNanoAODCustomSetter;
 class AliAODZDC;
@@ -97,6 +98,11 @@ class AliNanoAODReplicator : public AliAODBranchReplicator
   void SetOutputArrayName(TString name) {fOutputArrayName=name;}
 
   void SetVarListHeaderTC(TString var) {fVarListHeader_fTC=var;}
+
+  // Fill a columnar view of the stored tracks (transient, not written to the output),
+  // to be used by tasks running in the same train after the filtering
+  void SetFillTrackColumns(Bool_t b) { fFillTrackColumns = b; }
+  const AliNanoAODTrackColumns* GetTrackColumns() const { return fTrackColumns; }
     
  private:
 
@@ -156,10 +162,13 @@ class AliNanoAODReplicator : public AliAODBranchReplicator
   std::map<AliAODVertex*, std::vector<TObject*> > fKeepDaughters; //! Tracks needed as references to V0s and cascades
   std::map<AliAODVertex*, AliAODVertex*> fClonedVertices; //! avoid that vertices are stored several times
 
+  Bool_t fFillTrackColumns; // if kTRUE the columnar view of the stored tracks is filled
+  AliNanoAODTrackColumns* fTrackColumns; //! columnar view of the stored tracks
+
   AliNanoAODReplicator(const AliNanoAODReplicator&);
   AliNanoAODReplicator& operator=(const AliNanoAODReplicator&);
 
-  ClassDef(AliNanoAODReplicator, 7) // Branch replicator for ESD to muon AOD.
+  ClassDef(AliNanoAODReplicator, 8) // Branch replicator for ESD to muon AOD.
 };
 
 #endif
@@ -367,7 +367,7 @@ public:
 
 private :
 
-
+  friend class AliNanoAODTrackColumns; // copies the variables directly from the storage
 
   // Momentum & position
   // FIXME: the following was replaced by posx, posy, posz. Check if the names make sense
@@ -0,0 +1,182 @@
+/**************************************************************************
+ * Copyright(c) 1998-2007, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+
+//-------------------------------------------------------------------------
+//     Columnar view of the NanoAOD tracks of an event
+//-------------------------------------------------------------------------
+
+#include "TClonesArray.h"
+#include "TMath.h"
+#include "AliLog.h"
+#include "AliVEvent.h"
+
+#include "AliNanoAODTrack.h"
+#include "AliNanoAODTrackMapping.h"
+#include "AliNanoAODTrackColumns.h"
+
+ClassImp(AliNanoAODTrackColumns)
+
+//______________________________________________________________________________
+AliNanoAODTrackColumns::AliNanoAODTrackColumns() :
+  TObject(),
+  fNTracks(0),
+  fIndexPt(-1),
+  fIndexPhi(-1),
+  fIndexTheta(-1),
+  fIndexFilterMap(-1),
+  fSelVars(),
+  fSelVarsInt(),
+  fCopyVars(),
+  fCopyVarsInt(),
+  fHasVar(),
+  fHasVarInt(),
+  fVars(),
+  fVarsInt(),
+  fEta(),
+  fCharge(),
+  fNanoFlags(),
+  fLabel()
+{
+  // default constructor
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::SelectVar(Int_t index)
+{
+  // Adds a float variable to the columns. Takes effect with the next event.
+
+  if (index < 0)
+    AliFatal("Variable not in the NanoAOD track mapping");
+  fSelVars.push_back(index);
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::SelectVarInt(Int_t index)
+{
+  // Adds an int variable to the columns. Takes effect with the next event.
+
+  if (index < 0)
+    AliFatal("Variable not in the NanoAOD track mapping");
+  fSelVarsInt.push_back(index);
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Clear(Option_t * /*opt*/)
+{
+  // Removes all tracks. The layout of the columns is taken again from the
+  // mapping when the next track is added.
+
+  fNTracks = 0;
+  for (UInt_t ivar = 0; ivar < fVars.size(); ivar++)
+    fVars[ivar].clear();
+  for (UInt_t ivar = 0; ivar < fVarsInt.size(); ivar++)
+    fVarsInt[ivar].clear();
+  fEta.clear();
+  fCharge.clear();
+  fNanoFlags.clear();
+  fLabel.clear();
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Reset()
+{
+  // Sets up empty columns for the selected variables of the current
+  // mapping. The memory of the columns is kept from event to event.
+
+  AliNanoAODTrackMapping * mapping = AliNanoAODTrackMapping::GetInstance();
+  if (!mapping)
+    AliFatal("NanoAOD track mapping not available");
+
+  fIndexPt        = mapping->GetPt();
+  fIndexPhi       = mapping->GetPhi();
+  fIndexTheta     = mapping->GetTheta();
+  fIndexFilterMap = mapping->GetFilterMap();
+
+  const Bool_t all = fSelVars.empty() && fSelVarsInt.empty();
+  SetupCopy(fSelVars, all, mapping->GetSize(), fCopyVars, fHasVar);
+  SetupCopy(fSelVarsInt, all, mapping->GetSizeInt(), fCopyVarsInt, fHasVarInt);
+  fVars.resize(mapping->GetSize());
+  fVarsInt.resize(mapping->GetSizeInt());
+  Clear();
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::SetupCopy(const std::vector<Int_t> & selected, Bool_t all, Int_t size, std::vector<Int_t> & copy, std::vector<Bool_t> & has)
+{
+  // List of the variables to be copied: the selected ones, all if no variable is selected
+
+  has.assign(size, all);
+  for (UInt_t isel = 0; isel < selected.size(); isel++)
+    if (selected[isel] < size)
+      has[selected[isel]] = kTRUE;
+
+  copy.clear();
+  for (Int_t ivar = 0; ivar < size; ivar++)
+    if (has[ivar])
+      copy.push_back(ivar);
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Fill(const AliVEvent * event)
+{
+  // Fills the columns with all tracks of a NanoAOD event
+
+  Reset();
+  const Int_t ntracks = event->GetNumberOfTracks();
+  for (Int_t itrack = 0; itrack < ntracks; itrack++) {
+    const AliNanoAODTrack * track = dynamic_cast<const AliNanoAODTrack*>(event->GetTrack(itrack));
+    if (!track)
+      AliFatal("Not a nano AOD track");
+    AddTrack(track);
+  }
+}
+
+//______________________________________________________________________________
+void AliNanoAODTrackColumns::Fill(const TClonesArray * tracks)
+{
+  // Fills the columns with all tracks of an array of AliNanoAODTrack
+
+  Reset();
+  const Int_t ntracks = tracks->GetEntriesFast();
+  for (Int_t itrack = 0; itrack < ntracks; itrack++)
+    AddTrack(static_cast<const AliNanoAODTrack*>(tracks->UncheckedAt(itrack)));
+}
+
+//______________________________________________________________________________
+Int_t AliNanoAODTrackColumns::AddTrack(const AliNanoAODTrack * track)
+{
+  // Appends a track as a new row and returns its index. Custom variables
+  // are stored like all other variables of the mapping. The values are
+  // read directly from the storage of the track.
+
+  if (fNTracks == 0)
+    Reset();
+
+  for (UInt_t icopy = 0; icopy < fCopyVars.size(); icopy++)
+    fVars[fCopyVars[icopy]].push_back(track->fVars[fCopyVars[icopy]]);
+  for (UInt_t icopy = 0; icopy < fCopyVarsInt.size(); icopy++)
+    fVarsInt[fCopyVarsInt[icopy]].push_back(track->fVarsInt[fCopyVarsInt[icopy]]);
+
+  // same definitions as AliNanoAODTrack::Eta() and AliNanoAODTrack::Charge()
+  if (fIndexTheta >= 0 && fHasVar[fIndexTheta])
+    fEta.push_back(-TMath::Log(TMath::Tan(0.5 * fVars[fIndexTheta].back())));
+  const UInt_t flags = track->fNanoFlags;
+  fCharge.push_back(TESTBIT(flags, AliNanoAODTrack::kNanoCharge) ? 1 : -1);
+  fNanoFlags.push_back(flags);
+  fLabel.push_back(track->fLabel);
+
+  return fNTracks++;
+}
@@ -0,0 +1,109 @@
+#ifndef AliNanoAODTrackColumns_H
+#define AliNanoAODTrackColumns_H
+/* Copyright(c) 1998-2007, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+
+//-------------------------------------------------------------------------
+//     Columnar (structure of arrays) view of the NanoAOD tracks of an event
+//     Each selected variable of the AliNanoAODTrackMapping is stored as a
+//     contiguous array over the tracks of the event, so that a track
+//     selection can loop over plain arrays instead of calling the
+//     getters of AliNanoAODTrack (mapping lookup and virtual call per
+//     variable and track). The values are copied directly from the
+//     storage of the tracks. Only the selected variables are copied, all
+//     variables of the mapping if none is selected. Eta (if theta is
+//     selected), charge, nano flags and label are provided as additional
+//     columns.
+//     The view is transient. It is filled once per event from the track
+//     array of a NanoAOD event, or on the write side by the
+//     AliNanoAODReplicator (SetFillTrackColumns) while the tracks are
+//     stored, see GetTrackColumns.
+//     Row i corresponds to track i in the track array.
+//
+//     Usage:
+//       AliNanoAODTrackColumns columns;
+//       AliNanoAODTrackMapping * mapping = AliNanoAODTrackMapping::GetInstance();
+//       columns.SelectVar(mapping->GetPt());              // once
+//       columns.SelectVar(mapping->GetVarIndex("cstNSigmaTPCPi"));
+//       columns.Fill(aodEvent);                           // once per event
+//       const Double_t * pt  = columns.GetPt();
+//       const Double_t * nSigma = columns.GetVar(mapping->GetVarIndex("cstNSigmaTPCPi"));
+//       for (Int_t i = 0; i < columns.GetNumberOfTracks(); i++) { ... }
+//-------------------------------------------------------------------------
+
+#include "TObject.h"
+#include <vector>
+
+class TClonesArray;
+class AliVEvent;
+class AliNanoAODTrack;
+
+class AliNanoAODTrackColumns : public TObject {
+
+public:
+  AliNanoAODTrackColumns();
+  virtual ~AliNanoAODTrackColumns() {}
+
+  virtual void Clear(Option_t * opt = "");
+
+  // Variables to be copied, index as in AliNanoAODTrackMapping
+  void  SelectVar(Int_t index);
+  void  SelectVarInt(Int_t index);
+
+  void  Fill(const AliVEvent * event);
+  void  Fill(const TClonesArray * tracks);
+  Int_t AddTrack(const AliNanoAODTrack * track);
+
+  Int_t GetNumberOfTracks() const { return fNTracks; }
+  Int_t GetNumberOfVars()    const { return fVars.size();    }
+  Int_t GetNumberOfVarsInt() const { return fVarsInt.size(); }
+
+  // Columns of the mapped variables, index as in AliNanoAODTrackMapping.
+  // A null pointer is returned for variables which are not in the mapping
+  // or not selected.
+  const Double_t * GetVar(Int_t index)    const { return (index >= 0 && index < (Int_t) fHasVar.size()    && fHasVar[index])    ? fVars[index].data()    : 0x0; }
+  const Int_t    * GetVarInt(Int_t index) const { return (index >= 0 && index < (Int_t) fHasVarInt.size() && fHasVarInt[index]) ? fVarsInt[index].data() : 0x0; }
+
+  const Double_t * GetPt()        const { return GetVar(fIndexPt);           }
+  const Double_t * GetPhi()       const { return GetVar(fIndexPhi);          }
+  const Double_t * GetTheta()     const { return GetVar(fIndexTheta);        }
+  const Int_t    * GetFilterMap() const { return GetVarInt(fIndexFilterMap); }
+
+  // Derived columns
+  const Double_t * GetEta()    const { return (fIndexTheta >= 0 && fHasVar[fIndexTheta]) ? fEta.data() : 0x0; }
+  const Short_t  * GetCharge() const { return fCharge.data();    }
+  const UInt_t   * GetNanoFlags() const { return fNanoFlags.data(); }
+  const Int_t    * GetLabel()  const { return fLabel.data();     }
+
+private:
+  void Reset();
+  static void SetupCopy(const std::vector<Int_t> & selected, Bool_t all, Int_t size, std::vector<Int_t> & copy, std::vector<Bool_t> & has);
+
+  Int_t fNTracks;                                  //! number of tracks (rows)
+  Int_t fIndexPt;                                  //! cached mapping index of pt
+  Int_t fIndexPhi;                                 //! cached mapping index of phi
+  Int_t fIndexTheta;                               //! cached mapping index of theta
+  Int_t fIndexFilterMap;                           //! cached mapping index of the filter map
+
+  std::vector<Int_t>                  fSelVars;    //! selected float variables
+  std::vector<Int_t>                  fSelVarsInt; //! selected int variables
+  std::vector<Int_t>                  fCopyVars;   //! float variables copied for the current mapping
+  std::vector<Int_t>                  fCopyVarsInt; //! int variables copied for the current mapping
+  std::vector<Bool_t>                 fHasVar;     //! kTRUE for the copied float variables
+  std::vector<Bool_t>                 fHasVarInt;  //! kTRUE for the copied int variables
+
+  std::vector<std::vector<Double_t> > fVars;       //! one column per float variable of the mapping
+  std::vector<std::vector<Int_t> >    fVarsInt;    //! one column per int variable of the mapping
+  std::vector<Double_t>               fEta;        //! eta, computed from theta
+  std::vector<Short_t>                fCharge;     //! charge, from the nano flags
+  std::vector<UInt_t>                 fNanoFlags;  //! nano flags (see AliNanoAODTrack::ENanoFlags)
+  std::vector<Int_t>                  fLabel;      //! MC label
+
+  AliNanoAODTrackColumns(const AliNanoAODTrackColumns&);
+  AliNanoAODTrackColumns& operator=(const AliNanoAODTrackColumns&);
+
+  ClassDef(AliNanoAODTrackColumns, 1); // columnar view of the NanoAOD tracks
+};
+
+#endif
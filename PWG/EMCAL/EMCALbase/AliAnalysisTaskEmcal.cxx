@@ -38,6 +38,7 @@
 #include <TFile.h>
 #include <TChain.h>
 #include <TKey.h>
+#include <TBufferFile.h>
 
 #include "AliAnalysisTaskEmcal.h"
 #include "AliAnalysisUtils.h"
@@ -47,6 +48,7 @@
 #include "AliAnalysisManager.h"
 #include "AliCentrality.h"
 #include "AliEmcalDownscaleFactorsOCDB.h"
+#include "AliEmcalEventCache.h"
 #include "AliEMCALGeometry.h"
 #include "AliEmcalPythiaInfo.h"
 #include "AliEMCALTriggerPatchInfo.h"
@@ -133,6 +135,7 @@ AliAnalysisTaskEmcal::AliAnalysisTaskEmcal() :
   fPtHardAndJetPtFactor(0.),
   fPtHardAndClusterPtFactor(0.),
   fPtHardAndTrackPtFactor(0.),
+  fUseSharedEventCache(kFALSE),
   fRunNumber(-1),
   fAliEventCuts(kFALSE),
   fAliAnalysisUtils(nullptr),
@@ -162,6 +165,10 @@ AliAnalysisTaskEmcal::AliAnalysisTaskEmcal() :
   fNTrials(0),
   fXsection(0),
   fPythiaInfo(nullptr),
+  fEventRejectionReason(nullptr),
+  fEventCacheClient(-1),
+  fEventSelectionKey(-1),
+  fCentralityKey(-1),
   fOutput(nullptr),
   fHistEventCount(nullptr),
   fHistTrialsAfterSel(nullptr),
@@ -187,6 +194,9 @@ AliAnalysisTaskEmcal::AliAnalysisTaskEmcal() :
   fVertexSPD[0] = 0;
   fVertexSPD[1] = 0;
   fVertexSPD[2] = 0;
+  fEventPlaneKeys[0] = -1;
+  fEventPlaneKeys[1] = -1;
+  fEventPlaneKeys[2] = -1;
 
   fParticleCollArray.SetOwner(kTRUE);
   fClusterCollArray.SetOwner(kTRUE);
@@ -249,6 +259,7 @@ AliAnalysisTaskEmcal::AliAnalysisTaskEmcal(const char *name, Bool_t histo) :
   fPtHardAndJetPtFactor(0.),
   fPtHardAndClusterPtFactor(0.),
   fPtHardAndTrackPtFactor(0.),
+  fUseSharedEventCache(kFALSE),
   fRunNumber(-1),
   fAliEventCuts(kFALSE),
   fAliAnalysisUtils(nullptr),
@@ -278,6 +289,10 @@ AliAnalysisTaskEmcal::AliAnalysisTaskEmcal(const char *name, Bool_t histo) :
   fNTrials(0),
   fXsection(0),
   fPythiaInfo(0),
+  fEventRejectionReason(nullptr),
+  fEventCacheClient(-1),
+  fEventSelectionKey(-1),
+  fCentralityKey(-1),
   fOutput(nullptr),
   fHistEventCount(nullptr),
   fHistTrialsAfterSel(nullptr),
@@ -303,6 +318,9 @@ AliAnalysisTaskEmcal::AliAnalysisTaskEmcal(const char *name, Bool_t histo) :
   fVertexSPD[0] = 0;
   fVertexSPD[1] = 0;
   fVertexSPD[2] = 0;
+  fEventPlaneKeys[0] = -1;
+  fEventPlaneKeys[1] = -1;
+  fEventPlaneKeys[2] = -1;
   fParticleCollArray.SetOwner(kTRUE);
   fClusterCollArray.SetOwner(kTRUE);
   // Do not perform trigger selection in the AliEvent cuts but let the task do this before
@@ -615,8 +633,17 @@ void AliAnalysisTaskEmcal::UserExec(Option_t *option)
     fFileChanged = kFALSE;
   }
 
-  if (!RetrieveEventObjects())
+  PWG::EMCAL::AliEmcalEventCache *eventcache = nullptr;
+  if (fEventCacheClient >= 0) {
+    eventcache = PWG::EMCAL::AliEmcalEventCache::Instance();
+    eventcache->NextEvent(InputEvent(), AliAnalysisManager::GetAnalysisManager()->GetCurrentEntry());
+    eventcache->StartTimer(fEventCacheClient);
+  }
+
+  if (!RetrieveEventObjects()) {
+    if (eventcache) eventcache->StopTimer(fEventCacheClient);
     return;
+  }
 
   if(InputEvent()->GetRunNumber() != fRunNumber){
     fRunNumber = InputEvent()->GetRunNumber();
@@ -643,7 +670,10 @@ void AliAnalysisTaskEmcal::UserExec(Option_t *option)
     fHistXsection->Fill(fPtHardBinGlobal, fPythiaHeader->GetXsection());
   }
 
-  if (IsEventSelected()) {
+  Bool_t selected = IsEventSelected();
+  if (eventcache) eventcache->StopTimer(fEventCacheClient);
+
+  if (selected) {
     if (fGeneralHistograms) fHistEventCount->Fill("Accepted",1);
   }
   else {
@@ -858,9 +888,16 @@ Bool_t AliAnalysisTaskEmcal::PythiaInfoFromFile(const char* currFile, Float_t &f
 Bool_t AliAnalysisTaskEmcal::UserNotify(){
   fPtHardInitialized = kFALSE;
   fFileChanged = kTRUE;
+  // the entry used to identify the event in the shared cache restarts with each file
+  if (fEventCacheClient >= 0) PWG::EMCAL::AliEmcalEventCache::Instance()->Invalidate();
   return kTRUE;
 }
 
+void AliAnalysisTaskEmcal::FinishTaskOutput()
+{
+  if (fEventCacheClient >= 0) PWG::EMCAL::AliEmcalEventCache::Instance()->PrintReportOnce();
+}
+
 Bool_t AliAnalysisTaskEmcal::FileChanged(){
   if (!fIsPythia || !fGeneralHistograms || !fCreateHisto)
     return kTRUE;
@@ -1007,9 +1044,95 @@ void AliAnalysisTaskEmcal::ExecOnce()
 
   }
 
+  if (fUseSharedEventCache) InitEventCache();
+
   fLocalInitialized = kTRUE;
 }
 
+void AliAnalysisTaskEmcal::InitEventCache()
+{
+  PWG::EMCAL::AliEmcalEventCache *eventcache = PWG::EMCAL::AliEmcalEventCache::Instance();
+  fEventCacheClient = eventcache->RegisterClient(GetName());
+
+  fEventSelectionKey = eventcache->RegisterKey("selection:" + GetEventSelectionFingerprint());
+  fCentralityKey = eventcache->RegisterKey(Form("centrality:%d:%s", fUseNewCentralityEstimation, fCentEst.Data()));
+  const char *eventplanes[3] = {"V0", "V0A", "V0C"};
+  for (Int_t i = 0; i < 3; i++) {
+    fEventPlaneKeys[i] = eventcache->RegisterKey(Form("eventplane:%s", eventplanes[i]));
+  }
+
+  for (Int_t i = 0; i < fParticleCollArray.GetEntriesFast(); i++) {
+    AliEmcalContainer *cont = static_cast<AliEmcalContainer*>(fParticleCollArray.At(i));
+    cont->SetSharedAcceptanceKey(eventcache->RegisterKey("acceptance:" + GetObjectFingerprint(cont)), fEventCacheClient);
+  }
+  for (Int_t i = 0; i < fClusterCollArray.GetEntriesFast(); i++) {
+    AliEmcalContainer *cont = static_cast<AliEmcalContainer*>(fClusterCollArray.At(i));
+    cont->SetSharedAcceptanceKey(eventcache->RegisterKey("acceptance:" + GetObjectFingerprint(cont)), fEventCacheClient);
+  }
+
+  AliInfoStream() << GetName() << ": Using shared event cache, event selection key " << fEventSelectionKey << std::endl;
+}
+
+std::string AliAnalysisTaskEmcal::GetEventSelectionFingerprint()
+{
+  // Results are only shared among tasks of the same class, as IsTriggerSelected
+  // and CheckMCOutliers can be reimplemented
+  TString fingerprint = IsA()->GetName();
+  fingerprint += Form("|trigger:%s,%d", fTrigClass.Data(), fEMCalTriggerMode);
+  fingerprint += Form("|mc:%d,%d,%d,%.17g,%.17g,%.17g", fIsPythia, fIsHerwig, fMCRejectFilter, fPtHardAndJetPtFactor, fPtHardAndClusterPtFactor, fPtHardAndTrackPtFactor);
+  AliParticleContainer *particles = GetParticleContainer(0);
+  AliClusterContainer *clusters = GetClusterContainer(0);
+  fingerprint += Form("|mcarrays:%s,%s", particles ? particles->GetArrayName().Data() : "", clusters ? clusters->GetArrayName().Data() : "");
+
+  if (!fUseBuiltinEventSelection) {
+    return std::string(fingerprint.Data()) + "|eventcuts:" + GetObjectFingerprint(&fAliEventCuts);
+  }
+
+  // Vertex range as applied by IsEventSelectedInternal when the analysis utils are used
+  Double_t minVz = fMinVz, maxVz = fMaxVz;
+  if (fUseAliAnaUtils) {
+    if (minVz < -998.) minVz = -10.;
+    if (maxVz > 998.) maxVz = 10.;
+  }
+  fingerprint += Form("|physsel:%u,%d,%s", fOffTrigger, fTriggerTypeSel, fCaloTriggerPatchInfoName.Data());
+  fingerprint += Form("|cent:%d,%s,%d,%d,%.17g,%.17g", fUseNewCentralityEstimation, fCentEst.Data(), fForceBeamType, fNcentBins, fMinCent, fMaxCent);
+  fingerprint += Form("|vertex:%d,%d,%d,%d,%.17g,%.17g,%.17g", fUseAliAnaUtils, fMinVertexContrib, fRejectPileup, fTklVsClusSPDCut, minVz, maxVz, fZvertexDiff);
+  fingerprint += Form("|tracks:%.17g,%d,%d,%.17g", fMinPtTrackInEmcal, fNeedEmcalGeom, fMinNTrack, fTrackPtCut);
+  fingerprint += Form("|eventplane:%.17g,%.17g", fMinEventPlane, fMaxEventPlane);
+  fingerprint += Form("|pthard:%d", fSelectPtHardBin);
+  for (Int_t i = 0; i < fPtHardBinning.GetSize(); i++) fingerprint += Form(",%d", fPtHardBinning[i]);
+  std::string result(fingerprint.Data());
+  if ((fMinPtTrackInEmcal > 0 || fMinNTrack > 0) && particles) {
+    result += "|trackcont:" + GetObjectFingerprint(particles);
+  }
+  return result;
+}
+
+std::string AliAnalysisTaskEmcal::GetObjectFingerprint(TObject *obj)
+{
+  TBufferFile buffer(TBuffer::kWrite);
+  obj->Streamer(buffer);
+  return std::string(obj->IsA()->GetName()) + ":" + std::string(buffer.Buffer(), buffer.Length());
+}
+
+Bool_t AliAnalysisTaskEmcal::FindCachedValue(Int_t key, Double_t &value) const
+{
+  if (key < 0) return kFALSE;
+  PWG::EMCAL::AliEmcalEventCache *eventcache = PWG::EMCAL::AliEmcalEventCache::Instance();
+  if (eventcache->FindValue(key, value)) {
+    eventcache->AddHit(fEventCacheClient, PWG::EMCAL::AliEmcalEventCache::kEventProperty);
+    return kTRUE;
+  }
+  eventcache->AddMiss(fEventCacheClient, PWG::EMCAL::AliEmcalEventCache::kEventProperty);
+  return kFALSE;
+}
+
+void AliAnalysisTaskEmcal::StoreCachedValue(Int_t key, Double_t value) const
+{
+  if (key < 0) return;
+  PWG::EMCAL::AliEmcalEventCache::Instance()->SetValue(key, value);
+}
+
 AliAnalysisTaskEmcal::BeamType AliAnalysisTaskEmcal::GetBeamType() const
 {
   if (fForceBeamType != kNA)
@@ -1098,12 +1221,38 @@ Bool_t AliAnalysisTaskEmcal::HasTriggerType(TriggerType trigger)
 }
 
 Bool_t AliAnalysisTaskEmcal::IsEventSelected(){
+  if(fEventSelectionKey < 0) return EvaluateEventSelection();
+
+  PWG::EMCAL::AliEmcalEventCache *eventcache = PWG::EMCAL::AliEmcalEventCache::Instance();
+  Bool_t selected = kFALSE;
+  const char *reason = nullptr;
+  if(eventcache->FindSelection(fEventSelectionKey, selected, reason)) {
+    eventcache->AddHit(fEventCacheClient, PWG::EMCAL::AliEmcalEventCache::kEventSelection);
+    // Book keeping of the rejection reason as if the selection was evaluated by this task
+    if(!selected && reason && fUseBuiltinEventSelection && fGeneralHistograms) fHistEventRejection->Fill(reason,1);
+    return selected;
+  }
+
+  eventcache->AddMiss(fEventCacheClient, PWG::EMCAL::AliEmcalEventCache::kEventSelection);
+  fEventRejectionReason = nullptr;
+  selected = EvaluateEventSelection();
+  eventcache->SetSelection(fEventSelectionKey, selected, fEventRejectionReason);
+  return selected;
+}
+
+Bool_t AliAnalysisTaskEmcal::EvaluateEventSelection(){
   if(fUseBuiltinEventSelection) return IsEventSelectedInternal();
   if(!IsTriggerSelected()) return false;
   if(!CheckMCOutliers()) return false;
   return fAliEventCuts.AcceptEvent(fInputEvent);
 }
 
+Bool_t AliAnalysisTaskEmcal::RejectEvent(const char *reason){
+  fEventRejectionReason = reason;
+  if (fGeneralHistograms) fHistEventRejection->Fill(reason,1);
+  return kFALSE;
+}
+
 Bool_t AliAnalysisTaskEmcal::IsEventSelectedInternal()
 {
   AliDebugStream(3) << "Using default event selection" << std::endl;
@@ -1119,27 +1268,23 @@ Bool_t AliAnalysisTaskEmcal::IsEventSelectedInternal()
       }
     }
     if ((res & fOffTrigger) == 0) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("PhysSel",1);
-      return kFALSE;
+      return RejectEvent("PhysSel");
     }
   }
 
   if(!IsTriggerSelected()) {
-    if (fGeneralHistograms) fHistEventRejection->Fill("trigger",1);
-    return kFALSE;
+    return RejectEvent("trigger");
   }
 
   if (fTriggerTypeSel != kND) {
     if (!HasTriggerType(fTriggerTypeSel)) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("trigTypeSel",1);
-      return kFALSE;
+      return RejectEvent("trigTypeSel");
     }
   }
 
   if ((fMinCent != -999) && (fMaxCent != -999)) {
     if (fCent<fMinCent || fCent>fMaxCent) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("Cent",1);
-      return kFALSE;
+      return RejectEvent("Cent");
     }
   }
 
@@ -1152,30 +1297,25 @@ Bool_t AliAnalysisTaskEmcal::IsEventSelectedInternal()
     if(fMaxVz>998.)  fMaxVz = 10.;
 
     if (!fAliAnalysisUtils->IsVertexSelected2013pA(InputEvent())) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("VtxSel2013pA",1);
-      return kFALSE;
+      return RejectEvent("VtxSel2013pA");
     }
 
     if (fRejectPileup && fAliAnalysisUtils->IsPileUpEvent(InputEvent())) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("PileUp",1);
-      return kFALSE;
+      return RejectEvent("PileUp");
     }
 
     if(fTklVsClusSPDCut && fAliAnalysisUtils->IsSPDClusterVsTrackletBG(InputEvent())) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("Bkg evt",1);
-      return kFALSE;
+      return RejectEvent("Bkg evt");
     }
   }
 
   if ((fMinVz > -998.) && (fMaxVz < 998.)) {
     if (fNVertCont == 0 ) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("vertex contr.",1);
-      return kFALSE;
+      return RejectEvent("vertex contr.");
     }
     Double_t vz = fVertex[2];
     if (vz < fMinVz || vz > fMaxVz) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("Vz",1);
-      return kFALSE;
+      return RejectEvent("Vz");
     }
 
     if (fNVertSPDCont > 0 && fZvertexDiff < 999) {
@@ -1183,8 +1323,7 @@ Bool_t AliAnalysisTaskEmcal::IsEventSelectedInternal()
       Double_t dvertex = TMath::Abs(vz-vzSPD);
       //if difference larger than fZvertexDiff
       if (dvertex > fZvertexDiff) {
-        if (fGeneralHistograms) fHistEventRejection->Fill("VzSPD",1);
-        return kFALSE;
+        return RejectEvent("VzSPD");
       }
     }
   }
@@ -1213,8 +1352,7 @@ Bool_t AliAnalysisTaskEmcal::IsEventSelectedInternal()
       }
     }
     if (!trackInEmcalOk) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("trackInEmcal",1);
-      return kFALSE;
+      return RejectEvent("trackInEmcal");
     }
   }
 
@@ -1232,8 +1370,7 @@ Bool_t AliAnalysisTaskEmcal::IsEventSelectedInternal()
       }
     }
     if (nTracksAcc<fMinNTrack) {
-      if (fGeneralHistograms) fHistEventRejection->Fill("minNTrack",1);
-      return kFALSE;
+      return RejectEvent("minNTrack");
     }
   }
 
@@ -1241,13 +1378,11 @@ Bool_t AliAnalysisTaskEmcal::IsEventSelectedInternal()
       !(fEPV0 + TMath::Pi() > fMinEventPlane && fEPV0 + TMath::Pi() <= fMaxEventPlane) &&
       !(fEPV0 - TMath::Pi() > fMinEventPlane && fEPV0 - TMath::Pi() <= fMaxEventPlane)) 
   {
-    if (fGeneralHistograms) fHistEventRejection->Fill("EvtPlane",1);
-    return kFALSE;
+    return RejectEvent("EvtPlane");
   }
 
   if (fSelectPtHardBin != -999 && fSelectPtHardBin != fPtHardBin)  {
-    if (fGeneralHistograms) fHistEventRejection->Fill("SelPtHardBin",1);
-    return kFALSE;
+    return RejectEvent("SelPtHardBin");
   }
 
   // Reject filter for MC data
@@ -1430,14 +1565,19 @@ Bool_t AliAnalysisTaskEmcal::RetrieveEventObjects()
   fBeamType = GetBeamType();
   TObject * header = InputEvent()->GetHeader();
   if (fBeamType == kAA || fBeamType == kpA ) {
-    if (fUseNewCentralityEstimation) {
+    if (FindCachedValue(fCentralityKey, fCent)) {
+      // centrality retrieved by another wagon
+    }
+    else if (fUseNewCentralityEstimation) {
       if (header->InheritsFrom("AliNanoAODStorage")){
         AliNanoAODHeader *nanoHead = (AliNanoAODHeader*)header;
         fCent=nanoHead->GetCentr(fCentEst.Data());
+        StoreCachedValue(fCentralityKey, fCent);
       }else{
         AliMultSelection *MultSelection = static_cast<AliMultSelection*>(InputEvent()->FindListObject("MultSelection"));
         if (MultSelection) {
           fCent = MultSelection->GetMultiplicityPercentile(fCentEst.Data());
+          StoreCachedValue(fCentralityKey, fCent);
         }
         else {
           AliWarning(Form("%s: Could not retrieve centrality information! Assuming 99", GetName()));
@@ -1448,10 +1588,12 @@ Bool_t AliAnalysisTaskEmcal::RetrieveEventObjects()
       if (header->InheritsFrom("AliNanoAODStorage")){
         AliNanoAODHeader *nanoHead = (AliNanoAODHeader*)header;
         fCent=nanoHead->GetCentr(fCentEst.Data());
+        StoreCachedValue(fCentralityKey, fCent);
       }else{
         AliCentrality *aliCent = InputEvent()->GetCentrality();
         if (aliCent) {
           fCent = aliCent->GetCentralityPercentile(fCentEst.Data());
+          StoreCachedValue(fCentralityKey, fCent);
         }
         else {
           AliWarning(Form("%s: Could not retrieve centrality information! Assuming 99", GetName()));
@@ -1501,12 +1643,17 @@ Bool_t AliAnalysisTaskEmcal::RetrieveEventObjects()
         fEPV0=nanoHead->GetVar(nanoHead->GetVarIndex("cstEvPlaneV0"));
         fEPV0A=nanoHead->GetVar(nanoHead->GetVarIndex("cstEvPlaneV0A"));
         fEPV0C=nanoHead->GetVar(nanoHead->GetVarIndex("cstEvPlaneV0C"));
+    }else if (FindCachedValue(fEventPlaneKeys[0], fEPV0) && FindCachedValue(fEventPlaneKeys[1], fEPV0A) && FindCachedValue(fEventPlaneKeys[2], fEPV0C)) {
+      // event plane retrieved by another wagon
     }else{
     AliEventplane *aliEP = InputEvent()->GetEventplane();
     if (aliEP) {
       fEPV0  = aliEP->GetEventplane("V0" ,InputEvent());
       fEPV0A = aliEP->GetEventplane("V0A",InputEvent());
       fEPV0C = aliEP->GetEventplane("V0C",InputEvent());
+      StoreCachedValue(fEventPlaneKeys[0], fEPV0);
+      StoreCachedValue(fEventPlaneKeys[1], fEPV0A);
+      StoreCachedValue(fEventPlaneKeys[2], fEPV0C);
     } else {
       AliWarning(Form("%s: Could not retrieve event plane information!", GetName()));
     }
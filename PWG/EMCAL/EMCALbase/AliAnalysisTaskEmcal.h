@@ -47,6 +47,8 @@ class AliEmcalPythiaInfo;
 class AliAODInputHandler;
 class AliESDInputHandler;
 
+#include <string>
+
 #include "Rtypes.h"
 #include "TArrayI.h"
 
@@ -533,6 +535,32 @@ class AliAnalysisTaskEmcal : public AliAnalysisTaskSE {
    * @param[in] doUse It true use the old internal event selection instead of AliEventCuts
    */
   void                        SetUseBuiltinEventSelection(Bool_t doUse)            { fUseBuiltinEventSelection = doUse                  ; }
+
+  /**
+   * @brief Share event level results with other wagons
+   *
+   * If enabled, the event selection decision, the centrality and event plane, and
+   * the accepted entries of the particle and cluster containers are stored in the
+   * shared event cache (PWG::EMCAL::AliEmcalEventCache) and taken from there by other
+   * wagons with the same configuration, instead of being evaluated by each wagon.
+   * Wagons share a result only if the settings the result depends on are identical
+   * (including the class of the task and the configuration of the AliEventCuts).
+   *
+   * Requirements:
+   * - The configuration of the task and of the containers is not changed after ExecOnce
+   * - Tasks overriding IsEventSelected, IsTriggerSelected or CheckMCOutliers do not
+   *   depend on the state of other wagons (results are only shared among tasks of the
+   *   same class)
+   * - The state of the AliEventCuts object (i.e. the cut flags) is not used by the task:
+   *   if the decision is taken from the cache the event cuts are not evaluated, and
+   *   their QA histograms are only filled by the wagon evaluating the event.
+   *
+   * A report of the cache hits and misses and the time spent in the event preparation
+   * per wagon is printed at the end of the processing.
+   *
+   * @param[in] doUse If true the shared event cache is used
+   */
+  void                        SetUseSharedEventCache(Bool_t doUse)                 { fUseSharedEventCache = doUse                       ; }
   
   /**
    * @brief Set pre-configured event cut object
@@ -902,6 +930,13 @@ class AliAnalysisTaskEmcal : public AliAnalysisTaskSE {
    */
   Bool_t                      UserNotify();
 
+  /**
+   * @brief Steps at the end of the processing
+   *
+   * Prints the report of the shared event cache, if it is used.
+   */
+  void                        FinishTaskOutput();
+
   /**
    * @brief  Steps to be executed when a few file is loaded into the
    * input handler
@@ -1139,6 +1174,66 @@ class AliAnalysisTaskEmcal : public AliAnalysisTaskSE {
    */
   Bool_t                      IsEventSelectedInternal();
 
+  /**
+   * @brief Event selection without the shared event cache
+   *
+   * Either the builtin event selection or trigger selection, MC outlier
+   * rejection and AliEventCuts.
+   * @return True if the event is selected, false if it is rejected
+   */
+  Bool_t                      EvaluateEventSelection();
+
+  /**
+   * @brief Reject an event in the builtin event selection
+   *
+   * Records the rejection reason and fills the histogram
+   * monitoring the rejection reasons.
+   * @param[in] reason Reason of the rejection (bin label)
+   * @return Always false
+   */
+  Bool_t                      RejectEvent(const char *reason);
+
+  /**
+   * @brief Register the task and its keys in the shared event cache
+   *
+   * Called at the end of ExecOnce if the shared event cache is enabled.
+   */
+  void                        InitEventCache();
+
+  /**
+   * @brief Fingerprint of the configuration of the event selection
+   *
+   * Contains all settings the decision of IsEventSelected depends on
+   * in the implementation of this class.
+   * @return Fingerprint
+   */
+  std::string                 GetEventSelectionFingerprint();
+
+  /**
+   * @brief Fingerprint of the persistent configuration of an object
+   *
+   * The object is streamed into a buffer, transient members
+   * are not part of the fingerprint.
+   * @param[in] obj Object to be streamed
+   * @return Class name and streamed content of the object
+   */
+  static std::string          GetObjectFingerprint(TObject *obj);
+
+  /**
+   * @brief Get a value from the shared event cache
+   * @param[in] key Key of the value (-1: cache not used)
+   * @param[out] value Value, unchanged if not found
+   * @return True if the value is cached for the current event
+   */
+  Bool_t                      FindCachedValue(Int_t key, Double_t &value) const;
+
+  /**
+   * @brief Store a value in the shared event cache
+   * @param[in] key Key of the value (-1: cache not used)
+   * @param[in] value Value
+   */
+  void                        StoreCachedValue(Int_t key, Double_t value) const;
+
   /**
    * @brief Calculates the fraction of momentum z of part 1 w.r.t. part 2 in the direction of part 2.
    * @param[in] part1 Momentum vector for which the relative fraction is calculated
@@ -1213,6 +1308,7 @@ class AliAnalysisTaskEmcal : public AliAnalysisTaskSE {
   Float_t                     fPtHardAndJetPtFactor;       ///< Factor between ptHard and jet pT to reject/accept event.
   Float_t                     fPtHardAndClusterPtFactor;   ///< Factor between ptHard and cluster pT to reject/accept event.
   Float_t                     fPtHardAndTrackPtFactor;     ///< Factor between ptHard and track pT to reject/accept event.
+  Bool_t                      fUseSharedEventCache;        ///< Share event selection, centrality and accepted entries with other wagons
 
   // Service fields
   Int_t                       fRunNumber;                  //!<!run number (triggering RunChanged())
@@ -1246,6 +1342,11 @@ class AliAnalysisTaskEmcal : public AliAnalysisTaskSE {
   Int_t                       fNTrials;                    //!<!event trials
   Float_t                     fXsection;                   //!<!x-section from pythia header
   AliEmcalPythiaInfo         *fPythiaInfo;                 //!<!event parton info
+  const char                 *fEventRejectionReason;       //!<!reason of the rejection in the builtin event selection
+  Int_t                       fEventCacheClient;           //!<!client ID in the shared event cache (-1: cache not used)
+  Int_t                       fEventSelectionKey;          //!<!key of the event selection in the shared event cache (-1: not shared)
+  Int_t                       fCentralityKey;              //!<!key of the centrality in the shared event cache
+  Int_t                       fEventPlaneKeys[3];          //!<!keys of the event plane (V0, V0A, V0C) in the shared event cache
 
   // Output
   AliEmcalList               *fOutput;                     //!<!output list
@@ -1272,7 +1373,7 @@ class AliAnalysisTaskEmcal : public AliAnalysisTaskSE {
   AliAnalysisTaskEmcal &operator=(const AliAnalysisTaskEmcal&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisTaskEmcal, 20) // EMCAL base analysis task
+  ClassDef(AliAnalysisTaskEmcal, 21) // EMCAL base analysis task
   /// \endcond
 };
 
@@ -29,6 +29,7 @@
 #include <TGrid.h>
 #include <TGridResult.h>
 #include <TSystem.h>
+#include <TEnv.h>
 #include <TUUID.h>
 #include <TKey.h>
 #include <TProfile.h>
@@ -169,7 +170,10 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper() :
   fPythiaCrossSectionFromFile(0.),
   fPythiaPtHard(0.),
   fPrintTimingInfoToLog(false),
-  fTimer()
+  fTimer(),
+  fInputCacheSize(0),
+  fInputBranches(),
+  fAsyncPrefetching(false)
 {
   if (fgInstance != nullptr) {
     AliError("An instance of AliAnalysisTaskEmcalEmbeddingHelper already exists: it will be deleted!!!");
@@ -243,7 +247,10 @@ AliAnalysisTaskEmcalEmbeddingHelper::AliAnalysisTaskEmcalEmbeddingHelper(const c
   fPythiaCrossSectionFromFile(0.),
   fPythiaPtHard(0.),
   fPrintTimingInfoToLog(false),
-  fTimer()
+  fTimer(),
+  fInputCacheSize(0),
+  fInputBranches(),
+  fAsyncPrefetching(false)
 {
   if (fgInstance != 0) {
     AliError("An instance of AliAnalysisTaskEmcalEmbeddingHelper already exists: it will be deleted!!!");
@@ -328,6 +335,12 @@ void AliAnalysisTaskEmcalEmbeddingHelper::RetrieveTaskPropertiesFromYAMLConfig()
   res = fYAMLConfig.GetProperty("randomFileAccess", fRandomFileAccess, false);
   res = fYAMLConfig.GetProperty("createHisto", fCreateHisto, false);
   res = fYAMLConfig.GetProperty("printTimingInfoInLog", fPrintTimingInfoToLog, false);
+  // Reading of the embedded input
+  // NOTE: The base name is needed for the property path to not be ambiguous (see below)
+  std::string inputReadingName = "inputReading";
+  res = fYAMLConfig.GetProperty({inputReadingName, "cacheSize"}, fInputCacheSize, false);
+  res = fYAMLConfig.GetProperty({inputReadingName, "branches"}, fInputBranches, false);
+  res = fYAMLConfig.GetProperty({inputReadingName, "asyncPrefetching"}, fAsyncPrefetching, false);
   // More general embedding helper properties
   res = fYAMLConfig.GetProperty("filePattern", fFilePattern, false);
   res = fYAMLConfig.GetProperty("inputFilename", fInputFilename, false);
@@ -827,6 +840,8 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::GetNextEntry()
     if (fCurrentEntry == fUpperEntry) {
       fCurrentEntry = fLowerEntry;
       fWrappedAroundTree = true;
+      // The remaining entries of this file are the ones before the entry point
+      SetInputCacheEntryRange(fLowerEntry, fLowerEntry + fOffset - 1);
     }
 
     if ((fCurrentEntry < fLowerEntry + fOffset) || !fWrappedAroundTree) {
@@ -1267,6 +1282,16 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::SetupInputFiles()
   // Determine which file to start with
   DetermineFirstFileToEmbed();
 
+  // Asynchronous prefetching must be enabled before the files are opened
+  if (fAsyncPrefetching) {
+    if (fInputCacheSize > 0) {
+      gEnv->SetValue("TFile.AsyncPrefetching", 1);
+    }
+    else {
+      AliWarning("Asynchronous prefetching requires the input cache. Enable it with SetInputCacheSize()!");
+    }
+  }
+
   // Setup TChain
   fChain = new TChain(fTreeName);
 
@@ -1327,9 +1352,63 @@ Bool_t AliAnalysisTaskEmcalEmbeddingHelper::SetupInputFiles()
   Bool_t res = InitEvent();
   if (!res) return kFALSE;
 
+  SetupInputCache();
+
   return kTRUE;
 }
 
+/**
+ * Restrict reading to the requested branches and setup the TTreeCache for the embedded input.
+ * Must be called after the input event was connected to the TChain, as connecting the event
+ * sets the branch addresses.
+ */
+void AliAnalysisTaskEmcalEmbeddingHelper::SetupInputCache()
+{
+  if (fInputBranches.size() > 0) {
+    AliInfoStream() << "Reading only " << fInputBranches.size() << " branches of the embedded input.\n";
+    fChain->SetBranchStatus("*", 0);
+    for (auto branch : fInputBranches) {
+      fChain->SetBranchStatus(branch.c_str(), 1);
+    }
+  }
+
+  if (fInputCacheSize <= 0) {
+    return;
+  }
+
+  AliInfoStream() << "Enabling input cache with " << fInputCacheSize << " bytes.\n";
+  // The cache is attached to the current file, so the first tree must be loaded. The TChain
+  // moves the cache (including the branch list) to each following file.
+  fChain->LoadTree(0);
+  fChain->SetCacheSize(fInputCacheSize);
+  // The branches are known, so no learning phase is needed
+  if (fInputBranches.size() > 0) {
+    for (auto branch : fInputBranches) {
+      fChain->AddBranchToCache(branch.c_str(), kTRUE);
+    }
+  }
+  else {
+    fChain->AddBranchToCache("*", kTRUE);
+  }
+  fChain->StopCacheLearningPhase();
+}
+
+/**
+ * Restrict the input cache to the entries which are going to be read next, such that entries
+ * which are not embedded (i.e. before the random entry point) are not read into the cache.
+ *
+ * @param[in] first First entry (in the TChain) to be cached
+ * @param[in] last Last entry (in the TChain) to be cached
+ */
+void AliAnalysisTaskEmcalEmbeddingHelper::SetInputCacheEntryRange(Long64_t first, Long64_t last)
+{
+  if (fInputCacheSize <= 0 || last < first) {
+    return;
+  }
+  AliDebugStream(3) << "Caching entries " << first << "-" << last << " of the embedded input.\n";
+  fChain->SetCacheEntryRange(first, last);
+}
+
 /**
  * Check if the file pythia base filename can be found in the folder or archive corresponding where
  * the external event input file is found.
@@ -1460,6 +1539,7 @@ void AliAnalysisTaskEmcalEmbeddingHelper::InitTree()
 
   // Sets which entry to start if the try
   fCurrentEntry = fLowerEntry + fOffset;
+  SetInputCacheEntryRange(TMath::Max(fCurrentEntry, fLowerEntry), fUpperEntry - 1);
 
   // Keep track of the number of files that we have gone through
   // To start from 0, we only increment if fLowerEntry > 0
@@ -1889,6 +1969,18 @@ std::string AliAnalysisTaskEmcalEmbeddingHelper::toString(bool includeFileList)
   tempSS << "File list filename: \"" << fFileListFilename << "\"\n";
   tempSS << "Tree name: " << fTreeName << "\n";
   tempSS << "Print timing info to log: " << fPrintTimingInfoToLog << "\n";
+  tempSS << "Input cache size (bytes): " << fInputCacheSize << "\n";
+  tempSS << "Input branches: ";
+  if (fInputBranches.size() > 0) {
+    for (auto branch : fInputBranches) {
+      tempSS << "\"" << branch << "\" ";
+    }
+    tempSS << "\n";
+  }
+  else {
+    tempSS << "all\n";
+  }
+  tempSS << "Asynchronous prefetching: " << fAsyncPrefetching << "\n";
   tempSS << "Random event number access: " << fRandomEventNumberAccess << "\n";
   tempSS << "Random file access: " << fRandomFileAccess << "\n";
   tempSS << "Starting file index: " << fFilenameIndex << "\n";
@@ -152,6 +152,41 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   void SetConfigurationPath(const char * path)                    { fConfigurationPath = path; }
   /* @} */
 
+  /**
+   * @{
+   * @name Reading of the embedded input
+   * @brief Reduce the time spent waiting for the input. None of these options change which events are embedded.
+   */
+  Long64_t GetInputCacheSize()                              const { return fInputCacheSize; }
+  const std::vector<std::string> & GetInputBranches()       const { return fInputBranches; }
+  bool GetAsyncPrefetching()                                const { return fAsyncPrefetching; }
+
+  /**
+   * Enable a TTreeCache for the embedded input. Only the entries which will be embedded from the
+   * current file (starting from the random entry point if enabled) are read into the cache, in
+   * large vectored reads instead of one read per basket.
+   *
+   * @param[in] size Size of the cache in bytes, which determines how many of the upcoming entries are read ahead. 0 disables the cache.
+   */
+  void SetInputCacheSize(Long64_t size)                           { fInputCacheSize = size; }
+  /**
+   * Restrict reading of the embedded input to the given branches. All other branches are disabled and
+   * neither read nor cached. The list must contain all branches accessed by the embedding containers,
+   * including the header and MC header needed for the event selection (e.g. "header", "mcHeader",
+   * "tracks*", "mcparticles*"). Wildcards are allowed. If empty, all branches are read.
+   *
+   * @param[in] branches Names of the branches to read
+   */
+  void SetInputBranches(const std::vector<std::string> & branches) { fInputBranches = branches; }
+  /**
+   * Prefetch the blocks of the input cache in a background thread (TFile.AsyncPrefetching). Note that this
+   * is a global ROOT setting, which also affects all files opened later on. Requires SetInputCacheSize().
+   *
+   * @param[in] b If true, enable asynchronous prefetching
+   */
+  void SetAsyncPrefetching(bool b = true)                         { fAsyncPrefetching = b; }
+  /* @} */
+
   /**
    * @{
    * @name Internal event selection
@@ -300,6 +335,8 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   Bool_t          InitEvent()           ;
   void            InitTree()            ;
   bool            PythiaInfoFromCrossSectionFile(std::string filename);
+  void            SetupInputCache()     ;
+  void            SetInputCacheEntryRange(Long64_t first, Long64_t last);
   // Validation helper
   void            ValidatePhysicsSelectionForInternalEventSelection();
   // Helper functions
@@ -375,6 +412,10 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   bool                                          fPrintTimingInfoToLog; ///< Flag to print time to execute InitTree(), for logging purposes
   TStopwatch                                    fTimer            ;    //!<! Timer for the InitTree() function
 
+  Long64_t                                      fInputCacheSize   ; ///<  Size of the TTreeCache for the embedded input (bytes). 0 disables the cache
+  std::vector <std::string>                     fInputBranches    ; ///<  Branches of the embedded input to be read. All branches are read if empty
+  bool                                          fAsyncPrefetching ; ///<  If true, blocks of the input cache are prefetched by a background thread
+
   static AliAnalysisTaskEmcalEmbeddingHelper   *fgInstance        ; //!<! Global instance of this class
 
  private:
@@ -382,7 +423,7 @@ class AliAnalysisTaskEmcalEmbeddingHelper : public AliAnalysisTaskSE {
   AliAnalysisTaskEmcalEmbeddingHelper &operator=(const AliAnalysisTaskEmcalEmbeddingHelper&); // not implemented
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisTaskEmcalEmbeddingHelper, 12);
+  ClassDef(AliAnalysisTaskEmcalEmbeddingHelper, 13);
   /// \endcond
 };
 #endif
@@ -32,6 +32,7 @@
 #include "AliTLorentzVector.h"
 
 #include "AliEmcalContainerUtils.h"
+#include "AliEmcalEventCache.h"
 
 #include "AliEmcalContainer.h"
 
@@ -60,6 +61,9 @@ AliEmcalContainer::AliEmcalContainer():
   fCurrentID(0),
   fLabelMap(0),
   fLoadedClass(0),
+  fSharedAcceptanceKey(-1),
+  fEventCacheClient(-1),
+  fLocalAcceptIndices(),
   fClassName()
 {
   fVertex[0] = 0;
@@ -90,6 +94,9 @@ AliEmcalContainer::AliEmcalContainer(const char *name):
   fCurrentID(0),
   fLabelMap(0),
   fLoadedClass(0),
+  fSharedAcceptanceKey(-1),
+  fEventCacheClient(-1),
+  fLocalAcceptIndices(),
   fClassName()
 {
   fVertex[0] = 0;
@@ -176,6 +183,27 @@ Int_t AliEmcalContainer::GetNAcceptEntries() const{
   return result;
 }
 
+const std::vector<Int_t> &AliEmcalContainer::GetAcceptIndices() const {
+  std::vector<Int_t> *indices = &fLocalAcceptIndices;
+  if(fSharedAcceptanceKey >= 0){
+    PWG::EMCAL::AliEmcalEventCache *cache = PWG::EMCAL::AliEmcalEventCache::Instance();
+    const std::vector<Int_t> *cached = cache->FindAcceptIndices(fSharedAcceptanceKey);
+    if(cached){
+      if(fEventCacheClient >= 0) cache->AddHit(fEventCacheClient, PWG::EMCAL::AliEmcalEventCache::kAcceptance);
+      return *cached;
+    }
+    if(fEventCacheClient >= 0) cache->AddMiss(fEventCacheClient, PWG::EMCAL::AliEmcalEventCache::kAcceptance);
+    indices = &cache->SetAcceptIndices(fSharedAcceptanceKey);
+  }
+
+  indices->clear();
+  for(int index = 0; index < GetNEntries(); index++){
+    UInt_t rejectionReason = 0;
+    if(AcceptObject(index, rejectionReason)) indices->push_back(index);
+  }
+  return *indices;
+}
+
 Int_t AliEmcalContainer::GetIndexFromLabel(Int_t lab) const
 { 
   if (fLabelMap) {
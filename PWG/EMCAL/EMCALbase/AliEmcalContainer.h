@@ -37,6 +37,7 @@ class AliVEvent;
 class AliNamedArrayI;
 class AliVParticle;
 
+#include <vector>
 #include <TNamed.h>
 #include <TClonesArray.h>
 
@@ -229,6 +230,29 @@ class AliEmcalContainer : public TObject {
    */
   Int_t                       GetNAcceptEntries() const;
 
+  /**
+   * @brief Get the indices of the accepted entries in the container
+   *
+   * If a key of the shared event cache is set (SetSharedAcceptanceKey) the indices
+   * are taken from the cache when another container with the same key already
+   * determined them for the current event. Otherwise all objects are checked with
+   * AcceptObject.
+   * @return Indices of the accepted entries, valid until the next call
+   */
+  const std::vector<Int_t>   &GetAcceptIndices() const;
+
+  /**
+   * @brief Share the accepted entries among containers via the event cache
+   *
+   * Containers with the same key (see PWG::EMCAL::AliEmcalEventCache) must select the
+   * same objects; the accepted entries are determined once per event. The cuts must
+   * not be changed while the key is set.
+   * @param[in] key Key in the event cache (-1 to disable sharing)
+   * @param[in] client Client ID in the event cache for the statistics (-1: no statistics)
+   */
+  void                        SetSharedAcceptanceKey(Int_t key, Int_t client = -1) { fSharedAcceptanceKey = key; fEventCacheClient = client; }
+  Int_t                       GetSharedAcceptanceKey() const        { return fSharedAcceptanceKey       ; }
+
   /**
    * @brief Reset the iterator to a given index
    * 
@@ -394,6 +418,9 @@ class AliEmcalContainer : public TObject {
   AliNamedArrayI             *fLabelMap;                //!<! Label-Index map
   Double_t                    fVertex[3];               //!<! event vertex array
   TClass                     *fLoadedClass;             //!<! Class of the objects contained in the TClonesArray
+  Int_t                       fSharedAcceptanceKey;     //!<! Key of the accepted entries in the shared event cache (-1: not shared)
+  Int_t                       fEventCacheClient;        //!<! Client ID in the shared event cache
+  mutable std::vector<Int_t>  fLocalAcceptIndices;     //!<! Accepted entries (if not shared)
 
  private:
   TString                     fClassName;               ///< name of the class in the TClonesArray
@@ -401,6 +428,6 @@ class AliEmcalContainer : public TObject {
   AliEmcalContainer(const AliEmcalContainer& obj); // copy constructor
   AliEmcalContainer& operator=(const AliEmcalContainer& other); // assignment
 
-  ClassDef(AliEmcalContainer,9);
+  ClassDef(AliEmcalContainer,10);
 };
 #endif
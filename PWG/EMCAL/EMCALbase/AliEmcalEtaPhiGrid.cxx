@@ -0,0 +1,214 @@
+/************************************************************************************
+ * Copyright (C) 2019, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <algorithm>
+#include <TMath.h>
+#include <TRandom3.h>
+#include <TVector2.h>
+#include "AliEmcalEtaPhiGrid.h"
+
+/// \cond CLASSIMP
+ClassImp(PWG::EMCAL::AliEmcalEtaPhiGrid)
+ClassImp(PWG::EMCAL::TestAliEmcalEtaPhiGrid)
+/// \endcond
+
+using namespace PWG::EMCAL;
+
+AliEmcalEtaPhiGrid::AliEmcalEtaPhiGrid():
+  fNObjects(0),
+  fNCellsEta(1),
+  fNCellsPhi(1),
+  fEtaMin(0.),
+  fCellSizeEta(0.),
+  fCellSizePhi(0.),
+  fCellStart(),
+  fCellObjects(),
+  fObjectCell()
+{
+}
+
+void AliEmcalEtaPhiGrid::Clear() {
+  fNObjects = 0;
+  fNCellsEta = 1;
+  fNCellsPhi = 1;
+  fEtaMin = 0.;
+  fCellSizeEta = 0.;
+  fCellSizePhi = 0.;
+  fCellStart.assign(2, 0);
+  fCellObjects.clear();
+  fObjectCell.clear();
+}
+
+void AliEmcalEtaPhiGrid::Build(Int_t nobjects, const Double_t *eta, const Double_t *phi, Double_t maxDistance) {
+  Clear();
+  fNObjects = nobjects;
+  if(nobjects <= 0) return;
+
+  // The cells are chosen slightly larger than the maximum distance, so that objects
+  // within the maximum distance are never more than one cell apart due to rounding.
+  // The number of cells in eta is limited for the case of objects far outside the
+  // acceptance (i.e. at default positions).
+  const Int_t kMaxCellsEta = 1000;
+  const Double_t cellsize = maxDistance * (1. + 1e-6);
+  if(maxDistance > 0. && cellsize < TMath::Pi()) {
+    Double_t etamin = eta[0], etamax = eta[0];
+    for(Int_t iobj = 1; iobj < nobjects; iobj++) {
+      if(eta[iobj] < etamin) etamin = eta[iobj];
+      if(eta[iobj] > etamax) etamax = eta[iobj];
+    }
+    if(TMath::Finite(etamin) && TMath::Finite(etamax)) {
+      fEtaMin = etamin;
+      fCellSizeEta = std::max(cellsize, (etamax - etamin) / kMaxCellsEta);
+      fNCellsEta = static_cast<Int_t>((etamax - etamin) / fCellSizeEta) + 1;
+      fNCellsPhi = static_cast<Int_t>(TMath::TwoPi() / cellsize);
+      fCellSizePhi = TMath::TwoPi() / fNCellsPhi;
+    }
+  }
+
+  // Counting sort of the objects into the cells: objects stay in ascending order within a cell
+  const Int_t ncells = fNCellsEta * fNCellsPhi;
+  fCellStart.assign(ncells + 1, 0);
+  fObjectCell.resize(nobjects);
+  for(Int_t iobj = 0; iobj < nobjects; iobj++) {
+    Int_t icelleta = GetCellEta(eta[iobj]), icellphi = GetCellPhi(phi[iobj]);
+    if(icelleta < 0) icelleta = 0;
+    if(icelleta >= fNCellsEta) icelleta = fNCellsEta - 1;
+    fObjectCell[iobj] = icelleta * fNCellsPhi + icellphi;
+    fCellStart[fObjectCell[iobj] + 1]++;
+  }
+  for(Int_t icell = 0; icell < ncells; icell++) fCellStart[icell + 1] += fCellStart[icell];
+  fCellObjects.resize(nobjects);
+  std::vector<Int_t> fillpos(fCellStart.begin(), fCellStart.end() - 1);
+  for(Int_t iobj = 0; iobj < nobjects; iobj++) fCellObjects[fillpos[fObjectCell[iobj]]++] = iobj;
+}
+
+void AliEmcalEtaPhiGrid::FindCandidates(Double_t eta, Double_t phi, std::vector<Int_t> &candidates) const {
+  candidates.clear();
+  if(!fNObjects) return;
+
+  if(fNCellsEta * fNCellsPhi == 1) {
+    // single cell: all objects are candidates
+    candidates.assign(fCellObjects.begin(), fCellObjects.end());
+    return;
+  }
+
+  // All objects are inside the grid, points more than one cell away in eta have no candidates
+  Int_t icelleta = GetCellEta(eta), icellphi = GetCellPhi(phi);
+  if(icelleta < -1 || icelleta > fNCellsEta) return;
+  Int_t etafirst = std::max(icelleta - 1, 0), etalast = std::min(icelleta + 1, fNCellsEta - 1);
+
+  // Neighbouring cells in phi (periodic), each cell only once for less than 3 cells
+  Int_t phicells[3], nphicells = 0;
+  for(Int_t dphi = -1; dphi <= 1; dphi++) {
+    Int_t iphi = (icellphi + dphi + fNCellsPhi) % fNCellsPhi;
+    if(std::find(phicells, phicells + nphicells, iphi) == phicells + nphicells) phicells[nphicells++] = iphi;
+  }
+
+  for(Int_t ieta = etafirst; ieta <= etalast; ieta++) {
+    for(Int_t iphi = 0; iphi < nphicells; iphi++) {
+      Int_t icell = ieta * fNCellsPhi + phicells[iphi];
+      candidates.insert(candidates.end(), fCellObjects.begin() + fCellStart[icell], fCellObjects.begin() + fCellStart[icell + 1]);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+}
+
+Int_t AliEmcalEtaPhiGrid::GetCellEta(Double_t eta) const {
+  if(fNCellsEta == 1) return 0;
+  Double_t icell = TMath::Floor((eta - fEtaMin) / fCellSizeEta);
+  // avoid integer overflow for points far away from the grid
+  if(!(icell > -2.)) return -2;
+  if(!(icell < fNCellsEta + 1)) return fNCellsEta + 1;
+  return static_cast<Int_t>(icell);
+}
+
+Int_t AliEmcalEtaPhiGrid::GetCellPhi(Double_t phi) const {
+  if(fNCellsPhi == 1) return 0;
+  Double_t phinorm = TVector2::Phi_0_2pi(phi);
+  Int_t icell = static_cast<Int_t>(phinorm / fCellSizePhi);
+  if(icell < 0) icell = 0;
+  if(icell >= fNCellsPhi) icell = fNCellsPhi - 1;
+  return icell;
+}
+
+bool TestAliEmcalEtaPhiGrid::RunAllTests() const {
+  return TestRandomPositions() && TestPhiPeriodicity();
+}
+
+bool TestAliEmcalEtaPhiGrid::TestRandomPositions() const {
+  TRandom3 rnd(1234);
+  const Double_t distances[] = {0.01, 0.025, 0.1, 0.5, 4.};
+  bool testresult(true);
+  for(auto maxdist : distances) {
+    std::vector<Double_t> eta(1000), phi(1000), testeta(2000), testphi(2000);
+    for(UInt_t iobj = 0; iobj < eta.size(); iobj++) {
+      eta[iobj] = rnd.Uniform(-0.7, 0.7);
+      phi[iobj] = rnd.Uniform(1.4, 5.7);
+    }
+    for(UInt_t ipoint = 0; ipoint < testeta.size(); ipoint++) {
+      // half of the points close to an object
+      if(ipoint % 2) {
+        Int_t iobj = rnd.Integer(eta.size());
+        testeta[ipoint] = eta[iobj] + rnd.Gaus(0., maxdist);
+        testphi[ipoint] = phi[iobj] + rnd.Gaus(0., maxdist);
+      } else {
+        testeta[ipoint] = rnd.Uniform(-1., 1.);
+        testphi[ipoint] = rnd.Uniform(-TMath::Pi(), TMath::TwoPi());
+      }
+    }
+    if(!CompareToLoop(eta, phi, testeta, testphi, maxdist)) testresult = false;
+  }
+  return testresult;
+}
+
+bool TestAliEmcalEtaPhiGrid::TestPhiPeriodicity() const {
+  std::vector<Double_t> eta = {0., 0., 0.}, phi = {0.01, TMath::TwoPi() - 0.01, TMath::Pi()},
+                        testeta = {0., 0., 0.}, testphi = {-0.005, 0.005, TMath::TwoPi() - 0.001};
+  return CompareToLoop(eta, phi, testeta, testphi, 0.1);
+}
+
+bool TestAliEmcalEtaPhiGrid::CompareToLoop(const std::vector<Double_t> &eta, const std::vector<Double_t> &phi, const std::vector<Double_t> &testeta, const std::vector<Double_t> &testphi, Double_t maxDistance) const {
+  AliEmcalEtaPhiGrid grid;
+  grid.Build(eta.size(), eta.data(), phi.data(), maxDistance);
+  const Double_t maxd2 = maxDistance * maxDistance;
+  std::vector<Int_t> candidates, matchedgrid, matchedloop;
+  int failure(0);
+  for(UInt_t ipoint = 0; ipoint < testeta.size(); ipoint++) {
+    matchedloop.clear();
+    for(UInt_t iobj = 0; iobj < eta.size(); iobj++) {
+      Double_t deta = testeta[ipoint] - eta[iobj], dphi = TVector2::Phi_mpi_pi(testphi[ipoint] - phi[iobj]);
+      if(deta * deta + dphi * dphi <= maxd2) matchedloop.push_back(iobj);
+    }
+    matchedgrid.clear();
+    grid.FindCandidates(testeta[ipoint], testphi[ipoint], candidates);
+    for(auto iobj : candidates) {
+      Double_t deta = testeta[ipoint] - eta[iobj], dphi = TVector2::Phi_mpi_pi(testphi[ipoint] - phi[iobj]);
+      if(deta * deta + dphi * dphi <= maxd2) matchedgrid.push_back(iobj);
+    }
+    if(matchedgrid != matchedloop) failure++;
+  }
+  return failure == 0;
+}
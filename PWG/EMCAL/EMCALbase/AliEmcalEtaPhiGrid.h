@@ -0,0 +1,186 @@
+/************************************************************************************
+ * Copyright (C) 2019, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALETAPHIGRID_H
+#define ALIEMCALETAPHIGRID_H
+
+#include <TObject.h>
+#include <vector>
+
+namespace PWG {
+
+namespace EMCAL {
+
+/**
+ * @class AliEmcalEtaPhiGrid
+ * @brief Spatial index of objects in (\f$\eta\f$, \f$\phi\f$) for geometrical matching
+ * @ingroup EMCALCOREFW
+ * @since Oct 16, 2019
+ *
+ * Objects (i.e. clusters) are sorted into cells in \f$\eta\f$ and \f$\phi\f$
+ * with a cell size of at least the maximum matching distance. All objects within
+ * the maximum distance of a given point (i.e. a track position on the EMCAL surface)
+ * are then located in the cell of the point or in one of the neighbouring cells,
+ * and only these need to be tested, instead of all objects in the event. The
+ * \f$\phi\f$ direction is periodic.
+ *
+ * The grid only preselects candidates: the distance itself must be
+ * checked by the user, with the same definition as without the grid. The candidates
+ * are returned in ascending order of the object index, so that the order in which the
+ * matches are found is the same as in a loop over all objects.
+ *
+ * ~~~{.cxx}
+ * PWG::EMCAL::AliEmcalEtaPhiGrid grid;
+ * grid.Build(nclusters, clusterEta, clusterPhi, maxDistance);   // once per event
+ * std::vector<Int_t> candidates;
+ * for(track : tracks) {
+ *   grid.FindCandidates(track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), candidates);
+ *   for(auto icluster : candidates) {
+ *     // check distance between track and cluster icluster
+ *   }
+ * }
+ * ~~~
+ */
+class AliEmcalEtaPhiGrid {
+public:
+  /**
+   * @brief Constructor
+   */
+  AliEmcalEtaPhiGrid();
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~AliEmcalEtaPhiGrid() {}
+
+  /**
+   * @brief Build the grid for a set of objects
+   *
+   * Object i is located at (eta[i], phi[i]). The cell size is chosen such
+   * that all objects within maxDistance of a point are in the neighbouring
+   * cells. For maxDistance <= 0 all objects are stored in the same cell.
+   *
+   * @param[in] nobjects Number of objects
+   * @param[in] eta \f$\eta\f$ of the objects
+   * @param[in] phi \f$\phi\f$ of the objects (any range, periodic)
+   * @param[in] maxDistance Maximum distance in (\f$\eta\f$, \f$\phi\f$) of the matching
+   */
+  void Build(Int_t nobjects, const Double_t *eta, const Double_t *phi, Double_t maxDistance);
+
+  /**
+   * @brief Find objects which can be within the maximum distance of a point
+   * @param[in] eta \f$\eta\f$ of the point
+   * @param[in] phi \f$\phi\f$ of the point
+   * @param[out] candidates Indices of the candidate objects, in ascending order
+   */
+  void FindCandidates(Double_t eta, Double_t phi, std::vector<Int_t> &candidates) const;
+
+  /**
+   * @brief Remove all objects from the grid
+   */
+  void Clear();
+
+  Int_t GetNumberOfObjects() const { return fNObjects; }
+  Int_t GetNumberOfCellsEta() const { return fNCellsEta; }
+  Int_t GetNumberOfCellsPhi() const { return fNCellsPhi; }
+
+protected:
+  Int_t GetCellEta(Double_t eta) const;
+  Int_t GetCellPhi(Double_t phi) const;
+
+  Int_t                     fNObjects;            ///< Number of objects in the grid
+  Int_t                     fNCellsEta;           ///< Number of cells in \f$\eta\f$
+  Int_t                     fNCellsPhi;           ///< Number of cells in \f$\phi\f$
+  Double_t                  fEtaMin;              ///< Lower edge of the grid in \f$\eta\f$
+  Double_t                  fCellSizeEta;         ///< Cell size in \f$\eta\f$
+  Double_t                  fCellSizePhi;         ///< Cell size in \f$\phi\f$
+  std::vector<Int_t>        fCellStart;           ///< Index of the first object of each cell in fCellObjects (plus end marker)
+  std::vector<Int_t>        fCellObjects;         ///< Object indices sorted by cell, ascending within each cell
+  std::vector<Int_t>        fObjectCell;          ///< Cell of each object (temporary while building)
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalEtaPhiGrid, 1);
+  /// \endcond
+};
+
+/**
+ * @class TestAliEmcalEtaPhiGrid
+ * @brief Unit test for class AliEmcalEtaPhiGrid
+ * @ingroup EMCALCOREFW
+ * @since Oct 16, 2019
+ *
+ * Unit test for AliEmcalEtaPhiGrid, covering
+ * - Candidates contain all objects within the maximum distance (compared to a loop over all objects)
+ * - Periodicity in \f$\phi\f$
+ */
+class TestAliEmcalEtaPhiGrid : public TObject {
+public:
+  /**
+   * @brief Constructor
+   */
+  TestAliEmcalEtaPhiGrid() {}
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~TestAliEmcalEtaPhiGrid() {}
+
+  /**
+   * @brief Run test suite
+   * @return true All tests passed
+   * @return false At least one test failed
+   */
+  bool RunAllTests() const;
+
+  /**
+   * @brief Test that the objects within the maximum distance found with the grid are
+   * the same (and in the same order) as the ones found with a loop over all objects,
+   * for random positions and several maximum distances
+   * @return true Test passed
+   * @return false Test failed
+   */
+  bool TestRandomPositions() const;
+
+  /**
+   * @brief Test matching of objects across \f$\phi\f$ = 0
+   * @return true Test passed
+   * @return false Test failed
+   */
+  bool TestPhiPeriodicity() const;
+
+private:
+  bool CompareToLoop(const std::vector<Double_t> &eta, const std::vector<Double_t> &phi, const std::vector<Double_t> &testeta, const std::vector<Double_t> &testphi, Double_t maxDistance) const;
+
+  /// \cond CLASSIMP
+  ClassDef(TestAliEmcalEtaPhiGrid, 1);
+  /// \endcond
+};
+
+}
+
+}
+
+#endif /* ALIEMCALETAPHIGRID_H */
@@ -0,0 +1,149 @@
+/************************************************************************************
+ * Copyright (C) 2019, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <iomanip>
+#include <iostream>
+#include <TString.h>
+
+#include "AliVEvent.h"
+
+#include "AliEmcalEventCache.h"
+
+/// \cond CLASSIMP
+ClassImp(PWG::EMCAL::AliEmcalEventCache)
+/// \endcond
+
+using namespace PWG::EMCAL;
+
+AliEmcalEventCache *AliEmcalEventCache::fgEventCache = nullptr;
+
+AliEmcalEventCache::AliEmcalEventCache() :
+  TObject(),
+  fEvent(nullptr),
+  fEntry(-1),
+  fEventStamp(1),
+  fReportPrinted(kFALSE),
+  fFingerprints(),
+  fEntries(),
+  fClients()
+{
+}
+
+AliEmcalEventCache *AliEmcalEventCache::Instance(){
+  if(!fgEventCache) {
+    fgEventCache = new AliEmcalEventCache;
+  }
+  return fgEventCache;
+}
+
+Int_t AliEmcalEventCache::RegisterKey(const std::string &fingerprint){
+  for(std::size_t ikey = 0; ikey < fFingerprints.size(); ikey++) {
+    if(fFingerprints[ikey] == fingerprint) return ikey;
+  }
+  fFingerprints.push_back(fingerprint);
+  fEntries.push_back(Entry());
+  return fFingerprints.size() - 1;
+}
+
+Int_t AliEmcalEventCache::RegisterClient(const char *name){
+  fClients.push_back(Client());
+  fClients.back().fName = name;
+  return fClients.size() - 1;
+}
+
+void AliEmcalEventCache::NextEvent(const AliVEvent *event, Long64_t entry){
+  if(event == fEvent && entry == fEntry) return;
+  fEvent = event;
+  fEntry = entry;
+  fEventStamp++;
+}
+
+void AliEmcalEventCache::Invalidate(){
+  fEvent = nullptr;
+  fEntry = -1;
+  fEventStamp++;
+}
+
+Bool_t AliEmcalEventCache::FindSelection(Int_t key, Bool_t &accepted, const char *&reason) const {
+  const Entry &entry = fEntries[key];
+  if(entry.fEventSelection != fEventStamp) return kFALSE;
+  accepted = entry.fAccepted;
+  reason = entry.fReason;
+  return kTRUE;
+}
+
+void AliEmcalEventCache::SetSelection(Int_t key, Bool_t accepted, const char *reason){
+  Entry &entry = fEntries[key];
+  entry.fEventSelection = fEventStamp;
+  entry.fAccepted = accepted;
+  entry.fReason = reason;
+}
+
+Bool_t AliEmcalEventCache::FindValue(Int_t key, Double_t &value) const {
+  const Entry &entry = fEntries[key];
+  if(entry.fEventValue != fEventStamp) return kFALSE;
+  value = entry.fValue;
+  return kTRUE;
+}
+
+void AliEmcalEventCache::SetValue(Int_t key, Double_t value){
+  Entry &entry = fEntries[key];
+  entry.fEventValue = fEventStamp;
+  entry.fValue = value;
+}
+
+const std::vector<Int_t> *AliEmcalEventCache::FindAcceptIndices(Int_t key) const {
+  const Entry &entry = fEntries[key];
+  if(entry.fEventAccept != fEventStamp) return nullptr;
+  return &entry.fAcceptIndices;
+}
+
+std::vector<Int_t> &AliEmcalEventCache::SetAcceptIndices(Int_t key){
+  Entry &entry = fEntries[key];
+  entry.fEventAccept = fEventStamp;
+  entry.fAcceptIndices.clear();
+  return entry.fAcceptIndices;
+}
+
+void AliEmcalEventCache::Print(Option_t *) const {
+  const char *categories[kNCategories] = {"selection", "properties", "acceptance"};
+  std::cout << "Shared event cache: " << fFingerprints.size() << " keys, " << fClients.size() << " wagons" << std::endl;
+  std::cout << std::setw(40) << std::left << "Wagon";
+  for(int icat = 0; icat < kNCategories; icat++) std::cout << std::setw(22) << std::right << Form("%s hit/miss", categories[icat]);
+  std::cout << std::setw(14) << std::right << "CPU time (s)" << std::endl;
+  for(const auto &client : fClients) {
+    std::cout << std::setw(40) << std::left << client.fName;
+    for(int icat = 0; icat < kNCategories; icat++) std::cout << std::setw(22) << std::right << Form("%llu/%llu", client.fHits[icat], client.fMisses[icat]);
+    // TStopwatch::CpuTime is not const
+    std::cout << std::setw(14) << std::right << Form("%.3f", const_cast<TStopwatch &>(client.fTimer).CpuTime()) << std::endl;
+  }
+}
+
+void AliEmcalEventCache::PrintReportOnce(){
+  if(fReportPrinted) return;
+  fReportPrinted = kTRUE;
+  Print();
+}
@@ -0,0 +1,266 @@
+/************************************************************************************
+ * Copyright (C) 2019, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALEVENTCACHE_H
+#define ALIEMCALEVENTCACHE_H
+
+#include <string>
+#include <vector>
+#include <TObject.h>
+#include <TStopwatch.h>
+
+class AliVEvent;
+
+namespace PWG {
+
+namespace EMCAL {
+
+/**
+ * @class AliEmcalEventCache
+ * @brief Per-event cache of event properties and selections shared among wagons
+ * @ingroup EMCALCOREFW
+ * @since Oct 16, 2019
+ *
+ * Several wagons of a train often run the same event selection, read the same
+ * centrality estimator and loop over the accepted objects of containers with the
+ * same cuts. The cache stores these results for the current event, so that they
+ * are evaluated only by the first wagon and reused by the following ones. Like
+ * AliEmcalDownscaleFactorsOCDB the class is used as a singleton shared among the
+ * wagons.
+ *
+ * Results are identified by keys. A key is obtained once from RegisterKey for a
+ * fingerprint of the configuration the result depends on (e.g. the settings of the
+ * event selection): identical fingerprints give the same key, so only wagons with an
+ * identical configuration share the result. All results are invalidated when
+ * NextEvent is called with a different event, and with Invalidate when the input
+ * file changes.
+ *
+ * ~~~{.cxx}
+ * AliEmcalEventCache *cache = AliEmcalEventCache::Instance();
+ * Int_t key = cache->RegisterKey("centrality:V0M");     // once
+ * cache->NextEvent(event, entry);                       // every event
+ * Double_t cent = 0;
+ * if(!cache->FindValue(key, cent)) {
+ *   cent = ...;                                         // evaluate
+ *   cache->SetValue(key, cent);
+ * }
+ * ~~~
+ *
+ * For the timing report each wagon registers as client. The cache counts hits and
+ * misses per client and category, and accumulates the time the client spends in the
+ * cached parts of the event processing (StartTimer/StopTimer). The report is printed
+ * with Print().
+ */
+class AliEmcalEventCache : public TObject {
+public:
+  /**
+   * @enum Category_t
+   * @brief Categories of cached results in the statistics
+   */
+  enum Category_t {
+    kEventSelection = 0,      ///< Event selection decisions
+    kEventProperty = 1,       ///< Event properties (centrality, event plane)
+    kAcceptance = 2,          ///< Accepted objects of containers
+    kNCategories = 3          ///< Number of categories
+  };
+
+  /**
+   * Get instance of the event cache. If called for the
+   * first time a new object is created
+   * @return Event cache
+   */
+  static AliEmcalEventCache *Instance();
+
+  /**
+   * Destructor
+   */
+  virtual ~AliEmcalEventCache() {}
+
+  /**
+   * @brief Get the key for a configuration fingerprint
+   * @param[in] fingerprint Fingerprint of the configuration the cached result depends on
+   * @return Key (the same for identical fingerprints)
+   */
+  Int_t RegisterKey(const std::string &fingerprint);
+
+  /**
+   * @brief Register a wagon for the statistics
+   * @param[in] name Name of the wagon
+   * @return Client ID
+   */
+  Int_t RegisterClient(const char *name);
+
+  /**
+   * @brief Set the current event. Cached results are dropped if the event differs
+   * from the previous one.
+   * @param[in] event Input event
+   * @param[in] entry Entry of the event in the analysis manager
+   */
+  void NextEvent(const AliVEvent *event, Long64_t entry);
+
+  /**
+   * @brief Drop all cached results. To be called when the input file changes,
+   * since the entry passed to NextEvent is only unique within a file.
+   */
+  void Invalidate();
+
+  /**
+   * @brief Get a cached event selection decision
+   * @param[in] key Key of the selection
+   * @param[out] accepted Decision
+   * @param[out] reason Rejection reason stored with the decision (can be nullptr)
+   * @return True if the decision is cached for the current event
+   */
+  Bool_t FindSelection(Int_t key, Bool_t &accepted, const char *&reason) const;
+
+  /**
+   * @brief Store an event selection decision for the current event
+   * @param[in] key Key of the selection
+   * @param[in] accepted Decision
+   * @param[in] reason Rejection reason (string with static storage duration, or nullptr)
+   */
+  void SetSelection(Int_t key, Bool_t accepted, const char *reason);
+
+  /**
+   * @brief Get a cached value (i.e. centrality)
+   * @param[in] key Key of the value
+   * @param[out] value Value
+   * @return True if the value is cached for the current event
+   */
+  Bool_t FindValue(Int_t key, Double_t &value) const;
+
+  /**
+   * @brief Store a value for the current event
+   * @param[in] key Key of the value
+   * @param[in] value Value
+   */
+  void SetValue(Int_t key, Double_t value);
+
+  /**
+   * @brief Get cached indices of accepted objects of a container
+   * @param[in] key Key of the container configuration
+   * @return Indices of the accepted objects, nullptr if not cached for the current event
+   */
+  const std::vector<Int_t> *FindAcceptIndices(Int_t key) const;
+
+  /**
+   * @brief Store the indices of accepted objects of a container for the current event
+   * @param[in] key Key of the container configuration
+   * @return Vector to be filled with the indices
+   */
+  std::vector<Int_t> &SetAcceptIndices(Int_t key);
+
+  /**
+   * @brief Count a result of a category found in the cache
+   * @param[in] client Client ID
+   * @param[in] category Category of the result
+   */
+  void AddHit(Int_t client, Category_t category)  { fClients[client].fHits[category]++; }
+
+  /**
+   * @brief Count a result of a category evaluated by a client
+   * @param[in] client Client ID
+   * @param[in] category Category of the result
+   */
+  void AddMiss(Int_t client, Category_t category) { fClients[client].fMisses[category]++; }
+
+  /**
+   * @brief Start the timer of a client
+   * @param[in] client Client ID
+   */
+  void StartTimer(Int_t client)                   { fClients[client].fTimer.Start(kFALSE); }
+
+  /**
+   * @brief Stop the timer of a client
+   * @param[in] client Client ID
+   */
+  void StopTimer(Int_t client)                    { fClients[client].fTimer.Stop(); }
+
+  /**
+   * @brief Print the statistics of all clients
+   * @param[in] option Not used
+   */
+  virtual void Print(Option_t *option = "") const;
+
+  /**
+   * @brief Print the statistics once
+   *
+   * Meant to be called by every client at the end of the processing: only
+   * the first call prints the report.
+   */
+  void PrintReportOnce();
+
+private:
+  /**
+   * @struct Entry
+   * @brief Cached results for one key
+   */
+  struct Entry {
+    Entry() : fEventSelection(0), fEventValue(0), fEventAccept(0), fAccepted(kFALSE), fReason(nullptr), fValue(0.), fAcceptIndices() {}
+    ULong64_t                 fEventSelection;    ///< Event stamp of the selection decision
+    ULong64_t                 fEventValue;        ///< Event stamp of the value
+    ULong64_t                 fEventAccept;       ///< Event stamp of the accepted indices
+    Bool_t                    fAccepted;          ///< Selection decision
+    const char               *fReason;            ///< Rejection reason
+    Double_t                  fValue;             ///< Value
+    std::vector<Int_t>        fAcceptIndices;     ///< Indices of accepted objects
+  };
+
+  /**
+   * @struct Client
+   * @brief Statistics of one wagon
+   */
+  struct Client {
+    Client() : fName(), fTimer() { for(int i = 0; i < kNCategories; i++) { fHits[i] = 0; fMisses[i] = 0; } fTimer.Reset(); }
+    std::string               fName;                    ///< Name of the wagon
+    ULong64_t                 fHits[kNCategories];      ///< Results taken from the cache
+    ULong64_t                 fMisses[kNCategories];    ///< Results evaluated by the wagon
+    TStopwatch                fTimer;                   ///< Time spent in the cached parts of the event processing
+  };
+
+  AliEmcalEventCache();
+  AliEmcalEventCache(const AliEmcalEventCache &);
+  AliEmcalEventCache &operator=(const AliEmcalEventCache &);
+
+  const AliVEvent                            *fEvent;                //!<! Current event
+  Long64_t                                    fEntry;                //!<! Entry of the current event
+  ULong64_t                                   fEventStamp;           //!<! Stamp of the current event (starts at 1)
+  Bool_t                                      fReportPrinted;        //!<! Report printed by PrintReportOnce
+  std::vector<std::string>                    fFingerprints;         //!<! Fingerprints of the registered keys
+  std::vector<Entry>                          fEntries;              //!<! Cached results, by key
+  std::vector<Client>                         fClients;              //!<! Statistics, by client ID
+  static AliEmcalEventCache                  *fgEventCache;          ///< Singleton object
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalEventCache, 1);
+  /// \endcond
+};
+
+}
+
+}
+
+#endif /* ALIEMCALEVENTCACHE_H */
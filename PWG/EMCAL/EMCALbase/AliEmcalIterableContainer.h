@@ -328,17 +328,14 @@ T *AliEmcalIterableContainerT<T, STAR>::operator[](int index) const {
 
 /**
  * Build list of accepted indices inside the container.
- * For this all objects inside the container are checked
- * for being accepted or not.
+ * The indices are provided by the container (see
+ * AliEmcalContainer::GetAcceptIndices).
  */
 template <typename T, typename STAR>
 void AliEmcalIterableContainerT<T, STAR>::BuildAcceptIndices(){
-  fAcceptIndices.Set(fkContainer->GetNAcceptEntries());
-  int acceptCounter = 0;
-  for(int index = 0; index < fkContainer->GetNEntries(); index++){
-    UInt_t rejectionReason = 0;
-    if(fkContainer->AcceptObject(index, rejectionReason)) fAcceptIndices[acceptCounter++] = index;
-  }
+  const std::vector<int> &indices = fkContainer->GetAcceptIndices();
+  fAcceptIndices.Set(indices.size());
+  for(std::size_t index = 0; index < indices.size(); index++) fAcceptIndices[index] = indices[index];
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -48,8 +48,11 @@
 #pragma link C++ class PWG::EMCAL::AliEmcalESDHybridTrackCuts+;
 #pragma link C++ class PWG::EMCAL::AliEmcalESDTrackCutsGenerator+;
 #pragma link C++ class PWG::EMCAL::AliEmcalESDtrackCutsWrapper+;
+#pragma link C++ class PWG::EMCAL::AliEmcalEtaPhiGrid+;
+#pragma link C++ class PWG::EMCAL::AliEmcalEventCache+;
 #pragma link C++ class PWG::EMCAL::TestAliEmcalTrackSelResultPtr+;
 #pragma link C++ class PWG::EMCAL::TestAliEmcalAODHybridTrackCuts+;
 #pragma link C++ class PWG::EMCAL::TestAliEmcalTrackSelectionAOD+;
+#pragma link C++ class PWG::EMCAL::TestAliEmcalEtaPhiGrid+;
 #pragma link C++ class std::vector<PWG::EMCAL::AliEmcalTrackSelResultPtr>+;
 #endif
@@ -5,6 +5,8 @@
 
 #include <TH1.h>
 #include <TList.h>
+#include <TStopwatch.h>
+#include <TVector3.h>
 
 #include "AliClusterContainer.h"
 #include "AliParticleContainer.h"
@@ -46,6 +48,11 @@ AliEmcalCorrectionClusterTrackMatcher::AliEmcalCorrectionClusterTrackMatcher() :
   fNEmcalClusters(0),
   fHistMatchEtaAll(0),
   fHistMatchPhiAll(0),
+  fHistMatchingTime(0),
+  fClusterGrid(),
+  fClusterEta(),
+  fClusterPhi(),
+  fCandidateClusters(),
   fNMCGenerToAccept(0),
   fMCGenerToAcceptForTrack(1)
 {
@@ -156,6 +163,9 @@ void AliEmcalCorrectionClusterTrackMatcher::UserCreateOutputObjects()
     fHistMatchPhiAll = new TH1F("fHistMatchPhiAll", "fHistMatchPhiAll", 400, -0.2, 0.2);
     fOutput->Add(fHistMatchEtaAll);
     fOutput->Add(fHistMatchPhiAll);
+    fHistMatchingTime = new TH1F("fHistMatchingTime", "fHistMatchingTime", 500, 0, 50);
+    fHistMatchingTime->SetXTitle("matching time per event (ms)");
+    fOutput->Add(fHistMatchingTime);
     
     const Int_t nCentChBins = fNcentBins * 2;
     for(Int_t icent=0; icent<nCentChBins; ++icent) {
@@ -196,7 +206,10 @@ Bool_t AliEmcalCorrectionClusterTrackMatcher::Run()
 
   // Run the matching.
   GenerateEmcalParticles();
+  TStopwatch matchingTime;
   DoMatching();
+  matchingTime.Stop();
+  if (fHistMatchingTime) fHistMatchingTime->Fill(matchingTime.RealTime() * 1000);
   if (fUpdateTracks) UpdateTracks();
   if (fUpdateClusters) UpdateClusters();
   
@@ -365,16 +378,36 @@ void AliEmcalCorrectionClusterTrackMatcher::GenerateEmcalParticles()
 
 /**
  * Set the links between tracks and clusters.
+ *
+ * The clusters are sorted into an (eta, phi) grid with cells of the size of the maximum
+ * distance, so that only the clusters in the neighbouring cells of the track position
+ * on the EMCal surface need to be tested. Candidates are tested in ascending order of
+ * the cluster index, therefore the matches are the same as testing all pairs.
  */
 void AliEmcalCorrectionClusterTrackMatcher::DoMatching()
 {
   const Double_t maxd2 = fMaxDistance*fMaxDistance;
 
+  // Cluster positions, same definition as in GetEtaPhiDiff()
+  fClusterEta.resize(fNEmcalClusters);
+  fClusterPhi.resize(fNEmcalClusters);
+  for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
+    Float_t pos[3] = {0};
+    emcalCluster->GetCluster()->GetPosition(pos);
+    TVector3 cpos(pos);
+    fClusterEta[icluster] = cpos.Eta();
+    fClusterPhi[icluster] = cpos.Phi();
+  }
+  fClusterGrid.Build(fNEmcalClusters, fClusterEta.data(), fClusterPhi.data(), fMaxDistance);
+
   for (Int_t itrack = 0; itrack < fNEmcalTracks; itrack++) {
     AliEmcalParticle* emcalTrack = static_cast<AliEmcalParticle*>(fEmcalTracks->At(itrack));
     AliVTrack* track = emcalTrack->GetTrack();
 
-    for (Int_t icluster = 0; icluster < fNEmcalClusters; icluster++) {
+    fClusterGrid.FindCandidates(track->GetTrackEtaOnEMCal(), track->GetTrackPhiOnEMCal(), fCandidateClusters);
+    for (std::vector<Int_t>::const_iterator candidate = fCandidateClusters.begin(); candidate != fCandidateClusters.end(); ++candidate) {
+      Int_t icluster = *candidate;
       AliEmcalParticle* emcalCluster = static_cast<AliEmcalParticle*>(fEmcalClusters->At(icluster));
       AliVCluster* cluster = emcalCluster->GetCluster();
       
@@ -1,7 +1,10 @@
 #ifndef ALIEMCALCORRECTIONCLUSTERTRACKMATCHER_H
 #define ALIEMCALCORRECTIONCLUSTERTRACKMATCHER_H
 
+#include <vector>
+
 #include "AliEmcalCorrectionComponent.h"
+#include "AliEmcalEtaPhiGrid.h"
 
 #if !(defined(__CINT__) || defined(__MAKECINT__))
 #include "AliEmcalContainerIndexMap.h"
@@ -103,6 +106,12 @@ class AliEmcalCorrectionClusterTrackMatcher : public AliEmcalCorrectionComponent
   TH1          *fHistMatchPhiAll;       //!<!dphi distribution
   TH1          *fHistMatchEta[10][9][2]; //!<!deta distribution
   TH1          *fHistMatchPhi[10][9][2]; //!<!dphi distribution
+  TH1          *fHistMatchingTime;      //!<!time needed for the matching per event
+
+  PWG::EMCAL::AliEmcalEtaPhiGrid fClusterGrid; //!<!(eta, phi) grid of the emcal clusters
+  std::vector<Double_t> fClusterEta;    //!<!eta of the emcal clusters
+  std::vector<Double_t> fClusterPhi;    //!<!phi of the emcal clusters
+  std::vector<Int_t> fCandidateClusters; //!<!clusters close to the current track
   
   Int_t      fNMCGenerToAccept;          ///<  Number of MC generators that should not be included in analysis
   TString    fMCGenerToAccept[5];        ///<  List with name of generators that should not be included
@@ -116,7 +125,7 @@ private:
   static RegisterCorrectionComponent<AliEmcalCorrectionClusterTrackMatcher> reg;
 
   /// \cond CLASSIMP
-  ClassDef(AliEmcalCorrectionClusterTrackMatcher, 5); // EMCal cluster track matcher correction component
+  ClassDef(AliEmcalCorrectionClusterTrackMatcher, 6); // EMCal cluster track matcher correction component
   /// \endcond
 };
 
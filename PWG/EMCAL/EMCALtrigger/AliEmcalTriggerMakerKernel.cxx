@@ -68,6 +68,9 @@ AliEmcalTriggerMakerKernel::AliEmcalTriggerMakerKernel():
   fSmearThreshold(0.1),
   fScaleShift(0.),
   fDoBackgroundSubtraction(false),
+  fUseSummedAreaTables(kFALSE),
+  fL1AlgorithmConfig(),
+  fL0AlgorithmConfig(),
   fGeometry(nullptr),
   fPatchAmplitudes(nullptr),
   fPatchADCSimple(nullptr),
@@ -75,7 +78,13 @@ AliEmcalTriggerMakerKernel::AliEmcalTriggerMakerKernel():
   fPatchEnergySimpleSmeared(nullptr),
   fLevel0TimeMap(nullptr),
   fTriggerBitMap(nullptr),
-  fADCtoGeV(1.)
+  fADCtoGeV(1.),
+  fBadChannelMask(),
+  fOfflineBadChannelMask(),
+  fBadChannelMasksValid(kFALSE),
+  fADCTable(),
+  fAmplitudeTable(),
+  fADCSimpleTable()
 {
   memset(fThresholdConstants, 0, sizeof(Int_t) * 12);
   memset(fL1ThresholdsOffline, 0, sizeof(ULong64_t) * 4);
@@ -132,6 +141,10 @@ void AliEmcalTriggerMakerKernel::AddL1TriggerAlgorithm(Int_t rowmin, Int_t rowma
   trigger->SetPatchSize(patchSize);
   trigger->SetSubregionSize(subregionSize);
   fPatchFinder->AddTriggerAlgorithm(trigger);
+
+  // Keep the parameters for the patch finding with summed-area tables
+  Int_t config[5] = {rowmin, rowmax, static_cast<Int_t>(bitmask), patchSize, subregionSize};
+  fL1AlgorithmConfig.insert(fL1AlgorithmConfig.end(), config, config + 5);
 }
 
 void AliEmcalTriggerMakerKernel::SetL0TriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize)
@@ -140,6 +153,9 @@ void AliEmcalTriggerMakerKernel::SetL0TriggerAlgorithm(Int_t rowmin, Int_t rowma
   fLevel0PatchFinder = new AliEMCALTriggerAlgorithm<double>(rowmin, rowmax, bitmask);
   fLevel0PatchFinder->SetPatchSize(patchSize);
   fLevel0PatchFinder->SetSubregionSize(subregionSize);
+
+  Int_t config[5] = {rowmin, rowmax, static_cast<Int_t>(bitmask), patchSize, subregionSize};
+  fL0AlgorithmConfig.assign(config, config + 5);
 }
 
 void AliEmcalTriggerMakerKernel::ConfigureForPbPb2015()
@@ -150,6 +166,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPbPb2015()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fL1AlgorithmConfig.clear();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -168,6 +185,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2015()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fL1AlgorithmConfig.clear();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -185,6 +203,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP20158x8()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fL1AlgorithmConfig.clear();
 
   SetL0TriggerAlgorithm(0, 103, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -202,6 +221,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPPb2013()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fL1AlgorithmConfig.clear();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit() | 1<<fTriggerBitConfig->GetGammaLowBit(), 2, 1);
@@ -217,6 +237,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2012()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fL1AlgorithmConfig.clear();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit(), 2, 1);
@@ -232,6 +253,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPbPb2011()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fL1AlgorithmConfig.clear();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   AddL1TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetGammaHighBit(), 2, 1);
@@ -247,6 +269,7 @@ void AliEmcalTriggerMakerKernel::ConfigureForPP2011()
   // Initialize patch finder
   if (fPatchFinder) delete fPatchFinder;
   fPatchFinder = new AliEMCALTriggerPatchFinder<double>;
+  fL1AlgorithmConfig.clear();
 
   SetL0TriggerAlgorithm(0, 63, 1<<fTriggerBitConfig->GetLevel0Bit(), 2, 1);
   fConfigured = true;
@@ -321,6 +344,7 @@ void AliEmcalTriggerMakerKernel::Reset(){
 }
 
 void AliEmcalTriggerMakerKernel::ReadTriggerData(AliVCaloTrigger *trigger){
+  if(!fBadChannelMasksValid) BuildBadChannelMasks();
   trigger->Reset();
   Int_t globCol=-1, globRow=-1;
   Int_t adcAmp=-1, bitmap = 0;
@@ -363,7 +387,7 @@ void AliEmcalTriggerMakerKernel::ReadTriggerData(AliVCaloTrigger *trigger){
     }
 
     // exclude channel completely if it is masked as hot channel
-    if (fBadChannels.find(absId) != fBadChannels.end()){
+    if (IsFastORBad(absId)){
       AliDebugStream(1) << "Found ADC for masked fastor " << absId << ", rejecting" << std::endl;
       continue;
     }
@@ -413,6 +437,7 @@ void AliEmcalTriggerMakerKernel::ReadTriggerData(AliVCaloTrigger *trigger){
 }
 
 void AliEmcalTriggerMakerKernel::ReadCellData(AliVCaloCells *cells){
+  if(!fBadChannelMasksValid) BuildBadChannelMasks();
   // fill the patch ADCs from cells
   Int_t nCell = cells->GetNumberOfCells();
   for(Int_t iCell = 0; iCell < nCell; ++iCell) {
@@ -420,7 +445,7 @@ void AliEmcalTriggerMakerKernel::ReadCellData(AliVCaloCells *cells){
     Short_t cellId = cells->GetCellNumber(iCell);
 
     // Check bad channel map
-    if (fOfflineBadChannels.find(cellId) != fOfflineBadChannels.end()) {
+    if (IsOfflineCellBad(cellId)) {
       AliDebugStream(1) << "Cell " << cellId << " masked as bad channel, rejecting." << std::endl;
       continue;
     }
@@ -438,7 +463,7 @@ void AliEmcalTriggerMakerKernel::ReadCellData(AliVCaloCells *cells){
       // Exclude FEE amplitudes from cells which are within a TRU which is masked at
       // online level. Using this the online acceptance can be applied to offline
       // patches as well.
-      if(fBadChannels.find(absId) != fBadChannels.end()){
+      if(IsFastORBad(absId)){
         AliDebugStream(1) << "Cell " << cellId << " corresponding to masked fastor " << absId << ", rejecting." << std::endl;
         continue;
       }
@@ -464,7 +489,7 @@ void AliEmcalTriggerMakerKernel::ReadCellData(AliVCaloCells *cells){
           int absFastor = -1;
           fGeometry->GetAbsFastORIndexFromPositionInEMCAL(icol, irow, absFastor);
           if(absFastor > -1) {
-            if(fBadChannels.find(absFastor) != fBadChannels.end()){
+            if(IsFastORBad(absFastor)){
               AliDebugStream(1) << "In smearing, FastOR " << absFastor << " masked, rejecting." << std::endl;
               doChannel = false;
             }
@@ -530,8 +555,23 @@ void AliEmcalTriggerMakerKernel::CreateTriggerPatches(const AliVEvent *inputeven
   bkgPatchMask = 1 << fTriggerBitConfig->GetBkgBit();
       //l0PatchMask = 1 << fTriggerBitConfig->GetLevel0Bit();
 
+  // Summed-area tables are only used for algorithms known to the kernel
+  Bool_t useTablesL1 = fUseSummedAreaTables && fL1AlgorithmConfig.size(),
+         useTablesL0 = fUseSummedAreaTables && fL0AlgorithmConfig.size();
+  if(useTablesL1 || useTablesL0) fADCSimpleTable.Build(*fPatchADCSimple);
+  if((useTablesL1 && useL0amp) || useTablesL0) fAmplitudeTable.Build(*fPatchAmplitudes);
+  if(useTablesL1 && !useL0amp) fADCTable.Build(*fPatchADC);
+
   std::vector<AliEMCALTriggerRawPatch> patches;
-  if (fPatchFinder) {
+  if (useTablesL1) {
+    if (useL0amp) {
+      patches = FindPatchesSummedArea(fL1AlgorithmConfig, *fPatchAmplitudes, fAmplitudeTable, *fPatchADCSimple, fADCSimpleTable);
+    }
+    else {
+      patches = FindPatchesSummedArea(fL1AlgorithmConfig, *fPatchADC, fADCTable, *fPatchADCSimple, fADCSimpleTable);
+    }
+  }
+  else if (fPatchFinder) {
     if (useL0amp) {
       patches = fPatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
     }
@@ -593,7 +633,8 @@ void AliEmcalTriggerMakerKernel::CreateTriggerPatches(const AliVEvent *inputeven
 
   // Find Level0 patches
   std::vector<AliEMCALTriggerRawPatch> l0patches;
-  if (fLevel0PatchFinder) l0patches = fLevel0PatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
+  if (useTablesL0) l0patches = FindPatchesSummedArea(fL0AlgorithmConfig, *fPatchAmplitudes, fAmplitudeTable, *fPatchADCSimple, fADCSimpleTable);
+  else if (fLevel0PatchFinder) l0patches = fLevel0PatchFinder->FindPatches(*fPatchAmplitudes, *fPatchADCSimple);
   for(std::vector<AliEMCALTriggerRawPatch>::iterator patchit = l0patches.begin(); patchit != l0patches.end(); ++patchit){
     Int_t offlinebits = 0, onlinebits = 0;
     if(HasPHOSOverlap(*patchit)) continue;
@@ -723,12 +764,68 @@ AliEmcalTriggerMakerKernel::ELevel0TriggerStatus_t AliEmcalTriggerMakerKernel::C
   return result;
 }
 
+std::vector<AliEMCALTriggerRawPatch> AliEmcalTriggerMakerKernel::FindPatchesSummedArea(const std::vector<Int_t> &config,
+    const AliEMCALTriggerDataGrid<double> &adc, const AliEmcalTriggerSummedAreaTable &adctable,
+    const AliEMCALTriggerDataGrid<double> &offline, const AliEmcalTriggerSummedAreaTable &offlinetable) const {
+  std::vector<AliEMCALTriggerRawPatch> result;
+  // With negative amplitudes patches can sum to 0 without being empty
+  bool skipEmpty = adctable.IsNonNegative() && offlinetable.IsNonNegative();
+  for(std::size_t ialgo = 0; ialgo + 4 < config.size(); ialgo += 5){
+    int rowmin = config[ialgo], rowmax = config[ialgo+1], patchsize = config[ialgo+3], subregionsize = config[ialgo+4];
+    UInt_t bitmask = static_cast<UInt_t>(config[ialgo+2]);
+    int rowStartMax = rowmax - (patchsize - 1), colStartMax = adc.GetNumberOfCols() - patchsize;
+    for(int irow = rowmin; irow <= rowStartMax; irow += subregionsize){
+      for(int icol = 0; icol <= colStartMax; icol += subregionsize){
+        if(skipEmpty && !adctable.GetNumberOfFiredChannels(icol, irow, patchsize) && !offlinetable.GetNumberOfFiredChannels(icol, irow, patchsize)) continue;
+        double sumadc = GetPatchSum(adc, adctable, icol, irow, patchsize),
+               sumofflineAdc = GetPatchSum(offline, offlinetable, icol, irow, patchsize);
+        if(sumadc || sumofflineAdc){
+          AliEMCALTriggerRawPatch recpatch(icol, irow, patchsize, sumadc, sumofflineAdc);
+          recpatch.SetBitmask(bitmask);
+          result.push_back(recpatch);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+Double_t AliEmcalTriggerMakerKernel::GetPatchSum(const AliEMCALTriggerDataGrid<double> &grid, const AliEmcalTriggerSummedAreaTable &table, Int_t col, Int_t row, Int_t size) const {
+  if(table.IsIntegerValued()) return table.GetPatchSum(col, row, size);
+  // Sums of non-integer amplitudes depend on the order of the additions:
+  // sum row by row as the patch finders, channels outside the grid do not contribute
+  Int_t colmin = TMath::Max(col, 0), colmax = TMath::Min(col + size, grid.GetNumberOfCols()),
+        rowmin = TMath::Max(row, 0), rowmax = TMath::Min(row + size, grid.GetNumberOfRows());
+  Double_t sum = 0;
+  for(Int_t irow = rowmin; irow < rowmax; irow++){
+    for(Int_t icol = colmin; icol < colmax; icol++){
+      sum += grid(icol, irow);
+    }
+  }
+  return sum;
+}
+
+void AliEmcalTriggerMakerKernel::BuildBadChannelMasks(){
+  // The lists are sorted, the last entry is the maximum ID
+  fBadChannelMask.assign(fBadChannels.size() && *fBadChannels.rbegin() >= 0 ? *fBadChannels.rbegin() + 1 : 0, false);
+  for(std::set<Short_t>::const_iterator it = fBadChannels.begin(); it != fBadChannels.end(); ++it){
+    if(*it >= 0) fBadChannelMask[*it] = true;
+  }
+  fOfflineBadChannelMask.assign(fOfflineBadChannels.size() && *fOfflineBadChannels.rbegin() >= 0 ? *fOfflineBadChannels.rbegin() + 1 : 0, false);
+  for(std::set<Short_t>::const_iterator it = fOfflineBadChannels.begin(); it != fOfflineBadChannels.end(); ++it){
+    if(*it >= 0) fOfflineBadChannelMask[*it] = true;
+  }
+  fBadChannelMasksValid = kTRUE;
+}
+
 void AliEmcalTriggerMakerKernel::ClearFastORBadChannels(){
   fBadChannels.clear();
+  fBadChannelMasksValid = kFALSE;
 }
 
 void AliEmcalTriggerMakerKernel::ClearOfflineBadChannels() {
   fOfflineBadChannels.clear();
+  fBadChannelMasksValid = kFALSE;
 }
 
 Bool_t AliEmcalTriggerMakerKernel::IsGammaPatch(const AliEMCALTriggerRawPatch &patch) const {
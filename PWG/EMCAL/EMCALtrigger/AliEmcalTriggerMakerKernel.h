@@ -9,6 +9,7 @@
 
 #include <TObject.h>
 #include <TArrayF.h>
+#include "AliEmcalTriggerSummedAreaTable.h"
 //#include <AliEMCALTriggerPatchInfoV1.h>
 
 class TF1;
@@ -223,7 +224,7 @@ public:
    * @brief Add a FastOR bad channel to the list
    * @param[in] absId Absolute ID of the bad channel
    */
-  void AddFastORBadChannel(Short_t absId) { fBadChannels.insert(absId); }
+  void AddFastORBadChannel(Short_t absId) { fBadChannels.insert(absId); fBadChannelMasksValid = kFALSE; }
 
   /**
    * @brief Read the FastOR bad channel map from a standard stream
@@ -246,7 +247,7 @@ public:
    * @brief Add an offline bad channel to the set
    * @param[in] absId Absolute ID of the bad channel
    */
-  void AddOfflineBadChannel(Short_t absId) { fOfflineBadChannels.insert(absId); }
+  void AddOfflineBadChannel(Short_t absId) { fOfflineBadChannels.insert(absId); fBadChannelMasksValid = kFALSE; }
 
   /**
    * @brief Read the offline bad channel map from a standard stream
@@ -390,6 +391,23 @@ public:
    */
   void SetL0TriggerAlgorithm(Int_t rowmin, Int_t rowmax, UInt_t bitmask, Int_t patchSize, Int_t subregionSize);
 
+  /**
+   * @brief Find the patches using summed-area tables of the data grids
+   *
+   * The sums of the patches are obtained from summed-area tables (2D prefix
+   * sums) built once per event for each data grid, so that the cost per patch
+   * does not depend on the patch size, and patches without any fired channel
+   * are skipped directly. The patches are the same as the ones of the standard
+   * patch finders: for grids with non-integer amplitudes (L0 amplitudes, offline
+   * ADC) the channels of non-empty patches are summed directly in order to
+   * obtain bitwise identical sums.
+   *
+   * Only trigger algorithms defined via AddL1TriggerAlgorithm and
+   * SetL0TriggerAlgorithm (or the ConfigureForXX functions) are handled.
+   * @param[in] doUse If true the summed-area tables are used
+   */
+  void SetUseSummedAreaTables(Bool_t doUse = kTRUE) { fUseSummedAreaTables = doUse; }
+
   /**
    * @brief Set energy-dependent models for gaussian energy smearing
    * @param[in] mean Parameterization of the mean
@@ -504,6 +522,61 @@ protected:
    */
   bool HasPHOSOverlap(const AliEMCALTriggerRawPatch &patch) const;
 
+  /**
+   * @brief Find patches with the summed-area tables of the data grids
+   *
+   * Same patches (position, sums, order) as the patch finders for the
+   * given algorithms.
+   * @param[in] config Parameters of the algorithms (rowmin, rowmax, bitmask, patch size, subregion size for each algorithm)
+   * @param[in] adc Data grid with the online amplitudes
+   * @param[in] adctable Summed-area table of the online amplitudes
+   * @param[in] offline Data grid with the offline amplitudes
+   * @param[in] offlinetable Summed-area table of the offline amplitudes
+   * @return Patches of all algorithms, in the order of the algorithms
+   */
+  std::vector<AliEMCALTriggerRawPatch> FindPatchesSummedArea(const std::vector<Int_t> &config,
+      const AliEMCALTriggerDataGrid<double> &adc, const AliEmcalTriggerSummedAreaTable &adctable,
+      const AliEMCALTriggerDataGrid<double> &offline, const AliEmcalTriggerSummedAreaTable &offlinetable) const;
+
+  /**
+   * @brief Sum of the amplitudes of a patch
+   *
+   * The sum is taken from the summed-area table if it is exact, otherwise the
+   * channels are summed row by row as in the patch finders.
+   * @param[in] grid Data grid with the amplitudes
+   * @param[in] table Summed-area table of the data grid
+   * @param[in] col Starting column of the patch
+   * @param[in] row Starting row of the patch
+   * @param[in] size Size of the patch
+   * @return Sum of the amplitudes of the patch
+   */
+  Double_t GetPatchSum(const AliEMCALTriggerDataGrid<double> &grid, const AliEmcalTriggerSummedAreaTable &table, Int_t col, Int_t row, Int_t size) const;
+
+  /**
+   * @brief Build the dense bad channel masks from the lists of bad channels
+   */
+  void BuildBadChannelMasks();
+
+  /**
+   * @brief Check whether a FastOR is masked as bad channel
+   * @param[in] absId Absolute ID of the FastOR
+   * @return True if the FastOR is in the list of bad channels
+   */
+  Bool_t IsFastORBad(Int_t absId) const {
+    if(absId < 0) return fBadChannels.find(absId) != fBadChannels.end();
+    return absId < static_cast<Int_t>(fBadChannelMask.size()) && fBadChannelMask[absId];
+  }
+
+  /**
+   * @brief Check whether a cell is masked as offline bad channel
+   * @param[in] cellId Absolute ID of the cell
+   * @return True if the cell is in the list of offline bad channels
+   */
+  Bool_t IsOfflineCellBad(Int_t cellId) const {
+    if(cellId < 0) return fOfflineBadChannels.find(cellId) != fOfflineBadChannels.end();
+    return cellId < static_cast<Int_t>(fOfflineBadChannelMask.size()) && fOfflineBadChannelMask[cellId];
+  }
+
   std::set<Short_t>                         fBadChannels;                 ///< Container of bad channels
   std::set<Short_t>                         fOfflineBadChannels;          ///< Abd ID of offline bad channels
   TArrayF                                   fFastORPedestal;              ///< FastOR pedestal
@@ -532,6 +605,9 @@ protected:
   Double_t                                  fSmearThreshold;              ///< Smear threshold: Only cell energies above threshold are smeared
   Double_t                                  fScaleShift;                  ///< Scale shift simulation
   Bool_t                                    fDoBackgroundSubtraction;     ///< Swtich for background subtraction (only online ADC)
+  Bool_t                                    fUseSummedAreaTables;         ///< Find patches using summed-area tables of the data grids
+  std::vector<Int_t>                        fL1AlgorithmConfig;           ///< Parameters of the L1 trigger algorithms (5 per algorithm, see AddL1TriggerAlgorithm)
+  std::vector<Int_t>                        fL0AlgorithmConfig;           ///< Parameters of the L0 trigger algorithm (see SetL0TriggerAlgorithm)
 
   const AliEMCALGeometry                    *fGeometry;                   //!<! Underlying EMCAL geometry
   AliEMCALTriggerDataGrid<double>           *fPatchAmplitudes;            //!<! TRU Amplitudes (for L0)
@@ -544,8 +620,15 @@ protected:
 
   Double_t                                  fADCtoGeV;                    //!<! Conversion factor from ADC to GeV
 
+  std::vector<bool>                         fBadChannelMask;              //!<! Dense mask of the online bad channels, indexed by FastOR abs ID
+  std::vector<bool>                         fOfflineBadChannelMask;       //!<! Dense mask of the offline bad channels, indexed by cell abs ID
+  Bool_t                                    fBadChannelMasksValid;        //!<! Bad channel masks are up-to-date with the lists of bad channels
+  AliEmcalTriggerSummedAreaTable            fADCTable;                    //!<! Summed-area table of the online ADC values
+  AliEmcalTriggerSummedAreaTable            fAmplitudeTable;              //!<! Summed-area table of the L0 amplitudes
+  AliEmcalTriggerSummedAreaTable            fADCSimpleTable;              //!<! Summed-area table of the offline ADC values
+
   /// \cond CLASSIMP
-  ClassDef(AliEmcalTriggerMakerKernel, 4);
+  ClassDef(AliEmcalTriggerMakerKernel, 5);
   /// \endcond
 };
 
@@ -0,0 +1,78 @@
+/**************************************************************************
+ * Copyright(c) 1998-2019, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "AliEMCALTriggerDataGrid.h"
+#include "AliEmcalTriggerSummedAreaTable.h"
+
+/// \cond CLASSIMP
+ClassImp(AliEmcalTriggerSummedAreaTable)
+/// \endcond
+
+AliEmcalTriggerSummedAreaTable::AliEmcalTriggerSummedAreaTable():
+  TObject(),
+  fNCols(0),
+  fNRows(0),
+  fIntegerValued(kTRUE),
+  fNonNegative(kTRUE),
+  fSum(),
+  fFired()
+{
+}
+
+void AliEmcalTriggerSummedAreaTable::Build(const AliEMCALTriggerDataGrid<double> &grid){
+  // Sums of integers are exact in double precision up to 2^53
+  const Double_t kMaxExactSum = 9007199254740992.;
+
+  fNCols = grid.GetNumberOfCols();
+  fNRows = grid.GetNumberOfRows();
+  fIntegerValued = kTRUE;
+  fNonNegative = kTRUE;
+  fSum.assign((fNCols + 1) * (fNRows + 1), 0.);
+  fFired.assign((fNCols + 1) * (fNRows + 1), 0);
+
+  Double_t sumabs = 0;
+  for(Int_t irow = 0; irow < fNRows; irow++){
+    // Running sums over the current row, added to the table entries of the row below
+    Double_t rowsum = 0;
+    Int_t rowfired = 0;
+    for(Int_t icol = 0; icol < fNCols; icol++){
+      Double_t amp = grid(icol, irow);
+      if(amp < 0) fNonNegative = kFALSE;
+      if(amp != std::floor(amp)) fIntegerValued = kFALSE;
+      sumabs += std::fabs(amp);
+      rowsum += amp;
+      if(amp > 0) rowfired++;
+      fSum[GetIndex(icol + 1, irow + 1)] = fSum[GetIndex(icol + 1, irow)] + rowsum;
+      fFired[GetIndex(icol + 1, irow + 1)] = fFired[GetIndex(icol + 1, irow)] + rowfired;
+    }
+  }
+  if(sumabs >= kMaxExactSum) fIntegerValued = kFALSE;
+}
+
+Double_t AliEmcalTriggerSummedAreaTable::GetPatchSum(Int_t col, Int_t row, Int_t size) const {
+  Int_t colmin = std::max(col, 0), colmax = std::min(col + size, fNCols),
+        rowmin = std::max(row, 0), rowmax = std::min(row + size, fNRows);
+  if(colmin >= colmax || rowmin >= rowmax) return 0.;
+  return fSum[GetIndex(colmax, rowmax)] - fSum[GetIndex(colmin, rowmax)] - fSum[GetIndex(colmax, rowmin)] + fSum[GetIndex(colmin, rowmin)];
+}
+
+Int_t AliEmcalTriggerSummedAreaTable::GetNumberOfFiredChannels(Int_t col, Int_t row, Int_t size) const {
+  Int_t colmin = std::max(col, 0), colmax = std::min(col + size, fNCols),
+        rowmin = std::max(row, 0), rowmax = std::min(row + size, fNRows);
+  if(colmin >= colmax || rowmin >= rowmax) return 0;
+  return fFired[GetIndex(colmax, rowmax)] - fFired[GetIndex(colmin, rowmax)] - fFired[GetIndex(colmax, rowmin)] + fFired[GetIndex(colmin, rowmin)];
+}
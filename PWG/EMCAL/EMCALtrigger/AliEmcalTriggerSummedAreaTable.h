@@ -0,0 +1,106 @@
+#ifndef ALIEMCALTRIGGERSUMMEDAREATABLE_H
+#define ALIEMCALTRIGGERSUMMEDAREATABLE_H
+/* Copyright(c) 1998-2019, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+#include <vector>
+
+#include <TObject.h>
+
+template<class T> class AliEMCALTriggerDataGrid;
+
+/**
+ * @class AliEmcalTriggerSummedAreaTable
+ * @brief Summed-area table (2D prefix sums) of a FastOR data grid
+ * @ingroup EMCALTRGFW
+ * @since Oct 16, 2019
+ *
+ * The table is built in a single pass over an AliEMCALTriggerDataGrid and
+ * provides for patches of any size and position
+ * - the sum of the amplitudes
+ * - the number of channels with positive amplitude
+ * with four table lookups each. Channels outside the grid do not contribute.
+ *
+ * The sums from the table are exact only if all amplitudes are integer
+ * (IsIntegerValued), as it is the case for the online ADC values. For
+ * other grids the sums differ in the last bits from a sum over the channels
+ * of the patch, the user is then expected to sum the channels directly.
+ */
+class AliEmcalTriggerSummedAreaTable : public TObject {
+public:
+  /**
+   * @brief Constructor
+   */
+  AliEmcalTriggerSummedAreaTable();
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~AliEmcalTriggerSummedAreaTable() {}
+
+  /**
+   * @brief Build the table from the amplitudes of a data grid
+   * @param[in] grid Data grid with the amplitudes
+   */
+  void Build(const AliEMCALTriggerDataGrid<double> &grid);
+
+  /**
+   * @brief Sum of the amplitudes of a patch
+   * @param[in] col Starting column of the patch
+   * @param[in] row Starting row of the patch
+   * @param[in] size Size of the patch (in columns and rows)
+   * @return Sum of the amplitudes of the channels of the patch inside the grid
+   */
+  Double_t GetPatchSum(Int_t col, Int_t row, Int_t size) const;
+
+  /**
+   * @brief Number of channels with positive amplitude in a patch
+   * @param[in] col Starting column of the patch
+   * @param[in] row Starting row of the patch
+   * @param[in] size Size of the patch (in columns and rows)
+   * @return Number of channels of the patch inside the grid with amplitude > 0
+   */
+  Int_t GetNumberOfFiredChannels(Int_t col, Int_t row, Int_t size) const;
+
+  /**
+   * @brief Check whether all amplitudes are integer
+   *
+   * In this case all sums are exact.
+   * @return True if all amplitudes in the grid are integer
+   */
+  Bool_t IsIntegerValued() const { return fIntegerValued; }
+
+  /**
+   * @brief Check whether all amplitudes are positive or 0
+   *
+   * In this case the sum of a patch is positive if and only if
+   * the patch contains a fired channel.
+   * @return True if no amplitude in the grid is negative
+   */
+  Bool_t IsNonNegative() const { return fNonNegative; }
+
+  Int_t GetNumberOfCols() const { return fNCols; }
+  Int_t GetNumberOfRows() const { return fNRows; }
+
+protected:
+  /**
+   * @brief Index of a corner in the tables
+   * @param[in] col Column (0 to number of columns)
+   * @param[in] row Row (0 to number of rows)
+   * @return Index in the tables
+   */
+  Int_t GetIndex(Int_t col, Int_t row) const { return row * (fNCols + 1) + col; }
+
+  Int_t                       fNCols;             ///< Number of columns of the grid
+  Int_t                       fNRows;             ///< Number of rows of the grid
+  Bool_t                      fIntegerValued;     ///< All amplitudes are integer
+  Bool_t                      fNonNegative;       ///< No amplitude is negative
+  std::vector<Double_t>       fSum;               ///< Sum of the amplitudes below and left of each corner
+  std::vector<Int_t>          fFired;             ///< Number of fired channels below and left of each corner
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalTriggerSummedAreaTable, 1);
+  /// \endcond
+};
+
+#endif
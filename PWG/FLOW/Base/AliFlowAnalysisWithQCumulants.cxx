@@ -43,6 +43,7 @@
 #include "AliFlowEventSimple.h"
 #include "AliFlowTrackSimple.h"
 #include "AliFlowAnalysisWithQCumulants.h"
+#include "AliFlowQVectorAccumulator.h"
 #include "TArrayD.h"
 #include "TRandom.h"
 #include "TF1.h"
@@ -134,6 +135,8 @@ AliFlowAnalysisWithQCumulants::AliFlowAnalysisWithQCumulants():
  fUse2DHistograms(kFALSE),
  fFillProfilesVsMUsingWeights(kTRUE),
  fUseQvectorTerms(kFALSE),
+ fUseQVectorAccumulator(kFALSE),
+ fQVectorAccumulator(NULL),
  fReQ(NULL),
  fImQ(NULL),
  fSpk(NULL),
@@ -271,6 +274,7 @@ AliFlowAnalysisWithQCumulants::~AliFlowAnalysisWithQCumulants()
  // destructor
  
  delete fHistList;
+ delete fQVectorAccumulator;
 
 } // end of AliFlowAnalysisWithQCumulants::~AliFlowAnalysisWithQCumulants()
 
@@ -311,6 +315,15 @@ void AliFlowAnalysisWithQCumulants::Init()
  this->BookEverythingForMixedHarmonics();
  this->BookEverythingForControlHistograms();
  this->BookEverythingForBootstrap();
+ if(fUseQVectorAccumulator)
+ {
+  delete fQVectorAccumulator;
+  fQVectorAccumulator = new AliFlowQVectorAccumulator();
+  fQVectorAccumulator->Initialize(fHarmonic,
+                                  fCalculateDiffFlow ? fReRPQ1dEBE[0][0][0][0] : NULL,
+                                  fCalculateDiffFlow && fCalculateDiffFlowVsEta ? fReRPQ1dEBE[0][1][0][0] : NULL,
+                                  fCalculate2DDiffFlow ? fReRPQ2dEBE[0][0][0] : NULL);
+ }
 
  // d) Store flags for integrated and differential flow:
  this->StoreIntFlowFlags();
@@ -379,6 +392,11 @@ void AliFlowAnalysisWithQCumulants::Make(AliFlowEventSimple* anEvent)
  Int_t nPrim = anEvent->NumberOfTracks();  // nPrim = total number of primary tracks
  AliFlowTrackSimple *aftsTrack = NULL;
  Int_t n = fHarmonic; // shortcut for the harmonic 
+ if(fUseQVectorAccumulator) // same e-b-e quantities as in the loop below, calculated with flat arrays
+ {
+  this->FillQVectorsWithAccumulator(anEvent);
+  nPrim = 0; // the tracks are already processed, the loop below is skipped
+ }
  for(Int_t i=0;i<nPrim;i++) 
  { 
   if(fExactNoRPs > 0 && nCounterNoRPs>fExactNoRPs){continue;}
@@ -21086,6 +21104,102 @@ void AliFlowAnalysisWithQCumulants::ResetEventByEventQuantities()
 
 //=======================================================================================================================
 
+void AliFlowAnalysisWithQCumulants::FillQVectorsWithAccumulator(AliFlowEventSimple *anEvent)
+{
+ // Calculate e-b-e quantities Q_{n,k}, S_{p,k} (before the final power p+1), s_{p,k} 
+ // and the differential p-, q- and r-vectors with AliFlowQVectorAccumulator:
+ //  a) Loop over data and add each RP and POI with its weight to the flat arrays;
+ //  b) Write the sums into fReQ, fImQ, fSpk and the e-b-e profiles;
+ //  c) Reset the accumulator for the next event.
+ // The resulting e-b-e quantities are the same as in the loop over data in Make(). 
+
+ if(!fQVectorAccumulator)
+ {
+  printf("\n WARNING (QC): fQVectorAccumulator is NULL in AFAWQC::FillQVectorsWithAccumulator() !!!!\n\n");
+  exit(0);
+ }
+
+ // a) Loop over data and add each RP and POI with its weight to the flat arrays:
+ Double_t dPhi = 0.; // azimuthal angle in the laboratory frame
+ Double_t dPt  = 0.; // transverse momentum
+ Double_t dEta = 0.; // pseudorapidity
+ Double_t wPhi = 1.; // phi weight
+ Double_t wPt  = 1.; // pt weight
+ Double_t wEta = 1.; // eta weight
+ Double_t wTrack = 1.; // track weight
+ Int_t nCounterNoRPs = 0; // needed only for shuffling
+ Int_t nPrim = anEvent->NumberOfTracks();  // nPrim = total number of primary tracks
+ AliFlowTrackSimple *aftsTrack = NULL;
+ for(Int_t i=0;i<nPrim;i++) 
+ { 
+  if(fExactNoRPs > 0 && nCounterNoRPs>fExactNoRPs){continue;}
+  aftsTrack=anEvent->GetTrack(i);
+  if(aftsTrack)
+  {
+   Bool_t bRP = aftsTrack->InRPSelection();
+   Bool_t bPOI = aftsTrack->InPOISelection();
+   if(!(bRP || bPOI)){continue;} // safety measure: consider only tracks which are RPs or POIs
+   if(bRP){nCounterNoRPs++;}
+   dPhi = aftsTrack->Phi();
+   dPt  = aftsTrack->Pt();
+   dEta = aftsTrack->Eta();
+   wPhi = 1.;
+   wPt  = 1.;
+   wEta = 1.;
+   wTrack = 1.;
+   if(bRP) // particle weights are used only for RPs (also when RP is POI):
+   {
+    if(fUsePhiWeights && fPhiWeights && fnBinsPhi) // determine phi weight for this particle:
+    {
+     wPhi = fPhiWeights->GetBinContent(1+(Int_t)(TMath::Floor(dPhi*fnBinsPhi/TMath::TwoPi())));
+    }
+    if(fUsePtWeights && fPtWeights && fnBinsPt) // determine pt weight for this particle:
+    {
+     wPt = fPtWeights->GetBinContent(1+(Int_t)(TMath::Floor((dPt-fPtMin)/fPtBinWidth))); 
+    }              
+    if(fUseEtaWeights && fEtaWeights && fEtaBinWidth) // determine eta weight for this particle: 
+    {
+     wEta = fEtaWeights->GetBinContent(1+(Int_t)(TMath::Floor((dEta-fEtaMin)/fEtaBinWidth))); 
+    }      
+    if(fUseTrackWeights) // access track weight:
+    {
+     wTrack = aftsTrack->Weight(); 
+    }
+   } // end of if(bRP)
+   fQVectorAccumulator->AddTrack(dPhi,dPt,dEta,wPhi*wPt*wEta*wTrack,bRP,bPOI);
+  } else // to if(aftsTrack)
+    {
+     printf("\n WARNING (QC): No particle (i.e. aftsTrack is a NULL pointer in AFAWQC::FillQVectorsWithAccumulator())!!!!\n\n");
+    }
+ } // end of for(Int_t i=0;i<nPrim;i++) 
+
+ // b) Write the sums into fReQ, fImQ, fSpk and the e-b-e profiles:
+ fQVectorAccumulator->FillQVectors(fReQ,fImQ,fSpk);
+ if(fCalculateDiffFlow)
+ {
+  for(Int_t t=0;t<3;t++) // type (0 = RP, 1 = POI, 2 = RP&&POI)
+  {
+   for(Int_t pe=0;pe<1+(Int_t)fCalculateDiffFlowVsEta;pe++) // pt or eta
+   {
+    fQVectorAccumulator->FillProfiles1D(t,pe,fReRPQ1dEBE[t][pe],fImRPQ1dEBE[t][pe],t==1 ? NULL : fs1dEBE[t][pe]);
+   }
+  }
+ } // end of if(fCalculateDiffFlow)
+ if(fCalculate2DDiffFlow)
+ {
+  for(Int_t t=0;t<3;t++) // type (0 = RP, 1 = POI, 2 = RP&&POI)
+  {
+   fQVectorAccumulator->FillProfiles2D(t,fReRPQ2dEBE[t],fImRPQ2dEBE[t],t==1 ? NULL : fs2dEBE[t]);
+  }
+ } // end of if(fCalculate2DDiffFlow)
+
+ // c) Reset the accumulator for the next event:
+ fQVectorAccumulator->Clear();
+
+} // end of void AliFlowAnalysisWithQCumulants::FillQVectorsWithAccumulator(AliFlowEventSimple *anEvent)
+
+//=======================================================================================================================
+
 void AliFlowAnalysisWithQCumulants::CalculateDiffFlowCorrectionsForNUASinTerms(TString type, TString ptOrEta)
 {
  // Calculate correction terms for non-uniform acceptance for differential flow (sin terms).
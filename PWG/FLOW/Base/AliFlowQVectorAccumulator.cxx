@@ -0,0 +1,339 @@
+/*************************************************************************
+* Copyright(c) 1998-2008, ALICE Experiment at CERN, All rights reserved. *
+*                                                                        *
+* Author: The ALICE Off-line Project.                                    *
+* Contributors are mentioned in the code where appropriate.              *
+*                                                                        *
+* Permission to use, copy, modify and distribute this software and its   *
+* documentation strictly for non-commercial purposes is hereby granted   *
+* without fee, provided that the above copyright notice appears in all   *
+* copies and that both the copyright notice and this permission notice   *
+* appear in the supporting documentation. The authors make no claims     *
+* about the suitability of this software for any purpose. It is          *
+* provided "as is" without express or implied warranty.                  *
+**************************************************************************/
+
+#include "AliFlowQVectorAccumulator.h"
+#include "TMath.h"
+#include "TAxis.h"
+#include "TMatrixD.h"
+#include "TProfile.h"
+#include "TProfile2D.h"
+
+//********************************************************************
+// AliFlowQVectorAccumulator:                                        *
+// Flat arrays for the event-by-event Q-vectors of the Q-cumulant    *
+// analysis. Type t of the differential vectors is 0 = RP, 1 = POI,  *
+// 2 = RP && POI, as for the e-b-e profiles of                       *
+// AliFlowAnalysisWithQCumulants.                                    *
+//********************************************************************
+
+ClassImp(AliFlowQVectorAccumulator)
+
+//================================================================================================================
+
+AliFlowQVectorAccumulator::AliFlowQVectorAccumulator():
+ fHarmonic(0),
+ fProfile2D(NULL)
+{
+ // constructor
+
+ fAxis1D[0] = NULL;
+ fAxis1D[1] = NULL;
+ for(Int_t k=0;k<kNPowers;k++)
+ {
+  fPowers[k] = 0.;
+  fSk[k] = 0.;
+ }
+ for(Int_t m=0;m<kNHarmonics;m++)
+ {
+  fCos[m] = 0.;
+  fSin[m] = 0.;
+ }
+ for(Int_t i=0;i<kNHarmonics*kNPowers;i++)
+ {
+  fReQ[i] = 0.;
+  fImQ[i] = 0.;
+ }
+
+} // end of constructor
+
+//================================================================================================================
+
+AliFlowQVectorAccumulator::~AliFlowQVectorAccumulator()
+{
+ // destructor (the profiles defining the binning are not owned)
+
+} // end of AliFlowQVectorAccumulator::~AliFlowQVectorAccumulator()
+
+//================================================================================================================
+
+void AliFlowQVectorAccumulator::Initialize(Int_t harmonic, TProfile *ptProfile, TProfile *etaProfile, TProfile2D *ptEtaProfile)
+{
+ // Allocate the arrays for the binning of the e-b-e profiles. The profiles
+ // must stay alive as long as this object is used.
+
+ fHarmonic = harmonic;
+ TProfile *profile1D[2] = {ptProfile,etaProfile};
+ for(Int_t pe=0;pe<2;pe++)
+ {
+  fAxis1D[pe] = profile1D[pe] ? profile1D[pe]->GetXaxis() : NULL;
+  Int_t nCells = profile1D[pe] ? profile1D[pe]->GetNcells() : 0;
+  for(Int_t t=0;t<kNTypes;t++)
+  {
+   fRe1D[t][pe].assign(nCells*kNDiffHarmonics*kNPowers,0.);
+   fIm1D[t][pe].assign(nCells*kNDiffHarmonics*kNPowers,0.);
+   fS1D[t][pe].assign(nCells*kNPowers,0.);
+   fEntries1D[t][pe].assign(nCells,0.);
+   fTouched1D[t][pe].clear();
+   fTouched1D[t][pe].reserve(nCells);
+  }
+ }
+ fProfile2D = ptEtaProfile;
+ Int_t nCells2D = ptEtaProfile ? ptEtaProfile->GetNcells() : 0;
+ for(Int_t t=0;t<kNTypes;t++)
+ {
+  fRe2D[t].assign(nCells2D*kNDiffHarmonics*kNPowers,0.);
+  fIm2D[t].assign(nCells2D*kNDiffHarmonics*kNPowers,0.);
+  fS2D[t].assign(nCells2D*kNPowers,0.);
+  fEntries2D[t].assign(nCells2D,0.);
+  fTouched2D[t].clear();
+ }
+ this->Clear();
+
+} // end of void AliFlowQVectorAccumulator::Initialize(...)
+
+//================================================================================================================
+
+void AliFlowQVectorAccumulator::AddTrack(Double_t phi, Double_t pt, Double_t eta, Double_t w, Bool_t rp, Bool_t poi)
+{
+ // Add a track to the Q-vectors (RP) and to the differential vectors (RP, POI
+ // and RP && POI). The weight w must be 1 for tracks which are not RPs.
+ // The terms are calculated exactly as in AliFlowAnalysisWithQCumulants::Make().
+
+ if(!(rp || poi)){return;}
+
+ for(Int_t k=0;k<kNPowers;k++)
+ {
+  fPowers[k] = pow(w,k);
+ }
+ for(Int_t m=0;m<kNHarmonics;m++)
+ {
+  fCos[m] = TMath::Cos((m+1)*fHarmonic*phi);
+  fSin[m] = TMath::Sin((m+1)*fHarmonic*phi);
+ }
+
+ // Q_{m*n,k} and S_{p,k}:
+ if(rp)
+ {
+  for(Int_t m=0;m<kNHarmonics;m++)
+  {
+   for(Int_t k=0;k<kNPowers;k++)
+   {
+    fReQ[m*kNPowers+k] += fPowers[k]*fCos[m];
+    fImQ[m*kNPowers+k] += fPowers[k]*fSin[m];
+   }
+  }
+  for(Int_t k=0;k<kNPowers;k++)
+  {
+   fSk[k] += fPowers[k];
+  }
+ }
+
+ // r_{m*n,k} (RP), p_{m*n,k} (POI) and q_{m*n,k} (RP && POI), s_{p,k} only for RP and RP && POI:
+ Double_t ptEta[2] = {pt,eta};
+ for(Int_t pe=0;pe<2;pe++)
+ {
+  if(!fAxis1D[pe]){continue;}
+  Int_t bin = fAxis1D[pe]->FindBin(ptEta[pe]);
+  for(Int_t t=0;t<kNTypes;t++)
+  {
+   if((t==0 && !rp) || (t==1 && !poi) || (t==2 && !(rp && poi))){continue;}
+   this->AddToCell(fRe1D[t][pe],fIm1D[t][pe],fS1D[t][pe],fEntries1D[t][pe],fTouched1D[t][pe],bin,t!=1);
+  }
+ }
+ if(fProfile2D)
+ {
+  Int_t bin = fProfile2D->FindBin(pt,eta);
+  for(Int_t t=0;t<kNTypes;t++)
+  {
+   if((t==0 && !rp) || (t==1 && !poi) || (t==2 && !(rp && poi))){continue;}
+   this->AddToCell(fRe2D[t],fIm2D[t],fS2D[t],fEntries2D[t],fTouched2D[t],bin,t!=1);
+  }
+ }
+
+} // end of void AliFlowQVectorAccumulator::AddTrack(...)
+
+//================================================================================================================
+
+void AliFlowQVectorAccumulator::AddToCell(std::vector<Double_t> &re, std::vector<Double_t> &im, std::vector<Double_t> &s,
+                                          std::vector<Double_t> &entries, std::vector<Int_t> &touched, Int_t bin, Bool_t addS)
+{
+ // Add the current track to one bin of the differential vectors.
+
+ if(entries[bin] == 0.){touched.push_back(bin);}
+ entries[bin] += 1.;
+ Double_t *reBin = &re[bin*kNDiffHarmonics*kNPowers];
+ Double_t *imBin = &im[bin*kNDiffHarmonics*kNPowers];
+ for(Int_t m=0;m<kNDiffHarmonics;m++)
+ {
+  for(Int_t k=0;k<kNPowers;k++)
+  {
+   reBin[m*kNPowers+k] += fPowers[k]*fCos[m];
+   imBin[m*kNPowers+k] += fPowers[k]*fSin[m];
+  }
+ }
+ if(addS)
+ {
+  Double_t *sBin = &s[bin*kNPowers];
+  for(Int_t k=0;k<kNPowers;k++)
+  {
+   sBin[k] += fPowers[k];
+  }
+ }
+
+} // end of void AliFlowQVectorAccumulator::AddToCell(...)
+
+//================================================================================================================
+
+void AliFlowQVectorAccumulator::FillQVectors(TMatrixD *reQ, TMatrixD *imQ, TMatrixD *spk) const
+{
+ // Copy Q_{m*n,k} and S_{p,k} (before the power p+1) into the e-b-e matrices.
+
+ for(Int_t m=0;m<kNHarmonics;m++)
+ {
+  for(Int_t k=0;k<kNPowers;k++)
+  {
+   (*reQ)(m,k) = fReQ[m*kNPowers+k];
+   (*imQ)(m,k) = fImQ[m*kNPowers+k];
+  }
+ }
+ for(Int_t p=0;p<kNSpk;p++)
+ {
+  for(Int_t k=0;k<kNPowers;k++)
+  {
+   (*spk)(p,k) = fSk[k];
+  }
+ }
+
+} // end of void AliFlowQVectorAccumulator::FillQVectors(...)
+
+//================================================================================================================
+
+void AliFlowQVectorAccumulator::FillProfiles1D(Int_t t, Int_t pe, TProfile *re[][kNPowers], TProfile *im[][kNPowers], TProfile **s) const
+{
+ // Write the sums of type t into empty 1D e-b-e profiles. Bin content and
+ // bin entries are the same as after one Fill(x,y,1.) per track; the bin
+ // errors are not set. s can be NULL (POIs).
+
+ const std::vector<Int_t> &touched = fTouched1D[t][pe];
+ for(UInt_t i=0;i<touched.size();i++)
+ {
+  Int_t bin = touched[i];
+  Double_t entries = fEntries1D[t][pe][bin];
+  for(Int_t m=0;m<kNDiffHarmonics;m++)
+  {
+   for(Int_t k=0;k<kNPowers;k++)
+   {
+    re[m][k]->SetBinContent(bin,fRe1D[t][pe][(bin*kNDiffHarmonics+m)*kNPowers+k]);
+    re[m][k]->SetBinEntries(bin,entries);
+    im[m][k]->SetBinContent(bin,fIm1D[t][pe][(bin*kNDiffHarmonics+m)*kNPowers+k]);
+    im[m][k]->SetBinEntries(bin,entries);
+   }
+  }
+  if(!s){continue;}
+  for(Int_t k=0;k<kNPowers;k++)
+  {
+   s[k]->SetBinContent(bin,fS1D[t][pe][bin*kNPowers+k]);
+   s[k]->SetBinEntries(bin,entries);
+  }
+ }
+
+} // end of void AliFlowQVectorAccumulator::FillProfiles1D(...)
+
+//================================================================================================================
+
+void AliFlowQVectorAccumulator::FillProfiles2D(Int_t t, TProfile2D *re[][kNPowers], TProfile2D *im[][kNPowers], TProfile2D **s) const
+{
+ // Write the sums of type t into empty 2D e-b-e profiles (see FillProfiles1D).
+
+ const std::vector<Int_t> &touched = fTouched2D[t];
+ for(UInt_t i=0;i<touched.size();i++)
+ {
+  Int_t bin = touched[i];
+  Double_t entries = fEntries2D[t][bin];
+  for(Int_t m=0;m<kNDiffHarmonics;m++)
+  {
+   for(Int_t k=0;k<kNPowers;k++)
+   {
+    re[m][k]->SetBinContent(bin,fRe2D[t][(bin*kNDiffHarmonics+m)*kNPowers+k]);
+    re[m][k]->SetBinEntries(bin,entries);
+    im[m][k]->SetBinContent(bin,fIm2D[t][(bin*kNDiffHarmonics+m)*kNPowers+k]);
+    im[m][k]->SetBinEntries(bin,entries);
+   }
+  }
+  if(!s){continue;}
+  for(Int_t k=0;k<kNPowers;k++)
+  {
+   s[k]->SetBinContent(bin,fS2D[t][bin*kNPowers+k]);
+   s[k]->SetBinEntries(bin,entries);
+  }
+ }
+
+} // end of void AliFlowQVectorAccumulator::FillProfiles2D(...)
+
+//================================================================================================================
+
+void AliFlowQVectorAccumulator::Clear()
+{
+ // Reset all sums. Only the bins which were filled in this event are zeroed.
+
+ for(Int_t i=0;i<kNHarmonics*kNPowers;i++)
+ {
+  fReQ[i] = 0.;
+  fImQ[i] = 0.;
+ }
+ for(Int_t k=0;k<kNPowers;k++)
+ {
+  fSk[k] = 0.;
+ }
+ for(Int_t t=0;t<kNTypes;t++)
+ {
+  for(Int_t pe=0;pe<2;pe++)
+  {
+   std::vector<Int_t> &touched = fTouched1D[t][pe];
+   for(UInt_t i=0;i<touched.size();i++)
+   {
+    Int_t bin = touched[i];
+    for(Int_t j=0;j<kNDiffHarmonics*kNPowers;j++)
+    {
+     fRe1D[t][pe][bin*kNDiffHarmonics*kNPowers+j] = 0.;
+     fIm1D[t][pe][bin*kNDiffHarmonics*kNPowers+j] = 0.;
+    }
+    for(Int_t k=0;k<kNPowers;k++)
+    {
+     fS1D[t][pe][bin*kNPowers+k] = 0.;
+    }
+    fEntries1D[t][pe][bin] = 0.;
+   }
+   touched.clear();
+  }
+  std::vector<Int_t> &touched = fTouched2D[t];
+  for(UInt_t i=0;i<touched.size();i++)
+  {
+   Int_t bin = touched[i];
+   for(Int_t j=0;j<kNDiffHarmonics*kNPowers;j++)
+   {
+    fRe2D[t][bin*kNDiffHarmonics*kNPowers+j] = 0.;
+    fIm2D[t][bin*kNDiffHarmonics*kNPowers+j] = 0.;
+   }
+   for(Int_t k=0;k<kNPowers;k++)
+   {
+    fS2D[t][bin*kNPowers+k] = 0.;
+   }
+   fEntries2D[t][bin] = 0.;
+  }
+  touched.clear();
+ }
+
+} // end of void AliFlowQVectorAccumulator::Clear()
@@ -0,0 +1,78 @@
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice */
+/* $Id$ */
+
+#ifndef ALIFLOWQVECTORACCUMULATOR_H
+#define ALIFLOWQVECTORACCUMULATOR_H
+
+#include <vector>
+#include "Rtypes.h"
+
+class TAxis;
+class TProfile;
+class TProfile2D;
+class TMatrixD;
+
+//********************************************************************
+// AliFlowQVectorAccumulator:                                        *
+// Flat arrays for the event-by-event Q-vectors Q_{m*n,k}, S_{p,k}   *
+// and the differential p-, q- and r-vectors of the Q-cumulant       *
+// analysis (AliFlowAnalysisWithQCumulants). For each track the      *
+// powers of the weight and the cosines and sines of the harmonics   *
+// are calculated once and added to plain arrays, instead of filling *
+// one TProfile per (m,k) and track. At the end of the track loop    *
+// the sums are written into the event-by-event TMatrixD and         *
+// TProfile objects, with the same bin contents and bin entries as   *
+// when these are filled track by track.                             *
+//********************************************************************
+class AliFlowQVectorAccumulator{
+ public:
+  enum {kNHarmonics = 12, kNPowers = 9, kNSpk = 8, kNDiffHarmonics = 4, kNTypes = 3};
+
+  AliFlowQVectorAccumulator();
+  virtual ~AliFlowQVectorAccumulator();
+
+  // Define the binning from the e-b-e profiles (NULL if not calculated):
+  void Initialize(Int_t harmonic, TProfile *ptProfile, TProfile *etaProfile, TProfile2D *ptEtaProfile);
+  // Add a track with weight w as RP, POI or both:
+  void AddTrack(Double_t phi, Double_t pt, Double_t eta, Double_t w, Bool_t rp, Bool_t poi);
+  // Write the sums into the e-b-e objects (which must be empty):
+  void FillQVectors(TMatrixD *reQ, TMatrixD *imQ, TMatrixD *spk) const;
+  void FillProfiles1D(Int_t t, Int_t pe, TProfile *re[][kNPowers], TProfile *im[][kNPowers], TProfile **s) const;
+  void FillProfiles2D(Int_t t, TProfile2D *re[][kNPowers], TProfile2D *im[][kNPowers], TProfile2D **s) const;
+  // Reset for the next event:
+  void Clear();
+
+ private:
+  AliFlowQVectorAccumulator(const AliFlowQVectorAccumulator& afqva);
+  AliFlowQVectorAccumulator& operator=(const AliFlowQVectorAccumulator& afqva);
+
+  void AddToCell(std::vector<Double_t> &re, std::vector<Double_t> &im, std::vector<Double_t> &s,
+                 std::vector<Double_t> &entries, std::vector<Int_t> &touched, Int_t bin, Bool_t addS);
+
+  Int_t fHarmonic; //! harmonic n
+  TAxis *fAxis1D[2]; //! binning of the 1D e-b-e profiles [0=pt,1=eta] (not owned)
+  TProfile2D *fProfile2D; //! binning of the 2D e-b-e profiles (not owned)
+  Double_t fPowers[kNPowers]; //! w^k of the current track
+  Double_t fCos[kNHarmonics]; //! cos((m+1)*n*phi) of the current track
+  Double_t fSin[kNHarmonics]; //! sin((m+1)*n*phi) of the current track
+  Double_t fReQ[kNHarmonics*kNPowers]; //! Re[Q_{m*n,k}], index m*kNPowers+k
+  Double_t fImQ[kNHarmonics*kNPowers]; //! Im[Q_{m*n,k}], index m*kNPowers+k
+  Double_t fSk[kNPowers]; //! sum of w^k (before the power p+1 of S_{p,k})
+  // 1D [t][pe]: Re and Im with index (bin*kNDiffHarmonics+m)*kNPowers+k, s with index bin*kNPowers+k:
+  std::vector<Double_t> fRe1D[kNTypes][2]; //! real parts of the 1D p-, q- and r-vectors
+  std::vector<Double_t> fIm1D[kNTypes][2]; //! imaginary parts of the 1D p-, q- and r-vectors
+  std::vector<Double_t> fS1D[kNTypes][2]; //! 1D s_{p,k} before the power p+1
+  std::vector<Double_t> fEntries1D[kNTypes][2]; //! number of tracks per bin
+  std::vector<Int_t> fTouched1D[kNTypes][2]; //! bins with at least one track
+  // 2D [t], same layout with the global bin of the 2D profiles:
+  std::vector<Double_t> fRe2D[kNTypes]; //! real parts of the 2D p-, q- and r-vectors
+  std::vector<Double_t> fIm2D[kNTypes]; //! imaginary parts of the 2D p-, q- and r-vectors
+  std::vector<Double_t> fS2D[kNTypes]; //! 2D s_{p,k} before the power p+1
+  std::vector<Double_t> fEntries2D[kNTypes]; //! number of tracks per bin
+  std::vector<Int_t> fTouched2D[kNTypes]; //! bins with at least one track
+
+  ClassDef(AliFlowQVectorAccumulator, 1);
+};
+
+#endif
@@ -39,6 +39,7 @@
 #pragma link C++ class AliFlowAnalysisWithLeeYangZeros+;
 #pragma link C++ class AliFlowAnalysisWithCumulants+;
 #pragma link C++ class AliFlowAnalysisWithQCumulants+;
+#pragma link C++ class AliFlowQVectorAccumulator+;
 #pragma link C++ class AliFlowAnalysisWithFittingQDistribution+;
 #pragma link C++ class AliFlowAnalysisWithMixedHarmonics+;
 #pragma link C++ class AliFlowAnalysisWithNestedLoops+;
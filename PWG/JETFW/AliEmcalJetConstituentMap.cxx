@@ -0,0 +1,110 @@
+/************************************************************************************
+ * Copyright (C) 2019, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <algorithm>
+#include "AliEmcalJetConstituentMap.h"
+
+/// \cond CLASSIMP
+ClassImp(PWG::JETFW::AliEmcalJetConstituentMap)
+/// \endcond
+
+namespace PWG {
+
+namespace JETFW {
+
+AliEmcalJetConstituentMap::AliEmcalJetConstituentMap():
+  fJet(nullptr),
+  fSlotID(64, 0),
+  fSlotFirst(64, -1),
+  fSlotLast(64, -1),
+  fID(),
+  fNext(),
+  fPt(),
+  fFraction()
+{
+
+}
+
+void AliEmcalJetConstituentMap::Clear() {
+  fJet = nullptr;
+  std::fill(fSlotFirst.begin(), fSlotFirst.end(), -1);
+  fID.clear();
+  fNext.clear();
+  fPt.clear();
+  fFraction.clear();
+}
+
+Int_t AliEmcalJetConstituentMap::Add(Int_t id, Double_t pt, Double_t fraction) {
+  // keep the table at most half full
+  if (2 * (fID.size() + 1) > fSlotFirst.size()) Rehash(2 * fSlotFirst.size());
+
+  Int_t entry = fID.size();
+  fID.push_back(id);
+  fPt.push_back(pt);
+  fFraction.push_back(fraction);
+  fNext.push_back(-1);
+
+  Int_t slot = GetSlot(id);
+  if (fSlotFirst[slot] < 0) {
+    fSlotID[slot] = id;
+    fSlotFirst[slot] = entry;
+  } else {
+    // ID already known: append to the chain, such that entries are returned in the order they were added
+    fNext[fSlotLast[slot]] = entry;
+  }
+  fSlotLast[slot] = entry;
+  return entry;
+}
+
+Int_t AliEmcalJetConstituentMap::Find(Int_t id) const {
+  return fSlotFirst[GetSlot(id)];
+}
+
+Int_t AliEmcalJetConstituentMap::GetSlot(Int_t id) const {
+  // multiplicative hashing, linear probing until the ID or an empty slot is found
+  const UInt_t mask = fSlotFirst.size() - 1;
+  UInt_t slot = (static_cast<UInt_t>(id) * 2654435761u) & mask;
+  while (fSlotFirst[slot] >= 0 && fSlotID[slot] != id) slot = (slot + 1) & mask;
+  return slot;
+}
+
+void AliEmcalJetConstituentMap::Rehash(Int_t nslots) {
+  fSlotID.assign(nslots, 0);
+  fSlotFirst.assign(nslots, -1);
+  fSlotLast.assign(nslots, -1);
+  for (UInt_t entry = 0; entry < fID.size(); entry++) {
+    Int_t slot = GetSlot(fID[entry]);
+    if (fSlotFirst[slot] < 0) {
+      fSlotID[slot] = fID[entry];
+      fSlotFirst[slot] = entry;
+    }
+    fSlotLast[slot] = entry;
+  }
+}
+
+}
+
+}
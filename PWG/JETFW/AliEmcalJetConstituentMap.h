@@ -0,0 +1,149 @@
+/************************************************************************************
+ * Copyright (C) 2019, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALJETCONSTITUENTMAP_H
+#define ALIEMCALJETCONSTITUENTMAP_H
+
+#include <Rtypes.h>
+#include <vector>
+
+class AliEmcalJet;
+
+namespace PWG {
+
+namespace JETFW {
+
+/**
+ * @class AliEmcalJetConstituentMap
+ * @brief Hash map of the constituent IDs of a jet, for the calculation of the shared momentum of two jets
+ * @ingroup JETFW
+ * @since Oct 16, 2019
+ *
+ * The constituents of a reference jet are stored with their ID (i.e. the global
+ * track index, the cluster index or the index of the associated MC particle),
+ * their transverse momentum and a fraction (i.e. the cell amplitude fraction).
+ * The constituents of a second jet can then be looked up in constant time, which
+ * replaces the loop over the constituents of the reference jet for each constituent
+ * of the second jet. The IDs are stored in a flat hash table with open addressing,
+ * which is reused from jet to jet without memory allocations. Several entries can have the same ID (i.e. several tracks
+ * or cells associated to the same MC particle): they are chained and returned
+ * in the order in which they were added, such that sums over them are identical
+ * to the ones of a loop over all constituents.
+ *
+ * ~~~{.cxx}
+ * PWG::JETFW::AliEmcalJetConstituentMap map;
+ * map.SetJet(jet1);
+ * for(int itrk = 0; itrk < jet1->GetNumberOfTracks(); itrk++) map.Add(jet1->TrackAt(itrk), jet1->Track(itrk)->Pt());
+ * double sharedPt = 0;
+ * for(int itrk = 0; itrk < jet2->GetNumberOfTracks(); itrk++) {
+ *   for(int entry = map.Find(jet2->TrackAt(itrk)); entry >= 0; entry = map.Next(entry)) sharedPt += map.GetPt(entry);
+ * }
+ * ~~~
+ */
+class AliEmcalJetConstituentMap {
+public:
+  /**
+   * @brief Constructor
+   */
+  AliEmcalJetConstituentMap();
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~AliEmcalJetConstituentMap() {}
+
+  /**
+   * @brief Remove all entries and the reference jet
+   */
+  void Clear();
+
+  /**
+   * @brief Add a constituent
+   * @param[in] id ID of the constituent
+   * @param[in] pt Transverse momentum (or energy) of the constituent
+   * @param[in] fraction Fraction of the constituent (i.e. amplitude fraction of a cell)
+   * @return Index of the new entry
+   */
+  Int_t Add(Int_t id, Double_t pt, Double_t fraction = 1.);
+
+  /**
+   * @brief Find the first entry with a given ID
+   * @param[in] id ID of the constituent
+   * @return Index of the first entry with this ID, -1 if not found
+   */
+  Int_t Find(Int_t id) const;
+
+  /**
+   * @brief Next entry with the same ID
+   * @param[in] entry Index of an entry
+   * @return Index of the next entry with the same ID, -1 if there is none
+   */
+  Int_t Next(Int_t entry) const { return fNext[entry]; }
+
+  Double_t GetPt(Int_t entry) const { return fPt[entry]; }
+  Double_t GetFraction(Int_t entry) const { return fFraction[entry]; }
+  Int_t GetNumberOfEntries() const { return fPt.size(); }
+
+  /**
+   * @brief Set the jet the constituents belong to
+   *
+   * The jet is only used to check whether the map has to be refilled
+   * (see IsJet), it is not accessed.
+   *
+   * @param[in] jet Reference jet
+   */
+  void SetJet(const AliEmcalJet *jet) { fJet = jet; }
+
+  /**
+   * @brief Check whether the map contains the constituents of a given jet
+   * @param[in] jet Jet to check
+   * @return True if the jet is the reference jet of the map
+   */
+  Bool_t IsJet(const AliEmcalJet *jet) const { return jet && jet == fJet; }
+
+private:
+  Int_t GetSlot(Int_t id) const;
+  void Rehash(Int_t nslots);
+
+  const AliEmcalJet                      *fJet;       //!<! Reference jet
+  std::vector<Int_t>                      fSlotID;    //!<! ID stored in each slot of the hash table
+  std::vector<Int_t>                      fSlotFirst; //!<! First entry with the ID of the slot (-1 for empty slots)
+  std::vector<Int_t>                      fSlotLast;  //!<! Last entry with the ID of the slot
+  std::vector<Int_t>                      fID;        //!<! ID of the entries
+  std::vector<Int_t>                      fNext;      //!<! Next entry with the same ID
+  std::vector<Double_t>                   fPt;        //!<! Transverse momentum of the entries
+  std::vector<Double_t>                   fFraction;  //!<! Fraction of the entries
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalJetConstituentMap, 1);
+  /// \endcond
+};
+
+}
+
+}
+
+#endif /* ALIEMCALJETCONSTITUENTMAP_H */
@@ -0,0 +1,365 @@
+/************************************************************************************
+ * Copyright (C) 2019, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#include <iostream>
+#include <TMath.h>
+#include <TRandom3.h>
+#include <TStopwatch.h>
+#include <TVector2.h>
+#include "AliEmcalJet.h"
+#include "AliEmcalJetMatcher.h"
+
+/// \cond CLASSIMP
+ClassImp(PWG::JETFW::AliEmcalJetMatcher)
+ClassImp(PWG::JETFW::TestAliEmcalJetMatcher)
+/// \endcond
+
+using namespace PWG::JETFW;
+
+AliEmcalJetMatcher::AliEmcalJetMatcher():
+  fGrid(),
+  fJets(nullptr),
+  fEta(),
+  fPhi(),
+  fCandidates(),
+  fDistance1(),
+  fDistance2()
+{
+}
+
+void AliEmcalJetMatcher::SetJets(const std::vector<AliEmcalJet *> &jets, Double_t maxDistance) {
+  fJets = &jets;
+  fEta.resize(jets.size());
+  fPhi.resize(jets.size());
+  for(UInt_t ijet = 0; ijet < jets.size(); ijet++) {
+    fEta[ijet] = jets[ijet]->Eta();
+    fPhi[ijet] = jets[ijet]->Phi();
+  }
+  fGrid.Build(jets.size(), fEta.data(), fPhi.data(), maxDistance);
+}
+
+void AliEmcalJetMatcher::FindCandidates(const AliEmcalJet *jet, std::vector<Int_t> &candidates) const {
+  fGrid.FindCandidates(jet->Eta(), jet->Phi(), candidates);
+}
+
+Int_t AliEmcalJetMatcher::MatchGeometrical(const std::vector<AliEmcalJet *> &jets1, const std::vector<AliEmcalJet *> &jets2, Double_t maxDistance, std::vector<Int_t> &match1, std::vector<Int_t> &match2) {
+  match1.assign(jets1.size(), -1);
+  match2.assign(jets2.size(), -1);
+  if(jets1.empty() || jets2.empty()) return 0;
+
+  // closest jet within the maximum distance, in both directions. Jets are tested
+  // in ascending order, so for equal distances the first jet is kept as in a loop over all jets.
+  SetJets(jets2, maxDistance);
+  fDistance1.assign(jets1.size(), maxDistance);
+  fDistance2.assign(jets2.size(), maxDistance);
+  for(UInt_t ijet1 = 0; ijet1 < jets1.size(); ijet1++) {
+    FindCandidates(jets1[ijet1], fCandidates);
+    for(auto ijet2 : fCandidates) {
+      Double_t distance = jets1[ijet1]->DeltaR(jets2[ijet2]);
+      if(distance < fDistance1[ijet1]) {
+        fDistance1[ijet1] = distance;
+        match1[ijet1] = ijet2;
+      }
+      if(distance < fDistance2[ijet2]) {
+        fDistance2[ijet2] = distance;
+        match2[ijet2] = ijet1;
+      }
+    }
+  }
+
+  // keep only pairs where each jet is the closest jet of the other
+  Int_t nmatched = 0;
+  for(UInt_t ijet1 = 0; ijet1 < jets1.size(); ijet1++) {
+    if(match1[ijet1] < 0) continue;
+    if(match2[match1[ijet1]] == static_cast<Int_t>(ijet1)) nmatched++;
+    else match1[ijet1] = -1;
+  }
+  for(UInt_t ijet2 = 0; ijet2 < jets2.size(); ijet2++) {
+    if(match2[ijet2] >= 0 && match1[match2[ijet2]] != static_cast<Int_t>(ijet2)) match2[ijet2] = -1;
+  }
+  fJets = nullptr;
+  return nmatched;
+}
+
+Int_t AliEmcalJetMatcher::MatchGeometrical(const std::vector<std::vector<AliEmcalJet *> > &collections, Double_t maxDistance, std::vector<std::vector<Int_t> > &matches) {
+  matches.clear();
+  if(collections.size() < 2) return 0;
+  matches.resize(collections.size() - 1);
+  std::vector<Int_t> reverse;
+  for(UInt_t icoll = 0; icoll < collections.size() - 1; icoll++) {
+    MatchGeometrical(collections[icoll], collections[icoll + 1], maxDistance, matches[icoll], reverse);
+  }
+
+  Int_t nchains = 0;
+  for(UInt_t ijet = 0; ijet < collections[0].size(); ijet++) {
+    Int_t index = ijet;
+    for(UInt_t icoll = 0; icoll < matches.size() && index >= 0; icoll++) index = matches[icoll][index];
+    if(index >= 0) nchains++;
+  }
+  return nchains;
+}
+
+bool TestAliEmcalJetMatcher::RunAllTests() const {
+  return TestGeometricalMatching() && TestSharedPt();
+}
+
+bool TestAliEmcalJetMatcher::TestGeometricalMatching() const {
+  const Double_t distances[] = {0.1, 0.3, 0.6};
+  AliEmcalJetMatcher matcher;
+  std::vector<Int_t> match1, match2, loop1, loop2;
+  std::vector<std::vector<Int_t> > matches;
+  int failure(0);
+  for(UInt_t ievent = 0; ievent < 100; ievent++) {
+    SyntheticEvent_t event;
+    GenerateEvent(ievent + 1, event);
+    for(auto maxdist : distances) {
+      // all pairs of collections
+      for(UInt_t icoll1 = 0; icoll1 < event.fCollections.size(); icoll1++) {
+        for(UInt_t icoll2 = 0; icoll2 < event.fCollections.size(); icoll2++) {
+          if(icoll1 == icoll2) continue;
+          Int_t nmatched = matcher.MatchGeometrical(event.fCollections[icoll1], event.fCollections[icoll2], maxdist, match1, match2),
+                nloop = MatchLoop(event.fCollections[icoll1], event.fCollections[icoll2], maxdist, loop1);
+          MatchLoop(event.fCollections[icoll2], event.fCollections[icoll1], maxdist, loop2);
+          if(nmatched != nloop || match1 != loop1 || match2 != loop2) failure++;
+        }
+      }
+
+      // chain particle level - detector level - embedded
+      Int_t nchains = matcher.MatchGeometrical(event.fCollections, maxdist, matches), nloop = 0;
+      MatchLoop(event.fCollections[0], event.fCollections[1], maxdist, loop1);
+      MatchLoop(event.fCollections[1], event.fCollections[2], maxdist, loop2);
+      for(auto index : loop1) {
+        if(index >= 0 && loop2[index] >= 0) nloop++;
+      }
+      if(matches.size() != 2 || matches[0] != loop1 || matches[1] != loop2 || nchains != nloop) failure++;
+    }
+    DeleteEvent(event);
+  }
+  return failure == 0;
+}
+
+bool TestAliEmcalJetMatcher::TestSharedPt() const {
+  AliEmcalJetConstituentMap map;
+  int failure(0);
+  for(UInt_t ievent = 0; ievent < 20; ievent++) {
+    SyntheticEvent_t event;
+    GenerateEvent(ievent + 1000, event);
+    // detector level vs. embedded and particle level vs. detector level, all pairs
+    for(UInt_t icoll = 0; icoll < 2; icoll++) {
+      for(auto jet1 : event.fCollections[icoll + 1]) {
+        for(auto jet2 : event.fCollections[icoll]) {
+          if(SharedPtMap(map, jet1, jet2, event.fConstituentPt) != SharedPtLoop(jet1, jet2, event.fConstituentPt)) failure++;
+        }
+      }
+    }
+    DeleteEvent(event);
+  }
+  return failure == 0;
+}
+
+void TestAliEmcalJetMatcher::RunBenchmark(Int_t nevents) const {
+  const Double_t maxdist = 0.3;
+  std::vector<SyntheticEvent_t> events(nevents);
+  Int_t njets[3] = {0, 0, 0};
+  for(Int_t ievent = 0; ievent < nevents; ievent++) {
+    GenerateEvent(ievent + 1, events[ievent]);
+    for(Int_t icoll = 0; icoll < 3; icoll++) njets[icoll] += events[ievent].fCollections[icoll].size();
+  }
+
+  AliEmcalJetMatcher matcher;
+  AliEmcalJetConstituentMap map;
+  std::vector<Int_t> match1, match2;
+  std::vector<std::vector<Int_t> > matches;
+  TStopwatch timer;
+  Long64_t nloop(0), nmatcher(0);
+  Double_t sumloop(0.), summap(0.);
+
+  timer.Start();
+  for(auto &event : events) {
+    nloop += MatchLoop(event.fCollections[0], event.fCollections[1], maxdist, match1);
+    nloop += MatchLoop(event.fCollections[1], event.fCollections[0], maxdist, match2);
+    nloop += MatchLoop(event.fCollections[1], event.fCollections[2], maxdist, match1);
+    nloop += MatchLoop(event.fCollections[2], event.fCollections[1], maxdist, match2);
+  }
+  timer.Stop();
+  Double_t timeMatchLoop = timer.RealTime();
+
+  timer.Start();
+  for(auto &event : events) {
+    matcher.MatchGeometrical(event.fCollections, maxdist, matches);
+    for(auto &match : matches) {
+      for(auto index : match) if(index >= 0) nmatcher += 2;
+    }
+  }
+  timer.Stop();
+  Double_t timeMatcher = timer.RealTime();
+
+  // shared momentum for all pairs of detector level and embedded jets (as for the matching by shared constituents)
+  timer.Start();
+  for(auto &event : events) {
+    for(auto jet1 : event.fCollections[2]) {
+      for(auto jet2 : event.fCollections[1]) sumloop += SharedPtLoop(jet1, jet2, event.fConstituentPt);
+    }
+  }
+  timer.Stop();
+  Double_t timeSharedLoop = timer.RealTime();
+
+  timer.Start();
+  for(auto &event : events) {
+    for(auto jet1 : event.fCollections[2]) {
+      for(auto jet2 : event.fCollections[1]) summap += SharedPtMap(map, jet1, jet2, event.fConstituentPt);
+    }
+    map.Clear();
+  }
+  timer.Stop();
+  Double_t timeSharedMap = timer.RealTime();
+
+  std::cout << "Events: " << nevents << ", jets per event: particle level " << Double_t(njets[0]) / nevents
+            << ", detector level " << Double_t(njets[1]) / nevents << ", embedded " << Double_t(njets[2]) / nevents << std::endl;
+  std::cout << "Geometrical matching, loop:      " << timeMatchLoop << " s, matched jets " << nloop << std::endl;
+  std::cout << "Geometrical matching, matcher:   " << timeMatcher << " s, matched jets " << nmatcher << std::endl;
+  std::cout << "Shared pt, loop:                 " << timeSharedLoop << " s, sum " << sumloop << std::endl;
+  std::cout << "Shared pt, constituent map:      " << timeSharedMap << " s, sum " << summap << std::endl;
+
+  for(auto &event : events) DeleteEvent(event);
+}
+
+void TestAliEmcalJetMatcher::GenerateEvent(UInt_t seed, SyntheticEvent_t &event) const {
+  TRandom3 rnd(seed);
+  event.fConstituentPt.clear();
+  event.fCollections.assign(3, std::vector<AliEmcalJet *>());
+  std::vector<std::vector<Int_t> > particleConstituents;
+
+  auto addJet = [](std::vector<AliEmcalJet *> &collection, Double_t pt, Double_t eta, Double_t phi, const std::vector<Int_t> &constituents) {
+    AliEmcalJet *jet = new AliEmcalJet(pt, eta, TVector2::Phi_0_2pi(phi), 0.);
+    jet->SetNumberOfTracks(constituents.size());
+    for(UInt_t iconst = 0; iconst < constituents.size(); iconst++) jet->AddTrackAt(constituents[iconst], iconst);
+    collection.push_back(jet);
+  };
+  auto addConstituents = [&rnd, &event](Int_t nconst, Double_t meanpt, std::vector<Int_t> &constituents) {
+    for(Int_t iconst = 0; iconst < nconst; iconst++) {
+      constituents.push_back(event.fConstituentPt.size());
+      event.fConstituentPt.push_back(rnd.Exp(meanpt));
+    }
+  };
+
+  // particle level: few hard jets
+  Int_t nsignal = 1 + rnd.Poisson(4);
+  for(Int_t ijet = 0; ijet < nsignal; ijet++) {
+    Double_t pt = 10. + rnd.Exp(20.), eta = rnd.Uniform(-0.5, 0.5), phi = rnd.Uniform(0., TMath::TwoPi());
+    std::vector<Int_t> constituents;
+    addConstituents(5 + rnd.Poisson(10), pt / 10., constituents);
+    addJet(event.fCollections[0], pt, eta, phi, constituents);
+    particleConstituents.push_back(constituents);
+  }
+
+  // detector level: efficiency loss, smeared axis and momentum
+  for(Int_t ijet = 0; ijet < nsignal; ijet++) {
+    const AliEmcalJet *part = event.fCollections[0][ijet];
+    if(rnd.Uniform() > 0.9) continue;
+    std::vector<Int_t> constituents;
+    for(auto index : particleConstituents[ijet]) {
+      if(rnd.Uniform() < 0.85) constituents.push_back(index);
+    }
+    addJet(event.fCollections[1], part->Pt() * rnd.Gaus(0.9, 0.1), part->Eta() + rnd.Gaus(0., 0.03), part->Phi() + rnd.Gaus(0., 0.03), constituents);
+  }
+
+  // embedded: detector level jets with background constituents, plus the jets of the underlying Pb-Pb event
+  for(auto det : event.fCollections[1]) {
+    std::vector<Int_t> constituents;
+    for(Int_t iconst = 0; iconst < det->GetNumberOfTracks(); iconst++) constituents.push_back(det->TrackAt(iconst));
+    addConstituents(rnd.Poisson(20), 1., constituents);
+    addJet(event.fCollections[2], det->Pt() + rnd.Gaus(20., 10.), det->Eta() + rnd.Gaus(0., 0.05), det->Phi() + rnd.Gaus(0., 0.05), constituents);
+  }
+  Int_t nbackground = rnd.Poisson(100);
+  for(Int_t ijet = 0; ijet < nbackground; ijet++) {
+    std::vector<Int_t> constituents;
+    addConstituents(5 + rnd.Poisson(15), 1., constituents);
+    addJet(event.fCollections[2], rnd.Exp(20.), rnd.Uniform(-0.5, 0.5), rnd.Uniform(0., TMath::TwoPi()), constituents);
+  }
+}
+
+void TestAliEmcalJetMatcher::DeleteEvent(SyntheticEvent_t &event) const {
+  for(auto &collection : event.fCollections) {
+    for(auto jet : collection) delete jet;
+    collection.clear();
+  }
+  event.fConstituentPt.clear();
+}
+
+Int_t TestAliEmcalJetMatcher::MatchLoop(const std::vector<AliEmcalJet *> &jets1, const std::vector<AliEmcalJet *> &jets2, Double_t maxDistance, std::vector<Int_t> &match1) const {
+  std::vector<Int_t> closest1(jets1.size(), -1), closest2(jets2.size(), -1);
+  std::vector<Double_t> distance1(jets1.size(), 1e9), distance2(jets2.size(), 1e9);
+  for(UInt_t ijet1 = 0; ijet1 < jets1.size(); ijet1++) {
+    for(UInt_t ijet2 = 0; ijet2 < jets2.size(); ijet2++) {
+      Double_t distance = jets1[ijet1]->DeltaR(jets2[ijet2]);
+      if(distance < distance1[ijet1]) {
+        distance1[ijet1] = distance;
+        closest1[ijet1] = ijet2;
+      }
+      if(distance < distance2[ijet2]) {
+        distance2[ijet2] = distance;
+        closest2[ijet2] = ijet1;
+      }
+    }
+  }
+  Int_t nmatched = 0;
+  match1.assign(jets1.size(), -1);
+  for(UInt_t ijet1 = 0; ijet1 < jets1.size(); ijet1++) {
+    Int_t ijet2 = closest1[ijet1];
+    if(ijet2 < 0 || closest2[ijet2] != static_cast<Int_t>(ijet1) || distance1[ijet1] >= maxDistance) continue;
+    match1[ijet1] = ijet2;
+    nmatched++;
+  }
+  return nmatched;
+}
+
+Double_t TestAliEmcalJetMatcher::SharedPtLoop(const AliEmcalJet *jet1, const AliEmcalJet *jet2, const std::vector<Double_t> &constituentPt) const {
+  Double_t shared = 0.;
+  for(Int_t itrack2 = 0; itrack2 < jet2->GetNumberOfTracks(); itrack2++) {
+    for(Int_t itrack1 = 0; itrack1 < jet1->GetNumberOfTracks(); itrack1++) {
+      if(jet1->TrackAt(itrack1) == jet2->TrackAt(itrack2)) {
+        shared += constituentPt[jet1->TrackAt(itrack1)];
+        break;
+      }
+    }
+  }
+  return shared;
+}
+
+Double_t TestAliEmcalJetMatcher::SharedPtMap(AliEmcalJetConstituentMap &map, const AliEmcalJet *jet1, const AliEmcalJet *jet2, const std::vector<Double_t> &constituentPt) const {
+  if(!map.IsJet(jet1)) {
+    map.Clear();
+    map.SetJet(jet1);
+    for(Int_t itrack1 = 0; itrack1 < jet1->GetNumberOfTracks(); itrack1++) map.Add(jet1->TrackAt(itrack1), constituentPt[jet1->TrackAt(itrack1)]);
+  }
+  Double_t shared = 0.;
+  for(Int_t itrack2 = 0; itrack2 < jet2->GetNumberOfTracks(); itrack2++) {
+    Int_t entry = map.Find(jet2->TrackAt(itrack2));
+    if(entry >= 0) shared += map.GetPt(entry);
+  }
+  return shared;
+}
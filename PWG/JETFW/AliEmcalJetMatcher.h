@@ -0,0 +1,227 @@
+/************************************************************************************
+ * Copyright (C) 2019, Copyright Holders of the ALICE Collaboration                 *
+ * All rights reserved.                                                             *
+ *                                                                                  *
+ * Redistribution and use in source and binary forms, with or without               *
+ * modification, are permitted provided that the following conditions are met:      *
+ *     * Redistributions of source code must retain the above copyright             *
+ *       notice, this list of conditions and the following disclaimer.              *
+ *     * Redistributions in binary form must reproduce the above copyright          *
+ *       notice, this list of conditions and the following disclaimer in the        *
+ *       documentation and/or other materials provided with the distribution.       *
+ *     * Neither the name of the <organization> nor the                             *
+ *       names of its contributors may be used to endorse or promote products       *
+ *       derived from this software without specific prior written permission.      *
+ *                                                                                  *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND  *
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED    *
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE           *
+ * DISCLAIMED. IN NO EVENT SHALL ALICE COLLABORATION BE LIABLE FOR ANY              *
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES       *
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;     *
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND      *
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT       *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS    *
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.                     *
+ ************************************************************************************/
+#ifndef ALIEMCALJETMATCHER_H
+#define ALIEMCALJETMATCHER_H
+
+#include <TObject.h>
+#include <vector>
+#include "AliEmcalEtaPhiGrid.h"
+#include "AliEmcalJetConstituentMap.h"
+
+class AliEmcalJet;
+
+namespace PWG {
+
+namespace JETFW {
+
+/**
+ * @class AliEmcalJetMatcher
+ * @brief Geometrical matching of jet collections based on a spatial index in (\f$\eta\f$, \f$\phi\f$)
+ * @ingroup JETFW
+ * @since Oct 16, 2019
+ *
+ * The jets of the collection to be searched are sorted into a grid in
+ * (\f$\eta\f$, \f$\phi\f$) (see PWG::EMCAL::AliEmcalEtaPhiGrid) with the maximum
+ * matching distance as cell size. For a given jet only the jets in the neighbouring
+ * cells are tested, instead of all jets of the collection, which makes the matching
+ * linear in the number of jets instead of quadratic.
+ *
+ * Two collections are matched bijectively: a pair is matched if each jet is the
+ * closest jet (\f$\Delta R\f$, see AliEmcalJet::DeltaR) of the other, and the
+ * distance is smaller than the maximum distance. For equal distances the jet with
+ * the lower index is taken as closest jet, as in a loop over all jets. More than two
+ * collections (i.e. particle level, detector level and embedded detector level) are
+ * matched as a chain, each collection to the following one.
+ *
+ * ~~~{.cxx}
+ * PWG::JETFW::AliEmcalJetMatcher matcher;
+ * std::vector<int> matchBase, matchTag;
+ * matcher.MatchGeometrical(jetsBase, jetsTag, 0.3, matchBase, matchTag);
+ * for(int ibase = 0; ibase < jetsBase.size(); ibase++) {
+ *   if(matchBase[ibase] < 0) continue;
+ *   AliEmcalJet *tag = jetsTag[matchBase[ibase]];
+ * }
+ * ~~~
+ *
+ * The shared momentum of matched jets can be calculated with AliEmcalJetConstituentMap.
+ */
+class AliEmcalJetMatcher {
+public:
+  /**
+   * @brief Constructor
+   */
+  AliEmcalJetMatcher();
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~AliEmcalJetMatcher() {}
+
+  /**
+   * @brief Build the spatial index for a jet collection
+   *
+   * The index is used by FindCandidates. The jets are not copied, the
+   * vector must stay valid as long as candidates are searched.
+   *
+   * @param[in] jets Jets to be indexed
+   * @param[in] maxDistance Maximum matching distance
+   */
+  void SetJets(const std::vector<AliEmcalJet *> &jets, Double_t maxDistance);
+
+  /**
+   * @brief Find jets of the indexed collection which can be within the maximum distance of a jet
+   *
+   * Candidates can be at larger distance, the distance itself must be checked
+   * by the user.
+   *
+   * @param[in] jet Jet for which the candidates are searched
+   * @param[out] candidates Indices of the candidate jets, in ascending order
+   */
+  void FindCandidates(const AliEmcalJet *jet, std::vector<Int_t> &candidates) const;
+
+  /**
+   * @brief Bijective geometrical matching of two jet collections
+   * @param[in] jets1 First jet collection
+   * @param[in] jets2 Second jet collection
+   * @param[in] maxDistance Maximum distance of matched jets (\f$\Delta R\f$ < maxDistance)
+   * @param[out] match1 Index of the matched jet in jets2 for each jet in jets1 (-1 if not matched)
+   * @param[out] match2 Index of the matched jet in jets1 for each jet in jets2 (-1 if not matched)
+   * @return Number of matched pairs
+   */
+  Int_t MatchGeometrical(const std::vector<AliEmcalJet *> &jets1, const std::vector<AliEmcalJet *> &jets2, Double_t maxDistance, std::vector<Int_t> &match1, std::vector<Int_t> &match2);
+
+  /**
+   * @brief Bijective geometrical matching of a chain of jet collections
+   *
+   * Each collection is matched to the following one in the list.
+   *
+   * @param[in] collections Jet collections
+   * @param[in] maxDistance Maximum distance of matched jets (\f$\Delta R\f$ < maxDistance)
+   * @param[out] matches For each collection except the last one: index of the matched jet in the following collection (-1 if not matched)
+   * @return Number of jets of the first collection matched through the full chain
+   */
+  Int_t MatchGeometrical(const std::vector<std::vector<AliEmcalJet *> > &collections, Double_t maxDistance, std::vector<std::vector<Int_t> > &matches);
+
+private:
+  PWG::EMCAL::AliEmcalEtaPhiGrid          fGrid;              //!<! Spatial index of the jets
+  const std::vector<AliEmcalJet *>       *fJets;              //!<! Indexed jets
+  std::vector<Double_t>                   fEta;               //!<! Buffer for the jet pseudorapidities
+  std::vector<Double_t>                   fPhi;               //!<! Buffer for the jet azimuthal angles
+  std::vector<Int_t>                      fCandidates;        //!<! Buffer for the candidates
+  std::vector<Double_t>                   fDistance1;         //!<! Distance to the closest jet, first collection
+  std::vector<Double_t>                   fDistance2;         //!<! Distance to the closest jet, second collection
+
+  /// \cond CLASSIMP
+  ClassDef(AliEmcalJetMatcher, 1);
+  /// \endcond
+};
+
+/**
+ * @class TestAliEmcalJetMatcher
+ * @brief Unit test and benchmark for AliEmcalJetMatcher and AliEmcalJetConstituentMap
+ * @ingroup JETFW
+ * @since Oct 16, 2019
+ *
+ * The tests and the benchmark run on synthetic embedded Pb-Pb-like events:
+ * particle level jets, detector level jets sharing most of the constituents with
+ * smeared axes, and embedded jets consisting of the detector level jets with additional
+ * background constituents plus a large number of background jets. The results are
+ * compared to the ones of loops over all jets and all constituents.
+ *
+ * ~~~{.cxx}
+ * PWG::JETFW::TestAliEmcalJetMatcher test;
+ * test.RunAllTests();
+ * test.RunBenchmark(1000);
+ * ~~~
+ */
+class TestAliEmcalJetMatcher : public TObject {
+public:
+  /**
+   * @brief Constructor
+   */
+  TestAliEmcalJetMatcher() {}
+
+  /**
+   * @brief Destructor
+   */
+  virtual ~TestAliEmcalJetMatcher() {}
+
+  /**
+   * @brief Run test suite
+   * @return true All tests passed
+   * @return false At least one test failed
+   */
+  bool RunAllTests() const;
+
+  /**
+   * @brief Test that the geometrical matching of two and three collections is the
+   * same as the one of loops over all jets
+   * @return true Test passed
+   * @return false Test failed
+   */
+  bool TestGeometricalMatching() const;
+
+  /**
+   * @brief Test that the shared momentum obtained with the constituent map is the
+   * same as the one of loops over the constituents of both jets
+   * @return true Test passed
+   * @return false Test failed
+   */
+  bool TestSharedPt() const;
+
+  /**
+   * @brief Compare the timing of the matcher and the constituent map to the one of loops
+   * @param[in] nevents Number of synthetic events
+   */
+  void RunBenchmark(Int_t nevents = 1000) const;
+
+private:
+  /**
+   * @struct SyntheticEvent_t
+   * @brief Jet collections of a synthetic embedded event
+   */
+  struct SyntheticEvent_t {
+    std::vector<Double_t>                   fConstituentPt;       ///< Transverse momentum of all constituents of the event
+    std::vector<std::vector<AliEmcalJet *> > fCollections;        ///< Particle level, detector level and embedded jets
+  };
+
+  void GenerateEvent(UInt_t seed, SyntheticEvent_t &event) const;
+  void DeleteEvent(SyntheticEvent_t &event) const;
+  Int_t MatchLoop(const std::vector<AliEmcalJet *> &jets1, const std::vector<AliEmcalJet *> &jets2, Double_t maxDistance, std::vector<Int_t> &match1) const;
+  Double_t SharedPtLoop(const AliEmcalJet *jet1, const AliEmcalJet *jet2, const std::vector<Double_t> &constituentPt) const;
+  Double_t SharedPtMap(AliEmcalJetConstituentMap &map, const AliEmcalJet *jet1, const AliEmcalJet *jet2, const std::vector<Double_t> &constituentPt) const;
+
+  /// \cond CLASSIMP
+  ClassDef(TestAliEmcalJetMatcher, 1);
+  /// \endcond
+};
+
+}
+
+}
+
+#endif /* ALIEMCALJETMATCHER_H */
@@ -21,5 +21,8 @@
 #pragma link C++ class PWG::JETFW::AliEmcalJetConstituent+;
 #pragma link C++ class PWG::JETFW::AliEmcalParticleJetConstituent+;
 #pragma link C++ class PWG::JETFW::AliEmcalClusterJetConstituent+;
+#pragma link C++ class PWG::JETFW::AliEmcalJetConstituentMap+;
+#pragma link C++ class PWG::JETFW::AliEmcalJetMatcher+;
+#pragma link C++ class PWG::JETFW::TestAliEmcalJetMatcher+;
 
 #endif
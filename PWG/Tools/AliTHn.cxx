@@ -40,8 +40,90 @@
 #include "THnSparse.h"
 #include "TMath.h"
 
+#include <vector>
+
 templateClassImp(AliTHnT)
 
+// Binning of one axis for AliTHnT::Fill
+//
+// FindBin gives the same result as TAxis::FindBin. For equidistant axes the bin
+// is calculated with the same arithmetic as in TAxis. For axes with variable bin
+// widths a lookup table with a fixed number of equidistant cells gives the first
+// candidate bin for each cell, which is then corrected by comparing with the
+// neighbouring bin edges (in general no or one step) instead of a binary search
+// over all bin edges.
+class AliTHnAxisDescriptor
+{
+public:
+  AliTHnAxisDescriptor() : fNbins(0), fXmin(0), fXmax(0), fEdges(0), fLookupScale(0), fLookup() { }
+
+  void Init(const TAxis* axis)
+  {
+    fNbins = axis->GetNbins();
+    fXmin = axis->GetXmin();
+    fXmax = axis->GetXmax();
+    fEdges = (axis->GetXbins()->GetSize() > 0) ? axis->GetXbins()->GetArray() : 0;
+    fLookup.clear();
+    fLookupScale = 0;
+    if (!fEdges || fXmax <= fXmin)
+      return;
+
+    fLookup.resize(kLookupCellsPerBin * fNbins);
+    fLookupScale = fLookup.size() / (fXmax - fXmin);
+    for (UInt_t i=0; i<fLookup.size(); i++)
+      fLookup[i] = 1 + TMath::BinarySearch(fNbins+1, fEdges, fXmin + i / fLookupScale);
+  }
+
+  Int_t GetNbins() const { return fNbins; }
+
+  Int_t FindBin(Double_t x) const
+  {
+    if (x < fXmin)
+      return 0;
+    if (!(x < fXmax))
+      return fNbins + 1;
+    if (!fEdges)
+      return 1 + Int_t(fNbins * (x - fXmin) / (fXmax - fXmin));
+    if (fLookup.empty())
+      return 1 + TMath::BinarySearch(fNbins+1, fEdges, x);
+
+    Int_t cell = Int_t((x - fXmin) * fLookupScale);
+    if (cell < 0)
+      cell = 0;
+    if (cell >= (Int_t) fLookup.size())
+      cell = fLookup.size() - 1;
+
+    Int_t bin = fLookup[cell];
+    while (bin < fNbins && x >= fEdges[bin])
+      bin++;
+    while (bin > 1 && x < fEdges[bin-1])
+      bin--;
+    // TMath::BinarySearch returns the first of several equal bin edges
+    while (bin > 1 && x == fEdges[bin-2])
+      bin--;
+    return bin;
+  }
+
+private:
+  enum { kLookupCellsPerBin = 4 };
+
+  Int_t fNbins;                // number of bins
+  Double_t fXmin;              // lower edge of the axis
+  Double_t fXmax;              // upper edge of the axis
+  const Double_t* fEdges;      // bin edges of axes with variable bin width (owned by the TAxis), 0 for equidistant axes
+  Double_t fLookupScale;       // number of lookup cells per unit of x
+  std::vector<Int_t> fLookup;  // first candidate bin per lookup cell
+};
+
+void AliTHnBase::FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weights)
+{
+  // fills n entries; var contains the variables of entry i at var[i*nVar], weights (optional) the weight of entry i
+  
+  const Int_t nVars = GetNVar();
+  for (Int_t i=0; i<n; i++)
+    Fill(var + i * nVars, istep, (weights) ? weights[i] : 1.);
+}
+
 template <class TemplateArray, typename TemplateType>
 AliTHnT<TemplateArray, TemplateType>::AliTHnT() : 
   AliTHnBase(),
@@ -50,7 +132,7 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT() :
   fNSteps(0),
   fValues(0),
   fSumw2(0),
-  axisCache(0),
+  fAxisDescriptors(0),
   fNbinsCache(0),
   fLastVars(0),
   fLastBins(0)
@@ -66,7 +148,7 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const Char_t* name, const Char_t*
   fNSteps(nSelStep),
   fValues(0),
   fSumw2(0),
-  axisCache(0),
+  fAxisDescriptors(0),
   fNbinsCache(0),
   fLastVars(0),
   fLastBins(0)
@@ -103,7 +185,7 @@ AliTHnT<TemplateArray, TemplateType>::AliTHnT(const AliTHnT &c) :
   fNSteps(c.fNSteps),
   fValues(new TemplateArray*[c.fNSteps]),
   fSumw2(new TemplateArray*[c.fNSteps]),
-  axisCache(0),
+  fAxisDescriptors(0),
   fNbinsCache(0),
   fLastVars(0),
   fLastBins(0)
@@ -131,10 +213,23 @@ AliTHnT<TemplateArray, TemplateType>::~AliTHnT()
   
   delete[] fValues;
   delete[] fSumw2;
-  delete[] axisCache;
+  DeleteAxisCache();
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::DeleteAxisCache()
+{
+  // delete the axis cache, it is recreated by the next Fill
+  
+  delete[] fAxisDescriptors;
   delete[] fNbinsCache;
   delete[] fLastVars;
   delete[] fLastBins;
+  
+  fAxisDescriptors = 0;
+  fNbinsCache = 0;
+  fLastVars = 0;
+  fLastBins = 0;
 }
 
 template <class TemplateArray, typename TemplateType>
@@ -191,9 +286,7 @@ AliTHnT<TemplateArray, TemplateType> &AliTHnT<TemplateArray, TemplateType>::oper
       fValues = 0;
       fSumw2 = 0;
     }
-    delete [] axisCache;
-    axisCache = new TAxis*[fNVars];
-    memcpy(axisCache, c.axisCache, fNVars*sizeof(TAxis*));
+    DeleteAxisCache();
   }
   return *this;
 }
@@ -282,33 +375,34 @@ Long64_t AliTHnT<TemplateArray, TemplateType>::Merge(TCollection* list)
 }
 
 template <class TemplateArray, typename TemplateType>
-void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep, Double_t weight)
+void AliTHnT<TemplateArray, TemplateType>::InitAxisCache(const Double_t *var)
 {
-  // fills an entry
-
-  // fill axis cache
-  if (!axisCache)
+  // fills the axis cache; var are the variables of the first entry
+  
+  fAxisDescriptors = new AliTHnAxisDescriptor[fNVars];
+  fNbinsCache = new Int_t[fNVars];
+  for (Int_t i=0; i<fNVars; i++)
   {
-    axisCache = new TAxis*[fNVars];
-    fNbinsCache = new Int_t[fNVars];
-    for (Int_t i=0; i<fNVars; i++)
-    {
-      axisCache[i] = GetAxis(i, 0);
-      fNbinsCache[i] = axisCache[i]->GetNbins();
-    }
-    
-    fLastVars = new Double_t[fNVars];
-    fLastBins = new Int_t[fNVars];
-    
-    // initial values to prevent checking for 0 below
-    for (Int_t i=0; i<fNVars; i++)
-    {
-      fLastBins[i] = axisCache[i]->FindBin(var[i]);
-      fLastVars[i] = var[i];
-    }
+    fAxisDescriptors[i].Init(GetAxis(i, 0));
+    fNbinsCache[i] = fAxisDescriptors[i].GetNbins();
   }
   
-  // calculate global bin index
+  fLastVars = new Double_t[fNVars];
+  fLastBins = new Int_t[fNVars];
+  
+  // initial values to prevent checking for 0 below
+  for (Int_t i=0; i<fNVars; i++)
+  {
+    fLastBins[i] = fAxisDescriptors[i].FindBin(var[i]);
+    fLastVars[i] = var[i];
+  }
+}
+
+template <class TemplateArray, typename TemplateType>
+Long64_t AliTHnT<TemplateArray, TemplateType>::FindGlobalBin(const Double_t *var)
+{
+  // calculates the global bin index of an entry, -1 if it is in an under/overflow bin of any axis
+  
   Long64_t bin = 0;
   for (Int_t i=0; i<fNVars; i++)
   {
@@ -319,7 +413,7 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
       tmpBin = fLastBins[i];
     else
     {
-      tmpBin = axisCache[i]->FindBin(var[i]);
+      tmpBin = fAxisDescriptors[i].FindBin(var[i]);
       fLastBins[i] = tmpBin;
       fLastVars[i] = var[i];
     }
@@ -327,12 +421,20 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
 
     // under/overflow not supported
     if (tmpBin < 1 || tmpBin > fNbinsCache[i])
-      return;
+      return -1;
     
     // bins start from 0 here
     bin += tmpBin - 1;
 //     Printf("%lld", bin);
   }
+  
+  return bin;
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::AddToBin(Int_t istep, Long64_t bin, Double_t weight)
+{
+  // adds weight to the global bin <bin> of step <istep>
 
   if (!fValues[istep])
   {
@@ -355,11 +457,51 @@ void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep
     fSumw2[istep]->GetArray()[bin] += weight * weight;
   
 //   Printf("%f", fValues[istep][bin]);
+}
+
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::Fill(const Double_t *var, Int_t istep, Double_t weight)
+{
+  // fills an entry
+
+  // fill axis cache
+  if (!fAxisDescriptors)
+    InitAxisCache(var);
+  
+  Long64_t bin = FindGlobalBin(var);
+  if (bin < 0)
+    return;
+
+  AddToBin(istep, bin, weight);
   
   // debug
 //   AliCFContainer::Fill(var, istep, weight);
 }
 
+template <class TemplateArray, typename TemplateType>
+void AliTHnT<TemplateArray, TemplateType>::FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weights)
+{
+  // fills n entries, same result as n calls to Fill
+  // var contains the variables of entry i at var[i*fNVars], weights (optional) the weight of entry i
+  // Entries with the same variables as the previous entry (e.g. the trigger particle properties of
+  // a list of associated particles) reuse the bin of the previous entry on the corresponding axis
+
+  if (n <= 0)
+    return;
+  
+  if (!fAxisDescriptors)
+    InitAxisCache(var);
+  
+  for (Int_t i=0; i<n; i++)
+  {
+    Long64_t bin = FindGlobalBin(var + i * fNVars);
+    if (bin < 0)
+      continue;
+    
+    AddToBin(istep, bin, (weights) ? weights[i] : 1.);
+  }
+}
+
 template <class TemplateArray, typename TemplateType>
 Long64_t AliTHnT<TemplateArray, TemplateType>::GetGlobalBinIndex(const Int_t* binIdx)
 {
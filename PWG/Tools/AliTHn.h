@@ -18,6 +18,7 @@ class TArray;
 class TArrayF;
 class TArrayD;
 class TCollection;
+class AliTHnAxisDescriptor;
 
 class AliTHnBase : public AliCFContainer
 {
@@ -26,6 +27,7 @@ public:
   AliTHnBase(const Char_t* name, const Char_t* title,const Int_t nSelStep, const Int_t nVarIn, const Int_t* nBinIn) : AliCFContainer(name, title, nSelStep, nVarIn, nBinIn) { }
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) = 0;
+  virtual void FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weights=0);
   virtual void FillParent() = 0;
   virtual void FillContainer(AliCFContainer* cont) = 0;
 
@@ -48,6 +50,7 @@ class AliTHnT : public AliTHnBase
   virtual ~AliTHnT();
   
   virtual void Fill(const Double_t *var, Int_t istep, Double_t weight=1.) ;
+  virtual void FillN(Int_t n, const Double_t *var, Int_t istep, const Double_t *weights=0);
   virtual void FillParent();
   virtual void FillContainer(AliCFContainer* cont);
   
@@ -66,6 +69,10 @@ class AliTHnT : public AliTHnBase
 protected:
   void Init();
   Long64_t GetGlobalBinIndex(const Int_t* binIdx);
+  void InitAxisCache(const Double_t *var);
+  void DeleteAxisCache();
+  Long64_t FindGlobalBin(const Double_t *var);
+  void AddToBin(Int_t istep, Long64_t bin, Double_t weight);
   
   Long64_t fNBins;   // number of total bins
   Int_t    fNVars;   // number of variables
@@ -73,12 +80,12 @@ protected:
   TemplateArray **fValues;  //[fNSteps] data container
   TemplateArray **fSumw2;   //[fNSteps] data container
   
-  TAxis** axisCache; //! cache axis pointers (about 50% of the time in Fill is spent in GetAxis otherwise)
+  AliTHnAxisDescriptor* fAxisDescriptors; //! binning of the axes, cached (about 50% of the time in Fill is spent in GetAxis otherwise) and with a fast FindBin
   Int_t* fNbinsCache; //! cache Nbins per axis
   Double_t* fLastVars; //! caching of last used bins (in many loops some vars are the same for a while)
   Int_t* fLastBins; //! caching of last used bins (in many loops some vars are the same for a while)
   
-  ClassDef(AliTHnT, 5) // THn like container
+  ClassDef(AliTHnT, 6) // THn like container
 };
 
 typedef AliTHnT<TArrayF, Float_t> AliTHn;
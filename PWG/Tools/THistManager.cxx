@@ -42,14 +42,16 @@ ClassImp(THistManager)
 THistManager::THistManager():
 		TNamed(),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHistCache()
 {
 }
 
 THistManager::THistManager(const char *name):
 		TNamed(name, Form("Histogram container %s", name)),
 		fHistos(NULL),
-		fIsOwner(true)
+		fIsOwner(true),
+		fHistCache()
 {
 	fHistos = new THashList();
 	fHistos->SetName(Form("histos%s", name));
@@ -409,15 +411,10 @@ void THistManager::SetObject(TObject * const o, const char *group) {
 }
 
 void THistManager::FillTH1(const char *name, double x, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH1", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH1 *hist = dynamic_cast<TH1 *>(parent->FindObject(hname));
+	const HistCacheEntry *entry = FindCacheEntry(name);
+	TH1 *hist = entry ? entry->fTH1 : nullptr;
 	if(!hist){
-		Fatal("THistManager::FillTH1", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTH1", "Histogram %s not found", name);
 		return;
 	}
 	TString optionstring(opt);
@@ -432,15 +429,10 @@ void THistManager::FillTH1(const char *name, double x, double weight, Option_t *
 }
 
 void THistManager::FillTH1(const char *name, const char *label, double weight, Option_t *opt) {
-  TString dirname(basename(name)), hname(histname(name));
-  THashList *parent(FindGroup(dirname));
-  if(!parent){
-    Fatal("THistManager::FillTH1", "Parent group %s does not exist", dirname.Data());
-    return;
-  }
-  TH1 *hist = dynamic_cast<TH1 *>(parent->FindObject(hname));
+  const HistCacheEntry *entry = FindCacheEntry(name);
+  TH1 *hist = entry ? entry->fTH1 : nullptr;
   if(!hist){
-    Fatal("THistManager::FillTH1", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+    Fatal("THistManager::FillTH1", "Histogram %s not found", name);
     return;
   }
 	TString optionstring(opt);
@@ -456,15 +448,10 @@ void THistManager::FillTH1(const char *name, const char *label, double weight, O
 }
 
 void THistManager::FillTH2(const char *name, double x, double y, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH2", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH2 *hist = dynamic_cast<TH2 *>(parent->FindObject(hname));
+	const HistCacheEntry *entry = FindCacheEntry(name);
+	TH2 *hist = entry ? entry->fTH2 : nullptr;
 	if(!hist){
-		Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTH2", "Histogram %s not found", name);
 		return;
 	}
 	TString optstring(opt);
@@ -481,15 +468,10 @@ void THistManager::FillTH2(const char *name, double x, double y, double weight,
 }
 
 void THistManager::FillTH2(const char *name, double *point, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH2", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH2 *hist = dynamic_cast<TH2 *>(parent->FindObject(hname));
+	const HistCacheEntry *entry = FindCacheEntry(name);
+	TH2 *hist = entry ? entry->fTH2 : nullptr;
 	if(!hist){
-		Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTH2", "Histogram %s not found", name);
 		return;
 	}
 	TString optstring(opt);
@@ -506,15 +488,10 @@ void THistManager::FillTH2(const char *name, double *point, double weight, Optio
 }
 
 void THistManager::FillTH2(const char *name, const char *labelX, const char *labelY, double weight, Option_t *opt) {
-  TString dirname(basename(name)), hname(histname(name));
-  THashList *parent(FindGroup(dirname));
-  if(!parent){
-    Fatal("THistManager::FillTH2", "Parent group %s does not exist", dirname.Data());
-    return;
-  }
-  TH2 *hist = dynamic_cast<TH2 *>(parent->FindObject(hname));
+  const HistCacheEntry *entry = FindCacheEntry(name);
+  TH2 *hist = entry ? entry->fTH2 : nullptr;
   if(!hist){
-    Fatal("THistManager::FillTH2", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+    Fatal("THistManager::FillTH2", "Histogram %s not found", name);
     return;
   }
   TString optstring(opt);
@@ -531,15 +508,10 @@ void THistManager::FillTH2(const char *name, const char *labelX, const char *lab
 }
 
 void THistManager::FillTH3(const char* name, double x, double y, double z, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH3", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH3 *hist = dynamic_cast<TH3 *>(parent->FindObject(hname));
+	const HistCacheEntry *entry = FindCacheEntry(name);
+	TH3 *hist = entry ? entry->fTH3 : nullptr;
 	if(!hist){
-		Fatal("THistManager::FillTH3", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTH3", "Histogram %s not found", name);
 		return;
 	}
 	TString optstring(opt);
@@ -560,15 +532,10 @@ void THistManager::FillTH3(const char* name, double x, double y, double z, doubl
 }
 
 void THistManager::FillTH3(const char* name, const double* point, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTH3", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	TH3 *hist = dynamic_cast<TH3 *>(parent->FindObject(hname));
+	const HistCacheEntry *entry = FindCacheEntry(name);
+	TH3 *hist = entry ? entry->fTH3 : nullptr;
 	if(!hist){
-		Fatal("THistManager::FillTH3", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTH3", "Histogram %s not found", name);
 		return;
 	}
 	TString optstring(opt);
@@ -589,15 +556,10 @@ void THistManager::FillTH3(const char* name, const double* point, double weight,
 }
 
 void THistManager::FillTHnSparse(const char *name, const double *x, double weight, Option_t *opt) {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent){
-		Fatal("THistManager::FillTHnSparse", "Parent group %s does not exist", dirname.Data());
-		return;
-	}
-	THnSparseD *hist = dynamic_cast<THnSparseD *>(parent->FindObject(hname));
+	const HistCacheEntry *entry = FindCacheEntry(name);
+	THnSparse *hist = entry ? entry->fTHnSparse : nullptr;
 	if(!hist){
-		Fatal("THistManager::FillTHnSparse", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+		Fatal("THistManager::FillTHnSparse", "Histogram %s not found", name);
 		return;
 	}
 	TString optstring(opt);
@@ -615,21 +577,92 @@ void THistManager::FillTHnSparse(const char *name, const double *x, double weigh
 }
 
 void THistManager::FillProfile(const char* name, double x, double y, double weight){
-  TString dirname(basename(name)), hname(histname(name));
-  THashList *parent(FindGroup(dirname));
-  if(!parent)
-		Fatal("THistManager::FillTProfile", "Parent group %s does not exist", dirname.Data());
-  TProfile *hist = dynamic_cast<TProfile *>(parent->FindObject(hname));
-  if(!hist)
-		Fatal("THistManager::FillTProfile", "Histogram %s not found in parent group %s", hname.Data(), dirname.Data());
+  const HistCacheEntry *entry = FindCacheEntry(name);
+  TProfile *hist = entry ? entry->fTProfile : nullptr;
+  if(!hist){
+		Fatal("THistManager::FillTProfile", "Histogram %s not found", name);
+    return;
+  }
   hist->Fill(x, y, weight);
 }
 
+template<>
+THistManager::Handle<TH1> THistManager::GetHandle<TH1>(const char *name) {
+  const HistCacheEntry *entry = FindCacheEntry(name);
+  if(!(entry && entry->fTH1))
+    Fatal("THistManager::GetHandle", "Histogram %s not found or not of type TH1", name);
+  return Handle<TH1>(entry ? entry->fTH1 : nullptr);
+}
+
+template<>
+THistManager::Handle<TH2> THistManager::GetHandle<TH2>(const char *name) {
+  const HistCacheEntry *entry = FindCacheEntry(name);
+  if(!(entry && entry->fTH2))
+    Fatal("THistManager::GetHandle", "Histogram %s not found or not of type TH2", name);
+  return Handle<TH2>(entry ? entry->fTH2 : nullptr);
+}
+
+template<>
+THistManager::Handle<TH3> THistManager::GetHandle<TH3>(const char *name) {
+  const HistCacheEntry *entry = FindCacheEntry(name);
+  if(!(entry && entry->fTH3))
+    Fatal("THistManager::GetHandle", "Histogram %s not found or not of type TH3", name);
+  return Handle<TH3>(entry ? entry->fTH3 : nullptr);
+}
+
+template<>
+THistManager::Handle<THnSparse> THistManager::GetHandle<THnSparse>(const char *name) {
+  const HistCacheEntry *entry = FindCacheEntry(name);
+  if(!(entry && entry->fTHnSparse))
+    Fatal("THistManager::GetHandle", "Histogram %s not found or not of type THnSparse", name);
+  return Handle<THnSparse>(entry ? entry->fTHnSparse : nullptr);
+}
+
+template<>
+THistManager::Handle<TProfile> THistManager::GetHandle<TProfile>(const char *name) {
+  const HistCacheEntry *entry = FindCacheEntry(name);
+  if(!(entry && entry->fTProfile))
+    Fatal("THistManager::GetHandle", "Histogram %s not found or not of type TProfile", name);
+  return Handle<TProfile>(entry ? entry->fTProfile : nullptr);
+}
+
+void THistManager::FillN(const Handle<TH1> &hist, int n, const double *x, const double *weights) {
+  // TH1::FillN treats missing weights as weight 1
+  hist->FillN(n, x, weights);
+}
+
+void THistManager::FillN(const Handle<TH2> &hist, int n, const double *x, const double *y, const double *weights) {
+  hist->FillN(n, x, y, weights);
+}
+
+void THistManager::FillN(const Handle<TH3> &hist, int n, const double *x, const double *y, const double *z, const double *weights) {
+  // No FillN implementation in TH3
+  TH3 *h = hist.Get();
+  if(weights) {
+    for(int i = 0; i < n; i++) h->Fill(x[i], y[i], z[i], weights[i]);
+  } else {
+    for(int i = 0; i < n; i++) h->Fill(x[i], y[i], z[i]);
+  }
+}
+
+void THistManager::FillN(const Handle<THnSparse> &hist, int n, const double *points, const double *weights) {
+  THnSparse *h = hist.Get();
+  const int ndim = h->GetNdimensions();
+  for(int i = 0; i < n; i++) h->Fill(points + i * ndim, weights ? weights[i] : 1.);
+}
+
+void THistManager::FillN(const Handle<TProfile> &hist, int n, const double *x, const double *y, const double *weights) {
+  TProfile *h = hist.Get();
+  if(weights) {
+    for(int i = 0; i < n; i++) h->Fill(x[i], y[i], weights[i]);
+  } else {
+    for(int i = 0; i < n; i++) h->Fill(x[i], y[i]);
+  }
+}
+
 TObject *THistManager::FindObject(const char *name) const {
-	TString dirname(basename(name)), hname(histname(name));
-	THashList *parent(FindGroup(dirname));
-	if(!parent) return NULL;
-	return parent->FindObject(hname);
+	const HistCacheEntry *entry = FindCacheEntry(name);
+	return entry ? entry->fObject : NULL;
 }
 
 TObject* THistManager::FindObject(const TObject* obj) const {
@@ -639,6 +672,28 @@ TObject* THistManager::FindObject(const TObject* obj) const {
 	return parent->FindObject(hname);
 }
 
+const THistManager::HistCacheEntry *THistManager::FindCacheEntry(const char *name) const {
+  auto found = fHistCache.find(name);
+  if(found != fHistCache.end()) return &(found->second);
+
+  // Not yet looked up - search in the group structure.
+  // Objects are never removed from the container, therefore
+  // entries in the cache stay valid.
+  TString dirname(basename(name)), hname(histname(name));
+  THashList *parent(FindGroup(dirname));
+  if(!parent) return nullptr;
+  TObject *obj = parent->FindObject(hname);
+  if(!obj) return nullptr;
+  HistCacheEntry entry;
+  entry.fObject = obj;
+  entry.fTH1 = dynamic_cast<TH1 *>(obj);
+  entry.fTH2 = dynamic_cast<TH2 *>(obj);
+  entry.fTH3 = dynamic_cast<TH3 *>(obj);
+  entry.fTHnSparse = dynamic_cast<THnSparse *>(obj);
+  entry.fTProfile = dynamic_cast<TProfile *>(obj);
+  return &(fHistCache.emplace(name, entry).first->second);
+}
+
 THashList *THistManager::FindGroup(const char *dirname) const {
 	if(!strlen(dirname) || !strcmp(dirname, "/")) return fHistos;
 	// recursive find - avoids tokenizing filename
@@ -1030,6 +1085,75 @@ namespace TestTHistManager {
     return success ? 0 : 1;
   }
 
+  int THistManagerTestSuite::TestFillHandles(){
+    THistManager testmgr("testmgr");
+
+    testmgr.CreateTH1("Group1/Test1", "Test handle fill 1D histogram", 1, 0., 1.);
+    testmgr.CreateTH2("Group1/Test2", "Test handle fill 2D histogram", 1, 0., 1., 1, 0., 1.);
+    testmgr.CreateTH3("Group1/Test3", "Test handle fill 3D histogram", 1, 0., 1., 1, 0., 1., 1, 0., 1.);
+    int nbins[4] = {1,1,1,1}; double min[4] = {0.,0.,0.,0.}, max[4] = {1.,1.,1.,1.};
+    testmgr.CreateTHnSparse("Group1/TestN", "Test handle fill THnSparse", 4, nbins, min, max);
+    testmgr.CreateTProfile("Group1/TestProfile", "Test handle fill Profile histogram", 1, 0., 1.);
+
+    auto handle1 = testmgr.GetHandle<TH1>("Group1/Test1");
+    auto handle2 = testmgr.GetHandle<TH2>("Group1/Test2");
+    auto handle3 = testmgr.GetHandle<TH3>("Group1/Test3");
+    auto handleN = testmgr.GetHandle<THnSparse>("Group1/TestN");
+    auto handleProfile = testmgr.GetHandle<TProfile>("Group1/TestProfile");
+    if(!(handle1.IsValid() && handle2.IsValid() && handle3.IsValid() && handleN.IsValid() && handleProfile.IsValid())){
+      std::cout << "Invalid handle" << std::endl;
+      return 1;
+    }
+
+    double point[4] = {0.5, 0.5, 0.5, 0.5};
+    // Mix fill by name and fill via handle, both need to end up in the same histogram
+    for(int i = 0; i < 50; i++){
+      testmgr.FillTH1("Group1/Test1", 0.5);
+      testmgr.FillTH2("Group1/Test2", 0.5, 0.5);
+      testmgr.FillTH3("Group1/Test3", 0.5, 0.5, 0.5);
+      testmgr.FillTHnSparse("Group1/TestN", point);
+      testmgr.FillProfile("Group1/TestProfile", 0.5, 1.);
+    }
+    for(int i = 0; i < 25; i++){
+      handle1.Fill(0.5);
+      handle2.Fill(0.5, 0.5);
+      handle3.Fill(0.5, 0.5, 0.5);
+      handleN.Fill(point);
+      handleProfile.Fill(0.5, 1.);
+    }
+    std::vector<double> values(25, 0.5), points(25 * 4, 0.5), ones(25, 1.);
+    THistManager::FillN(handle1, 25, values.data());
+    THistManager::FillN(handle2, 25, values.data(), values.data());
+    THistManager::FillN(handle3, 25, values.data(), values.data(), values.data());
+    THistManager::FillN(handleN, 25, points.data());
+    THistManager::FillN(handleProfile, 25, values.data(), ones.data(), ones.data());
+
+    // Evaluate test
+    bool success(true);
+    int index[4] = {1,1,1,1};
+    std::vector<std::pair<std::string, double>> contents = {
+      {"Test1", handle1->GetBinContent(1)},
+      {"Test2", handle2->GetBinContent(1, 1)},
+      {"Test3", handle3->GetBinContent(1, 1, 1)},
+      {"TestN", handleN->GetBinContent(index)}
+    };
+    for(const auto &content : contents){
+      if(TMath::Abs(content.second - 100) > DBL_EPSILON){
+        std::cout << content.first << ": Mismatch in values, expected 100, found " << content.second << std::endl;
+        success = false;
+      }
+    }
+    if(TMath::Abs(handleProfile->GetBinContent(1) - 1) > DBL_EPSILON){
+      std::cout << "TestProfile: Mismatch in values, expected 1, found " << handleProfile->GetBinContent(1) << std::endl;
+      success = false;
+    }
+    if(TMath::Abs(handleProfile->GetBinEntries(1) - 100) > DBL_EPSILON){
+      std::cout << "TestProfile: Mismatch in entries, expected 100, found " << handleProfile->GetBinEntries(1) << std::endl;
+      success = false;
+    }
+    return success ? 0 : 1;
+  }
+
   int TestRunAll(){
     int testresult(0);
     THistManagerTestSuite testsuite;
@@ -1050,6 +1174,10 @@ namespace TestTHistManager {
     testresult += testsuite.TestFillGroupedHistograms();
     std::cout << "Result after test: " << testresult << std::endl;
 
+    std::cout << "Running test: Fill Handles" << std::endl;
+    testresult += testsuite.TestFillHandles();
+    std::cout << "Result after test: " << testresult << std::endl;
+
     return testresult;
   }
 
@@ -1072,4 +1200,9 @@ namespace TestTHistManager {
     THistManagerTestSuite testsuite;
     return testsuite.TestFillGroupedHistograms();
   }
+
+  int TestRunFillHandles(){
+    THistManagerTestSuite testsuite;
+    return testsuite.TestFillHandles();
+  }
 }
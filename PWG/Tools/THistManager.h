@@ -7,6 +7,8 @@
 #include <TIterator.h>
 #include <TNamed.h>
 #include <iterator>
+#include <string>
+#include <unordered_map>
 
 class TArrayD;
 class TAxis;
@@ -95,6 +97,25 @@ class TProfile;
  * an argument for options. Automatic correction for the bin width is done when
  * specifying the argument *W*, followed by the direction. Adding multiple directions
  * the weight is calculated for all directions at the same time.
+ *
+ * # Filling histograms via handles
+ *
+ * Filling by name requires the path to be resolved for every call. Histogram
+ * lookups are cached inside the manager, so the group structure is only walked
+ * the first time a name is used, however the name still needs to be hashed for
+ * each fill. For histograms filled very frequently (i.e. once per track or cluster)
+ * a typed handle can be requested once after the histograms are created. The handle
+ * fills the histogram directly, without any lookup:
+ *
+ * ~~~{.cxx}
+ * auto hptHandle = mgr.GetHandle<TH1>("hPt");     // i.e. in UserCreateOutputObjects
+ * ...
+ * hptHandle.Fill(pt);                              // i.e. in the track loop
+ * THistManager::FillN(hptHandle, ntracks, ptvalues);  // or for all tracks at once
+ * ~~~
+ *
+ * Handles stay valid as long as the histogram manager owning the histogram
+ * exists. Handles are supported for TH1, TH2, TH3, THnSparse and TProfile.
  */
 class THistManager : public TNamed {
 public:
@@ -229,6 +250,68 @@ public:
     iterator();
   };
 
+  /**
+   * @class Handle
+   * @brief Typed handle to a histogram inside the histogram manager
+   * @ingroup Histmanager
+   *
+   * Light-weight wrapper around the pointer to a histogram managed by the
+   * histogram manager, obtained via THistManager::GetHandle. Filling via
+   * the handle skips the name lookup and the type check, which are done
+   * only once when the handle is created. The handle does not own the
+   * histogram.
+   */
+  template<typename HistType>
+  class Handle {
+  public:
+    /**
+     * @brief Default constructor, creating an invalid handle
+     */
+    Handle(): fHist(nullptr) { }
+
+    /**
+     * @brief Constructor, wrapping an existing histogram
+     * @param[in] hist Histogram connected to the handle
+     */
+    explicit Handle(HistType *hist): fHist(hist) { }
+
+    /**
+     * @brief Destructor (histogram not owned)
+     */
+    ~Handle() { }
+
+    /**
+     * @brief Check whether the handle is connected to a histogram
+     * @return True if the handle points to a histogram, false otherwise
+     */
+    bool IsValid() const { return fHist != nullptr; }
+
+    /**
+     * @brief Access to the underlying histogram
+     * @return Histogram connected to the handle
+     */
+    HistType *Get() const { return fHist; }
+
+    /**
+     * @brief Access to the underlying histogram
+     * @return Histogram connected to the handle
+     */
+    HistType *operator->() const { return fHist; }
+
+    /**
+     * @brief Fill the underlying histogram
+     *
+     * Arguments are forwarded to the Fill function of the histogram
+     * type, i.e. (x, weight) for TH1, (x, y, weight) for TH2.
+     * @param[in] args Arguments of the Fill function of the histogram type
+     */
+    template<typename... Args>
+    void Fill(Args... args) const { fHist->Fill(args...); }
+
+  private:
+    HistType            *fHist;             ///< Underlying histogram (not owned)
+  };
+
   /**
    * @brief Default constructor.
    *
@@ -634,6 +717,68 @@ public:
 	 */
   void FillProfile(const char *name, double x, double y, double weight = 1.);
 
+  /**
+   * @brief Get a typed handle to a histogram within the container.
+   *
+   * The histogram name also contains the parent group(s) according to the common
+   * group notation. Supported types are TH1, TH2, TH3, THnSparse and TProfile.
+   * The histogram is looked up only once, subsequent fills via the handle
+   * don't need any lookup.
+   * @param[in] name Name of the histogram
+   * @return Handle to the histogram (fatal if the histogram is not found or the type does not match)
+   */
+  template<typename HistType>
+  Handle<HistType> GetHandle(const char *name);
+
+  /**
+   * @brief Fill a 1D histogram with an array of values.
+   * @param[in] hist Handle to the histogram
+   * @param[in] n Number of entries
+   * @param[in] x Array of x-values (size n)
+   * @param[in] weights Optional array of weights (size n, weight 1 if NULL)
+   */
+  static void FillN(const Handle<TH1> &hist, int n, const double *x, const double *weights = nullptr);
+
+  /**
+   * @brief Fill a 2D histogram with arrays of values.
+   * @param[in] hist Handle to the histogram
+   * @param[in] n Number of entries
+   * @param[in] x Array of x-values (size n)
+   * @param[in] y Array of y-values (size n)
+   * @param[in] weights Optional array of weights (size n, weight 1 if NULL)
+   */
+  static void FillN(const Handle<TH2> &hist, int n, const double *x, const double *y, const double *weights = nullptr);
+
+  /**
+   * @brief Fill a 3D histogram with arrays of values.
+   * @param[in] hist Handle to the histogram
+   * @param[in] n Number of entries
+   * @param[in] x Array of x-values (size n)
+   * @param[in] y Array of y-values (size n)
+   * @param[in] z Array of z-values (size n)
+   * @param[in] weights Optional array of weights (size n, weight 1 if NULL)
+   */
+  static void FillN(const Handle<TH3> &hist, int n, const double *x, const double *y, const double *z, const double *weights = nullptr);
+
+  /**
+   * @brief Fill a nD histogram with an array of points.
+   * @param[in] hist Handle to the histogram
+   * @param[in] n Number of entries
+   * @param[in] points Points to be filled, stored row-wise (size n x ndim)
+   * @param[in] weights Optional array of weights (size n, weight 1 if NULL)
+   */
+  static void FillN(const Handle<THnSparse> &hist, int n, const double *points, const double *weights = nullptr);
+
+  /**
+   * @brief Fill a profile histogram with arrays of values.
+   * @param[in] hist Handle to the profile histogram
+   * @param[in] n Number of entries
+   * @param[in] x Array of x-values (size n)
+   * @param[in] y Array of y-values (size n)
+   * @param[in] weights Optional array of weights (size n, weight 1 if NULL)
+   */
+  static void FillN(const Handle<TProfile> &hist, int n, const double *x, const double *y, const double *weights = nullptr);
+
   /**
    * @brief Create forward iterator starting at the beginning of the
    * container
@@ -695,6 +840,32 @@ private:
 	THistManager(const THistManager &);
 	THistManager &operator=(const THistManager &);
 
+	/**
+	 * @struct HistCacheEntry
+	 * @brief Result of a histogram lookup, including the type casts
+	 *
+	 * Type casts are done once when the object is inserted into the cache,
+	 * pointers for types not matching the object are set to NULL.
+	 */
+	struct HistCacheEntry {
+	  TObject       *fObject;             ///< Object found in the container
+	  TH1           *fTH1;                ///< Object as TH1 (NULL if type does not match)
+	  TH2           *fTH2;                ///< Object as TH2 (NULL if type does not match)
+	  TH3           *fTH3;                ///< Object as TH3 (NULL if type does not match)
+	  THnSparse     *fTHnSparse;          ///< Object as THnSparse (NULL if type does not match)
+	  TProfile      *fTProfile;           ///< Object as TProfile (NULL if type does not match)
+	};
+
+	/**
+	 * @brief Find object in the cache of histogram lookups.
+	 *
+	 * In case the object is not yet in the cache it is searched in
+	 * the group structure and inserted in the cache.
+	 * @param[in] name Name of the histogram, including the parent group(s)
+	 * @return Cache entry for the object (NULL if the object does not exist)
+	 */
+	const HistCacheEntry *FindCacheEntry(const char *name) const;
+
 
 	/**
 	 * @brief Find histogram group.
@@ -721,12 +892,19 @@ private:
 
 	THashList *fHistos;                   ///< List of histograms
 	bool fIsOwner;                        ///< Set the ownership
+	mutable std::unordered_map<std::string, HistCacheEntry> fHistCache;   //!<! Cache of histogram lookups by full path
 
   /// \cond CLASSIMP
 	ClassDef(THistManager, 1);  // Container for histograms
   /// \endcond
 };
 
+template<> THistManager::Handle<TH1> THistManager::GetHandle<TH1>(const char *name);
+template<> THistManager::Handle<TH2> THistManager::GetHandle<TH2>(const char *name);
+template<> THistManager::Handle<TH3> THistManager::GetHandle<TH3>(const char *name);
+template<> THistManager::Handle<THnSparse> THistManager::GetHandle<THnSparse>(const char *name);
+template<> THistManager::Handle<TProfile> THistManager::GetHandle<TProfile>(const char *name);
+
 THistManager::iterator THistManager::begin() const {
   return iterator(this, 0, iterator::kTHMIforward);
 }
@@ -845,6 +1023,24 @@ public:
    * @return 0 if test is passed, 1 if it failed
    */
   int TestFillGroupedHistograms();
+
+  /**
+   * Purpose of the test: Check whether filling via handles and batched filling
+   * gives the same result as filling by name
+   * Relies on: TestFillSimpleHistograms, TestFillGroupedHistograms
+   *
+   * Creating histograms of all types in a group, and filling each
+   * - 50 times by name
+   * - 25 times via the handle
+   * - 25 times via the batched fill with the handle
+   * with 1 bin per dimension
+   *
+   * Test passed:
+   * - All handles are valid
+   * - All histograms need to have in its 1 bin the bin content 100 (1 for the profile)
+   * @return 0 if test is passed, 1 if it failed
+   */
+  int TestFillHandles();
 };
 
 /**
@@ -882,5 +1078,12 @@ int TestRunFillSimple();
  */
 int TestRunFillGrouped();
 
+/**
+ * Run the test for filling histograms via handles. See @ref THistManagerTestSuite
+ * for details.
+ * @return 0 if test is passed, 1 if failed
+ */
+int TestRunFillHandles();
+
 }
 #endif
@@ -0,0 +1,289 @@
+/**************************************************************************
+ * Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ *                                                                        *
+ * Author: The ALICE Off-line Project.                                    *
+ * Contributors are mentioned in the code where appropriate.              *
+ *                                                                        *
+ * Permission to use, copy, modify and distribute this software and its   *
+ * documentation strictly for non-commercial purposes is hereby granted   *
+ * without fee, provided that the above copyright notice appears in all   *
+ * copies and that both the copyright notice and this permission notice   *
+ * appear in the supporting documentation. The authors make no claims     *
+ * about the suitability of this software for any purpose. It is          *
+ * provided "as is" without express or implied warranty.                  *
+ **************************************************************************/
+
+//
+//
+// two-track efficiency (merging) cut based on the minimum of dphi* between two tracks in the TPC
+// see AliTwoTrackCut.h for details
+//
+
+#include "AliTwoTrackCut.h"
+
+#include <algorithm>
+
+AliTwoTrackCut::AliTwoTrackCut(Float_t minRadius, Float_t maxRadius) :
+  fMinRadius(0),
+  fMaxRadius(0),
+  fRadii(),
+  fBSign(0),
+  fNAssociated(0),
+  fPhi(),
+  fPt(),
+  fCharge(),
+  fEta(),
+  fBendMin(),
+  fBendMax(),
+  fCandidate()
+{
+  // constructor
+
+  SetRadii(minRadius, maxRadius);
+}
+
+//____________________________________________________________________
+void AliTwoTrackCut::SetRadii(Float_t minRadius, Float_t maxRadius)
+{
+  // sets the radius range of the search and builds the radius grid (1 cm steps)
+  // the grid points are the same as the ones of the loop in AliUEHistograms::FillCorrelations
+
+  fMinRadius = minRadius;
+  fMaxRadius = maxRadius;
+
+  fRadii.clear();
+  for (Double_t rad=fMinRadius; rad<fMaxRadius+0.01; rad+=0.01)
+    fRadii.push_back(rad);
+
+  // the terms of the associated tracks depend on the radii
+  fNAssociated = 0;
+}
+
+//____________________________________________________________________
+void AliTwoTrackCut::SetAssociated(Int_t n, const Float_t* phi, const Float_t* pt, const Float_t* charge, const Float_t* eta, Float_t bSign)
+{
+  // sets the associated tracks, and computes their bending at the minimum and maximum radius
+  // which is used for the boundary checks in Evaluate
+
+  fBSign = bSign;
+  fNAssociated = n;
+
+  fPhi.assign(phi, phi + n);
+  fPt.assign(pt, pt + n);
+  fCharge.assign(charge, charge + n);
+  fEta.assign(eta, eta + n);
+  fBendMin.resize(n);
+  fBendMax.resize(n);
+  fCandidate.resize(n);
+
+  for (Int_t j=0; j<n; j++)
+  {
+    fBendMin[j] = charge[j] * bSign * TMath::ASin(0.075 * fMinRadius / pt[j]);
+    fBendMax[j] = charge[j] * bSign * TMath::ASin(0.075 * fMaxRadius / pt[j]);
+  }
+}
+
+//____________________________________________________________________
+Int_t AliTwoTrackCut::Evaluate(Float_t phi1, Float_t pt1, Float_t charge1, Float_t eta1, Float_t cutValue, Float_t* dphistarmin, UChar_t* status, const UChar_t* accepted) const
+{
+  // checks the trigger particle against all associated tracks
+  //
+  // status[j] is kClose if the pair is close enough to need the search for the minimum, in this case
+  // dphistarmin[j] contains the (signed) minimum of dphi* over the radius grid
+  // the pair is to be removed if |dphistarmin| < cutValue and |deta| < cutValue
+  // if accepted is given, pairs with accepted[j] == 0 (rejected by other cuts) are not checked (kNotClose)
+  //
+  // returns the number of close pairs
+
+  const Double_t bendMin1 = charge1 * fBSign * TMath::ASin(0.075 * fMinRadius / pt1);
+  const Double_t bendMax1 = charge1 * fBSign * TMath::ASin(0.075 * fMaxRadius / pt1);
+
+  const Double_t kEtaLimit = cutValue * 2.5 * 3;
+  const Float_t kLimit = cutValue * 3;
+
+  // boundary checks for all accepted pairs
+  const Float_t* phi = fPhi.data();
+  const Float_t* eta = fEta.data();
+  const Double_t* bendMin = fBendMin.data();
+  const Double_t* bendMax = fBendMax.data();
+  UChar_t* candidate = fCandidate.data();
+  for (Int_t j=0; j<fNAssociated; j++)
+  {
+    if (accepted && !accepted[j])
+    {
+      candidate[j] = 0;
+      continue;
+    }
+
+    Float_t deta = eta1 - eta[j];
+    Float_t dphistar1 = FoldDPhiStar(phi1 - phi[j] - bendMin1 + bendMin[j]);
+    Float_t dphistar2 = FoldDPhiStar(phi1 - phi[j] - bendMax1 + bendMax[j]);
+
+    candidate[j] = (TMath::Abs(deta) < kEtaLimit) & ((TMath::Abs(dphistar1) < kLimit) | (TMath::Abs(dphistar2) < kLimit) | (dphistar1 * dphistar2 < 0));
+  }
+
+  // search of the minimum only for the close pairs
+  Int_t nClose = 0;
+  for (Int_t j=0; j<fNAssociated; j++)
+  {
+    status[j] = kNotClose;
+    if (!candidate[j])
+      continue;
+
+    dphistarmin[j] = BisectMinDPhiStar(phi1, pt1, charge1, fPhi[j], fPt[j], fCharge[j], fBSign);
+    status[j] = kClose;
+    nClose++;
+  }
+
+  return nClose;
+}
+
+//____________________________________________________________________
+Bool_t AliTwoTrackCut::MinDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t bSign, Float_t cutValue, Float_t& dphistarmin) const
+{
+  // single pair version of Evaluate (without the check on deta)
+  // returns kFALSE if the pair is not close, otherwise dphistarmin is set
+
+  Float_t dphistar1 = DPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fMinRadius, bSign);
+  Float_t dphistar2 = DPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fMaxRadius, bSign);
+
+  const Float_t kLimit = cutValue * 3;
+
+  if (!(TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0))
+    return kFALSE;
+
+  dphistarmin = BisectMinDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, bSign);
+  return kTRUE;
+}
+
+//____________________________________________________________________
+Float_t AliTwoTrackCut::ScanMinDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t bSign) const
+{
+  // minimum of dphi* by evaluating all points of the radius grid
+  // reference for BisectMinDPhiStar
+
+  Float_t dphistarminabs = 1e5;
+  Float_t dphistarmin = 1e5;
+  for (UInt_t i=0; i<fRadii.size(); i++)
+  {
+    Float_t dphistar = DPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fRadii[i], bSign);
+    Float_t dphistarabs = TMath::Abs(dphistar);
+
+    if (dphistarabs < dphistarminabs)
+    {
+      dphistarmin = dphistar;
+      dphistarminabs = dphistarabs;
+    }
+  }
+
+  return dphistarmin;
+}
+
+//____________________________________________________________________
+Int_t AliTwoTrackCut::FirstSaturatedRadius(Float_t pt1, Float_t pt2) const
+{
+  // first grid point where 0.075 r / pt > 1 for one of the tracks (i.e. TMath::ASin returns pi/2),
+  // or the number of grid points if there is none
+
+  Int_t lo = 0;
+  Int_t hi = fRadii.size();
+  while (lo < hi)
+  {
+    Int_t mid = (lo + hi) / 2;
+    if (0.075 * fRadii[mid] / pt1 <= 1 && 0.075 * fRadii[mid] / pt2 <= 1)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+//____________________________________________________________________
+Int_t AliTwoTrackCut::FindCandidates(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t bSign, Int_t first, Int_t last, Int_t* candidates) const
+{
+  // adds the candidates for the minimum in the monotonic range [first, last] of the radius grid:
+  // the first and last point and the points next to the crossings of -2 pi, 0 and 2 pi
+  // returns the number of candidates added
+
+  Int_t nCandidates = 0;
+  candidates[nCandidates++] = first;
+  candidates[nCandidates++] = last;
+
+  // unfolded dphi* at the first and last grid point
+  Float_t firstValue = phi1 - phi2 - charge1 * bSign * TMath::ASin(0.075 * fRadii[first] / pt1) + charge2 * bSign * TMath::ASin(0.075 * fRadii[first] / pt2);
+  Float_t lastValue = phi1 - phi2 - charge1 * bSign * TMath::ASin(0.075 * fRadii[last] / pt1) + charge2 * bSign * TMath::ASin(0.075 * fRadii[last] / pt2);
+
+  static const Double_t kCrossings[3] = { -TMath::TwoPi(), 0, TMath::TwoPi() };
+  for (Int_t c=0; c<3; c++)
+  {
+    Bool_t firstAbove = (firstValue > kCrossings[c]);
+    if (firstAbove == (lastValue > kCrossings[c]))
+      continue;
+
+    // first grid point on the other side of the crossing
+    Int_t lo = first;
+    Int_t hi = last;
+    while (hi - lo > 1)
+    {
+      Int_t mid = (lo + hi) / 2;
+      Float_t dphistar = phi1 - phi2 - charge1 * bSign * TMath::ASin(0.075 * fRadii[mid] / pt1) + charge2 * bSign * TMath::ASin(0.075 * fRadii[mid] / pt2);
+      if ((dphistar > kCrossings[c]) == firstAbove)
+        lo = mid;
+      else
+        hi = mid;
+    }
+    candidates[nCandidates++] = lo;
+    candidates[nCandidates++] = hi;
+  }
+
+  return nCandidates;
+}
+
+//____________________________________________________________________
+Float_t AliTwoTrackCut::BisectMinDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t bSign) const
+{
+  // minimum of dphi* over the radius grid
+  //
+  // before folding into [-pi, pi], dphi* is a monotonic function of the radius as long as
+  // 0.075 r / pt < 1 for both tracks (both asin terms are monotonic, and for charged tracks their
+  // difference or sum is monotonic as well). Beyond, TMath::ASin returns pi/2 for the track with the
+  // lower pt, and dphi* is again monotonic. |dphi*| after folding is the distance to the closest
+  // multiple of 2 pi, therefore in each of the two ranges the minimum is at the first or last grid
+  // point or next to the radius where dphi* crosses -2 pi, 0 or 2 pi. These crossings are found by
+  // bisection and only the points next to them are evaluated.
+  // The result is the same as the one of ScanMinDPhiStar.
+
+  const Int_t nRadii = fRadii.size();
+  if (nRadii == 0)
+    return 1e5;
+
+  Int_t candidates[16];
+  Int_t nCandidates = 0;
+
+  Int_t saturated = FirstSaturatedRadius(pt1, pt2);
+  if (saturated > 0)
+    nCandidates += FindCandidates(phi1, pt1, charge1, phi2, pt2, charge2, bSign, 0, saturated - 1, candidates + nCandidates);
+  if (saturated < nRadii)
+    nCandidates += FindCandidates(phi1, pt1, charge1, phi2, pt2, charge2, bSign, saturated, nRadii - 1, candidates + nCandidates);
+
+  std::sort(candidates, candidates + nCandidates);
+
+  Float_t dphistarminabs = 1e5;
+  Float_t dphistarmin = 1e5;
+  for (Int_t i=0; i<nCandidates; i++)
+  {
+    if (i > 0 && candidates[i] == candidates[i-1])
+      continue;
+
+    Float_t dphistar = DPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fRadii[candidates[i]], bSign);
+    Float_t dphistarabs = TMath::Abs(dphistar);
+
+    if (dphistarabs < dphistarminabs)
+    {
+      dphistarmin = dphistar;
+      dphistarminabs = dphistarabs;
+    }
+  }
+
+  return dphistarmin;
+}
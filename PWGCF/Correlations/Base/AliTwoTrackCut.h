@@ -0,0 +1,92 @@
+#ifndef AliTwoTrackCut_H
+#define AliTwoTrackCut_H
+
+/* Copyright(c) 1998-1999, ALICE Experiment at CERN, All rights reserved. *
+ * See cxx source for full Copyright notice                               */
+
+// two-track efficiency (merging) cut based on the minimum of dphi* between two tracks in the TPC
+//
+// The minimum of dphi* over the radius is equal to the one of a scan from the minimum radius to
+// 2.5 m in steps of 1 cm (as done in AliUEHistograms::FillCorrelations), but it is found by a
+// bisection on the radius grid: dphi* is a piecewise monotonic function of the radius for two charged tracks.
+// The associated tracks are given as arrays (SoA). Pairs rejected by the caller's cheaper cuts can be
+// excluded with a mask, the boundary checks are done for the remaining pairs in one loop over the arrays
+// and only the close pairs are searched for the minimum.
+//
+// Usage:
+//   AliTwoTrackCut cut(minRadius);
+//   cut.SetAssociated(n, phi, pt, charge, eta, bSign);   // once per event (or mixed event)
+//   cut.Evaluate(phi1, pt1, charge1, eta1, cutValue, dphistarmin, status, accepted);  // once per trigger
+
+#include "TMath.h"
+#include <vector>
+
+class AliTwoTrackCut
+{
+ public:
+  enum EPairStatus { kNotClose = 0, kClose = 1 }; // kClose: the pair passed the boundary checks and dphistarmin has been computed
+
+  AliTwoTrackCut(Float_t minRadius = 0.8, Float_t maxRadius = 2.5);
+  virtual ~AliTwoTrackCut() {}
+
+  void SetRadii(Float_t minRadius, Float_t maxRadius = 2.5);
+  Float_t GetMinRadius() const { return fMinRadius; }
+  Float_t GetMaxRadius() const { return fMaxRadius; }
+
+  void SetAssociated(Int_t n, const Float_t* phi, const Float_t* pt, const Float_t* charge, const Float_t* eta, Float_t bSign);
+  Int_t Evaluate(Float_t phi1, Float_t pt1, Float_t charge1, Float_t eta1, Float_t cutValue, Float_t* dphistarmin, UChar_t* status, const UChar_t* accepted = 0) const;
+
+  Bool_t MinDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t bSign, Float_t cutValue, Float_t& dphistarmin) const;
+  Float_t ScanMinDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t bSign) const;
+
+  static inline Float_t DPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign);
+  static inline Float_t FoldDPhiStar(Float_t dphistar);
+
+ protected:
+  Float_t BisectMinDPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t bSign) const;
+  Int_t FirstSaturatedRadius(Float_t pt1, Float_t pt2) const;
+  Int_t FindCandidates(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t bSign, Int_t first, Int_t last, Int_t* candidates) const;
+
+  Float_t fMinRadius;              // minimum radius of the search (m)
+  Float_t fMaxRadius;              // maximum radius of the search (m)
+  std::vector<Float_t> fRadii;     // radius grid of the search
+
+  Float_t fBSign;                  // sign of the magnetic field of the associated tracks
+  Int_t fNAssociated;              // number of associated tracks
+  std::vector<Float_t> fPhi;       // associated tracks: phi
+  std::vector<Float_t> fPt;        // associated tracks: pt
+  std::vector<Float_t> fCharge;    // associated tracks: charge
+  std::vector<Float_t> fEta;       // associated tracks: eta
+  std::vector<Double_t> fBendMin;  // associated tracks: charge * bSign * asin(0.075 r / pt) at the minimum radius
+  std::vector<Double_t> fBendMax;  // associated tracks: charge * bSign * asin(0.075 r / pt) at the maximum radius
+  mutable std::vector<UChar_t> fCandidate; // buffer for the boundary checks in Evaluate
+};
+
+Float_t AliTwoTrackCut::DPhiStar(Float_t phi1, Float_t pt1, Float_t charge1, Float_t phi2, Float_t pt2, Float_t charge2, Float_t radius, Float_t bSign)
+{
+  //
+  // calculates dphistar (identical to AliUEHistograms::GetDPhiStar)
+  //
+
+  Float_t dphistar = phi1 - phi2 - charge1 * bSign * TMath::ASin(0.075 * radius / pt1) + charge2 * bSign * TMath::ASin(0.075 * radius / pt2);
+
+  return FoldDPhiStar(dphistar);
+}
+
+Float_t AliTwoTrackCut::FoldDPhiStar(Float_t dphistar)
+{
+  // brings dphistar into [-pi, pi]
+
+  static const Double_t kPi = TMath::Pi();
+
+  if (dphistar > kPi)
+    dphistar = kPi * 2 - dphistar;
+  if (dphistar < -kPi)
+    dphistar = -kPi * 2 - dphistar;
+  if (dphistar > kPi) // might look funny but is needed
+    dphistar = kPi * 2 - dphistar;
+
+  return dphistar;
+}
+
+#endif
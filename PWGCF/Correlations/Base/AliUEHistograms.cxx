@@ -25,6 +25,7 @@
 #include "AliUEHistograms.h"
 
 #include "AliCFContainer.h"
+#include "AliTHn.h"
 #include "AliBasicParticle.h"
 #include "AliVParticle.h"
 #include "AliAODTrack.h"
@@ -37,6 +38,8 @@
 #include "TMath.h"
 #include "TLorentzVector.h"
 
+#include <vector>
+
 ClassImp(AliUEHistograms)
 
 const Int_t AliUEHistograms::fgkUEHists = 3;
@@ -597,6 +600,34 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
   for (Int_t i=0; i<input->GetEntriesFast(); i++)
     eta[i] = ((AliVParticle*) input->UncheckedAt(i))->Eta();
   
+  // two-track efficiency cut: the associated particles are passed as arrays, for each trigger particle
+  // the minimum dphi* is computed for all close pairs at once
+  AliTwoTrackCut twoTrackCut(fTwoTrackCutMinRadius);
+  TArrayF twoTrackDPhiStarMin;
+  std::vector<UChar_t> twoTrackStatus;
+  std::vector<UChar_t> twoTrackAccepted;
+  TArrayD assocPt;
+  TArrayF assocCharge;
+  if (twoTrackEfficiencyCut && particles)
+  {
+    Int_t nAssociated = input->GetEntriesFast();
+    TArrayF phi(nAssociated), pt(nAssociated), charge(nAssociated);
+    assocPt.Set(nAssociated);
+    for (Int_t i=0; i<nAssociated; i++)
+    {
+      AliVParticle* particle = (AliVParticle*) input->UncheckedAt(i);
+      phi[i] = particle->Phi();
+      assocPt[i] = particle->Pt();
+      pt[i] = assocPt[i];
+      charge[i] = particle->Charge();
+    }
+    twoTrackCut.SetAssociated(nAssociated, phi.GetArray(), pt.GetArray(), charge.GetArray(), eta.GetArray(), bSign);
+    twoTrackDPhiStarMin.Set(nAssociated);
+    twoTrackStatus.resize(nAssociated);
+    twoTrackAccepted.resize(nAssociated);
+    assocCharge = charge;
+  }
+  
   // if particles is not set, just fill event statistics
   if (particles)
   {
@@ -711,6 +742,13 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
       }
     }
     
+    // the associated particles of one trigger particle are filled at once if the track histogram is an AliTHn
+    AliCFContainer* trackHist = fNumberDensityPhi->GetTrackHist(AliUEHist::kToward);
+    AliTHnBase* trackHistTHn = dynamic_cast<AliTHnBase*> (trackHist);
+    const Int_t trackHistNVar = trackHist->GetNVar(); // 5 or 6 depending on the binning (without or with vertex axis)
+    std::vector<Double_t> assocVars;
+    std::vector<Double_t> assocWeights;
+    
     for (Int_t i=0; i<particles->GetEntriesFast(); i++)
     {
       AliVParticle* triggerParticle = (AliVParticle*) particles->UncheckedAt(i);
@@ -738,6 +776,33 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  continue;
 	}
 	
+      assocVars.clear();
+      assocWeights.clear();
+
+      if (twoTrackEfficiencyCut && !twoTrackStatus.empty())
+      {
+	// pairs removed by the cheaper cuts of the loop below (same particle, pT ordering, charge selection) are not checked
+	Double_t triggerPt = triggerParticle->Pt();
+	Short_t triggerCharge = triggerParticle->Charge();
+	for (Int_t j=0; j<jMax; j++)
+	{
+	  Bool_t accepted = kTRUE;
+	  if (!mixed && i == j)
+	    accepted = kFALSE;
+	  if (fPtOrder && assocPt[j] >= triggerPt)
+	    accepted = kFALSE;
+	  if (fAssociatedSelectCharge != 0 && assocCharge[j] * fAssociatedSelectCharge < 0)
+	    accepted = kFALSE;
+	  if (fSelectCharge == 1 && assocCharge[j] * triggerCharge > 0)
+	    accepted = kFALSE;
+	  if (fSelectCharge == 2 && assocCharge[j] * triggerCharge < 0)
+	    accepted = kFALSE;
+	  twoTrackAccepted[j] = accepted;
+	}
+	
+	twoTrackCut.Evaluate(triggerParticle->Phi(), triggerPt, triggerCharge, triggerEta, twoTrackEfficiencyCutValue, twoTrackDPhiStarMin.GetArray(), &twoTrackStatus[0], &twoTrackAccepted[0]);
+      }
+	
       for (Int_t j=0; j<jMax; j++)
       {
         if (!mixed && i == j)
@@ -915,58 +980,27 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	  }
 	}
 
-	if (twoTrackEfficiencyCut)
+	if (twoTrackEfficiencyCut && twoTrackStatus[j] == AliTwoTrackCut::kClose)
 	{
 	  // the variables & cuthave been developed by the HBT group 
 	  // see e.g. https://indico.cern.ch/materialDisplay.py?contribId=36&sessionId=6&materialId=slides&confId=142700
+	  // the boundary checks and the search of the minimum dphi* over the radius are done in AliTwoTrackCut
 
-	  Float_t phi1 = triggerParticle->Phi();
 	  Float_t pt1 = triggerParticle->Pt();
-	  Float_t charge1 = triggerParticle->Charge();
-	    
-	  Float_t phi2 = particle->Phi();
 	  Float_t pt2 = particle->Pt();
-	  Float_t charge2 = particle->Charge();
-	      
 	  Float_t deta = triggerEta - eta[j];
-	      
-	  // optimization
-	  if (TMath::Abs(deta) < twoTrackEfficiencyCutValue * 2.5 * 3)
-	  {
-	    // check first boundaries to see if is worth to loop and find the minimum
-	    Float_t dphistar1 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, fTwoTrackCutMinRadius, bSign);
-	    Float_t dphistar2 = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, 2.5, bSign);
-	    
-	    const Float_t kLimit = twoTrackEfficiencyCutValue * 3;
+	  Float_t dphistarmin = twoTrackDPhiStarMin[j];
+	  Float_t dphistarminabs = TMath::Abs(dphistarmin);
 
-	    Float_t dphistarminabs = 1e5;
-	    Float_t dphistarmin = 1e5;
-	    if (TMath::Abs(dphistar1) < kLimit || TMath::Abs(dphistar2) < kLimit || dphistar1 * dphistar2 < 0)
-	    {
-	      for (Double_t rad=fTwoTrackCutMinRadius; rad<2.51; rad+=0.01) 
-	      {
-		Float_t dphistar = GetDPhiStar(phi1, pt1, charge1, phi2, pt2, charge2, rad, bSign);
-
-		Float_t dphistarabs = TMath::Abs(dphistar);
-		
-		if (dphistarabs < dphistarminabs)
-		{
-		  dphistarmin = dphistar;
-		  dphistarminabs = dphistarabs;
-		}
-	      }
+	  fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
 	      
-	      fTwoTrackDistancePt[0]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
-	      
-	      if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
-	      {
-// 		Printf("Removed track pair %d %d with %f %f %f %f %f %f %f %f %f", i, j, deta, dphistarminabs, phi1, pt1, charge1, phi2, pt2, charge2, bSign);
-		continue;
-	      }
-
-    	      fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
-	    }
+	  if (dphistarminabs < twoTrackEfficiencyCutValue && TMath::Abs(deta) < twoTrackEfficiencyCutValue)
+	  {
+// 	    Printf("Removed track pair %d %d with %f %f %f %f %f", i, j, deta, dphistarminabs, pt1, pt2, bSign);
+	    continue;
 	  }
+
+	  fTwoTrackDistancePt[1]->Fill(deta, dphistarmin, TMath::Abs(pt1 - pt2));
 	}
         
         Double_t vars[6];
@@ -1020,10 +1054,19 @@ void AliUEHistograms::FillCorrelations(Double_t centrality, Float_t zVtx, AliUEH
 	}
     
         // fill all in toward region and do not use the other regions
-	fNumberDensityPhi->GetTrackHist(AliUEHist::kToward)->Fill(vars, step, useWeight);
+	if (trackHistTHn)
+	{
+	  assocVars.insert(assocVars.end(), vars, vars + trackHistNVar);
+	  assocWeights.push_back(useWeight);
+	}
+	else
+	  trackHist->Fill(vars, step, useWeight);
 
 // 	Printf("%.2f %.2f --> %.2f", triggerEta, eta[j], vars[0]);
       }
+      
+      if (trackHistTHn && !assocWeights.empty())
+	trackHistTHn->FillN(assocWeights.size(), &assocVars[0], step, &assocWeights[0]);
  
       if (firstTime)
       {
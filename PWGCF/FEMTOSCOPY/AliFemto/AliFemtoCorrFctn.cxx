@@ -34,6 +34,25 @@ void AliFemtoCorrFctn::AddMixedPair(AliFemtoPair*)
   cout << "AliFemtoCorrFctn::AddMixedPair -- Not implemented\n";
 }
 
+void AliFemtoCorrFctn::AddRealPairs(AliFemtoPairBlock &block)
+{
+  const UChar_t *passed = block.Passed();
+  for (size_t i = 0; i < block.Size(); ++i) {
+    if (passed[i]) {
+      AddRealPair(block.Pair(i));
+    }
+  }
+}
+void AliFemtoCorrFctn::AddMixedPairs(AliFemtoPairBlock &block)
+{
+  const UChar_t *passed = block.Passed();
+  for (size_t i = 0; i < block.Size(); ++i) {
+    if (passed[i]) {
+      AddMixedPair(block.Pair(i));
+    }
+  }
+}
+
 void AliFemtoCorrFctn::AddFirstParticle(AliFemtoParticle*, bool)
 {
   cout << "AliFemtoCorrFctn::AddFirstParticle -- Not implemented\n";
@@ -11,6 +11,7 @@
 #include "AliFemtoEvent.h"
 #include "AliFemtoPair.h"
 #include "AliFemtoPairCut.h"
+#include "AliFemtoPairBlock.h"
 
 #include <TCollection.h>
 
@@ -44,6 +45,16 @@ public:
   /// Not Implemented - Add background pair
   virtual void AddMixedPair(AliFemtoPair* aPir);
 
+  /// Add the signal pairs of a block which passed the pair cut
+  ///
+  /// Called instead of AddRealPair when the analysis uses pair blocks.
+  /// The default implementation calls AddRealPair for each pair.
+  virtual void AddRealPairs(AliFemtoPairBlock &block);
+  /// Add the background pairs of a block which passed the pair cut
+  ///
+  /// The default implementation calls AddMixedPair for each pair.
+  virtual void AddMixedPairs(AliFemtoPairBlock &block);
+
   /// Not Implemented - Add pair with optional
   virtual void AddFirstParticle(AliFemtoParticle *particle, bool mixing);
   virtual void AddSecondParticle(AliFemtoParticle *particle);
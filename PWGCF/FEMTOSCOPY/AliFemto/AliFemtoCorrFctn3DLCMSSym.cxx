@@ -198,6 +198,61 @@ void AliFemtoCorrFctn3DLCMSSym::AddMixedPair(AliFemtoPair* pair)
   }
 }
 
+//____________________________
+void AliFemtoCorrFctn3DLCMSSym::AddRealPairs(AliFemtoPairBlock &block)
+{
+  if (!fUseLCMS) {
+    AliFemtoCorrFctn::AddRealPairs(block);
+    return;
+  }
+  FillPairs(block, fNumerator, fNumeratorW);
+}
+//____________________________
+void AliFemtoCorrFctn3DLCMSSym::AddMixedPairs(AliFemtoPairBlock &block)
+{
+  if (!fUseLCMS) {
+    AliFemtoCorrFctn::AddMixedPairs(block);
+    return;
+  }
+  FillPairs(block, fDenominator, fDenominatorW);
+}
+//____________________________
+void AliFemtoCorrFctn3DLCMSSym::FillPairs(AliFemtoPairBlock &block, TH3F *hist, TH3F *histW)
+{
+  // fill the LCMS components of the selected pairs of the block
+  const UChar_t *pass = block.Passed();
+  if (fPairCut) {
+    UChar_t *selection = block.CopyPassed();
+    fPairCut->PassPairs(block, selection);
+    pass = selection;
+  }
+
+  const double *qinv = block.QInv(),
+               *qout = block.QOutCMS(),
+               *qside = block.QSideCMS(),
+               *qlong = block.QLongCMS();
+
+  // in range of the histogram, i.e. neither underflow nor overflow bin
+  const TAxis *xaxis = hist->GetXaxis(),
+              *yaxis = hist->GetYaxis(),
+              *zaxis = hist->GetZaxis();
+  const double xlo = xaxis->GetXmin(), xhi = xaxis->GetXmax(),
+               ylo = yaxis->GetXmin(), yhi = yaxis->GetXmax(),
+               zlo = zaxis->GetXmin(), zhi = zaxis->GetXmax();
+
+  for (size_t i = 0; i < block.Size(); ++i) {
+    if (!pass[i]) {
+      continue;
+    }
+    if (xlo <= qout[i] && qout[i] < xhi
+        && ylo <= qside[i] && qside[i] < yhi
+        && zlo <= qlong[i] && qlong[i] < zhi) {
+      hist->Fill(qout[i], qside[i], qlong[i], 1.0);
+      histW->Fill(qout[i], qside[i], qlong[i], qinv[i]);
+    }
+  }
+}
+
 void AliFemtoCorrFctn3DLCMSSym::SetUseLCMS(int aUseLCMS)
 {
   fUseLCMS = aUseLCMS;
@@ -40,6 +40,11 @@ public:
   virtual void AddRealPair(AliFemtoPair* aPair);
   virtual void AddMixedPair(AliFemtoPair* aPair);
 
+  /// Fill from the precomputed LCMS components of the block; in the pair
+  /// frame (SetUseLCMS(0)) the per-pair methods are used
+  virtual void AddRealPairs(AliFemtoPairBlock &block);
+  virtual void AddMixedPairs(AliFemtoPairBlock &block);
+
   virtual void Finish();
 
   TH3F* Numerator();
@@ -56,6 +61,8 @@ public:
 
 private:
 
+  void FillPairs(AliFemtoPairBlock &block, TH3F *hist, TH3F *histW);
+
   TH3F* fNumerator;     ///< Numerator
   TH3F* fDenominator;   ///< Denominator
   TH3F* fNumeratorW;    ///< Qinv-Weighted numerator
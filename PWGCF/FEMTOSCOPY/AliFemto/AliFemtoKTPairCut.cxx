@@ -155,6 +155,26 @@ bool AliFemtoKTPairCut::Pass(const AliFemtoPair* pair)
   return (fPhiMin <= rpangle) && (rpangle < fPhiMax);
 }
 
+void AliFemtoKTPairCut::PassPairs(AliFemtoPairBlock &block, UChar_t *pass)
+{
+  // The kT cut from the precomputed kT of the block. The pT and angle
+  // cuts, if they are set, are applied with the per-pair method.
+  const bool only_kt = (fPtMin <= 0.0) && (fPtMax >= 1000.0)
+                    && (fPhiMin == 0.0) && (fPhiMax == 360.0);
+
+  const double *kt = block.KT();
+  for (size_t i = 0; i < block.Size(); ++i) {
+    if (!pass[i]) {
+      continue;
+    }
+    if (kt[i] < fKTMin || fKTMax <= kt[i]) {
+      pass[i] = false;
+    } else if (!only_kt) {
+      pass[i] = Pass(block.Pair(i));
+    }
+  }
+}
+
 bool AliFemtoKTPairCut::Pass(const AliFemtoPair* pair, double aRPAngle)
 {
   // The same as above, but it is defined with RP Angle as input in
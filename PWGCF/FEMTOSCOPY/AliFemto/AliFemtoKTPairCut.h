@@ -34,6 +34,7 @@ public:
   void SetPTMin(double ptmin, double ptmax=1000.0);
   virtual bool Pass(const AliFemtoPair* pair);
   virtual bool Pass(const AliFemtoPair* pair, double aRPAngle);
+  virtual void PassPairs(AliFemtoPairBlock &block, UChar_t *pass);
 
   std::pair<double, double> GetKtRange() const
     { return std::make_pair(fKTMin, fKTMax); }
@@ -0,0 +1,163 @@
+///
+/// \file AliFemtoPairBlock.cxx
+///
+
+#include "AliFemtoPairBlock.h"
+
+#include <cmath>
+
+
+AliFemtoParticleArray::AliFemtoParticleArray():
+  fParticle()
+  , fPx()
+  , fPy()
+  , fPz()
+  , fE()
+{
+}
+
+void AliFemtoParticleArray::Fill(const AliFemtoParticleCollection &collection)
+{
+  fParticle.clear();
+  fPx.clear();
+  fPy.clear();
+  fPz.clear();
+  fE.clear();
+
+  for (AliFemtoParticle *particle : collection) {
+    const AliFemtoLorentzVector &p = particle->FourMomentum();
+    fParticle.push_back(particle);
+    fPx.push_back(p.x());
+    fPy.push_back(p.y());
+    fPz.push_back(p.z());
+    fE.push_back(p.t());
+  }
+}
+
+//_________________________
+AliFemtoPairBlock::AliFemtoPairBlock(size_t capacity):
+  fCapacity(capacity > 0 ? capacity : 1)
+  , fTrack1()
+  , fTrack2()
+  , fPx1()
+  , fPy1()
+  , fPz1()
+  , fE1()
+  , fPx2()
+  , fPy2()
+  , fPz2()
+  , fE2()
+  , fQInv()
+  , fKT()
+  , fQOutCMS()
+  , fQSideCMS()
+  , fQLongCMS()
+  , fPassed()
+  , fSelection()
+  , fPair()
+{
+  fTrack1.reserve(fCapacity);
+  fTrack2.reserve(fCapacity);
+  fPx1.reserve(fCapacity);
+  fPy1.reserve(fCapacity);
+  fPz1.reserve(fCapacity);
+  fE1.reserve(fCapacity);
+  fPx2.reserve(fCapacity);
+  fPy2.reserve(fCapacity);
+  fPz2.reserve(fCapacity);
+  fE2.reserve(fCapacity);
+}
+
+AliFemtoPairBlock::AliFemtoPairBlock(const AliFemtoPairBlock &orig):
+  AliFemtoPairBlock(orig.fCapacity)
+{
+}
+
+AliFemtoPairBlock& AliFemtoPairBlock::operator=(const AliFemtoPairBlock &orig)
+{
+  if (this != &orig) {
+    fCapacity = orig.fCapacity;
+    Clear();
+  }
+  return *this;
+}
+
+void AliFemtoPairBlock::Clear()
+{
+  fTrack1.clear();
+  fTrack2.clear();
+  fPx1.clear();
+  fPy1.clear();
+  fPz1.clear();
+  fE1.clear();
+  fPx2.clear();
+  fPy2.clear();
+  fPz2.clear();
+  fE2.clear();
+}
+
+void AliFemtoPairBlock::AddPair(const AliFemtoParticleArray &p1, size_t i1,
+                                const AliFemtoParticleArray &p2, size_t i2)
+{
+  fTrack1.push_back(p1.Particle(i1));
+  fPx1.push_back(p1.Px(i1));
+  fPy1.push_back(p1.Py(i1));
+  fPz1.push_back(p1.Pz(i1));
+  fE1.push_back(p1.E(i1));
+
+  fTrack2.push_back(p2.Particle(i2));
+  fPx2.push_back(p2.Px(i2));
+  fPy2.push_back(p2.Py(i2));
+  fPz2.push_back(p2.Pz(i2));
+  fE2.push_back(p2.E(i2));
+}
+
+void AliFemtoPairBlock::Compute()
+{
+  // The expressions are those of AliFemtoPair::QInv, KT, QOutCMS,
+  // QSideCMS and QLongCMS, evaluated in the same order so that the
+  // results are identical.
+
+  const size_t n = Size();
+
+  fQInv.resize(n);
+  fKT.resize(n);
+  fQOutCMS.resize(n);
+  fQSideCMS.resize(n);
+  fQLongCMS.resize(n);
+  fPassed.assign(n, 1);
+
+  for (size_t i = 0; i < n; ++i) {
+    const double
+      x1 = fPx1[i], y1 = fPy1[i], z1 = fPz1[i], t1 = fE1[i],
+      x2 = fPx2[i], y2 = fPy2[i], z2 = fPz2[i], t2 = fE2[i],
+
+      dx = x1 - x2,
+      dy = y1 - y2,
+      dz = z1 - z2,
+      dt = t1 - t2,
+
+      xt = x1 + x2,
+      yt = y1 + y2,
+      zz = z1 + z2,
+      tt = t1 + t2,
+
+      m2 = dt*dt - (dx*dx + dy*dy + dz*dz),
+      pt = ::sqrt(xt*xt + yt*yt),
+
+      beta = zz/tt,
+      gamma = 1.0/::sqrt((1.-beta)*(1.+beta));
+
+    fQInv[i] = (m2 < 0) ? ::sqrt(-m2) : -::sqrt(m2);
+    fKT[i] = pt * .5;
+    fQOutCMS[i] = (pt == 0.0) ? 0.0 : (dx*xt + dy*yt) / pt;
+    fQSideCMS[i] = (pt == 0.0) ? 0.0 : 2.0 * (x2*y1 - x1*y2) / pt;
+    fQLongCMS[i] = gamma * (dz - beta*dt);
+  }
+}
+
+UChar_t* AliFemtoPairBlock::CopyPassed()
+{
+  fSelection.assign(fPassed.begin(), fPassed.end());
+  return fSelection.data();
+}
@@ -0,0 +1,141 @@
+///
+/// \file AliFemtoPairBlock.h
+///
+
+#pragma once
+
+#ifndef ALIFEMTOPAIRBLOCK_H
+#define ALIFEMTOPAIRBLOCK_H
+
+#include "AliFemtoParticleCollection.h"
+#include "AliFemtoPair.h"
+
+#include <vector>
+
+
+/// \class AliFemtoParticleArray
+/// \brief The particles of a collection with their four-momenta in
+///        contiguous arrays
+///
+/// The particle collections are lists of pointers; the pair loops of
+/// the block backend read the momenta from this copy instead.
+/// Entry i is the i-th particle of the collection.
+///
+class AliFemtoParticleArray {
+public:
+  AliFemtoParticleArray();
+
+  /// Replace the contents with the particles of the collection
+  void Fill(const AliFemtoParticleCollection &collection);
+
+  size_t Size() const { return fParticle.size(); }
+
+  AliFemtoParticle* Particle(size_t i) const { return fParticle[i]; }
+  double Px(size_t i) const { return fPx[i]; }
+  double Py(size_t i) const { return fPy[i]; }
+  double Pz(size_t i) const { return fPz[i]; }
+  double E(size_t i) const { return fE[i]; }
+
+protected:
+  std::vector<AliFemtoParticle*> fParticle;  ///< the particles (not owned)
+  std::vector<double> fPx;                   ///< x-component of the momenta
+  std::vector<double> fPy;                   ///< y-component of the momenta
+  std::vector<double> fPz;                   ///< z-component of the momenta
+  std::vector<double> fE;                    ///< energies
+};
+
+
+/// \class AliFemtoPairBlock
+/// \brief A block of pairs with their kinematics computed in one pass
+///
+/// Used by AliFemtoSimpleAnalysis when SetUsePairBlocks(true) is set.
+/// Pairs are collected with AddPair, then Compute() fills QInv, KT and
+/// the LCMS components QOutCMS, QSideCMS and QLongCMS (same definitions
+/// as the methods of AliFemtoPair) for all pairs at once.
+///
+/// The pair cut of the analysis sets the flags returned by Passed().
+/// Pair cuts (AliFemtoPairCut::PassPairs) and correlation functions
+/// (AliFemtoCorrFctn::AddRealPairs/AddMixedPairs) may read the arrays
+/// directly; the default implementations call the per-pair methods with
+/// the AliFemtoPair returned by Pair(i).
+///
+class AliFemtoPairBlock {
+public:
+  /// Construct an empty block holding at most capacity pairs
+  AliFemtoPairBlock(size_t capacity=1024);
+  /// Copy constructor - copies the capacity only, the block is empty
+  AliFemtoPairBlock(const AliFemtoPairBlock &orig);
+  AliFemtoPairBlock& operator=(const AliFemtoPairBlock &orig);
+
+  /// Remove all pairs
+  void Clear();
+
+  /// Append the pair (particle i1 of p1, particle i2 of p2)
+  void AddPair(const AliFemtoParticleArray &p1, size_t i1,
+               const AliFemtoParticleArray &p2, size_t i2);
+
+  /// Compute the kinematics of all pairs and mark all pairs as passed
+  void Compute();
+
+  size_t Size() const { return fTrack1.size(); }
+  size_t Capacity() const { return fCapacity; }
+  bool IsFull() const { return fTrack1.size() >= fCapacity; }
+
+  AliFemtoParticle* Track1(size_t i) const { return fTrack1[i]; }
+  AliFemtoParticle* Track2(size_t i) const { return fTrack2[i]; }
+
+  /// The pair i as AliFemtoPair, for the per-pair interface
+  ///
+  /// The same object is returned for every pair, it is only valid until
+  /// the next call.
+  AliFemtoPair* Pair(size_t i);
+
+  const double* QInv() const { return fQInv.data(); }
+  const double* KT() const { return fKT.data(); }
+  const double* QOutCMS() const { return fQOutCMS.data(); }
+  const double* QSideCMS() const { return fQSideCMS.data(); }
+  const double* QLongCMS() const { return fQLongCMS.data(); }
+
+  /// Flags of the pairs passing the pair cut of the analysis
+  const UChar_t* Passed() const { return fPassed.data(); }
+  UChar_t* Passed() { return fPassed.data(); }
+
+  /// Copy of the flags of Passed() in a scratch buffer, for correlation
+  /// functions which apply an additional pair cut
+  UChar_t* CopyPassed();
+
+protected:
+  size_t fCapacity;                         ///< maximum number of pairs
+
+  std::vector<AliFemtoParticle*> fTrack1;   ///< first particles (not owned)
+  std::vector<AliFemtoParticle*> fTrack2;   ///< second particles (not owned)
+
+  std::vector<double> fPx1;                 ///< four-momenta of the first particles
+  std::vector<double> fPy1;
+  std::vector<double> fPz1;
+  std::vector<double> fE1;
+  std::vector<double> fPx2;                 ///< four-momenta of the second particles
+  std::vector<double> fPy2;
+  std::vector<double> fPz2;
+  std::vector<double> fE2;
+
+  std::vector<double> fQInv;                ///< invariant relative momentum
+  std::vector<double> fKT;                  ///< pair transverse momentum
+  std::vector<double> fQOutCMS;             ///< out component in the LCMS
+  std::vector<double> fQSideCMS;            ///< side component in the LCMS
+  std::vector<double> fQLongCMS;            ///< long component in the LCMS
+
+  std::vector<UChar_t> fPassed;             ///< pair cut flags
+  std::vector<UChar_t> fSelection;          ///< scratch copy of fPassed
+
+  AliFemtoPair fPair;                       ///< pair handed to the per-pair interface
+};
+
+inline AliFemtoPair* AliFemtoPairBlock::Pair(size_t i)
+{
+  fPair.SetTrack1(fTrack1[i]);
+  fPair.SetTrack2(fTrack2[i]);
+  return &fPair;
+}
+
+#endif
@@ -17,6 +17,7 @@ class AliFemtoAnalysis;
 #include "AliFemtoString.h"
 #include "AliFemtoEvent.h"
 #include "AliFemtoPair.h"
+#include "AliFemtoPairBlock.h"
 #include "AliFemtoCutMonitorHandler.h"
 #include <TList.h>
 #include <TObjString.h>
@@ -43,6 +44,14 @@ public:
 
   virtual bool Pass(const AliFemtoPair* pair) = 0;  ///< true if pair passes, false if not
 
+  /// Apply the cut to the pairs of a block
+  ///
+  /// pass[i] is cleared for the pairs i which fail the cut; pairs with
+  /// pass[i] already cleared are not tested. The default implementation
+  /// calls Pass for each pair, cuts depending only on the kinematics
+  /// of AliFemtoPairBlock may use the precomputed arrays instead.
+  virtual void PassPairs(AliFemtoPairBlock &block, UChar_t *pass);
+
   virtual AliFemtoString Report() = 0;              ///< user-written method to return string describing cuts
   virtual TList *ListSettings() = 0;                ///< Return a TList of settings
 
@@ -66,6 +75,15 @@ inline AliFemtoPairCut::AliFemtoPairCut(): AliFemtoCutMonitorHandler(), fyAnalys
 inline AliFemtoPairCut::AliFemtoPairCut(const AliFemtoPairCut& /* aCut */): AliFemtoCutMonitorHandler(), fyAnalysis(NULL) { /* no-op */ }
 inline AliFemtoPairCut::~AliFemtoPairCut(){ /* no-op */ }
 
+inline void AliFemtoPairCut::PassPairs(AliFemtoPairBlock &block, UChar_t *pass)
+{
+  for (size_t i = 0; i < block.Size(); ++i) {
+    if (pass[i]) {
+      pass[i] = Pass(block.Pair(i));
+    }
+  }
+}
+
 inline void AliFemtoPairCut::SetAnalysis(AliFemtoAnalysis* analysis) { fyAnalysis = analysis; }
 inline AliFemtoPairCut& AliFemtoPairCut::operator=(const AliFemtoPairCut &aCut) { if (this == &aCut) return *this; fyAnalysis = aCut.fyAnalysis; return *this; }
 
@@ -183,7 +183,11 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis():
   fMinSizePartCollection(0),
   fVerbose(kTRUE),
   fPerformSharedDaughterCut(kFALSE),
-  fEnablePairMonitors(kFALSE)
+  fEnablePairMonitors(kFALSE),
+  fUsePairBlocks(kFALSE),
+  fParticles1(),
+  fParticles2(),
+  fPairBlock()
 {
   // Default constructor
   fCorrFctnCollection = new AliFemtoCorrFctnCollection;
@@ -205,7 +209,11 @@ AliFemtoSimpleAnalysis::AliFemtoSimpleAnalysis(const AliFemtoSimpleAnalysis& a):
   fMinSizePartCollection(a.fMinSizePartCollection),
   fVerbose(a.fVerbose),
   fPerformSharedDaughterCut(a.fPerformSharedDaughterCut),
-  fEnablePairMonitors(a.fEnablePairMonitors)
+  fEnablePairMonitors(a.fEnablePairMonitors),
+  fUsePairBlocks(a.fUsePairBlocks),
+  fParticles1(),
+  fParticles2(),
+  fPairBlock(a.fPairBlock)
 {
   /// Copy constructor
 
@@ -402,6 +410,7 @@ AliFemtoSimpleAnalysis& AliFemtoSimpleAnalysis::operator=(const AliFemtoSimpleAn
   fVerbose = aAna.fVerbose;
   fPerformSharedDaughterCut = aAna.fPerformSharedDaughterCut;
   fEnablePairMonitors = aAna.fEnablePairMonitors;
+  fUsePairBlocks = aAna.fUsePairBlocks;
 
   return *this;
 }
@@ -591,6 +600,11 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
     std::cerr << "Problem with pair type, type = " << typeIn << "\n";
     return;
   }
+
+  if (fUsePairBlocks) {
+    MakePairBlocks(these_are_real_pairs, partCollection1, partCollection2, enablePairMonitors);
+    return;
+  }
   //  int swpart = ((long int) partCollection1) % 2;
 
   // Used to swap particle 1 & 2 in identical-particle analysis
@@ -680,6 +694,80 @@ void AliFemtoSimpleAnalysis::MakePairs(const char* typeIn,
   delete tPair;
 }
 //_________________________
+void AliFemtoSimpleAnalysis::MakePairBlocks(bool real,
+                                            AliFemtoParticleCollection *partCollection1,
+                                            AliFemtoParticleCollection *partCollection2,
+                                            Bool_t enablePairMonitors)
+{
+  /// Same pairs, in the same order and with the same swapping of the
+  /// particles, as the loops of MakePairs - collected in fPairBlock
+
+  bool swpart = fNeventsProcessed % 2;
+
+  fParticles1.Fill(*partCollection1);
+  if (partCollection2) {
+    fParticles2.Fill(*partCollection2);
+  }
+  const AliFemtoParticleArray &inner = partCollection2 ? fParticles2 : fParticles1;
+
+  const size_t n1 = fParticles1.Size(),
+               n2 = inner.Size();
+
+  fPairBlock.Clear();
+
+  for (size_t i = 0; i < n1; ++i) {
+    for (size_t j = partCollection2 ? 0 : i + 1; j < n2; ++j) {
+
+      if (partCollection2 != nullptr) {
+        fPairBlock.AddPair(fParticles1, i, inner, j);
+
+      // Swap between first and second particles to avoid biased ordering
+      } else {
+        if (swpart) {
+          fPairBlock.AddPair(inner, j, fParticles1, i);
+        } else {
+          fPairBlock.AddPair(fParticles1, i, inner, j);
+        }
+        swpart = !swpart;
+      }
+
+      if (fPairBlock.IsFull()) {
+        ProcessPairBlock(real, enablePairMonitors);
+      }
+    }
+  }
+
+  ProcessPairBlock(real, enablePairMonitors);
+}
+//_________________________
+void AliFemtoSimpleAnalysis::ProcessPairBlock(bool real, Bool_t enablePairMonitors)
+{
+  if (fPairBlock.Size() == 0) {
+    return;
+  }
+
+  fPairBlock.Compute();
+
+  UChar_t *pass = fPairBlock.Passed();
+  fPairCut->PassPairs(fPairBlock, pass);
+
+  // This is a condition for speed reasons
+  if (enablePairMonitors) {
+    for (size_t i = 0; i < fPairBlock.Size(); ++i) {
+      fPairCut->FillCutMonitor(fPairBlock.Pair(i), pass[i]);
+    }
+  }
+
+  for (auto &tCorrFctn : *fCorrFctnCollection) {
+    if (real)
+      tCorrFctn->AddRealPairs(fPairBlock);
+    else
+      tCorrFctn->AddMixedPairs(fPairBlock);
+  }
+
+  fPairBlock.Clear();
+}
+//_________________________
 void AliFemtoSimpleAnalysis::EventBegin(const AliFemtoEvent* ev)
 {
   /// Perform initialization operations at the beginning of the event processing
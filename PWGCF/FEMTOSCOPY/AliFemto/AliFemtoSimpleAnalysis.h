@@ -13,6 +13,7 @@
 #include "AliFemtoCorrFctnCollection.h"
 #include "AliFemtoPicoEventCollection.h"
 #include "AliFemtoParticleCollection.h"
+#include "AliFemtoPairBlock.h"
 #include "AliFemtoV0SharedDaughterCut.h"
 #include "AliFemtoXiSharedDaughterCut.h"
 
@@ -99,6 +100,17 @@ public:
   void SetEnablePairMonitors(Bool_t aEnable);
   Bool_t EnablePairMonitors();
 
+  /// Process the pairs in blocks (AliFemtoPairBlock) instead of one by one
+  ///
+  /// The particles are copied into contiguous arrays, the kinematics of
+  /// a block of pairs are computed at once, and the pair cut and the
+  /// correlation functions receive the whole block (PassPairs,
+  /// AddRealPairs/AddMixedPairs). Cuts and correlation functions without
+  /// a block implementation are called per pair, in the same pair order
+  /// as without blocks. Off by default.
+  void SetUsePairBlocks(Bool_t aUse);
+  Bool_t UsePairBlocks();
+
   unsigned int NumEventsToMix() const;
   void SetNumEventsToMix(const unsigned int& NumberOfEventsToMix);
   AliFemtoPicoEvent* CurrentPicoEvent();
@@ -159,6 +171,16 @@ protected:
                  AliFemtoParticleCollection* ParticlesPssingCut2=NULL,
                  Bool_t enablePairMonitors=kFALSE);
 
+  /// Implementation of MakePairs with pair blocks, see SetUsePairBlocks
+  void MakePairBlocks(bool real,
+                      AliFemtoParticleCollection* ParticlesPassingCut1,
+                      AliFemtoParticleCollection* ParticlesPssingCut2,
+                      Bool_t enablePairMonitors);
+
+  /// Apply the pair cut to fPairBlock and pass it to the correlation
+  /// functions, then clear it
+  void ProcessPairBlock(bool real, Bool_t enablePairMonitors);
+
   AliFemtoPicoEventCollectionVectorHideAway* fPicoEventCollectionVectorHideAway; //!<! Mixing Buffer used for Analyses which wrap this one
 
   AliFemtoPairCut*             fPairCut;             ///< cut applied to pairs
@@ -177,6 +199,11 @@ protected:
   Bool_t fVerbose;
   Bool_t fPerformSharedDaughterCut;
   Bool_t fEnablePairMonitors;
+  Bool_t fUsePairBlocks;                             ///< process pairs in blocks, see SetUsePairBlocks
+
+  AliFemtoParticleArray fParticles1;                 //!<! contiguous copy of the first particle collection
+  AliFemtoParticleArray fParticles2;                 //!<! contiguous copy of the second particle collection
+  AliFemtoPairBlock     fPairBlock;                  //!<! current block of pairs
 
 #ifdef __ROOT__
   /// \cond CLASSIMP
@@ -242,6 +269,11 @@ inline bool AliFemtoSimpleAnalysis::EnablePairMonitors()
   return fEnablePairMonitors;
 }
 
+inline Bool_t AliFemtoSimpleAnalysis::UsePairBlocks()
+{
+  return fUsePairBlocks;
+}
+
 // Sets
 inline void AliFemtoSimpleAnalysis::SetPairCut(AliFemtoPairCut* x)
 {
@@ -305,4 +337,9 @@ inline void AliFemtoSimpleAnalysis::SetEnablePairMonitors(Bool_t aEnable)
   fEnablePairMonitors = aEnable;
 }
 
+inline void AliFemtoSimpleAnalysis::SetUsePairBlocks(Bool_t aUse)
+{
+  fUsePairBlocks = aUse;
+}
+
 #endif
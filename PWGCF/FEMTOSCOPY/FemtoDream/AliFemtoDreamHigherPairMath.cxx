@@ -8,6 +8,7 @@
 #include <AliFemtoDreamHigherPairMath.h>
 #include "TMath.h"
 #include "TDatabasePDG.h"
+#include <cmath>
 static const float piHi = TMath::Pi();
 
 AliFemtoDreamHigherPairMath::AliFemtoDreamHigherPairMath(
@@ -439,6 +440,34 @@ float AliFemtoDreamHigherPairMath::RelativePairMomentum(
   return 0.5 * trackRelK.P();
 }
 
+void AliFemtoDreamHigherPairMath::RelativePairMomentum(
+    double px1, double py1, double pz1, double e1, unsigned int nPart,
+    const double *px2, const double *py2, const double *pz2, const double *e2,
+    float *RelativeK) {
+  //Boost of the difference of the two four momenta into the pair rest frame,
+  //as TLorentzVector::Boost, the loop has no branches
+  for (unsigned int iPart = 0; iPart < nPart; ++iPart) {
+    const double eSum = e1 + e2[iPart];
+    const double bx = (px1 + px2[iPart]) / eSum;
+    const double by = (py1 + py2[iPart]) / eSum;
+    const double bz = (pz1 + pz2[iPart]) / eSum;
+    const double b2 = bx * bx + by * by + bz * bz;
+    const double gamma = 1. / std::sqrt(1. - b2);
+    //(gamma - 1) / b2, written such that it is finite for b2 -> 0
+    const double gamma2 = gamma * gamma / (gamma + 1.);
+    const double qx = px1 - px2[iPart];
+    const double qy = py1 - py2[iPart];
+    const double qz = pz1 - pz2[iPart];
+    const double q0 = e1 - e2[iPart];
+    const double bq = bx * qx + by * qy + bz * qz;
+    const double fac = gamma2 * bq - gamma * q0;
+    const double kx = qx + fac * bx;
+    const double ky = qy + fac * by;
+    const double kz = qz + fac * bz;
+    RelativeK[iPart] = 0.5 * std::sqrt(kx * kx + ky * ky + kz * kz);
+  }
+}
+
 float AliFemtoDreamHigherPairMath::RelativePairkT(AliFemtoDreamBasePart *part1,
                                                   const int pdg1,
                                                   AliFemtoDreamBasePart *part2,
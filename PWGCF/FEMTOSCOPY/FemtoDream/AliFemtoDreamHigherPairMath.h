@@ -83,6 +83,13 @@ class AliFemtoDreamHigherPairMath {
                                     const int pdg2);
   static float RelativePairMomentum(TLorentzVector &PartOne,
                                     TLorentzVector &PartTwo);
+  //k* of one particle (px, py, pz, E) with nPart particles given as arrays,
+  //same definition as above without the intermediate TLorentzVectors
+  static void RelativePairMomentum(double px1, double py1, double pz1,
+                                   double e1, unsigned int nPart,
+                                   const double *px2, const double *py2,
+                                   const double *pz2, const double *e2,
+                                   float *RelativeK);
   static float RelativePairkT(AliFemtoDreamBasePart *PartOne, const int pdg1,
                               AliFemtoDreamBasePart *PartTwo, const int pdg2);
   static float RelativePairkT(TLorentzVector &PartOne, TLorentzVector &PartTwo);
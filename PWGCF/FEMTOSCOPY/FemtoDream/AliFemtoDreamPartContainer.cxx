@@ -8,17 +8,43 @@
 #include <iostream>
 #include "AliFemtoDreamPartContainer.h"
 #include "TLorentzVector.h"
+#include "TMath.h"
 #include "TVector3.h"
 ClassImp(AliFemtoDreamPartContainer)
+
+void AliFemtoDreamPartKinematics::Set(
+    const std::vector<AliFemtoDreamBasePart> &Particles, double mass) {
+  const unsigned int nPart = Particles.size();
+  fPx.resize(nPart);
+  fPy.resize(nPart);
+  fPz.resize(nPart);
+  fE.resize(nPart);
+  for (unsigned int iPart = 0; iPart < nPart; ++iPart) {
+    TVector3 P(Particles[iPart].GetMomentum());
+    fPx[iPart] = P.X();
+    fPy[iPart] = P.Y();
+    fPz[iPart] = P.Z();
+    fE[iPart] = TMath::Sqrt(P.Mag2() + mass * mass);
+  }
+}
+
 AliFemtoDreamPartContainer::AliFemtoDreamPartContainer()
     : fPartBuffer(),
-      fMixingDepth(0) {
+      fKinematics(),
+      fMixingDepth(0),
+      fFirstEvent(0),
+      fNEvents(0),
+      fMass(0) {
 
 }
 
 AliFemtoDreamPartContainer::AliFemtoDreamPartContainer(int MixingDepth)
-    : fPartBuffer(),
-      fMixingDepth(MixingDepth) {
+    : fPartBuffer(MixingDepth),
+      fKinematics(MixingDepth),
+      fMixingDepth(MixingDepth),
+      fFirstEvent(0),
+      fNEvents(0),
+      fMass(0) {
 
 }
 
@@ -27,15 +53,12 @@ AliFemtoDreamPartContainer& AliFemtoDreamPartContainer::operator=(
   if (this == &obj) {
     return *this;
   }
-//  std::deque<std::deque<AliFemtoDreamBasePart>>::iterator copyIter;
-//  std::deque<std::deque<AliFemtoDreamBasePart>>::iterator objIter;
-//  for (objIter=obj.fPartBuffer.begin();objIter!=obj.fPartBuffer.end();
-//      ++objIter)
-//  {
-//
-//  }
   this->fMixingDepth = obj.fMixingDepth;
   this->fPartBuffer = obj.fPartBuffer;
+  this->fKinematics = obj.fKinematics;
+  this->fFirstEvent = obj.fFirstEvent;
+  this->fNEvents = obj.fNEvents;
+  this->fMass = obj.fMass;
   return (*this);
 }
 
@@ -44,22 +67,30 @@ AliFemtoDreamPartContainer::~AliFemtoDreamPartContainer() {
 
 void AliFemtoDreamPartContainer::SetEvent(
     std::vector<AliFemtoDreamBasePart> &Particles) {
-  if (!(fPartBuffer.size() < fMixingDepth)) {
-//    std::cout << "Popping Front" << std::endl;
-    fPartBuffer.pop_front();
+  if (fMixingDepth == 0) {
+    return;
+  }
+  unsigned int slot;
+  if (fNEvents < fMixingDepth) {
+    slot = GetSlot(fNEvents);
+    ++fNEvents;
+  } else {
+    //overwrite the oldest event
+    slot = fFirstEvent;
+    fFirstEvent = (fFirstEvent + 1) % fMixingDepth;
   }
-  fPartBuffer.push_back(Particles);
-//  std::cout << "PartBuffer Size: "<<fPartBuffer.size()<<'\t'<<"Input Size: "
-//      << Particles.size() << '\n';
+  //the assignment reuses the memory of the event previously in this slot
+  fPartBuffer[slot] = Particles;
+  fKinematics[slot].Set(Particles, fMass);
   return;
 }
 
 void AliFemtoDreamPartContainer::PrintLastEvent() {
-  for (std::deque<std::vector<AliFemtoDreamBasePart>>::iterator itEvt =
-      fPartBuffer.begin(); itEvt != fPartBuffer.end(); ++itEvt) {
-    std::cout << "Printing Last Event with size: " << itEvt->size() << '\n';
-    for (std::vector<AliFemtoDreamBasePart>::iterator itPart = itEvt->begin();
-        itPart != itEvt->end(); ++itPart) {
+  for (unsigned int iDepth = 0; iDepth < fNEvents; ++iDepth) {
+    std::vector<AliFemtoDreamBasePart> &Evt = GetEvent(iDepth);
+    std::cout << "Printing Last Event with size: " << Evt.size() << '\n';
+    for (std::vector<AliFemtoDreamBasePart>::iterator itPart = Evt.begin();
+        itPart != Evt.end(); ++itPart) {
       TVector3 P(itPart->GetMomentum());
       std::cout << "Px: " << P.X() << '\t' << "Py: " << P.Y() << '\t' << "Pz: "
                 << P.Z() << std::endl;
@@ -68,7 +99,10 @@ void AliFemtoDreamPartContainer::PrintLastEvent() {
 }
 std::vector<AliFemtoDreamBasePart> &AliFemtoDreamPartContainer::GetEvent(
     int Depth) {
-  std::deque<std::vector<AliFemtoDreamBasePart>>::iterator itEvt = fPartBuffer
-      .begin() + Depth;
-  return *itEvt;
+  return fPartBuffer[GetSlot(Depth)];
+}
+
+const AliFemtoDreamPartKinematics &AliFemtoDreamPartContainer::GetKinematics(
+    int Depth) const {
+  return fKinematics[GetSlot(Depth)];
 }
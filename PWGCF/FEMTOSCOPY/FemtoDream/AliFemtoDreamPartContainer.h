@@ -7,15 +7,32 @@
 
 #ifndef ALIFEMTODREAMPARTCONTAINER_H_
 #define ALIFEMTODREAMPARTCONTAINER_H_
-#include <deque>
 #include <vector>
 #include "Rtypes.h"
 
 #include "AliFemtoDreamBasePart.h"
 
+//Momenta and energies of the particles of one event, stored as arrays to
+//compute the relative momenta of all pairs with one particle in one go
+//(see AliFemtoDreamHigherPairMath::RelativePairMomentum)
+struct AliFemtoDreamPartKinematics {
+  void Set(const std::vector<AliFemtoDreamBasePart> &Particles, double mass);
+  unsigned int Size() const {
+    return fPx.size();
+  }
+  ;
+  std::vector<double> fPx;
+  std::vector<double> fPy;
+  std::vector<double> fPz;
+  std::vector<double> fE;
+};
+
 //Class Containing the Particles from previous Events up to a certain mixing
 //depth for one Particle Species and Mult/ZVtx Bin
 //ZVtx bin.
+//The events are kept in a ring buffer with one slot per mixing depth, the
+//oldest event is overwritten once the buffer is full. The slots keep their
+//memory from event to event and the events are accessed by reference.
 class AliFemtoDreamPartContainer {
  public:
   AliFemtoDreamPartContainer();
@@ -23,19 +40,29 @@ class AliFemtoDreamPartContainer {
   AliFemtoDreamPartContainer& operator=(const AliFemtoDreamPartContainer& obj);
   virtual ~AliFemtoDreamPartContainer();
   void PrintLastEvent();
-  void SetEvent(std::vector<AliFemtoDreamBasePart> &Particles);
-  std::deque<std::vector<AliFemtoDreamBasePart>> GetEventBuffer() const {
-    return fPartBuffer;
+  void SetMass(double mass) {
+    fMass = mass;
   }
   ;
+  void SetEvent(std::vector<AliFemtoDreamBasePart> &Particles);
+  //Depth 0 is the oldest event in the buffer
   std::vector<AliFemtoDreamBasePart> &GetEvent(int Depth);
+  const AliFemtoDreamPartKinematics &GetKinematics(int Depth) const;
   unsigned int GetMixingDepth() const {
-    return fPartBuffer.size();
+    return fNEvents;
   }
   ;
  private:
-  std::deque<std::vector<AliFemtoDreamBasePart>> fPartBuffer;
-  unsigned int fMixingDepth;ClassDef(AliFemtoDreamPartContainer,2)
+  unsigned int GetSlot(int Depth) const {
+    return (fFirstEvent + Depth) % fMixingDepth;
+  }
+  ;
+  std::vector<std::vector<AliFemtoDreamBasePart>> fPartBuffer;
+  std::vector<AliFemtoDreamPartKinematics> fKinematics;  //!
+  unsigned int fMixingDepth;
+  unsigned int fFirstEvent;
+  unsigned int fNEvents;
+  double fMass;ClassDef(AliFemtoDreamPartContainer,3)
   ;
 };
 
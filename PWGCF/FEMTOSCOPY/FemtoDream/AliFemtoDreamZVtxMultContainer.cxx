@@ -15,7 +15,10 @@ ClassImp(AliFemtoDreamPartContainer)
 AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer()
     : fPartContainer(0),
       fPDGParticleSpecies(0),
-      fWhichPairs(){
+      fWhichPairs(),
+      fMasses(),
+      fSEKinematics(),
+      fRelativeK() {
 }
 
 AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer(
@@ -23,10 +26,22 @@ AliFemtoDreamZVtxMultContainer::AliFemtoDreamZVtxMultContainer(
     : fPartContainer(conf->GetNParticles(),
                      AliFemtoDreamPartContainer(conf->GetMixingDepth())),
       fPDGParticleSpecies(conf->GetPDGCodes()),
-      fWhichPairs(conf->GetWhichPairs()){
+      fWhichPairs(conf->GetWhichPairs()),
+      fMasses(),
+      fSEKinematics(conf->GetNParticles()),
+      fRelativeK() {
   TDatabasePDG::Instance()->AddParticle("deuteron", "deuteron", 1.8756134,
                                         kTRUE, 0.0, 1, "Nucleus", 1000010020);
   TDatabasePDG::Instance()->AddAntiParticle("anti-deuteron", -1000010020);
+  //Look up the masses once, instead of for each pair
+  for (auto itPDG = fPDGParticleSpecies.begin();
+      itPDG != fPDGParticleSpecies.end(); ++itPDG) {
+    TParticlePDG *part = TDatabasePDG::Instance()->GetParticle(*itPDG);
+    fMasses.push_back(part ? part->Mass() : 0.);
+  }
+  for (unsigned int iSpec = 0; iSpec < fPartContainer.size(); ++iSpec) {
+    fPartContainer[iSpec].SetMass(fMasses.at(iSpec));
+  }
 }
 
 AliFemtoDreamZVtxMultContainer::~AliFemtoDreamZVtxMultContainer() {
@@ -56,57 +71,61 @@ void AliFemtoDreamZVtxMultContainer::SetEvent(
   }
   //  }
 }
+void AliFemtoDreamZVtxMultContainer::SetKinematics(
+    std::vector<std::vector<AliFemtoDreamBasePart>> &Particles) {
+  for (unsigned int iSpec = 0; iSpec < Particles.size(); ++iSpec) {
+    fSEKinematics[iSpec].Set(Particles[iSpec], fMasses[iSpec]);
+  }
+}
+
 void AliFemtoDreamZVtxMultContainer::PairParticlesSE(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
   int HistCounter = 0;
+  SetKinematics(Particles);
   //First loop over all the different Species
   auto itPDGPar1 = fPDGParticleSpecies.begin();
   for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
       ++itSpec1) {
+    const int iSpec1 = itSpec1 - Particles.begin();
+    const AliFemtoDreamPartKinematics &Kin1 = fSEKinematics[iSpec1];
     auto itPDGPar2 = fPDGParticleSpecies.begin();
-    itPDGPar2 += itSpec1 - Particles.begin();
+    itPDGPar2 += iSpec1;
     for (auto itSpec2 = itSpec1; itSpec2 != Particles.end(); ++itSpec2) {
+      const AliFemtoDreamPartKinematics &Kin2 = fSEKinematics[itSpec2
+          - Particles.begin()];
       HigherMath->FillPairCounterSE(HistCounter, itSpec1->size(),
                                     itSpec2->size());
       //Now loop over the actual Particles and correlate them
       for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
           ++itPart1) {
-        AliFemtoDreamBasePart part1 = *itPart1;
-        std::vector<AliFemtoDreamBasePart>::iterator itPart2;
-        if (itSpec1 == itSpec2) {
-          itPart2 = itPart1 + 1;
-        } else {
-          itPart2 = itSpec2->begin();
+        const int iPart1 = itPart1 - itSpec1->begin();
+        const int iFirst2 = (itSpec1 == itSpec2) ? iPart1 + 1 : 0;
+        const int nPart2 = (int) itSpec2->size() - iFirst2;
+        if (nPart2 <= 0) {
+          continue;
         }
-        while (itPart2 != itSpec2->end()) {
-          AliFemtoDreamBasePart part2 = *itPart2;
-          TLorentzVector PartOne, PartTwo;
-          PartOne.SetXYZM(
-              itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
-              itPart1->GetMomentum().Z(),
-              TDatabasePDG::Instance()->GetParticle(*itPDGPar1)->Mass());
-          PartTwo.SetXYZM(
-              itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
-              itPart2->GetMomentum().Z(),
-              TDatabasePDG::Instance()->GetParticle(*itPDGPar2)->Mass());
-          float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
-          if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
-                                               RelativeK, true, false)) {
-            ++itPart2;
+        //k* of this particle with all its partners in one go
+        fRelativeK.resize(nPart2);
+        AliFemtoDreamHigherPairMath::RelativePairMomentum(
+            Kin1.fPx[iPart1], Kin1.fPy[iPart1], Kin1.fPz[iPart1],
+            Kin1.fE[iPart1], nPart2, &Kin2.fPx[iFirst2], &Kin2.fPy[iFirst2],
+            &Kin2.fPz[iFirst2], &Kin2.fE[iFirst2], fRelativeK.data());
+        for (int iPart2 = 0; iPart2 < nPart2; ++iPart2) {
+          AliFemtoDreamBasePart &part2 = (*itSpec2)[iFirst2 + iPart2];
+          if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, part2,
+                                               fRelativeK[iPart2], true,
+                                               false)) {
             continue;
           }
-          RelativeK = HigherMath->FillSameEvent(HistCounter, iMult, cent,
-                                                part1,
-                                                *itPDGPar1,
-                                                part2,
-                                                *itPDGPar2);
-          HigherMath->MassQA(HistCounter, RelativeK, *itPart1, *itPart2);
+          float RelativeK = HigherMath->FillSameEvent(HistCounter, iMult, cent,
+                                                      *itPart1, *itPDGPar1,
+                                                      part2, *itPDGPar2);
+          HigherMath->MassQA(HistCounter, RelativeK, *itPart1, part2);
           HigherMath->SEDetaDPhiPlots(HistCounter, *itPart1, *itPDGPar1,
-                                      *itPart2, *itPDGPar2, RelativeK, false);
+                                      part2, *itPDGPar2, RelativeK, false);
           HigherMath->SEMomentumResolution(HistCounter, &(*itPart1), *itPDGPar1,
-                                           &(*itPart2), *itPDGPar2, RelativeK);
-          ++itPart2;
+                                           &part2, *itPDGPar2, RelativeK);
         }
       }
       ++HistCounter;
@@ -120,6 +139,7 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     std::vector<std::vector<AliFemtoDreamBasePart>> &Particles,
     AliFemtoDreamHigherPairMath *HigherMath, int iMult, float cent) {
   int HistCounter = 0;
+  SetKinematics(Particles);
   auto itPDGPar1 = fPDGParticleSpecies.begin();
   //First loop over all the different Species
   for (auto itSpec1 = Particles.begin(); itSpec1 != Particles.end();
@@ -127,6 +147,7 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
     //We dont want to correlate the particles twice. Mixed Event Dist. of
     //Particle1 + Particle2 == Particle2 + Particle 1
     int SkipPart = itSpec1 - Particles.begin();
+    const AliFemtoDreamPartKinematics &Kin1 = fSEKinematics[SkipPart];
     auto itPDGPar2 = fPDGParticleSpecies.begin() + SkipPart;
     for (auto itSpec2 = fPartContainer.begin() + SkipPart;
         itSpec2 != fPartContainer.end(); ++itSpec2) {
@@ -135,38 +156,41 @@ void AliFemtoDreamZVtxMultContainer::PairParticlesME(
                                              (int) itSpec2->GetMixingDepth());
       }
       for (int iDepth = 0; iDepth < (int) itSpec2->GetMixingDepth(); ++iDepth) {
-        std::vector<AliFemtoDreamBasePart> ParticlesOfEvent = itSpec2->GetEvent(
+        //reference to the buffered event, no copy
+        std::vector<AliFemtoDreamBasePart> &ParticlesOfEvent = itSpec2->GetEvent(
+            iDepth);
+        const AliFemtoDreamPartKinematics &Kin2 = itSpec2->GetKinematics(
             iDepth);
+        const int nPart2 = ParticlesOfEvent.size();
         HigherMath->FillPairCounterME(HistCounter, itSpec1->size(),
                                       ParticlesOfEvent.size());
+        if (nPart2 == 0) {
+          continue;
+        }
+        fRelativeK.resize(nPart2);
         for (auto itPart1 = itSpec1->begin(); itPart1 != itSpec1->end();
             ++itPart1) {
-          for (auto itPart2 = ParticlesOfEvent.begin();
-              itPart2 != ParticlesOfEvent.end(); ++itPart2) {
-
-            TLorentzVector PartOne, PartTwo;
-            PartOne.SetXYZM(
-                itPart1->GetMomentum().X(), itPart1->GetMomentum().Y(),
-                itPart1->GetMomentum().Z(),
-                TDatabasePDG::Instance()->GetParticle(*itPDGPar1)->Mass());
-            PartTwo.SetXYZM(
-                itPart2->GetMomentum().X(), itPart2->GetMomentum().Y(),
-                itPart2->GetMomentum().Z(),
-                TDatabasePDG::Instance()->GetParticle(*itPDGPar2)->Mass());
-            float RelativeK = HigherMath->RelativePairMomentum(PartOne, PartTwo);
-            if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, *itPart2,
-                                                 RelativeK, false, false)) {
+          const int iPart1 = itPart1 - itSpec1->begin();
+          AliFemtoDreamHigherPairMath::RelativePairMomentum(
+              Kin1.fPx[iPart1], Kin1.fPy[iPart1], Kin1.fPz[iPart1],
+              Kin1.fE[iPart1], nPart2, Kin2.fPx.data(), Kin2.fPy.data(),
+              Kin2.fPz.data(), Kin2.fE.data(), fRelativeK.data());
+          for (int iPart2 = 0; iPart2 < nPart2; ++iPart2) {
+            AliFemtoDreamBasePart &part2 = ParticlesOfEvent[iPart2];
+            if (!HigherMath->PassesPairSelection(HistCounter, *itPart1, part2,
+                                                 fRelativeK[iPart2], false,
+                                                 false)) {
               continue;
             }
-            RelativeK = HigherMath->FillMixedEvent(
+            float RelativeK = HigherMath->FillMixedEvent(
                 HistCounter, iMult, cent, *itPart1, *itPDGPar1,
-                *itPart2, *itPDGPar2,
+                part2, *itPDGPar2,
                 AliFemtoDreamCollConfig::kNone);
 
             HigherMath->MEDetaDPhiPlots(HistCounter, *itPart1, *itPDGPar1,
-                                        *itPart2, *itPDGPar2, RelativeK, false);
+                                        part2, *itPDGPar2, RelativeK, false);
             HigherMath->MEMomentumResolution(HistCounter, &(*itPart1),
-                                             *itPDGPar1, &(*itPart2),
+                                             *itPDGPar1, &part2,
                                              *itPDGPar2, RelativeK);
           }
         }
@@ -41,16 +41,20 @@ class AliFemtoDreamZVtxMultContainer {
   }
   ;
  private:
+  void SetKinematics(std::vector<std::vector<AliFemtoDreamBasePart>> &Particles);
   std::vector<AliFemtoDreamPartContainer> fPartContainer;
   std::vector<int> fPDGParticleSpecies;
   std::vector<unsigned int> fWhichPairs;
+  std::vector<double> fMasses;  // masses of the species, from the PDG codes
+  std::vector<AliFemtoDreamPartKinematics> fSEKinematics;  //! kinematics of the particles of the current event
+  std::vector<float> fRelativeK;  //! k* of one particle with all partners
 //  std::vector<bool> fRejPairs;
 //  bool fDoDeltaEtaDeltaPhiCut;
 //  float fDeltaEtaMax;
 //  float fDeltaPhiMax;
 //  float fDeltaPhiEtaMax;
 
-ClassDef(AliFemtoDreamZVtxMultContainer, 4)
+ClassDef(AliFemtoDreamZVtxMultContainer, 5)
   ;
 };
 
@@ -517,14 +517,14 @@ void AliAnalysisTaskGFWPIDFlow::DevFunction(AliAODEvent *fAOD, Double_t vz, Doub
   for(Int_t i=0;i<corrconfigs.size();i++)  Bool_t dm = FillFCs(corrconfigs.at(i),l_Cent,rndm);
   PostData(1,fFC);
 }
-Bool_t AliAnalysisTaskGFWPIDFlow::GetIntValAndDNX(AliGFW::CorrConfig corconf, Double_t &l_val, Double_t &l_dnx) {
+Bool_t AliAnalysisTaskGFWPIDFlow::GetIntValAndDNX(const AliGFW::CorrConfig &corconf, Double_t &l_val, Double_t &l_dnx) {
   l_dnx = fGFW->Calculate(corconf,0,kTRUE).Re();
   if(l_dnx==0) return kFALSE;
   l_val = fGFW->Calculate(corconf,0,kFALSE).Re()/l_dnx;
   if(TMath::Abs(l_val)>1) return kFALSE;
   return kTRUE;
 };
-Bool_t AliAnalysisTaskGFWPIDFlow::FillFCs(AliGFW::CorrConfig corconf, Double_t cent, Double_t rndmn, Bool_t EnableDebug) {
+Bool_t AliAnalysisTaskGFWPIDFlow::FillFCs(const AliGFW::CorrConfig &corconf, Double_t cent, Double_t rndmn, Bool_t EnableDebug) {
   Double_t dnx, val;
   if(!corconf.pTDif) {
     dnx = fGFW->Calculate(corconf,0,kTRUE).Re();
@@ -547,7 +547,7 @@ Bool_t AliAnalysisTaskGFWPIDFlow::FillFCs(AliGFW::CorrConfig corconf, Double_t c
   }
   return kTRUE;
 };
-Bool_t AliAnalysisTaskGFWPIDFlow::FillCovariance(AliGFW::CorrConfig corconf, Double_t cent, Double_t d_mpt, Double_t dw_mpt) {
+Bool_t AliAnalysisTaskGFWPIDFlow::FillCovariance(const AliGFW::CorrConfig &corconf, Double_t cent, Double_t d_mpt, Double_t dw_mpt) {
   Double_t dnx, val;
   dnx = fGFW->Calculate(corconf,0,kTRUE).Re();
   if(dnx==0) return kFALSE;
@@ -379,7 +379,7 @@ void AliAnalysisTaskMeanPtV2Corr::FillCK(AliAODEvent *fAOD, Double_t vz, Double_
   FillCovariance(corrconfigs.at(0),w1p0,mpt_local-l_meanPt,w1p0);
   PostData(3,fCovariance);
 }
-Bool_t AliAnalysisTaskMeanPtV2Corr::FillFCs(AliGFW::CorrConfig corconf, Double_t cent, Double_t rndmn) {
+Bool_t AliAnalysisTaskMeanPtV2Corr::FillFCs(const AliGFW::CorrConfig &corconf, Double_t cent, Double_t rndmn) {
   Double_t dnx, val;
   dnx = fGFW->Calculate(corconf,0,kTRUE).Re();
   if(dnx==0) return kFALSE;
@@ -391,7 +391,7 @@ Bool_t AliAnalysisTaskMeanPtV2Corr::FillFCs(AliGFW::CorrConfig corconf, Double_t
   };
   return kTRUE;
 };
-Bool_t AliAnalysisTaskMeanPtV2Corr::FillCovariance(AliGFW::CorrConfig corconf, Double_t cent, Double_t d_mpt, Double_t dw_mpt) {
+Bool_t AliAnalysisTaskMeanPtV2Corr::FillCovariance(const AliGFW::CorrConfig &corconf, Double_t cent, Double_t d_mpt, Double_t dw_mpt) {
   Double_t dnx, val;
   dnx = fGFW->Calculate(corconf,0,kTRUE).Re();
   if(dnx==0) return kFALSE;
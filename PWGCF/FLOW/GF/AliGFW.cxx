@@ -78,13 +78,13 @@ Int_t AliGFW::CreateRegions() {
   //for(auto pitr = fRegions.begin(); pitr!=fRegions.end(); pitr++) pitr->PrintStructure();
   Int_t nRegions=0;
   for(auto pItr=fRegions.begin(); pItr!=fRegions.end(); pItr++) {
-    AliGFWCumulant *lCumulant = new AliGFWCumulant();
+    AliGFWCumulant lCumulant;
     if(pItr->NparVec.size()) {
-      lCumulant->CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
+      lCumulant.CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
     } else {
-      lCumulant->CreateComplexVectorArray(pItr->Nhar, pItr->Npar, pItr->NpT);
+      lCumulant.CreateComplexVectorArray(pItr->Nhar, pItr->Npar, pItr->NpT);
     };
-    fCumulants.push_back(*lCumulant);
+    fCumulants.push_back(lCumulant);
     ++nRegions;
   };
   if(nRegions) fInitialized=kTRUE;
@@ -131,34 +131,109 @@ TComplex AliGFW::RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGF
   };
   return formula;
 };
+Int_t AliGFW::AddRecursionStep(CorrPlan &plan, std::map<std::pair<vector<Int_t>,vector<Int_t> >,Int_t> &known, const vector<Int_t> &hars, const vector<Int_t> &pows) {
+  //Same recursion as RecursiveCorr, but each (harmonics, powers) combination is added to the plan only once
+  std::pair<vector<Int_t>,vector<Int_t> > key(hars,pows);
+  auto kItr = known.find(key);
+  if(kItr!=known.end()) return kItr->second;
+  RecursionStep step;
+  step.Har = hars.at(0);
+  step.Pow = pows.at(0);
+  if(hars.size()<2) {
+    step.Type = RecursionStep::kSingle;
+  } else if(hars.size()<3) {
+    step.Type = RecursionStep::kTwo;
+    step.RefHar = hars.at(1);
+    step.RefPow = pows.at(1);
+  } else {
+    step.Type = RecursionStep::kRecursive;
+    step.RefHar = hars.at(hars.size()-1);
+    step.RefPow = pows.at(pows.size()-1);
+    vector<Int_t> lhars(hars.begin(),hars.end()-1);
+    vector<Int_t> lpows(pows.begin(),pows.end()-1);
+    step.Prev = AddRecursionStep(plan,known,lhars,lpows);
+    vector<Int_t> subs;
+    for(Int_t i=0;i<(Int_t)lhars.size();i++) {
+      vector<Int_t> shars = lhars;
+      vector<Int_t> spows = lpows;
+      shars.at(i)+=step.RefHar;
+      spows.at(i)+=step.RefPow;
+      subs.push_back(AddRecursionStep(plan,known,shars,spows));
+    };
+    step.FirstSub = plan.Subs.size();
+    step.NSub = subs.size();
+    plan.Subs.insert(plan.Subs.end(),subs.begin(),subs.end());
+  };
+  plan.Steps.push_back(step);
+  known[key] = plan.Steps.size()-1;
+  return plan.Steps.size()-1;
+};
+AliGFW::CorrPlan AliGFW::CompilePlan(const vector<Int_t> &hars) {
+  CorrPlan plan;
+  plan.Hars = hars;
+  if(hars.size()==0) return plan;
+  std::map<std::pair<vector<Int_t>,vector<Int_t> >,Int_t> known;
+  AddRecursionStep(plan,known,hars,vector<Int_t>(hars.size(),1));
+  return plan;
+};
+TComplex AliGFW::EvaluatePlan(const CorrPlan &plan, AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin) {
+  Int_t nSteps = plan.Steps.size();
+  if(!nSteps) return TComplex(0,0);
+  if((Int_t)fStepValues.size()<nSteps) fStepValues.resize(nSteps);
+  for(Int_t i=0;i<nSteps;i++) {
+    const RecursionStep &step = plan.Steps[i];
+    AliGFWCumulant *lpoi = ((step.Pow!=1) && qol)?qol:qpoi; //as in RecursiveCorr: if the power of POI is not unity, then use overlap (if defined)
+    if(step.Type==RecursionStep::kSingle) {
+      fStepValues[i] = lpoi->Vec(step.Har,step.Pow,ptbin);
+    } else if(step.Type==RecursionStep::kTwo) {
+      fStepValues[i] = TwoRec(step.Har,step.RefHar,step.Pow,step.RefPow,ptbin,lpoi,qref,qol);
+    } else {
+      TComplex formula = fStepValues[step.Prev]*qref->Vec(step.RefHar,step.RefPow);
+      for(Int_t j=step.FirstSub;j<step.FirstSub+step.NSub;j++) formula-=fStepValues[plan.Subs[j]];
+      fStepValues[i] = formula;
+    };
+  };
+  return fStepValues[nSteps-1];
+};
+TComplex AliGFW::CalculateRecursion(const CorrPlan &plan, const vector<Int_t> &hars, Bool_t SetHarmsToZero, AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin) {
+  Bool_t matches = (plan.Hars.size()==hars.size());
+  for(Int_t i=0;matches && i<(Int_t)hars.size();i++) matches = (plan.Hars[i]==(SetHarmsToZero?0:hars[i]));
+  if(matches) return EvaluatePlan(plan,qpoi,qref,qol,ptbin);
+  //Not compiled, or harmonics changed after compilation:
+  vector<Int_t> lhars = hars;
+  if(SetHarmsToZero) for(Int_t i=0;i<(Int_t)lhars.size();i++) lhars.at(i) = 0;
+  return RecursiveCorr(qpoi,qref,qol,ptbin,lhars);
+};
 void AliGFW::Clear() {
   for(auto ptr = fCumulants.begin(); ptr!=fCumulants.end(); ++ptr) ptr->ResetQs();
-  fCalculatedNames.clear();
-  fCalculatedQs.clear();
 };
 TComplex AliGFW::Calculate(TString config, Bool_t SetHarmsToZero) {
   if(config.EqualTo("")) {
     printf("Configuration empty!\n");
     return TComplex(0,0);
   };
-  TString tmp;
-  Ssiz_t sz1=0;
+  //Parse the configuration only the first time it is used
+  std::map<std::string, vector<SingleConfig> > &parsed = fParsedConfigs[SetHarmsToZero?1:0];
+  auto pItr = parsed.find(config.Data());
+  if(pItr==parsed.end()) {
+    vector<SingleConfig> singles;
+    TString tmp;
+    Ssiz_t sz1=0;
+    while(config.Tokenize(tmp,sz1,"}")) {
+      if(SetHarmsToZero) SetHarmonicsToZero(tmp);
+      singles.push_back(ParseSingle(tmp));
+    };
+    pItr = parsed.insert(std::make_pair(std::string(config.Data()),singles)).first;
+  };
   TComplex ret(1,0);
-  while(config.Tokenize(tmp,sz1,"}")) {
-    if(SetHarmsToZero) SetHarmonicsToZero(tmp);
-    /*Int_t ind=FindCalculated(tmp);
-    if(ind>=0) {
-      ret*=fCalculatedQs.at(ind);
-      continue;
-    };*/
-    TComplex val=CalculateSingle(tmp);
-    ret*=val;
-    fCalculatedQs.push_back(val);
-    fCalculatedNames.push_back(tmp);
+  for(auto sItr = pItr->second.begin(); sItr!=pItr->second.end(); ++sItr) {
+    if(sItr->Poi<0) return TComplex(0,0);
+    AliGFWCumulant *qpoi = &fCumulants.at(sItr->Poi);
+    ret*=EvaluatePlan(sItr->Plan, qpoi, &fCumulants.at(sItr->Ref), qpoi, sItr->PtBin);
   };
   return ret;
 };
-TComplex AliGFW::CalculateSingle(TString config) {
+AliGFW::SingleConfig AliGFW::ParseSingle(TString config) {
   //First remove all ; and ,:
   config.ReplaceAll(","," ");
   config.ReplaceAll(";"," ");
@@ -179,7 +254,7 @@ TComplex AliGFW::CalculateSingle(TString config) {
   if(sz1<0) sz1=0;
   if(!config.Tokenize(ts,szend,"{")) {
     printf("Could not find harmonics!\n");
-    return TComplex(0,0);
+    return SingleConfig();
   };
   //Fetch regions
   while(ts.Tokenize(ts2,sz1," ")) {
@@ -194,8 +269,14 @@ TComplex AliGFW::CalculateSingle(TString config) {
   };
   //Fetch harmonics
   while(config.Tokenize(ts,szend," ")) hars.push_back(ts.Atoi());
-  if(regs.size()==1) return Calculate(regs.at(0),hars);
-  return Calculate(regs.at(0),regs.at(1),hars,ptbin);
+  SingleConfig single;
+  if(regs.size()==0) return single;
+  //One region: integrated, Calculate(poi,hars); two regions: Calculate(poi,ref,hars,ptbin)
+  single.Poi = regs.at(0);
+  single.Ref = (regs.size()==1)?regs.at(0):regs.at(1);
+  single.PtBin = (regs.size()==1)?0:ptbin;
+  single.Plan = CompilePlan(hars);
+  return single;
 };
 AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Bool_t ptdif) {
   //First remove all ; and ,:
@@ -260,6 +341,10 @@ AliGFW::CorrConfig AliGFW::GetCorrelatorConfig(TString config, TString head, Boo
   };
   ReturnConfig.Head = head;
   ReturnConfig.pTDif = ptdif;
+  ReturnConfig.Plan = CompilePlan(ReturnConfig.Hars);
+  ReturnConfig.PlanZero = CompilePlan(vector<Int_t>(ReturnConfig.Hars.size(),0));
+  ReturnConfig.Plan2 = CompilePlan(ReturnConfig.Hars2);
+  ReturnConfig.Plan2Zero = CompilePlan(vector<Int_t>(ReturnConfig.Hars2.size(),0));
   return ReturnConfig;
 };
 
@@ -269,7 +354,7 @@ TComplex AliGFW::Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin
   AliGFWCumulant *qovl = qpoi;
   return RecursiveCorr(qpoi, qref, qovl, ptbin, hars);
 };
-TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
+TComplex AliGFW::Calculate(const CorrConfig &corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap) {
   if(corconf.Regs.size()==0) return TComplex(0,0);
   Int_t poi = corconf.Regs.at(0);
   Int_t ref = (corconf.Regs.size()>1)?corconf.Regs.at(1):corconf.Regs.at(0);
@@ -281,8 +366,7 @@ TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZer
   else if(ref==poi) qovl = qref; //If ref and poi are the same, then the same is for overlap. Only, when OL not explicitly defined
   if(!qpoi->IsPtBinFilled(ptbin)) return TComplex(0,0);
   //if(!qref->IsPtBinFilled(ptbin)) return TComplex(0,0);
-  if(SetHarmsToZero) for(Int_t i=0;i<(Int_t)corconf.Hars.size();i++) corconf.Hars.at(i) = 0;
-  TComplex retval = RecursiveCorr(qpoi, qref, qovl, ptbin, corconf.Hars);
+  TComplex retval = CalculateRecursion(SetHarmsToZero?corconf.PlanZero:corconf.Plan, corconf.Hars, SetHarmsToZero, qpoi, qref, qovl, ptbin);
   if(corconf.Regs2.size()==0) return retval;
   poi = corconf.Regs2.at(0);
   ref = (corconf.Regs2.size()>1)?corconf.Regs2.at(1):corconf.Regs2.at(0);
@@ -291,8 +375,7 @@ TComplex AliGFW::Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZer
   if(corconf.Overlap2 > -1)
     qovl = DisableOverlap?0:(&fCumulants.at(corconf.Overlap2));//;DisableOverlap?0:qpoi;
   else if(ref==poi) qovl = qref; //Only when OL is not explicitly defined, then set it to ref/POI if they are the same
-  if(SetHarmsToZero) for(Int_t i=0;i<(Int_t)corconf.Hars2.size();i++) corconf.Hars2.at(i) = 0;
-  retval*=RecursiveCorr(qpoi, qref, qovl, 0, corconf.Hars2);
+  retval*=CalculateRecursion(SetHarmsToZero?corconf.Plan2Zero:corconf.Plan2, corconf.Hars2, SetHarmsToZero, qpoi, qref, qovl, 0);
   return retval;
 };
 
@@ -304,13 +387,6 @@ Int_t AliGFW::FindRegionByName(TString refName) {
   for(Int_t i=0;i<(Int_t)fRegions.size();i++) if(fRegions.at(i).rName.EqualTo(refName)) return i;
   return -1;
 };
-Int_t AliGFW::FindCalculated(TString identifier) {
-  if(fCalculatedNames.size()==0) return -1;
-  for(Int_t i=0;i<(Int_t)fCalculatedNames.size();i++) {
-    if(fCalculatedNames.at(i).EqualTo(identifier)) return i;
-  };
-  return -1;
-};
 Bool_t AliGFW::SetHarmonicsToZero(TString &instr) {
   TString tmp;
   Ssiz_t sz1=0, sz2;
@@ -8,6 +8,8 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <map>
+#include <string>
 #include "TString.h"
 #include "TObjArray.h"
 using std::vector;
@@ -37,6 +39,21 @@ class AliGFW {
     };
     void PrintStructure() {printf("%s: eta [%f.. %f].",rName.Data(),EtaMin,EtaMax); };
   };
+  //One unique sub-correlator of RecursiveCorr, for fixed harmonics and powers
+  struct RecursionStep {
+    enum { kSingle, kTwo, kRecursive };
+    Int_t Type=kSingle;
+    Int_t Har=0, Pow=1; //first particle (kSingle, kTwo)
+    Int_t RefHar=0, RefPow=1; //particle from the reference: second (kTwo) or last (kRecursive)
+    Int_t Prev=-1; //kRecursive: step without the last particle
+    Int_t FirstSub=0, NSub=0; //kRecursive: steps to subtract, in CorrPlan::Subs
+  };
+  //RecursiveCorr flattened for a set of harmonics: each sub-correlator appears once, steps are in evaluation order and the last one is the result
+  struct CorrPlan {
+    vector<Int_t> Hars {}; //harmonics the plan was compiled for
+    vector<RecursionStep> Steps {};
+    vector<Int_t> Subs {};
+  };
   struct CorrConfig {
     vector<Int_t> Regs {};
     vector<Int_t> Hars {};
@@ -46,6 +63,11 @@ class AliGFW {
     Int_t Overlap2=-1;
     Bool_t pTDif=kFALSE;
     TString Head="";
+    //Compiled by GetCorrelatorConfig; if the harmonics are changed afterwards, the recursion is evaluated directly
+    CorrPlan Plan {};
+    CorrPlan PlanZero {}; //harmonics set to zero
+    CorrPlan Plan2 {};
+    CorrPlan Plan2Zero {};
   };
   AliGFW();
   ~AliGFW();
@@ -60,25 +82,34 @@ class AliGFW {
   AliGFWCumulant GetCumulant(Int_t index) { return fCumulants.at(index); };
   TComplex Calculate(TString config, Bool_t SetHarmsToZero=kFALSE);
   CorrConfig GetCorrelatorConfig(TString config, TString head = "", Bool_t ptdif=kFALSE);
-  TComplex Calculate(CorrConfig corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
+  TComplex Calculate(const CorrConfig &corconf, Int_t ptbin, Bool_t SetHarmsToZero, Bool_t DisableOverlap=kFALSE);
+  static CorrPlan CompilePlan(const vector<Int_t> &hars);
  private:
   Bool_t fInitialized;
   void SplitRegions();
   AliGFWCumulant fEmptyCumulant;
   TComplex TwoRec(Int_t n1, Int_t n2, Int_t p1, Int_t p2, Int_t ptbin, AliGFWCumulant*, AliGFWCumulant*, AliGFWCumulant*);
   TComplex RecursiveCorr(AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin, vector<Int_t> hars, vector<Int_t> pows={}); //POI, Ref. flow, overlapping region
+  //Same as RecursiveCorr with the harmonics of the plan, without allocations
+  TComplex EvaluatePlan(const CorrPlan &plan, AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin);
+  //Plan if it matches the harmonics (set to zero if requested), otherwise RecursiveCorr
+  TComplex CalculateRecursion(const CorrPlan &plan, const vector<Int_t> &hars, Bool_t SetHarmsToZero, AliGFWCumulant *qpoi, AliGFWCumulant *qref, AliGFWCumulant *qol, Int_t ptbin);
+  static Int_t AddRecursionStep(CorrPlan &plan, std::map<std::pair<vector<Int_t>,vector<Int_t> >,Int_t> &known, const vector<Int_t> &hars, const vector<Int_t> &pows);
+  vector<TComplex> fStepValues; //! values of the steps of the plan being evaluated
   //Deprecated and not used (for now):
   void AddRegion(Region inreg) { fRegions.push_back(inreg); };
   Region GetRegion(Int_t index) { return fRegions.at(index); };
   Int_t FindRegionByName(TString refName);
-  vector<TString> fCalculatedNames;
-  vector<TComplex> fCalculatedQs;
-  Int_t FindCalculated(TString identifier);
   //Calculateing functions:
   TComplex Calculate(Int_t poi, Int_t ref, vector<Int_t> hars, Int_t ptbin=0); //For differential, need POI and reference
   TComplex Calculate(Int_t poi, vector<Int_t> hars); //For integrated case
-  //Process one string (= one region)
-  TComplex CalculateSingle(TString config);
+  //One string (= one region), parsed once. Poi<0 if the string is invalid
+  struct SingleConfig {
+    Int_t Poi=-1, Ref=-1, PtBin=0;
+    CorrPlan Plan {};
+  };
+  SingleConfig ParseSingle(TString config);
+  std::map<std::string, vector<SingleConfig> > fParsedConfigs[2]; //! cache of Calculate(TString), without and with harmonics set to zero
 
   Bool_t SetHarmonicsToZero(TString &instr);
 
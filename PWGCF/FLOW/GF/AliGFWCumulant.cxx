@@ -3,15 +3,19 @@ Author: Vytautas Vislavicius
 Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 */
 #include "AliGFWCumulant.h"
+#include <algorithm>
 
 AliGFWCumulant::AliGFWCumulant():
-  fQvector(0),
+  fQvector(),
   fUsed(kBlank),
   fNEntries(-1),
   fN(1),
   fPow(1),
+  fPowVec(),
+  fPowOffset(),
+  fPtStride(0),
   fPt(1),
-  fFilledPts(0),
+  fFilledPts(),
   fInitialized(kFALSE)
 {
 };
@@ -27,6 +31,7 @@ void AliGFWCumulant::FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t
   if(fPt==1) ptin=0; //If one bin, then just fill it straight; otherwise, if ptin is out-of-range, do not fill
   else if(ptin<0 || ptin>=fPt) return;
   fFilledPts[ptin] = kTRUE;
+  TComplex *lQ = &fQvector[ptin*fPtStride]; //Q-vectors of this pT bin, in the order of the loops below
   for(Int_t lN = 0; lN<fN; lN++) {
     Double_t lSin = TMath::Sin(lN*phi); //No need to recalculate for each power
     Double_t lCos = TMath::Cos(lN*phi); //No need to recalculate for each power
@@ -39,35 +44,22 @@ void AliGFWCumulant::FillArray(Double_t eta, Int_t ptin, Double_t phi, Double_t
       else lPrefactor = TMath::Power(weight,lPow);
       Double_t qsin = lPrefactor * lSin;
       Double_t qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow](fQvector[ptin][lN][lPow].Re()+qcos,fQvector[ptin][lN][lPow].Im()+qsin);//+=TComplex(qcos,qsin);
+      (*lQ)(lQ->Re()+qcos,lQ->Im()+qsin);//+=TComplex(qcos,qsin);
+      ++lQ;
     };
   };
   Inc();
 };
 void AliGFWCumulant::ResetQs() {
   if(!fNEntries) return; //If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for(Int_t i=0; i<fPt; i++) {
-    fFilledPts[i] = kFALSE;
-    for(Int_t lN=0;lN<fN;lN++) {
-      for(Int_t lPow=0;lPow<PW(lN);lPow++) {
-  	       fQvector[i][lN][lPow](0.,0.);
-      };
-    };
-  };
+  std::fill(fFilledPts.begin(),fFilledPts.end(),kFALSE);
+  for(auto lQ = fQvector.begin(); lQ!=fQvector.end(); ++lQ) (*lQ)(0.,0.);
   fNEntries=0;
 };
 void AliGFWCumulant::DestroyComplexVectorArray() {
   if(!fInitialized) return;
-  for(Int_t l_n = 0; l_n<fN; l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      delete [] fQvector[i][l_n];
-    };
-  };
-  for(Int_t i=0;i<fPt;i++) {
-    delete [] fQvector[i];
-  };
-  delete [] fQvector;
-  delete [] fFilledPts;
+  fQvector.clear();
+  fFilledPts.clear();
   fInitialized=kFALSE;
   fNEntries=-1;
 };
@@ -83,23 +75,15 @@ void AliGFWCumulant::CreateComplexVectorArrayVarPower(Int_t N, vector<Int_t> Pow
   fN=N;
   fPow=0;
   fPt=Pt;
-  fFilledPts = new Bool_t[Pt];
   fPowVec = PowVec;
-  fQvector = new TComplex**[fPt];
-  for(Int_t i=0;i<fPt;i++) {
-    fQvector[i] = new TComplex*[fN];
-  };
+  fPowOffset.resize(fN);
+  fPtStride=0;
   for(Int_t l_n=0;l_n<fN;l_n++) {
-    for(Int_t i=0;i<fPt;i++) {
-      fQvector[i][l_n] = new TComplex[PW(l_n)];
-    };
+    fPowOffset[l_n] = fPtStride;
+    fPtStride+=PW(l_n);
   };
+  fFilledPts.assign(fPt,kFALSE);
+  fQvector.assign(fPt*fPtStride,TComplex(0.,0.));
   ResetQs();
   fInitialized=kTRUE;
 };
-TComplex AliGFWCumulant::Vec(Int_t n, Int_t p, Int_t ptbin) {
-  if(!fInitialized) return 0;
-  if(ptbin>=fPt || ptbin<0) ptbin=0;
-  if(n>=0) return fQvector[ptbin][n][p];
-  return TComplex::Conjugate(fQvector[ptbin][-n][p]);
-};
@@ -8,6 +8,7 @@ Extention of Generic Flow (https://arxiv.org/abs/1312.3572)
 #include "TNamed.h"
 #include "TMath.h"
 #include "TAxis.h"
+#include <vector>
 using std::vector;
 class AliGFWCumulant {
  public:
@@ -20,7 +21,7 @@ class AliGFWCumulant {
   void Inc() { fNEntries++; };
   Int_t GetN() { return fNEntries; };
   // protected:
-  TComplex ***fQvector;
+  vector<TComplex> fQvector; //Q-vectors of all pT bins, harmonics and powers in one contiguous array, index (ptbin, harmonic, power) -> ptbin*fPtStride + fPowOffset[harmonic] + power
   UInt_t fUsed;
   Int_t fNEntries;
   //Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
@@ -28,14 +29,22 @@ class AliGFWCumulant {
   Int_t fN; //! Harmonics
   Int_t fPow; //! Power
   vector<Int_t> fPowVec; //! Powers array
+  vector<Int_t> fPowOffset; //! Offset of the first power of each harmonic within a pT bin
+  Int_t fPtStride; //! Number of Q-vectors per pT bin
   Int_t fPt; //!fPt bins
-  Bool_t *fFilledPts;
+  vector<Bool_t> fFilledPts;
   Bool_t fInitialized; //Arrays are initialized
   void CreateComplexVectorArray(Int_t N=1, Int_t P=1, Int_t Pt=1);
   void CreateComplexVectorArrayVarPower(Int_t N=1, vector<Int_t> Pvec={1}, Int_t Pt=1);
   Int_t PW(Int_t ind) { return fPowVec.at(ind); }; //No checks to speed up, be carefull!!!
   void DestroyComplexVectorArray();
-  Bool_t IsPtBinFilled(Int_t ptb) { if(!fFilledPts) return kFALSE; return fFilledPts[ptb]; };
+  Bool_t IsPtBinFilled(Int_t ptb) { if(!fInitialized) return kFALSE; return fFilledPts[ptb]; };
+};
+inline TComplex AliGFWCumulant::Vec(Int_t n, Int_t p, Int_t ptbin) {
+  if(!fInitialized) return 0;
+  if(ptbin>=fPt || ptbin<0) ptbin=0;
+  if(n>=0) return fQvector[ptbin*fPtStride+fPowOffset[n]+p];
+  return TComplex::Conjugate(fQvector[ptbin*fPtStride+fPowOffset[-n]+p]);
 };
 
 #endif
@@ -38,6 +38,7 @@
 #include "AliDielectronCF.h"
 #include "AliDielectronMC.h"
 #include "AliDielectronMixingHandler.h"
+#include "AliDielectronVarManager.h"
 #include "AliAnalysisTaskMultiDielectron.h"
 
 ClassImp(AliAnalysisTaskMultiDielectron)
@@ -307,6 +308,8 @@ void AliAnalysisTaskMultiDielectron::UserExec(Option_t *)
   while ( (die=static_cast<AliDielectron*>(nextDie())) ){
     AliDielectronHistos *h=die->GetHistoManager();
     if (h){
+      // the calibration inputs are configured in the variable context of the instance
+      AliDielectronVarContextScope varContext(die->DoEventProcess() ? die->GetVarContext() : AliDielectronVarManager::GetContext());
       AliDielectronVarManager::SetFillMap(h->GetUsedVars());
       if (hasMC && AliDielectronMC::Instance()->ConnectMCEvent() && h->GetHistogramList()->FindObject("MCEvent_noCuts")) {
 	AliDielectronVarManager::SetEvent(AliDielectronMC::Instance()->GetMCEvent());
@@ -372,17 +375,22 @@ void AliAnalysisTaskMultiDielectron::UserExec(Option_t *)
   //   AliDielectron *die=0;
   Bool_t sel=kFALSE;
   Int_t idie=0;
+  AliDielectron *dieTrain=0x0;
   while ( (die=static_cast<AliDielectron*>(nextDie())) ){
     if(die->DoEventProcess()) {
       sel= die->Process(InputEvent());
+      dieTrain=die;
       // input for internal train
       if(die->DontClearArrays()) {
         fPairArray = (*(die->GetPairArraysPointer())); // the pair arrays from the current 'die' object are stored so they can be used by the next one(s). saves computing time from pairing.
       }
     }
     else {
-      // internal train
-      if(sel) die->Process(fPairArray);
+      // internal train, uses the event data of the event processing instance
+      if(sel) {
+        AliDielectronVarContextScope varContext(dieTrain->GetVarContext());
+        die->Process(fPairArray);
+      }
     }
 
     if (die->HasCandidates()){
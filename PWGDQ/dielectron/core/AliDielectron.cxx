@@ -68,6 +68,10 @@ The names are available via the function PairClassName(Int_t i)
 #include "AliDielectronSignalMC.h"
 #include "AliDielectronMixingHandler.h"
 #include "AliDielectronPairLegCuts.h"
+#include "AliDielectronCutGroup.h"
+#include "AliDielectronVarCuts.h"
+#include "AliDielectronEventCuts.h"
+#include "AliDielectronTMVACuts.h"
 #include "AliDielectronV0Cuts.h"
 #include "AliDielectronPID.h"
 #include "AliDielectronHistos.h"
@@ -166,8 +170,9 @@ AliDielectron::AliDielectron() :
   fTRDpidCorrectionFilename(""),
   fVZEROCalibrationFilename(""),
   fVZERORecenteringFilename(""),
-  fZDCRecenteringFilename("")
-
+  fZDCRecenteringFilename(""),
+  fFillOnlyUsedVars(kFALSE),
+  fVarContext(0x0)
 {
   //
   // Default constructor
@@ -253,7 +258,9 @@ AliDielectron::AliDielectron(const char* name, const char* title) :
   fTRDpidCorrectionFilename(""),
   fVZEROCalibrationFilename(""),
   fVZERORecenteringFilename(""),
-  fZDCRecenteringFilename("")
+  fZDCRecenteringFilename(""),
+  fFillOnlyUsedVars(kFALSE),
+  fVarContext(0x0)
 {
   //
   // Named constructor
@@ -294,6 +301,7 @@ AliDielectron::~AliDielectron()
   if (fSignalsMC) delete fSignalsMC;
   if (fCfManagerPair) delete fCfManagerPair;
   if (fHistoArray) delete fHistoArray;
+  if (fVarContext) delete fVarContext;
 
 	for(Int_t i=0;i<15;i++){
 		for(Int_t j=0;j<15;j++){
@@ -331,12 +339,13 @@ void AliDielectron::Init()
   }
   if (fDebugTree) fDebugTree->SetDielectron(this);
 
-  if(fEstimatorFilename.Contains(".root"))        AliDielectronVarManager::InitEstimatorAvg(fEstimatorFilename.Data());
-  if(fEstimatorObjArray)			  AliDielectronVarManager::InitEstimatorObjArrayAvg(fEstimatorObjArray);
-  if(fTRDpidCorrectionFilename.Contains(".root")) AliDielectronVarManager::InitTRDpidEffHistograms(fTRDpidCorrectionFilename.Data());
-  if(fVZEROCalibrationFilename.Contains(".root")) AliDielectronVarManager::SetVZEROCalibrationFile(fVZEROCalibrationFilename.Data());
-  if(fVZERORecenteringFilename.Contains(".root")) AliDielectronVarManager::SetVZERORecenteringFile(fVZERORecenteringFilename.Data());
-  if(fZDCRecenteringFilename.Contains(".root")) AliDielectronVarManager::SetZDCRecenteringFile(fZDCRecenteringFilename.Data());
+  // configure the calling context, which the tasks read with the static interface,
+  // and the context of this instance, which is active in Process
+  InitVarManager();
+  if(fEventProcess) {
+    AliDielectronVarContextScope varContext(GetVarContext());
+    InitVarManager();
+  }
 
   if (fMixing) fMixing->Init(this);
   if (fHistoArray) {
@@ -373,6 +382,106 @@ void AliDielectron::Init()
       fEvtVsTrkHist->SetHistogramList(fHistos);
     }
   }
+
+  if(fFillOnlyUsedVars) {
+    // the event data is filled once with the fill map of this instance and used by all
+    // cuts and outputs, the fill map has to contain the variables of all of them
+    AddUsedVars(fEventFilter);
+    AddUsedVars(fTrackFilter);
+    AddUsedVars(fPairPreFilter1);
+    AddUsedVars(fPairPreFilter2);
+    AddUsedVars(fPairPreFilterLegs1);
+    AddUsedVars(fPairPreFilterLegs2);
+    AddUsedVars(fPairFilter);
+    AddUsedVars(fEventPlanePreFilter);
+    AddUsedVars(fEventPlanePOIPreFilter);
+    if(fHistoArray && fHistoArray->GetUsedVars())       (*fUsedVars)|= (*fHistoArray->GetUsedVars());
+    if(fCfManagerPair && fCfManagerPair->GetUsedVars()) (*fUsedVars)|= (*fCfManagerPair->GetUsedVars());
+    if(fDebugTree && fDebugTree->GetUsedVars())         (*fUsedVars)|= (*fDebugTree->GetUsedVars());
+    if(fMixing) fMixing->AddUsedVars(fUsedVars);
+    AddEffMapVars(fLegEffMap);
+    AddEffMapVars(fPairEffMap);
+  }
+  if(fEventProcess) GetVarContext()->SetFillOnlyUsedVars(fFillOnlyUsedVars);
+}
+
+//________________________________________________________________
+void AliDielectron::InitVarManager()
+{
+  //
+  // Initialise the calibration and estimator objects of the current variable manager context
+  //
+  if(fEstimatorFilename.Contains(".root"))        AliDielectronVarManager::InitEstimatorAvg(fEstimatorFilename.Data());
+  if(fEstimatorObjArray)			  AliDielectronVarManager::InitEstimatorObjArrayAvg(fEstimatorObjArray);
+  if(fTRDpidCorrectionFilename.Contains(".root")) AliDielectronVarManager::InitTRDpidEffHistograms(fTRDpidCorrectionFilename.Data());
+  if(fVZEROCalibrationFilename.Contains(".root")) AliDielectronVarManager::SetVZEROCalibrationFile(fVZEROCalibrationFilename.Data());
+  if(fVZERORecenteringFilename.Contains(".root")) AliDielectronVarManager::SetVZERORecenteringFile(fVZERORecenteringFilename.Data());
+  if(fZDCRecenteringFilename.Contains(".root")) AliDielectronVarManager::SetZDCRecenteringFile(fZDCRecenteringFilename.Data());
+}
+
+//________________________________________________________________
+AliDielectronVarContext* AliDielectron::GetVarContext()
+{
+  //
+  // variable manager context of this instance, created on first use
+  //
+  if(!fVarContext) fVarContext=new AliDielectronVarContext;
+  return fVarContext;
+}
+
+//________________________________________________________________
+void AliDielectron::AddUsedVars(const AliAnalysisFilter &filter)
+{
+  //
+  // add the variables used by the cuts of a filter to the fill map
+  //
+  TIter nextCut(filter.GetCuts());
+  while (AliAnalysisCuts *cuts = static_cast<AliAnalysisCuts*>(nextCut())) AddUsedVars(cuts);
+}
+
+//________________________________________________________________
+void AliDielectron::AddUsedVars(const AliAnalysisCuts *cuts)
+{
+  //
+  // add the variables used by a cut object to the fill map
+  //
+  TBits *used=0x0;
+  if (cuts->InheritsFrom(AliDielectronVarCuts::Class()))            used=static_cast<const AliDielectronVarCuts*>(cuts)->GetUsedVars();
+  else if (cuts->InheritsFrom(AliDielectronPID::Class()))           used=static_cast<const AliDielectronPID*>(cuts)->GetUsedVars();
+  else if (cuts->InheritsFrom(AliDielectronEventCuts::Class()))     used=static_cast<const AliDielectronEventCuts*>(cuts)->GetUsedVars();
+  else if (cuts->InheritsFrom(AliDielectronTMVACuts::Class()))      used=static_cast<const AliDielectronTMVACuts*>(cuts)->GetUsedVars();
+  else if (cuts->InheritsFrom(AliDielectronCutGroup::Class())) {
+    const AliDielectronCutGroup *group=static_cast<const AliDielectronCutGroup*>(cuts);
+    for (Int_t iCut=0; iCut<group->GetNCuts(); ++iCut) AddUsedVars(group->GetCut(iCut));
+  }
+  else if (cuts->InheritsFrom(AliDielectronPairLegCuts::Class())) {
+    AliDielectronPairLegCuts *legCuts=const_cast<AliDielectronPairLegCuts*>(static_cast<const AliDielectronPairLegCuts*>(cuts));
+    AddUsedVars(legCuts->GetLeg1Filter());
+    AddUsedVars(legCuts->GetLeg2Filter());
+  }
+  if (used) (*fUsedVars)|= (*used);
+}
+
+//________________________________________________________________
+void AliDielectron::AddEffMapVars(const TObject *effMap)
+{
+  //
+  // add the variables of the axes of an efficiency map to the fill map
+  //
+  if (!effMap) return;
+  if (effMap->InheritsFrom(THnBase::Class())) {
+    const THnBase *eff=static_cast<const THnBase*>(effMap);
+    for (Int_t idim=0; idim<eff->GetNdimensions(); ++idim) {
+      UInt_t var=AliDielectronVarManager::GetValueType(eff->GetAxis(idim)->GetName());
+      if (var<AliDielectronVarManager::kNMaxValues) fUsedVars->SetBitNumber(var,kTRUE);
+    }
+  }
+  else if (effMap->IsA()==TSpline3::Class()) {
+    const TSpline3 *eff=static_cast<const TSpline3*>(effMap);
+    if (!eff->GetHistogram()) return;
+    UInt_t var=AliDielectronVarManager::GetValueType(eff->GetHistogram()->GetXaxis()->GetName());
+    if (var<AliDielectronVarManager::kNMaxValues) fUsedVars->SetBitNumber(var,kTRUE);
+  }
 }
 
 //________________________________________________________________
@@ -412,6 +521,10 @@ Bool_t AliDielectron::Process(AliVEvent *ev1, AliVEvent *ev2)
     return 0;
   }
 
+  // use the variable manager context of this instance, the event state is handed
+  // back to the calling context for the tasks using the static interface
+  AliDielectronVarContextScope varContext(GetVarContext(),kTRUE);
+
   // modify event numbers in MC so that we can identify new events
   // in AliDielectronV0Cuts (not neeeded for collision data)
   if(GetHasMC()) {
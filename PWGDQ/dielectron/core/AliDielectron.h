@@ -39,6 +39,7 @@ class AliDielectronTrackRotator;
 class AliDielectronPair;
 class AliDielectronSignalMC;
 class AliDielectronMixingHandler;
+class AliDielectronVarContext;
 
 //________________________________________________________________
 class AliDielectron : public TNamed {
@@ -196,6 +197,13 @@ public:
 
   void FinishEvtVsTrkHistoClass();
 
+  // fill only the variables used by the cuts, histograms and outputs of this instance,
+  // also the ones which the variable manager fills by default (PID nsigma, EMCAL, ...).
+  // Internal train wagons use the event data of the event processing instance.
+  void SetFillOnlyUsedVars(Bool_t fillOnly=kTRUE) { fFillOnlyUsedVars=fillOnly; }
+  Bool_t GetFillOnlyUsedVars() const              { return fFillOnlyUsedVars;    }
+  AliDielectronVarContext* GetVarContext();
+
 private:
 
   Bool_t fCutQA;                    // monitor cuts
@@ -307,6 +315,14 @@ private:
   TString fVZERORecenteringFilename;         // file containing VZERO Q-vector recentering averages
   TString fZDCRecenteringFilename;         // file containing ZDCQ-vector recentering averages
 
+  Bool_t fFillOnlyUsedVars;                  // fill only the variables used by this instance
+  AliDielectronVarContext *fVarContext;      //! variable manager context of this instance
+
+  void InitVarManager();
+  void AddUsedVars(const AliAnalysisFilter &filter);
+  void AddUsedVars(const AliAnalysisCuts *cuts);
+  void AddEffMapVars(const TObject *effMap);
+
   void ProcessMC(AliVEvent *ev1);
 
   void  FillHistograms(const AliVEvent *ev, Bool_t pairInfoOnly=kFALSE);
@@ -321,7 +337,7 @@ private:
   AliDielectron(const AliDielectron &c);
   AliDielectron &operator=(const AliDielectron &c);
 
-  ClassDef(AliDielectron,18);
+  ClassDef(AliDielectron,19);
 };
 
 inline void AliDielectron::InitPairCandidateArrays()
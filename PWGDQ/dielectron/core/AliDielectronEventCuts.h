@@ -79,6 +79,7 @@ public:
   enum EPileUpTool{kSPD, kSPDInMultBins, kMultiVertexer};
 
   void Print(const Option_t* option = "") const;
+  TBits *GetUsedVars() const { return fUsedVars; }
 
 private:
   static const char* fgkVtxNames[AliDielectronEventCuts::kVtxTracksOrSPD+1];  //vertex names
@@ -100,6 +100,7 @@ public:
   const TObjArray * GetHistArray() const { return &fArrPairType; }
   Bool_t GetStepForMCGenerated()   const { return fStepGenerated; }
   Bool_t IsEventArray()           const { return fEventArray; }
+  TBits *GetUsedVars()            const { return fUsedVars; }
   
   
 
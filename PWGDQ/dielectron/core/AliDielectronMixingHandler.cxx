@@ -475,6 +475,16 @@ Int_t AliDielectronMixingHandler::GetNumberOfBins() const
   return size;
 }
 
+//______________________________________________
+void AliDielectronMixingHandler::AddUsedVars(TBits *usedVars) const
+{
+  //
+  // add the variables of the event binning to the list of used variables
+  //
+  for (Int_t i=0; i<fAxes.GetEntriesFast(); ++i)
+    usedVars->SetBitNumber(fEventCuts[i],kTRUE);
+}
+
 //______________________________________________
 Int_t AliDielectronMixingHandler::FindBin(const Double_t values[], TString *dim)
 {
@@ -56,6 +56,7 @@ public:
   void SetSkipFirstEvent(Bool_t skip) { fSkipFirstEvt=skip; }
 
   Int_t GetNumberOfBins() const;
+  void AddUsedVars(TBits *usedVars) const;
   Int_t FindBin(const Double_t values[], TString *dim=0x0);
   void Fill(const AliVEvent *ev, AliDielectron *diele);
 
@@ -148,6 +148,8 @@ public:
 		else return (fgFunWdthCorrPU[AliDielectronPID::kTOF][partype] ? GetPIDCorr(track,fgFunWdthCorrPU[AliDielectronPID::kTOF][partype]) : 1.0);
 	}
 
+  TBits *GetUsedVars() const { return fUsedVars; }
+
 private:
   enum {kNmaxPID=30};
 
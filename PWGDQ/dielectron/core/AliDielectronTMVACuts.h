@@ -32,6 +32,7 @@ public:
   void AddTMVASpectator(TString featureName, AliDielectronVarManager::ValueTypes dielectronVar);
   void SetTMVAWeights(TString TMVAName, TString weightName);
   void SetTMVACutValue(Float_t userTMVACutValue) {mvaCutValue = userTMVACutValue;}
+  TBits* GetUsedVars() const { return fUsedVars; }
     
 
   //
@@ -721,27 +721,15 @@ const char* AliDielectronVarManager::fgkParticleNames[AliDielectronVarManager::k
   {"LegSource",              "Leg source",                                         ""}
 };
 
-AliPIDResponse* AliDielectronVarManager::fgPIDResponse      = 0x0;
-AliVEvent*      AliDielectronVarManager::fgEvent            = 0x0;
-AliEventplane*  AliDielectronVarManager::fgTPCEventPlane    = 0x0;
-AliKFVertex*    AliDielectronVarManager::fgKFVertex         = 0x0;
-TProfile*       AliDielectronVarManager::fgMultEstimatorAvg[7][9] = {{0x0}};
-TH3D*           AliDielectronVarManager::fgTRDpidEff[10][4] = {{0x0}};
-TObject*        AliDielectronVarManager::fgLegEffMap           = 0x0;
-TObject*        AliDielectronVarManager::fgPairEffMap          = 0x0;
-TBits*          AliDielectronVarManager::fgFillMap          = 0x0;
-Double_t        AliDielectronVarManager::fgTRDpidEffCentRanges[10][4] = {{0.0}};
-TString         AliDielectronVarManager::fgVZEROCalibrationFile = "";
-TString         AliDielectronVarManager::fgVZERORecenteringFile = "";
-TString         AliDielectronVarManager::fgZDCRecenteringFile = "";
-TProfile2D*     AliDielectronVarManager::fgVZEROCalib[64] = {0x0};
-TProfile2D*     AliDielectronVarManager::fgVZERORecentering[2][2] = {{0x0,0x0},{0x0,0x0}};
-TProfile3D*     AliDielectronVarManager::fgZDCRecentering[3][2] = {{0x0,0x0},{0x0,0x0},{0x0,0x0}};
-AliDielectronQnEPcorrection* AliDielectronVarManager::fgQnEPacRemoval = 0x0;
-Bool_t          AliDielectronVarManager::fgEventPlaneACremoval = kFALSE;
-TString         AliDielectronVarManager::fgQnVectorNorm = "";
-Int_t           AliDielectronVarManager::fgCurrentRun = -1;
-Double_t        AliDielectronVarManager::fgData[AliDielectronVarManager::kNMaxValues] = {0.};
+namespace {
+  // variable context activated in the calling thread (0x0: default context)
+#if __cplusplus >= 201103L
+  thread_local AliDielectronVarContext *gActiveVarContext = 0x0;
+#else
+  AliDielectronVarContext *gActiveVarContext = 0x0;
+#endif
+}
+
 //________________________________________________________________
 AliDielectronVarManager::AliDielectronVarManager() :
   TNamed("AliDielectronVarManager","AliDielectronVarManager")
@@ -749,19 +737,6 @@ AliDielectronVarManager::AliDielectronVarManager() :
   //
   // Default constructor
   //
-  for(Int_t i=0; i<6; ++i)
-    for(Int_t j=0; j<9; ++j)
-      fgMultEstimatorAvg[i][j] = 0x0;
-  for(Int_t i=0; i<10; ++i)
-    for(Int_t j=0; j<4; ++j)
-      fgTRDpidEff[i][j] = 0x0;
-  for(Int_t i=0; i<64; ++i) fgVZEROCalib[i] = 0x0;
-  for(Int_t i=0; i<2; ++i) {
-    for(Int_t j=0; j<2; ++j) fgVZERORecentering[i][j] = 0x0;
-  }
-  for(Int_t i=0; i<3; ++i)
-    for(Int_t j=0; j<2; ++j) fgZDCRecentering[i][j] = 0x0;
-
   gRandom->SetSeed();
 }
 
@@ -772,55 +747,155 @@ AliDielectronVarManager::AliDielectronVarManager(const char* name, const char* t
   //
   // Named constructor
   //
-  for(Int_t i=0; i<6; ++i)
+  gRandom->SetSeed();
+}
+
+//________________________________________________________________
+AliDielectronVarManager::~AliDielectronVarManager()
+{
+  //
+  // Default destructor
+  //
+}
+
+//________________________________________________________________
+AliDielectronVarContext* AliDielectronVarManager::GetContext()
+{
+  //
+  // Variable context active in the calling thread
+  //
+  return gActiveVarContext ? gActiveVarContext : GetDefaultContext();
+}
+
+//________________________________________________________________
+AliDielectronVarContext* AliDielectronVarManager::SetContext(AliDielectronVarContext *context)
+{
+  //
+  // Activate a variable context in the calling thread (0x0: default context)
+  // return the previously active context
+  //
+  AliDielectronVarContext *previous=GetContext();
+  gActiveVarContext=context;
+  return previous;
+}
+
+//________________________________________________________________
+AliDielectronVarContext* AliDielectronVarManager::GetDefaultContext()
+{
+  //
+  // Context used if none is activated, shared by all threads.
+  // It is never deleted, as the former static data members
+  //
+  static AliDielectronVarContext *defaultContext=new AliDielectronVarContext;
+  return defaultContext;
+}
+
+//________________________________________________________________
+UInt_t AliDielectronVarManager::GetValueType(const char* valname) {
+  //
+  // Get value type by value name
+  //
+
+  TString name(valname);
+  for(UInt_t i=0; i<AliDielectronVarManager::kNMaxValues; i++) {
+    if(!name.CompareTo(fgkParticleNames[i][0])) return i;
+  }
+  return -1;
+}
+
+//________________________________________________________________
+AliDielectronVarContext::AliDielectronVarContext() :
+  fPIDResponse(0x0),
+  fEvent(0x0),
+  fTPCEventPlane(0x0),
+  fKFVertex(0x0),
+  fLegEffMap(0x0),
+  fPairEffMap(0x0),
+  fFillMap(0x0),
+  fFillOnlyUsedVars(kFALSE),
+  fVZEROCalibrationFile(""),
+  fVZERORecenteringFile(""),
+  fCurrentRun(-1),
+  fZDCRecenteringFile(""),
+  fQnEPacRemoval(0x0),
+  fEventPlaneACremoval(kFALSE),
+  fQnVectorNorm("")
+{
+  //
+  // Default constructor
+  //
+  for(Int_t i=0; i<7; ++i)
     for(Int_t j=0; j<9; ++j)
-      fgMultEstimatorAvg[i][j] = 0x0;
+      fMultEstimatorAvg[i][j] = 0x0;
   for(Int_t i=0; i<10; ++i)
-    for(Int_t j=0; j<4; ++j)
-      fgTRDpidEff[i][j] = 0x0;
-  for(Int_t i=0; i<64; ++i) fgVZEROCalib[i] = 0x0;
+    for(Int_t j=0; j<4; ++j) {
+      fTRDpidEffCentRanges[i][j] = 0.0;
+      fTRDpidEff[i][j] = 0x0;
+    }
+  for(Int_t i=0; i<64; ++i) fVZEROCalib[i] = 0x0;
   for(Int_t i=0; i<2; ++i)
     for(Int_t j=0; j<2; ++j)
-      fgVZERORecentering[i][j] = 0x0;
+      fVZERORecentering[i][j] = 0x0;
   for(Int_t i=0; i<3; ++i)
-    for(Int_t j=0; j<2; ++j) fgZDCRecentering[i][j] = 0x0;
-
-
-  gRandom->SetSeed();
+    for(Int_t j=0; j<2; ++j) fZDCRecentering[i][j] = 0x0;
+  for(Int_t i=0; i<AliDielectronVarManager::kNMaxValues; ++i) fData[i] = 0.;
 }
 
 //________________________________________________________________
-AliDielectronVarManager::~AliDielectronVarManager()
+AliDielectronVarContext::~AliDielectronVarContext()
 {
   //
-  // Default destructor
+  // Default destructor, deletes the objects created by the variable manager
+  // for this context
   //
-  for(Int_t i=0; i<6; ++i)
+  if (AliDielectronVarManager::GetContext()==this) AliDielectronVarManager::SetContext(0x0);
+  delete fKFVertex;
+  for(Int_t i=0; i<7; ++i)
     for(Int_t j=0; j<9; ++j)
-      if(fgMultEstimatorAvg[i][j]) delete fgMultEstimatorAvg[i][j];
+      if(fMultEstimatorAvg[i][j]) delete fMultEstimatorAvg[i][j];
   for(Int_t i=0; i<10; ++i)
     for(Int_t j=0; j<4; ++j)
-      if(fgTRDpidEff[i][j]) delete fgTRDpidEff[i][j];
+      if(fTRDpidEff[i][j]) delete fTRDpidEff[i][j];
   for(Int_t i=0; i<64; ++i)
-    if(fgVZEROCalib[i]) delete fgVZEROCalib[i];
+    if(fVZEROCalib[i]) delete fVZEROCalib[i];
   for(Int_t i=0; i<2; ++i)
     for(Int_t j=0; j<2; ++j)
-      if(fgVZERORecentering[i][j]) delete fgVZERORecentering[i][j];
+      if(fVZERORecentering[i][j]) delete fVZERORecentering[i][j];
   for(Int_t i=0; i<3; ++i)
     for(Int_t j=0; j<2; ++j)
-      if(fgZDCRecentering[i][j]) delete fgZDCRecentering[i][j];
+      if(fZDCRecentering[i][j]) delete fZDCRecentering[i][j];
+}
 
+//________________________________________________________________
+void AliDielectronVarContext::CopyEventState(const AliDielectronVarContext &c)
+{
+  //
+  // Take over the event state of another context (not the configuration)
+  //
+  fEvent=c.fEvent;
+  fTPCEventPlane=c.fTPCEventPlane;
+  fFillMap=c.fFillMap;
+  for(Int_t i=0; i<AliDielectronVarManager::kNMaxValues; ++i) fData[i]=c.fData[i];
 }
 
 //________________________________________________________________
-UInt_t AliDielectronVarManager::GetValueType(const char* valname) {
+AliDielectronVarContextScope::AliDielectronVarContextScope(AliDielectronVarContext *context, Bool_t handBack) :
+  fContext(context),
+  fPrevious(AliDielectronVarManager::SetContext(context)),
+  fHandBack(handBack)
+{
   //
-  // Get value type by value name
+  // Activate the context, take over the PID response from the previous context
   //
+  if (context && context!=fPrevious && fPrevious->fPIDResponse) context->fPIDResponse=fPrevious->fPIDResponse;
+}
 
-  TString name(valname);
-  for(UInt_t i=0; i<AliDielectronVarManager::kNMaxValues; i++) {
-    if(!name.CompareTo(fgkParticleNames[i][0])) return i;
-  }
-  return -1;
+//________________________________________________________________
+AliDielectronVarContextScope::~AliDielectronVarContextScope()
+{
+  //
+  // Restore the previous context, hand back the event state if requested
+  //
+  if (fHandBack && fContext && fContext!=fPrevious) fPrevious->CopyEventState(*fContext);
+  AliDielectronVarManager::SetContext(fPrevious);
 }
@@ -49,7 +49,12 @@ AliHistogramManager::AliHistogramManager() :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(0)
+  fNVars(0),
+  fFillPlan(),
+  fFillPlanVars(),
+  fFillPlanClassStart(),
+  fFillPlanClassIndex(),
+  fFillPlanCompiled(kFALSE)
 {
   //
   // Constructor
@@ -71,7 +76,12 @@ AliHistogramManager::AliHistogramManager(const Char_t* name, Int_t nvars) :
   fBinsAllocated(0),
   fVariableNames(),
   fVariableUnits(),
-  fNVars(nvars)
+  fNVars(nvars),
+  fFillPlan(),
+  fFillPlanVars(),
+  fFillPlanClassStart(),
+  fFillPlanClassIndex(),
+  fFillPlanCompiled(kFALSE)
 {
   //
   // Constructor
@@ -131,6 +141,7 @@ void AliHistogramManager::AddHistClass(const Char_t* histClass) {
   hList->SetOwner(kTRUE);
   hList->SetName(histClass);
   fMainList.Add(hList);
+  fFillPlanCompiled = kFALSE;
 }
 
 //_________________________________________________________________
@@ -154,6 +165,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  fFillPlanCompiled = kFALSE;
   TString hname = name;
   
   Int_t dimension = 1;
@@ -296,6 +308,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  fFillPlanCompiled = kFALSE;
   TString hname = name;
   
   Int_t dimension = 1;
@@ -441,6 +454,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  fFillPlanCompiled = kFALSE;
   TString hname = name;
   
   TString titleStr(title);
@@ -494,6 +508,7 @@ void AliHistogramManager::AddHistogram(const Char_t* histClass,
     cout << "Warning in AliHistogramManager::AddHistogram(): Histogram " << name << " already exists" << endl;
     return;
   }
+  fFillPlanCompiled = kFALSE;
   TString hname = name;
   
   TString titleStr(title);
@@ -630,140 +645,168 @@ void AliHistogramManager::FillHistClass(const Char_t* className, Float_t* values
     cout << "         Histogram list not filled" << endl; */
     return;
   }
-  if(!hList) {
-    return;
-  }
+  if(!fFillPlanCompiled) CompileFillPlans();
+  FillPlannedClass(fFillPlanClassIndex[hList], values);
+}
+
+//__________________________________________________________________
+Int_t AliHistogramManager::GetHistClassIndex(const Char_t* className) {
+  //
+  //  index of a histogram class to be used with FillHistClass(Int_t, Float_t*), -1 if the class does not exist
+  //
+  THashList* hList = (THashList*)fMainList.FindObject(className);
+  if(!hList) return -1;
+  if(!fFillPlanCompiled) CompileFillPlans();
+  return fFillPlanClassIndex[hList];
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClass(Int_t classIndex, Float_t* values) {
+  //
+  //  fill a class of histograms given by its index
+  //
+  if(classIndex<0) return;
+  if(!fFillPlanCompiled) CompileFillPlans();
+  FillPlannedClass(classIndex, values);
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillHistClasses(Int_t nClasses, const Int_t* classIndices, Float_t* values) {
+  //
+  //  fill several classes of histograms with the same values, negative indices are skipped
+  //
+  if(!fFillPlanCompiled) CompileFillPlans();
+  for(Int_t i=0; i<nClasses; ++i)
+    if(classIndices[i]>=0) FillPlannedClass(classIndices[i], values);
+}
+
+//__________________________________________________________________
+void AliHistogramManager::CompileFillPlans() {
+  //
+  //  decode the type and the variables of all booked histograms (encoded in the unique IDs of the
+  //  histograms and of their axes) into the fill plan. Histograms with a variable which is not used
+  //  are not filled and therefore not added.
+  //  This is done automatically at the first fill after booking histograms.
+  //
+  fFillPlan.clear();
+  fFillPlanVars.clear();
+  fFillPlanClassStart.clear();
+  fFillPlanClassIndex.clear();
+  
+  for(Int_t iclass=0; iclass<fMainList.GetEntries(); ++iclass) {
+    THashList* hList = (THashList*)fMainList.At(iclass);
+    fFillPlanClassIndex[hList] = iclass;
+    fFillPlanClassStart.push_back(fFillPlan.size());
     
-  TIter next(hList);
-  TObject* h=0x0;
-  Bool_t isProfile;
-  Bool_t isTHn;
-  Int_t thnDim=0;
-  Bool_t isSparse=kFALSE;
-  Double_t fillValues[20]={0.0};
-  Int_t uid = 0;
-  Int_t varX=-1, varY=-1, varZ=-1, varT=-1, varW=-1;
-  Int_t dimension=0;
-  while((h=next())) {
-    Bool_t allVarsGood = kTRUE;
-    uid = h->GetUniqueID();
-    isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
-    isTHn = ((uid%100)>10 ? kTRUE : kFALSE);      
-    if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
-    if(isTHn && ((TString)h->ClassName()).Contains("Sparse")) isSparse = kTRUE;
-    dimension = 0;
-    if(!isTHn) dimension = ((TH1*)h)->GetDimension();
-        
-    uid = (uid-(uid%100))/100;
-    varX = -1;
-    varY = -1;
-    varZ = -1;
-    varT = -1;
-    varW = -1;
-    if(uid>0) {
-      varW = uid%(fNVars+1)-1;
-      if(varW==0) varW=AliReducedVarManager::kNothing;
-      uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
-      if(uid>0) varT = uid - 1;
-      //cout << "Filling " << h->GetName() << " with varT " << varT << endl;
-    }
-        
-    if(!isTHn) {
-      varX = ((TH1*)h)->GetXaxis()->GetUniqueID();
-      if(fUsedVars[varX]) {
-        switch(dimension) {
+    TIter next(hList);
+    TObject* h=0x0;
+    while((h=next())) {
+      Int_t uid = h->GetUniqueID();
+      Bool_t isProfile = (uid%10==1 ? kTRUE : kFALSE);   // units digit encodes the isProfile
+      Bool_t isTHn = ((uid%100)>10 ? kTRUE : kFALSE);
+      Int_t thnDim = 0;
+      if(isTHn) thnDim = (uid%100)-10;        // the excess over 10 from the last 2 digits give the dimension of the THn
+      
+      uid = (uid-(uid%100))/100;
+      Int_t varW = -1, varT = -1;
+      if(uid>0) {
+        varW = uid%(fNVars+1)-1;
+        if(varW==0) varW=AliReducedVarManager::kNothing;
+        uid = (uid-(uid%(fNVars+1)))/(fNVars+1);
+        if(uid>0) varT = uid - 1;
+      }
+      if(varW>AliReducedVarManager::kNothing && !fUsedVars[varW]) continue;
+      
+      FillPlanEntry entry;
+      entry.fHist = h;
+      entry.fFirstVar = fFillPlanVars.size();
+      entry.fVarW = (varW>AliReducedVarManager::kNothing ? varW : -1);
+      Int_t vars[20];
+      Int_t nVars = 0;
+      if(!isTHn) {
+        TH1* h1 = (TH1*)h;
+        vars[nVars++] = h1->GetXaxis()->GetUniqueID();
+        switch(h1->GetDimension()) {
           case 1:
-            if(isProfile) {
-              varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-              if(!fUsedVars[varY]) break;
-              if(varW>AliReducedVarManager::kNothing) { 
-                if(!fUsedVars[varW]) break;
-                ((TProfile*)h)->Fill(values[varX],values[varY],values[varW]);
-              }
-              else 
-                ((TProfile*)h)->Fill(values[varX],values[varY]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH1F*)h)->Fill(values[varX],values[varW]);
-              }
-              else
-                ((TH1F*)h)->Fill(values[varX]);
-            }
+            if(isProfile) vars[nVars++] = h1->GetYaxis()->GetUniqueID();
+            entry.fType = (isProfile ? kFillTProfile : kFillTH1);
           break;
           case 2:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            if(isProfile) {
-              varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-              if(!fUsedVars[varZ]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TProfile2D*)h)->Fill(values[varX],values[varY],values[varZ]);        
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH2F*)h)->Fill(values[varX],values[varY], values[varW]);
-              }
-              else
-                ((TH2F*)h)->Fill(values[varX],values[varY]);
-            }
+            vars[nVars++] = h1->GetYaxis()->GetUniqueID();
+            if(isProfile) vars[nVars++] = h1->GetZaxis()->GetUniqueID();
+            entry.fType = (isProfile ? kFillTProfile2D : kFillTH2);
           break;
           case 3:
-            varY = ((TH1*)h)->GetYaxis()->GetUniqueID();
-            if(!fUsedVars[varY]) break;
-            varZ = ((TH1*)h)->GetZaxis()->GetUniqueID();
-            if(!fUsedVars[varZ]) break;
-            if(isProfile) {
-              if(!fUsedVars[varT]) break;
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT],values[varW]);
-              }
-              else
-                ((TProfile3D*)h)->Fill(values[varX],values[varY],values[varZ],values[varT]);
-            }
-            else {
-              if(varW>AliReducedVarManager::kNothing) {
-                if(!fUsedVars[varW]) break;
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ],values[varW]);
-              }
-              else
-                ((TH3F*)h)->Fill(values[varX],values[varY],values[varZ]);
-            }
+            vars[nVars++] = h1->GetYaxis()->GetUniqueID();
+            vars[nVars++] = h1->GetZaxis()->GetUniqueID();
+            if(isProfile) vars[nVars++] = varT;
+            entry.fType = (isProfile ? kFillTProfile3D : kFillTH3);
           break;
           default:
-          break;
-        }  // end switch
-      }
-    }  // end if(!isTHn)
-    else {
-      for(Int_t idim=0;idim<thnDim;++idim) {
-        if (isSparse) {
-          allVarsGood &= fUsedVars[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnSparseF*)h)->GetAxis(idim)->GetUniqueID()];
-        } else {
-          allVarsGood &= fUsedVars[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
-          fillValues[idim] = values[((THnF*)h)->GetAxis(idim)->GetUniqueID()];
+            continue;
         }
       }
-      if(allVarsGood) {
-        if(varW>AliReducedVarManager::kNothing) {
-          if(fUsedVars[varW]) {
-            if (isSparse) ((THnSparseF*)h)->Fill(fillValues,values[varW]);
-            else          ((THnF*)h)->Fill(fillValues,values[varW]);
-          }
-        }
-        else {
-          if (isSparse) ((THnSparseF*)h)->Fill(fillValues);
-          else          ((THnF*)h)->Fill(fillValues);
-        }
+      else {
+        THnBase* hn = (THnBase*)h;
+        for(Int_t idim=0;idim<thnDim;++idim) vars[nVars++] = hn->GetAxis(idim)->GetUniqueID();
+        entry.fType = kFillTHn;
       }
+      
+      Bool_t allVarsGood = kTRUE;
+      for(Int_t i=0; i<nVars; ++i) allVarsGood &= fUsedVars[vars[i]];
+      if(!allVarsGood) continue;
+      
+      entry.fNVars = nVars;
+      for(Int_t i=0; i<nVars; ++i) fFillPlanVars.push_back(vars[i]);
+      fFillPlan.push_back(entry);
+    }
+  }
+  fFillPlanClassStart.push_back(fFillPlan.size());
+  fFillPlanCompiled = kTRUE;
+}
+
+//__________________________________________________________________
+void AliHistogramManager::FillPlannedClass(Int_t classIndex, const Float_t* values) {
+  //
+  //  fill the histograms of a class from the fill plan
+  //
+  Double_t fillValues[20]={0.0};
+  const Int_t* planVars = (fFillPlanVars.empty() ? 0x0 : &fFillPlanVars[0]);
+  for(Int_t ientry=fFillPlanClassStart[classIndex]; ientry<fFillPlanClassStart[classIndex+1]; ++ientry) {
+    const FillPlanEntry& entry = fFillPlan[ientry];
+    const Int_t* v = planVars + entry.fFirstVar;
+    switch(entry.fType) {
+      case kFillTH1:
+        if(entry.fVarW>=0) ((TH1F*)entry.fHist)->Fill(values[v[0]],values[entry.fVarW]);
+        else               ((TH1F*)entry.fHist)->Fill(values[v[0]]);
+      break;
+      case kFillTProfile:
+        if(entry.fVarW>=0) ((TProfile*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[entry.fVarW]);
+        else               ((TProfile*)entry.fHist)->Fill(values[v[0]],values[v[1]]);
+      break;
+      case kFillTH2:
+        if(entry.fVarW>=0) ((TH2F*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[entry.fVarW]);
+        else               ((TH2F*)entry.fHist)->Fill(values[v[0]],values[v[1]]);
+      break;
+      case kFillTProfile2D:
+        if(entry.fVarW>=0) ((TProfile2D*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[entry.fVarW]);
+        else               ((TProfile2D*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]]);
+      break;
+      case kFillTH3:
+        if(entry.fVarW>=0) ((TH3F*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[entry.fVarW]);
+        else               ((TH3F*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]]);
+      break;
+      case kFillTProfile3D:
+        if(entry.fVarW>=0) ((TProfile3D*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[v[3]],values[entry.fVarW]);
+        else               ((TProfile3D*)entry.fHist)->Fill(values[v[0]],values[v[1]],values[v[2]],values[v[3]]);
+      break;
+      case kFillTHn:
+        for(Int_t idim=0; idim<entry.fNVars; ++idim) fillValues[idim] = values[v[idim]];
+        if(entry.fVarW>=0) ((THnBase*)entry.fHist)->Fill(fillValues,values[entry.fVarW]);
+        else               ((THnBase*)entry.fHist)->Fill(fillValues);
+      break;
+      default:
+      break;
     }
   }
 }
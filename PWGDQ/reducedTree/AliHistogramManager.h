@@ -14,6 +14,9 @@
 #include <TList.h>
 #include <THashList.h>
 
+#include <vector>
+#include <map>
+
 #include "AliReducedVarManager.h"
 
 class TAxis;
@@ -69,6 +72,12 @@ class AliHistogramManager : public TObject {
                         TAxis* axis);
   
   void FillHistClass(const Char_t* className, Float_t* values);
+  // fill via the index of the histogram class (position in the main list), avoids the lookup by name;
+  // FillHistClasses fills several classes with the same values, e.g. all cut classes of a pair candidate
+  Int_t GetHistClassIndex(const Char_t* className);
+  void FillHistClass(Int_t classIndex, Float_t* values);
+  void FillHistClasses(Int_t nClasses, const Int_t* classIndices, Float_t* values);
+  void CompileFillPlans();
   
   void SetUseDefaultVariableNames(Bool_t flag) {fUseDefaultVariableNames = flag;};
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -106,9 +115,27 @@ class AliHistogramManager : public TObject {
   TString fVariableUnits[AliReducedVarManager::kNVars];               //! variable units
   Int_t fNVars;                          // maximum number of variables
   
+  // fill plan: the histograms of all classes with their type and variables, decoded once after booking
+  enum FillTypes {
+    kFillTH1=0, kFillTProfile, kFillTH2, kFillTProfile2D, kFillTH3, kFillTProfile3D, kFillTHn
+  };
+  struct FillPlanEntry {
+    TObject* fHist;      // histogram
+    Int_t fType;         // one of FillTypes
+    Int_t fFirstVar;     // first variable index in fFillPlanVars
+    Int_t fNVars;        // number of variables (without the weight)
+    Int_t fVarW;         // weight variable, -1 if not weighted
+  };
+  std::vector<FillPlanEntry> fFillPlan;           //! histograms of all classes, ordered by class
+  std::vector<Int_t> fFillPlanVars;                //! variable indices of the fill plan entries
+  std::vector<Int_t> fFillPlanClassStart;          //! first fill plan entry of each class (plus end marker)
+  std::map<const TObject*, Int_t> fFillPlanClassIndex;   //! class index for each histogram list
+  Bool_t fFillPlanCompiled;                        //! the fill plan is up to date with the booked histograms
+  
   void MakeAxisLabels(TAxis* ax, const Char_t* labels);
+  void FillPlannedClass(Int_t classIndex, const Float_t* values);
   
-  ClassDef(AliHistogramManager, 4)
+  ClassDef(AliHistogramManager, 5)
 };
 
 #endif
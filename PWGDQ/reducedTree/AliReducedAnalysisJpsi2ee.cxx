@@ -61,7 +61,10 @@ AliReducedAnalysisJpsi2ee::AliReducedAnalysisJpsi2ee() :
   fClusterTrackMatcherMultipleMatchesBefore(0x0),
   fClusterTrackMatcherMultipleMatchesAfter(0x0),
   fSkipMCEvent(kFALSE),
-  fMCJpsiPtWeights(0x0)
+  fMCJpsiPtWeights(0x0),
+  fPairHistClassName(""),
+  fPairHistClassIndices(),
+  fPairHistClassesToFill()
 {
   //
   // default constructor
@@ -103,7 +106,10 @@ AliReducedAnalysisJpsi2ee::AliReducedAnalysisJpsi2ee(const Char_t* name, const C
   fClusterTrackMatcherMultipleMatchesBefore(0x0),
   fClusterTrackMatcherMultipleMatchesAfter(0x0),
   fSkipMCEvent(kFALSE),
-  fMCJpsiPtWeights(0x0)
+  fMCJpsiPtWeights(0x0),
+  fPairHistClassName(""),
+  fPairHistClassIndices(),
+  fPairHistClassesToFill()
 {
   //
   // named constructor
@@ -559,37 +565,56 @@ void AliReducedAnalysisJpsi2ee::FillPairHistograms(ULong_t trackMask, ULong_t pa
    //
    // fill pair level histograms
    // NOTE: pairType can be 0,1 or 2 corresponding to ++, +- or -- pairs
-   TString typeStr[3] = {"PP", "PM", "MM"};
-   if (fPairCuts.GetEntries()>1) {
-      for(Int_t iTrackCut=0; iTrackCut<fTrackCuts.GetEntries(); ++iTrackCut) {
-         for(Int_t iPairCut=0; iPairCut<fPairCuts.GetEntries(); ++iPairCut) {
-            if((trackMask & (ULong_t(1)<<iTrackCut)) && (pairMask & (ULong_t(1)<<iPairCut))) {
-               fHistosManager->FillHistClass(Form("%s%s_%s_%s", pairClass.Data(), typeStr[pairType].Data(),
-                                                  fTrackCuts.At(iTrackCut)->GetName(), fPairCuts.At(iPairCut)->GetName()), fValues);
-               if(mcDecisions && pairType==1) {
-                  for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                     if(mcDecisions & (UInt_t(1)<<iMC))
-                        fHistosManager->FillHistClass(Form("%s%s_%s_%s_%s", pairClass.Data(), typeStr[pairType].Data(),
-                                                           fTrackCuts.At(iTrackCut)->GetName(), fPairCuts.At(iPairCut)->GetName(),
-                                                           fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-                  }
-               }
+   // The histogram classes of all cut combinations are looked up once, the classes selected by the
+   //   track, pair and MC masks are then filled in one pass
+   if(fPairHistClassIndices.empty() || pairClass!=fPairHistClassName) BuildPairHistClassIndices(pairClass);
+   
+   Int_t nTrackCuts = fTrackCuts.GetEntries();
+   Int_t nPairCuts = (fPairCuts.GetEntries()>1 ? fPairCuts.GetEntries() : 1);
+   Int_t nMCcuts = fLegCandidatesMCcuts.GetEntries();
+   fPairHistClassesToFill.clear();
+   for(Int_t iTrackCut=0; iTrackCut<nTrackCuts; ++iTrackCut) {
+      if(!(trackMask & (ULong_t(1)<<iTrackCut))) continue;
+      for(Int_t iPairCut=0; iPairCut<nPairCuts; ++iPairCut) {
+         if(fPairCuts.GetEntries()>1 && !(pairMask & (ULong_t(1)<<iPairCut))) continue;
+         const Int_t* classIndices = &fPairHistClassIndices[((pairType*nTrackCuts+iTrackCut)*nPairCuts+iPairCut)*(nMCcuts+1)];
+         fPairHistClassesToFill.push_back(classIndices[0]);
+         if(mcDecisions && pairType==1) {
+            for(Int_t iMC=0; iMC<nMCcuts; ++iMC) {
+               if(mcDecisions & (UInt_t(1)<<iMC))
+                  fPairHistClassesToFill.push_back(classIndices[1+iMC]);
             }
          }
       }
-   } else {
-      for(Int_t iTrackCut=0; iTrackCut<fTrackCuts.GetEntries(); ++iTrackCut) {
-         if(trackMask & (ULong_t(1)<<iTrackCut)) {
-            fHistosManager->FillHistClass(Form("%s%s_%s", pairClass.Data(), typeStr[pairType].Data(), fTrackCuts.At(iTrackCut)->GetName()), fValues);
-            if(mcDecisions && pairType==1) {
-               for(Int_t iMC=0; iMC<=fLegCandidatesMCcuts.GetEntries(); ++iMC) {
-                  if(mcDecisions & (UInt_t(1)<<iMC))
-                     fHistosManager->FillHistClass(Form("%s%s_%s_%s", pairClass.Data(), typeStr[pairType].Data(), fTrackCuts.At(iTrackCut)->GetName(), fLegCandidatesMCcuts.At(iMC)->GetName()), fValues);
-               }
-            }
+   }
+   if(!fPairHistClassesToFill.empty())
+      fHistosManager->FillHistClasses(fPairHistClassesToFill.size(), &fPairHistClassesToFill[0], fValues);
+}
+
+//___________________________________________________________________________
+void AliReducedAnalysisJpsi2ee::BuildPairHistClassIndices(TString pairClass) {
+   //
+   // look up the histogram class indices of the pair classes for all pair types, track cuts, pair cuts
+   //  and leg MC cuts (-1 for classes which are not defined)
+   //
+   TString typeStr[3] = {"PP", "PM", "MM"};
+   Int_t nTrackCuts = fTrackCuts.GetEntries();
+   Int_t nPairCuts = (fPairCuts.GetEntries()>1 ? fPairCuts.GetEntries() : 1);
+   Int_t nMCcuts = fLegCandidatesMCcuts.GetEntries();
+   fPairHistClassIndices.assign(3*nTrackCuts*nPairCuts*(nMCcuts+1), -1);
+   for(Int_t pairType=0; pairType<3; ++pairType) {
+      for(Int_t iTrackCut=0; iTrackCut<nTrackCuts; ++iTrackCut) {
+         for(Int_t iPairCut=0; iPairCut<nPairCuts; ++iPairCut) {
+            TString className = Form("%s%s_%s", pairClass.Data(), typeStr[pairType].Data(), fTrackCuts.At(iTrackCut)->GetName());
+            if(fPairCuts.GetEntries()>1) className += Form("_%s", fPairCuts.At(iPairCut)->GetName());
+            Int_t offset = ((pairType*nTrackCuts+iTrackCut)*nPairCuts+iPairCut)*(nMCcuts+1);
+            fPairHistClassIndices[offset] = fHistosManager->GetHistClassIndex(className.Data());
+            for(Int_t iMC=0; iMC<nMCcuts; ++iMC)
+               fPairHistClassIndices[offset+1+iMC] = fHistosManager->GetHistClassIndex(Form("%s_%s", className.Data(), fLegCandidatesMCcuts.At(iMC)->GetName()));
          }
-      }  // end loop over cuts
+      }
    }
+   fPairHistClassName = pairClass;
 }
 
 //___________________________________________________________________________
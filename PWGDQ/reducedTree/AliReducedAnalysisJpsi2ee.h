@@ -7,6 +7,8 @@
 
 #include <TList.h>
 
+#include <vector>
+
 #include "AliReducedAnalysisTaskSE.h"
 #include "AliReducedInfoCut.h"
 #include "AliReducedBaseEvent.h"
@@ -161,6 +163,7 @@ protected:
   void FillTrackHistograms(TString trackClass = "Track");
   void FillTrackHistograms(AliReducedBaseTrack* track, TString trackClass = "Track");
   void FillPairHistograms(ULong_t trackMask, ULong_t pairMask, Int_t pairType, TString pairClass = "PairSE", UInt_t mcDecisions = 0);
+  void BuildPairHistClassIndices(TString pairClass);
   void FillClusterHistograms(TString clusterClass="CaloCluster");
   void FillClusterHistograms(AliReducedCaloClusterInfo* cluster, TString clusterClass="CaloCluster");
   void FillMCTruthHistograms();
@@ -172,7 +175,11 @@ protected:
   Bool_t fSkipMCEvent;          // decision to skip MC event
   TH1F*  fMCJpsiPtWeights;            // weights vs pt to reject events depending on the jpsi true pt (needed to re-weights jpsi Pt distribution)
   
-  ClassDef(AliReducedAnalysisJpsi2ee,13);
+  TString fPairHistClassName;                  //! pair class for which fPairHistClassIndices were built
+  std::vector<Int_t> fPairHistClassIndices;    //! histogram class indices for each pair type, track cut, pair cut and leg MC cut
+  std::vector<Int_t> fPairHistClassesToFill;   //! histogram classes to be filled for the current pair
+  
+  ClassDef(AliReducedAnalysisJpsi2ee,14);
 };
 
 #endif
@@ -69,12 +69,237 @@
 #include "AliAODv0.h"
 #include "AliCodeTimer.h"
 #include "AliMultSelection.h"
+#include <TROOT.h>
 #include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 /// \cond CLASSIMP
 ClassImp(AliAnalysisVertexingHF);
 /// \endcond
 
+//----------------------------------------------------------------------------
+// Secondary vertex of a track pair or triplet of the loops of FindCandidates,
+// fitted by a worker thread. The fits of a first positive track are ordered
+// as they are visited in the loops: by first negative track, then by loop
+// (0: pair, 1: +-+ triplet, 2: -+- triplet), then by third track.
+struct AliAnalysisVertexingHFVertexFit
+{
+  Int_t    fTrkN1;       // first negative track
+  Int_t    fLoop;        // 0: pair, 1: 2nd loop on positive tracks, 2: 2nd loop on negative tracks
+  Int_t    fTrk3;        // third track, -1 for the pair
+  Bool_t   fOK;          // kFALSE if the fit failed or the vertex was rejected
+  Double_t fPos[3];      // vertex position
+  Double_t fCov[6];      // vertex covariance matrix
+  Double_t fChi2perNDF;  // vertex chi2/NDF
+  Double_t fDispersion;  // vertex dispersion
+
+  Bool_t Before(Int_t iTrkN1,Int_t loop,Int_t iTrk3) const {
+    if(fTrkN1!=iTrkN1) return fTrkN1<iTrkN1;
+    if(fLoop!=loop) return fLoop<loop;
+    return fTrk3<iTrk3;
+  }
+  Bool_t Is(Int_t iTrkN1,Int_t loop,Int_t iTrk3) const {
+    return fTrkN1==iTrkN1 && fLoop==loop && fTrk3==iTrk3;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Worker threads of FindCandidates. For each event the first positive tracks
+// are handed out to the threads one at a time, and each thread fits the
+// secondary vertices of the pairs and triplets of its tracks with its own
+// vertexer and its own copies of the selected tracks. The fits are stored per
+// first positive track, so the result does not depend on which thread did the
+// work, and are used by the loops of FindCandidates, which create the
+// candidates in the usual order.
+class AliAnalysisVertexingHFWorkers
+{
+public:
+  AliAnalysisVertexingHFWorkers(Int_t nThreads);
+  ~AliAnalysisVertexingHFWorkers();
+
+  // Fit the vertices for all first positive tracks of the event, returns when all are done
+  void Process(const AliAnalysisVertexingHF *vHF,const TObjArray *seleTrks,const TObjArray *tracksAtVertex,
+	       const UChar_t *seleFlags,const Int_t *evtNumber,
+	       Double_t dcaMax,Double_t maxMass3Prong,Double_t maxPt3ProngTrk);
+  // Fit done by the threads, 0x0 if it was not done. The lookups of a first
+  // positive track have to come in the order of the fits.
+  const AliAnalysisVertexingHFVertexFit* Find(Int_t iTrkP1,Int_t iTrkN1,Int_t loop,Int_t iTrk3);
+  // Drop the fits of the event
+  void Clear() { fActive=kFALSE; }
+
+private:
+  struct Worker {
+    Worker() : fThread(), fVertexer(0x0), fMassCalc(0x0), fTracks() {}
+    std::thread        fThread;    // the thread
+    AliVertexerTracks *fVertexer;  // vertexer of the thread
+    AliAODRecoDecay   *fMassCalc;  // for the 3 prong invariant mass
+    TObjArray          fTracks;    // copies of the selected tracks, at the primary vertex
+  };
+
+  void Run(Worker *worker);
+
+  std::vector<Worker*> fWorkers;            // the threads
+  std::mutex fMutex;                        // protects the fields below up to fNDone
+  std::condition_variable fStart;           // signals a new event or the stop to the threads
+  std::condition_variable fDone;            // signals the end of the event to Process
+  Int_t  fGeneration;                       // number of the event
+  Int_t  fNDone;                            // threads done with the event
+  Bool_t fStop;                             // stop the threads
+  std::atomic<Int_t> fNextTrack;            // next first positive track to be processed
+
+  // event data, read by the threads
+  const AliAnalysisVertexingHF *fVertexingHF;
+  const TObjArray *fSeleTrks;
+  const TObjArray *fTracksAtVertex;
+  const UChar_t   *fSeleFlags;
+  const Int_t     *fEvtNumber;
+  Int_t    fNSeleTrks;
+  Double_t fDCAMax;
+  Double_t fMaxMass3Prong;
+  Double_t fMaxPt3ProngTrk;
+
+  std::vector<std::vector<AliAnalysisVertexingHFVertexFit> > fFits; // fits per first positive track
+  std::vector<size_t> fNextFit;            // next fit to be looked up, per first positive track
+  Bool_t fActive;                          // fits of the current event available
+
+  AliAnalysisVertexingHFWorkers(const AliAnalysisVertexingHFWorkers&);
+  AliAnalysisVertexingHFWorkers& operator=(const AliAnalysisVertexingHFWorkers&);
+};
+
+//----------------------------------------------------------------------------
+AliAnalysisVertexingHFWorkers::AliAnalysisVertexingHFWorkers(Int_t nThreads) :
+  fWorkers(),
+  fMutex(),
+  fStart(),
+  fDone(),
+  fGeneration(0),
+  fNDone(0),
+  fStop(kFALSE),
+  fNextTrack(0),
+  fVertexingHF(0x0),
+  fSeleTrks(0x0),
+  fTracksAtVertex(0x0),
+  fSeleFlags(0x0),
+  fEvtNumber(0x0),
+  fNSeleTrks(0),
+  fDCAMax(0.),
+  fMaxMass3Prong(0.),
+  fMaxPt3ProngTrk(0.),
+  fFits(),
+  fNextFit(),
+  fActive(kFALSE)
+{
+  // the threads create ROOT objects (vertices, track copies)
+  ROOT::EnableThreadSafety();
+
+  Double_t d03[3]={0.,0.,0.};
+  for(Int_t i=0; i<nThreads; i++) {
+    Worker *worker = new Worker;
+    worker->fMassCalc = new AliAODRecoDecay(0x0,3,1,d03);
+    worker->fTracks.SetOwner(kTRUE);
+    fWorkers.push_back(worker);
+  }
+  for(size_t i=0; i<fWorkers.size(); i++)
+    fWorkers[i]->fThread = std::thread(&AliAnalysisVertexingHFWorkers::Run,this,fWorkers[i]);
+}
+//----------------------------------------------------------------------------
+AliAnalysisVertexingHFWorkers::~AliAnalysisVertexingHFWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop=kTRUE;
+  }
+  fStart.notify_all();
+  for(size_t i=0; i<fWorkers.size(); i++) {
+    fWorkers[i]->fThread.join();
+    delete fWorkers[i]->fVertexer;
+    delete fWorkers[i]->fMassCalc;
+    delete fWorkers[i];
+  }
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHFWorkers::Process(const AliAnalysisVertexingHF *vHF,const TObjArray *seleTrks,const TObjArray *tracksAtVertex,
+					    const UChar_t *seleFlags,const Int_t *evtNumber,
+					    Double_t dcaMax,Double_t maxMass3Prong,Double_t maxPt3ProngTrk)
+{
+  fNSeleTrks = seleTrks->GetEntriesFast();
+  if((Int_t)fFits.size()<fNSeleTrks) fFits.resize(fNSeleTrks);
+  for(Int_t i=0; i<fNSeleTrks; i++) fFits[i].clear();
+  fNextFit.assign(fNSeleTrks,0);
+
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fVertexingHF = vHF;
+    fSeleTrks = seleTrks;
+    fTracksAtVertex = tracksAtVertex;
+    fSeleFlags = seleFlags;
+    fEvtNumber = evtNumber;
+    fDCAMax = dcaMax;
+    fMaxMass3Prong = maxMass3Prong;
+    fMaxPt3ProngTrk = maxPt3ProngTrk;
+    fNextTrack = 0;
+    fNDone = 0;
+    fGeneration++;
+  }
+  fStart.notify_all();
+
+  std::unique_lock<std::mutex> lock(fMutex);
+  fDone.wait(lock,[this]{ return fNDone==(Int_t)fWorkers.size(); });
+  fActive=kTRUE;
+}
+//----------------------------------------------------------------------------
+const AliAnalysisVertexingHFVertexFit* AliAnalysisVertexingHFWorkers::Find(Int_t iTrkP1,Int_t iTrkN1,Int_t loop,Int_t iTrk3)
+{
+  if(!fActive || iTrkP1>=fNSeleTrks) return 0x0;
+  const std::vector<AliAnalysisVertexingHFVertexFit> &fits = fFits[iTrkP1];
+  size_t &next = fNextFit[iTrkP1];
+  while(next<fits.size() && fits[next].Before(iTrkN1,loop,iTrk3)) next++;
+  if(next<fits.size() && fits[next].Is(iTrkN1,loop,iTrk3)) return &fits[next];
+  return 0x0;
+}
+//----------------------------------------------------------------------------
+void AliAnalysisVertexingHFWorkers::Run(Worker *worker)
+{
+  Int_t generation=0;
+  while(kTRUE) {
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fStart.wait(lock,[this,generation]{ return fStop || fGeneration!=generation; });
+      if(fStop) return;
+      generation=fGeneration;
+    }
+
+    // vertexer with the field of the event, configured as the one of AliAnalysisVertexingHF
+    Double_t bz=fVertexingHF->fBzkG;
+    if(!worker->fVertexer) worker->fVertexer=new AliVertexerTracks(bz);
+    else if(worker->fVertexer->GetFieldkG()!=bz) worker->fVertexer->SetFieldkG(bz);
+
+    // copies of the selected tracks with their parameters at the primary vertex,
+    // as the tracks in the loops when the vertices are fitted
+    worker->fTracks.Expand(fNSeleTrks);
+    for(Int_t i=0; i<fNSeleTrks; i++) {
+      AliESDtrack *track = new AliESDtrack(*(AliESDtrack*)fSeleTrks->UncheckedAt(i));
+      fVertexingHF->SetParametersAtVertex(track,(AliExternalTrackParam*)fTracksAtVertex->UncheckedAt(i));
+      worker->fTracks.AddAt(track,i);
+    }
+
+    for(Int_t iTrkP1=fNextTrack++; iTrkP1<fNSeleTrks; iTrkP1=fNextTrack++)
+      fVertexingHF->FitSecondaryVertices(iTrkP1,worker->fTracks,fSeleFlags,fEvtNumber,
+					 fDCAMax,fMaxMass3Prong,fMaxPt3ProngTrk,
+					 worker->fVertexer,worker->fMassCalc,fFits[iTrkP1]);
+    worker->fTracks.Delete();
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fNDone++;
+    }
+    fDone.notify_one();
+  }
+}
+
 //----------------------------------------------------------------------------
 AliAnalysisVertexingHF::AliAnalysisVertexingHF():
 fInputAOD(kFALSE),
@@ -139,6 +364,12 @@ fFindVertexForDstar(kTRUE),
 fFindVertexForCascades(kTRUE),
 fV0TypeForCascadeVertex(0),
 fMassCutBeforeVertexing(kFALSE),
+fUseTrackPairDCACache(kFALSE),
+fNTrksDCACache(0),
+fTrackPairDCA(),
+fUse3ProngPairPrefilter(kFALSE),
+fNWorkerThreads(0),
+fWorkers(0x0),
 fMassCalc2(0),
 fMassCalc3(0),
 fMassCalc4(0),
@@ -153,6 +384,8 @@ fOKInvMassD0to4p(kFALSE),
 fOKInvMassLctoV0(kFALSE),
 fnTrksTotal(0),
 fnSeleTrksTotal(0),
+fnPairsSkipped3ProngFlags(0),
+fnPairsSkipped3ProngKine(0),
 fMakeReducedRHF(kFALSE),
 fMassDzero(0.),
 fMassDplus(0.),
@@ -161,7 +394,8 @@ fMassLambdaC(0.),
 fMassDstar(0.),
 fMassJpsi(0.),
 fMassPhi(0.),
-fMassK(0.)
+fMassK(0.),
+fMassPi(0.)
 {
   /// Default constructor
 
@@ -238,6 +472,12 @@ fFindVertexForDstar(source.fFindVertexForDstar),
 fFindVertexForCascades(source.fFindVertexForCascades),
 fV0TypeForCascadeVertex(source.fV0TypeForCascadeVertex),
 fMassCutBeforeVertexing(source.fMassCutBeforeVertexing),
+fUseTrackPairDCACache(source.fUseTrackPairDCACache),
+fNTrksDCACache(0),
+fTrackPairDCA(),
+fUse3ProngPairPrefilter(source.fUse3ProngPairPrefilter),
+fNWorkerThreads(source.fNWorkerThreads),
+fWorkers(0x0),
 fMassCalc2(source.fMassCalc2),
 fMassCalc3(source.fMassCalc3),
 fMassCalc4(source.fMassCalc4),
@@ -252,6 +492,8 @@ fOKInvMassD0to4p(source.fOKInvMassD0to4p),
 fOKInvMassLctoV0(source.fOKInvMassLctoV0),
 fnTrksTotal(0),
 fnSeleTrksTotal(0),
+fnPairsSkipped3ProngFlags(0),
+fnPairsSkipped3ProngKine(0),
 fMakeReducedRHF(kFALSE),
 fMassDzero(source.fMassDzero),
 fMassDplus(source.fMassDplus),
@@ -260,7 +502,8 @@ fMassLambdaC(source.fMassLambdaC),
 fMassDstar(source.fMassDstar),
 fMassJpsi(source.fMassJpsi),
 fMassPhi(source.fMassPhi),
-fMassK(source.fMassK)
+fMassK(source.fMassK),
+fMassPi(source.fMassPi)
 {
   ///
   /// Copy constructor
@@ -336,6 +579,9 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
   fFindVertexForCascades = source.fFindVertexForCascades;
   fV0TypeForCascadeVertex = source.fV0TypeForCascadeVertex;
   fMassCutBeforeVertexing = source.fMassCutBeforeVertexing;
+  fUseTrackPairDCACache = source.fUseTrackPairDCACache;
+  fUse3ProngPairPrefilter = source.fUse3ProngPairPrefilter;
+  fNWorkerThreads = source.fNWorkerThreads;
   fMassCalc2 = source.fMassCalc2;
   fMassCalc3 = source.fMassCalc3;
   fMassCalc4 = source.fMassCalc4;
@@ -356,6 +602,7 @@ AliAnalysisVertexingHF &AliAnalysisVertexingHF::operator=(const AliAnalysisVerte
   fMassJpsi = source.fMassJpsi;
   fMassPhi = source.fMassPhi;
   fMassK = source.fMassK;
+  fMassPi = source.fMassPi;
 
   return *this;
 }
@@ -365,6 +612,7 @@ AliAnalysisVertexingHF::~AliAnalysisVertexingHF() {
   if(fV1) { delete fV1; fV1=0; }
   if(fV1AOD) { delete fV1AOD; fV1AOD=0; }
   delete fVertexerTracks;
+  delete fWorkers;
   if(fTrackFilter) { delete fTrackFilter; fTrackFilter=0; }
   if(fTrackFilter2prongCentral) { delete fTrackFilter2prongCentral; fTrackFilter2prongCentral=0; }
   if(fTrackFilter3prongCentral) { delete fTrackFilter3prongCentral; fTrackFilter3prongCentral=0; }
@@ -629,6 +877,12 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   AliDebug(1,Form(" Selected tracks: %d",nSeleTrks));
   fnSeleTrksTotal += nSeleTrks;
 
+  // reset the cache of the track-to-track DCAs
+  if(fUseTrackPairDCACache) {
+    fNTrksDCACache = nSeleTrks;
+    fTrackPairDCA.assign((size_t)nSeleTrks*nSeleTrks,-1.);
+  }
+
 
   TObjArray *twoTrackArray1    = new TObjArray(2);
   TObjArray *twoTrackArray2    = new TObjArray(2);
@@ -651,6 +905,24 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   fMinPt3Prong=TMath::Min(fCutsDplustoKpipi->GetMinPtCandidate(),fCutsDstoKKpi->GetMinPtCandidate());
   fMinPt3Prong=TMath::Min(fMinPt3Prong,fCutsLctopKpi->GetMinPtCandidate());
 
+  // bounds for the pre-filter of the track pairs in the 3 prong loops
+  Double_t maxMass3Prong=0.,maxPt3ProngTrk=0.;
+  if(fUse3ProngPairPrefilter && f3Prong && fMassCutBeforeVertexing) {
+    maxMass3Prong=GetMaxMass3Prong();
+    for(Int_t iTrk=0; iTrk<nSeleTrks; iTrk++) {
+      if(!TESTBIT(seleFlags[iTrk],kBit3Prong)) continue;
+      Double_t ptTrk=((AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrk))->Pt();
+      if(ptTrk>maxPt3ProngTrk) maxPt3ProngTrk=ptTrk;
+    }
+  }
+
+  // fit the secondary vertices of the track pairs and triplets with the worker
+  // threads, the loops below take the vertices from there
+  if(fNWorkerThreads>1 && !fSecVtxWithKF && trkEntries>=2 && nSeleTrks>1) {
+    if(!fWorkers) fWorkers = new AliAnalysisVertexingHFWorkers(fNWorkerThreads);
+    fWorkers->Process(this,&seleTrksArray,&tracksAtVertex,seleFlags,evtNumber,dcaMax,maxMass3Prong,maxPt3ProngTrk);
+  }
+
   Double_t minPtV0=0.;
   if(fCutsLctoV0) minPtV0=fCutsLctoV0->GetMinV0PtCut();
   if(fCutsDstoK0sK){
@@ -876,13 +1148,13 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       negtrack1->GetPxPyPz(momneg1);
 
       // DCA between the two tracks
-      dcap1n1 = postrack1->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+      dcap1n1 = GetTrackPairDCA(postrack1,iTrkP1,negtrack1,iTrkN1);
       if(dcap1n1>dcaMax) { negtrack1=0; continue; }
 
       // Vertexing
       twoTrackArray1->AddAt(postrack1,0);
       twoTrackArray1->AddAt(negtrack1,1);
-      AliAODVertex *vertexp1n1 = ReconstructSecondaryVertex(twoTrackArray1,dispersion);
+      AliAODVertex *vertexp1n1 = GetSecondaryVertex(twoTrackArray1,dispersion,iTrkP1,iTrkN1,0,-1);
       if(!vertexp1n1) {
 	twoTrackArray1->Clear();
 	negtrack1=0;
@@ -1056,8 +1328,37 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	continue;
       }
 
+      // Pre-filter of the pair: skip the 3 prong loops if all triplets would be
+      // rejected in the loops (same checks, done once per pair)
+      Bool_t skipLoopP2=kFALSE,skipLoopN2=kFALSE;
+      if(fUse3ProngPairPrefilter) {
+	if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong) || !TESTBIT(seleFlags[iTrkN1],kBit3Prong)) {
+	  skipLoopP2=kTRUE;
+	  skipLoopN2=kTRUE;
+	  fnPairsSkipped3ProngFlags++;
+	} else if(fUseKaonPIDfor3Prong) {
+	  if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat)) skipLoopP2=kTRUE;
+	  if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat)) skipLoopN2=kTRUE;
+	  if(skipLoopP2 || skipLoopN2) fnPairsSkipped3ProngFlags++;
+	}
+	if(f3Prong && fMassCutBeforeVertexing) {
+	  // +-+ (the 2nd loop on positive tracks also builds the 4 prongs)
+	  if(!skipLoopP2 && !f4Prong && !Pass3ProngPairPrefilter(mompos1,momneg1,maxMass3Prong,maxPt3ProngTrk)) {
+	    skipLoopP2=kTRUE;
+	    fnPairsSkipped3ProngKine++;
+	  }
+	  // -+-
+	  if(!skipLoopN2 && !Pass3ProngPairPrefilter(momneg1,mompos1,maxMass3Prong,maxPt3ProngTrk)) {
+	    skipLoopN2=kTRUE;
+	    fnPairsSkipped3ProngKine++;
+	  }
+	}
+      }
+      // the 2nd loop on negative tracks uses iTrkP2 as left by the 2nd loop on positive tracks
+      if(skipLoopP2) iTrkP2=nSeleTrks;
 
       // 2nd LOOP  ON  POSITIVE  TRACKS
+      if(!skipLoopP2)
       for(iTrkP2=iTrkP1+1; iTrkP2<nSeleTrks; iTrkP2++) {
 
 	if(iTrkP2==iTrkP1 || iTrkP2==iTrkN1) continue;
@@ -1139,9 +1440,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 
 	//printf("********** %d %d %d\n",postrack1->GetID(),postrack2->GetID(),negtrack1->GetID());
 
-	dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+	dcap2n1 = GetTrackPairDCA(postrack2,iTrkP2,negtrack1,iTrkN1);
 	if(dcap2n1>dcaMax) { postrack2=0; continue; }
-	dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
+	dcap1p2 = GetTrackPairDCA(postrack2,iTrkP2,postrack1,iTrkP1);
 	if(dcap1p2>dcaMax) { postrack2=0; continue; }
 
 	// check invariant mass cuts for D+,Ds,Lc
@@ -1181,7 +1482,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	// 3 prong candidates
 	if(f3Prong && massCutOK) {
 	  
-	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
+	  AliAODVertex* secVert3PrAOD = GetSecondaryVertex(threeTrackArray,dispersion,iTrkP1,iTrkN1,1,iTrkP2);
 	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap2n1,dcap1p2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
 	  if(ok3Prong) {
             AliAODVertex *v3Prong=0x0;
@@ -1243,7 +1544,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
           threeTrackArray->AddAt(postrack1,0);
           threeTrackArray->AddAt(negtrack1,1);
 	  threeTrackArray->AddAt(postrack2,2);
-          AliAODVertex* vertexp1n1p2 = ReconstructSecondaryVertex(threeTrackArray,dispersion);
+          AliAODVertex* vertexp1n1p2 = GetSecondaryVertex(threeTrackArray,dispersion,iTrkP1,iTrkN1,1,iTrkP2);
 
 	  // 3rd LOOP  ON  NEGATIVE  TRACKS (for 4 prong)
 	  for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
@@ -1277,9 +1578,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	    SetParametersAtVertex(postrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkP2));
 	    SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
 
-	    dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	    dcap1n2 = GetTrackPairDCA(postrack1,iTrkP1,negtrack2,iTrkN2);
 	    if(dcap1n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
-            dcap2n2 = postrack2->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+            dcap2n2 = GetTrackPairDCA(postrack2,iTrkP2,negtrack2,iTrkN2);
             if(dcap2n2 > fCutsD0toKpipipi->GetDCACut()) { negtrack2=0; continue; }
 
 
@@ -1334,6 +1635,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
       twoTrackArray2->Clear();
 
       // 2nd LOOP  ON  NEGATIVE  TRACKS (for 3 prong -+-)
+      if(!skipLoopN2)
       for(iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
 
 	if(iTrkN2==iTrkP1 || iTrkN2==iTrkP2 || iTrkN2==iTrkN1) continue;
@@ -1410,9 +1712,9 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	SetParametersAtVertex(negtrack2,(AliExternalTrackParam*)tracksAtVertex.UncheckedAt(iTrkN2));
 	//printf("********** %d %d %d\n",postrack1->GetID(),negtrack1->GetID(),negtrack2->GetID());
 
-	dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	dcap1n2 = GetTrackPairDCA(postrack1,iTrkP1,negtrack2,iTrkN2);
 	if(dcap1n2>dcaMax) { negtrack2=0; continue; }
-	dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+	dcan1n2 = GetTrackPairDCA(negtrack1,iTrkN1,negtrack2,iTrkN2);
 	if(dcan1n2>dcaMax) { negtrack2=0; continue; }
 
 	threeTrackArray->AddAt(negtrack1,0);
@@ -1440,7 +1742,7 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
 	twoTrackArray2->AddAt(negtrack2,1);
 
 	if(f3Prong) {
-	  AliAODVertex* secVert3PrAOD = ReconstructSecondaryVertex(threeTrackArray,dispersion);
+	  AliAODVertex* secVert3PrAOD = GetSecondaryVertex(threeTrackArray,dispersion,iTrkP1,iTrkN1,2,iTrkN2);
 	  io3Prong = Make3Prong(threeTrackArray,event,secVert3PrAOD,dispersion,vertexp1n1,twoTrackArray2,dcap1n1,dcap1n2,dcan1n2,okForLcTopKpi,okForDsToKKpi,ok3Prong);
 	  if(ok3Prong) {
 	    AliAODVertex *v3Prong = 0x0;
@@ -1528,6 +1830,10 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
     AliDebug(1,Form(" Like-sign 3Prong in event = %d;\n",
 		    (Int_t)aodLikeSign3ProngTClArr->GetEntriesFast()));
   }
+  if(fUse3ProngPairPrefilter) {
+    AliDebug(1,Form(" 3 prong pre-filter (total): %lld pairs skipped for single-track flags, %lld loops skipped for mass and pt;\n",
+		    fnPairsSkipped3ProngFlags,fnPairsSkipped3ProngKine));
+  }
 
 
   twoTrackArray1->Delete();  delete twoTrackArray1;
@@ -1539,6 +1845,8 @@ void AliAnalysisVertexingHF::FindCandidates(AliVEvent *event,
   fourTrackArray->Delete();  delete fourTrackArray;
   delete [] seleFlags; seleFlags=NULL;
   if(evtNumber) {delete [] evtNumber; evtNumber=NULL;}
+  fNTrksDCACache=0;
+  if(fWorkers) fWorkers->Clear();
   tracksAtVertex.Delete();
 
   if(fInputAOD) {
@@ -2930,6 +3238,7 @@ void AliAnalysisVertexingHF::PrintStatus() const {
     printf("Secondary vertex with Kalman filter package (AliKFParticle)\n");
   } else {
     printf("Secondary vertex with AliVertexerTracks\n");
+    if(fNWorkerThreads>1) printf("  fitted with %d worker threads\n",fNWorkerThreads);
   }
   if(fRecoPrimVtxSkippingTrks) printf("RecoPrimVtxSkippingTrks\n");
   if(fRmTrksFromPrimVtx) printf("RmTrksFromPrimVtx\n");
@@ -2983,28 +3292,11 @@ AliAODVertex* AliAnalysisVertexingHF::ReconstructSecondaryVertex(TObjArray *trkA
   /// Secondary vertex reconstruction with AliVertexerTracks or AliKFParticle
   //AliCodeTimerAuto("",0);
 
-  AliESDVertex *vertexESD = 0;
-  AliAODVertex *vertexAOD = 0;
+  Double_t pos[3],cov[6],chi2perNDF;
 
   if(!fSecVtxWithKF) { // AliVertexerTracks
 
-    fVertexerTracks->SetVtxStart(fV1);
-    vertexESD = (AliESDVertex*)fVertexerTracks->VertexForSelectedESDTracks(trkArray);
-
-    if(!vertexESD) return vertexAOD;
-
-    if(vertexESD->GetNContributors()!=trkArray->GetEntriesFast()) {
-      //AliDebug(2,"vertexing failed");
-      delete vertexESD; vertexESD=NULL;
-      return vertexAOD;
-    }
-
-    Double_t vertRadius2=vertexESD->GetX()*vertexESD->GetX()+vertexESD->GetY()*vertexESD->GetY();
-    if(vertRadius2>8.){
-      // vertex outside beam pipe, reject candidate to avoid propagation through material
-      delete vertexESD; vertexESD=NULL;
-      return vertexAOD;
-    }
+    if(!FitSecondaryVertex(fVertexerTracks,trkArray,pos,cov,chi2perNDF,dispersion)) return 0x0;
 
   } else { // Kalman Filter vertexer (AliKFParticle)
 
@@ -3018,25 +3310,253 @@ AliAODVertex* AliAnalysisVertexingHF::ReconstructSecondaryVertex(TObjArray *trkA
       AliKFParticle daughterKF(*esdTrack,211);
       vertexKF.AddDaughter(daughterKF);
     }
-    vertexESD = new AliESDVertex(vertexKF.Parameters(),
-				 vertexKF.CovarianceMatrix(),
-				 vertexKF.GetChi2(),
-				 vertexKF.GetNContributors());
+    AliESDVertex *vertexESD = new AliESDVertex(vertexKF.Parameters(),
+					       vertexKF.CovarianceMatrix(),
+					       vertexKF.GetChi2(),
+					       vertexKF.GetNContributors());
+
+    vertexESD->GetXYZ(pos); // position
+    vertexESD->GetCovMatrix(cov); //covariance matrix
+    chi2perNDF = vertexESD->GetChi2toNDF();
+    dispersion = vertexESD->GetDispersion();
+    delete vertexESD; vertexESD=NULL;
 
   }
 
   // convert to AliAODVertex
-  Double_t pos[3],cov[6],chi2perNDF;
+  Int_t nprongs= (useTRefArray ? 0 : trkArray->GetEntriesFast());
+  AliAODVertex *vertexAOD = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,nprongs);
+
+  return vertexAOD;
+}
+//-----------------------------------------------------------------------------
+Bool_t AliAnalysisVertexingHF::FitSecondaryVertex(AliVertexerTracks *vertexer,TObjArray *trkArray,
+						  Double_t *pos,Double_t *cov,Double_t &chi2perNDF,Double_t &dispersion) const
+{
+  /// Secondary vertex fit with AliVertexerTracks, kFALSE if the fit failed or
+  /// the vertex is rejected. Only touches the vertexer, so it can be called by
+  /// the worker threads with their own vertexer and tracks.
+
+  vertexer->SetVtxStart(fV1);
+  AliESDVertex *vertexESD = (AliESDVertex*)vertexer->VertexForSelectedESDTracks(trkArray);
+
+  if(!vertexESD) return kFALSE;
+
+  if(vertexESD->GetNContributors()!=trkArray->GetEntriesFast()) {
+    //AliDebug(2,"vertexing failed");
+    delete vertexESD; vertexESD=NULL;
+    return kFALSE;
+  }
+
+  Double_t vertRadius2=vertexESD->GetX()*vertexESD->GetX()+vertexESD->GetY()*vertexESD->GetY();
+  if(vertRadius2>8.){
+    // vertex outside beam pipe, reject candidate to avoid propagation through material
+    delete vertexESD; vertexESD=NULL;
+    return kFALSE;
+  }
+
   vertexESD->GetXYZ(pos); // position
   vertexESD->GetCovMatrix(cov); //covariance matrix
   chi2perNDF = vertexESD->GetChi2toNDF();
   dispersion = vertexESD->GetDispersion();
   delete vertexESD; vertexESD=NULL;
 
-  Int_t nprongs= (useTRefArray ? 0 : trkArray->GetEntriesFast());
-  vertexAOD = new AliAODVertex(pos,cov,chi2perNDF,0x0,-1,AliAODVertex::kUndef,nprongs);
+  return kTRUE;
+}
+//-----------------------------------------------------------------------------
+AliAODVertex* AliAnalysisVertexingHF::GetSecondaryVertex(TObjArray *trkArray,Double_t &dispersion,
+							 Int_t iTrkP1,Int_t iTrkN1,Int_t loop,Int_t iTrk3) const
+{
+  /// Secondary vertex of a track pair (loop 0) or triplet (loop 1: 2nd loop on
+  /// positive tracks, loop 2: 2nd loop on negative tracks) of FindCandidates:
+  /// the fit of the worker threads if they did it, else ReconstructSecondaryVertex
 
-  return vertexAOD;
+  const AliAnalysisVertexingHFVertexFit *fit = fWorkers ? fWorkers->Find(iTrkP1,iTrkN1,loop,iTrk3) : 0x0;
+  if(!fit) return ReconstructSecondaryVertex(trkArray,dispersion);
+  if(!fit->fOK) return 0x0;
+
+  dispersion = fit->fDispersion;
+  return new AliAODVertex(fit->fPos,fit->fCov,fit->fChi2perNDF,0x0,-1,AliAODVertex::kUndef,0);
+}
+//-----------------------------------------------------------------------------
+void AliAnalysisVertexingHF::FitSecondaryVertices(Int_t iTrkP1,const TObjArray &tracks,
+						  const UChar_t *seleFlags,const Int_t *evtNumber,
+						  Double_t dcaMax,Double_t maxMass3Prong,Double_t maxPt3ProngTrk,
+						  AliVertexerTracks *vertexer,AliAODRecoDecay *massCalc,
+						  std::vector<AliAnalysisVertexingHFVertexFit> &fits) const
+{
+  /// Fit the secondary vertices of the pairs and 3 prong triplets of the first
+  /// positive track iTrkP1, with the same track selection as the loops of
+  /// FindCandidates, in the order of the loops. Called by the worker threads:
+  /// uses only the given vertexer, mass calculator and track copies (at the
+  /// primary vertex) and does not change the data members.
+
+  Int_t nSeleTrks = tracks.GetEntriesFast();
+  Double_t xdummy,ydummy;
+  Double_t mompos1[3],mompos2[3],momneg1[3],momneg2[3];
+  Bool_t okDplus,okDs,okLc;
+  TObjArray trkArray(3);
+  AliAnalysisVertexingHFVertexFit fit;
+  memset(&fit,0,sizeof(fit));
+
+  if(!TESTBIT(seleFlags[iTrkP1],kBitDispl)) return;
+  AliESDtrack *postrack1 = (AliESDtrack*)tracks.UncheckedAt(iTrkP1);
+  if(postrack1->Charge()<0 && !fLikeSign) return;
+  postrack1->GetPxPyPz(mompos1);
+
+  for(Int_t iTrkN1=0; iTrkN1<nSeleTrks; iTrkN1++) {
+
+    if(iTrkN1==iTrkP1) continue;
+    AliESDtrack *negtrack1 = (AliESDtrack*)tracks.UncheckedAt(iTrkN1);
+    if(negtrack1->Charge()>0 && !fLikeSign) continue;
+    if(!TESTBIT(seleFlags[iTrkN1],kBitDispl)) continue;
+    if(fMixEvent && evtNumber[iTrkP1]==evtNumber[iTrkN1]) continue;
+
+    Bool_t isLikeSign2Prong=kFALSE;
+    if(postrack1->Charge()==negtrack1->Charge()) {
+      isLikeSign2Prong=kTRUE;
+      if(!fLikeSign || iTrkN1<iTrkP1) continue;
+    } else {
+      if(postrack1->Charge()<0 || negtrack1->Charge()>0) continue;
+    }
+    negtrack1->GetPxPyPz(momneg1);
+
+    Double_t dcap1n1 = postrack1->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+    if(dcap1n1>dcaMax) continue;
+
+    // pair
+    trkArray.Clear();
+    trkArray.AddAt(postrack1,0);
+    trkArray.AddAt(negtrack1,1);
+    fit.fTrkN1=iTrkN1; fit.fLoop=0; fit.fTrk3=-1;
+    fit.fOK=FitSecondaryVertex(vertexer,&trkArray,fit.fPos,fit.fCov,fit.fChi2perNDF,fit.fDispersion);
+    fits.push_back(fit);
+    if(!fit.fOK) continue;
+
+    if( (!f3Prong && !f4Prong) || (isLikeSign2Prong && !f3Prong) ) continue;
+    // the 2nd loops (also the one for the 4 prongs) need the 3 prong flags of the pair
+    if(!TESTBIT(seleFlags[iTrkP1],kBit3Prong) || !TESTBIT(seleFlags[iTrkN1],kBit3Prong)) continue;
+
+    // same pre-filter of the pair as in FindCandidates
+    Bool_t skipLoopP2=kFALSE,skipLoopN2=kFALSE;
+    if(fUse3ProngPairPrefilter) {
+      if(fUseKaonPIDfor3Prong) {
+	if(!TESTBIT(seleFlags[iTrkN1],kBitKaonCompat)) skipLoopP2=kTRUE;
+	if(!TESTBIT(seleFlags[iTrkP1],kBitKaonCompat)) skipLoopN2=kTRUE;
+      }
+      if(f3Prong && fMassCutBeforeVertexing) {
+	if(!skipLoopP2 && !f4Prong && !Pass3ProngPairPrefilter(mompos1,momneg1,maxMass3Prong,maxPt3ProngTrk)) skipLoopP2=kTRUE;
+	if(!skipLoopN2 && !Pass3ProngPairPrefilter(momneg1,mompos1,maxMass3Prong,maxPt3ProngTrk)) skipLoopN2=kTRUE;
+      }
+    }
+
+    // triplets of the 2nd loop on positive tracks (+-+, or +++), also used for the 4 prongs
+    if(!skipLoopP2)
+    for(Int_t iTrkP2=iTrkP1+1; iTrkP2<nSeleTrks; iTrkP2++) {
+
+      if(iTrkP2==iTrkN1) continue;
+      AliESDtrack *postrack2 = (AliESDtrack*)tracks.UncheckedAt(iTrkP2);
+      if(postrack2->Charge()<0) continue;
+      if(!TESTBIT(seleFlags[iTrkP2],kBitDispl)) continue;
+      if(!TESTBIT(seleFlags[iTrkP2],kBit3Prong)) continue;
+      if(fMixEvent && (evtNumber[iTrkP1]==evtNumber[iTrkP2] || evtNumber[iTrkN1]==evtNumber[iTrkP2])) continue;
+
+      Bool_t isLikeSign3Prong=kFALSE;
+      if(isLikeSign2Prong) {
+	if(!fLikeSign3prong || postrack1->Charge()<0) continue;
+	isLikeSign3Prong=kTRUE;
+      }
+      if(fUseKaonPIDfor3Prong && !TESTBIT(seleFlags[iTrkN1],kBitKaonCompat)) continue;
+
+      Int_t pidLcStatus=3;
+      if(fUsePIDforLc>0){
+	if(!TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) &&
+	   !TESTBIT(seleFlags[iTrkP2],kBitProtonCompat) ) pidLcStatus=0;
+	else if(fUsePIDforLc>1){
+	  pidLcStatus=0;
+	  if(TESTBIT(seleFlags[iTrkP1],kBitProtonCompat) &&
+	     TESTBIT(seleFlags[iTrkP2],kBitPionCompat) ) pidLcStatus+=1;
+	  if(TESTBIT(seleFlags[iTrkP2],kBitProtonCompat) &&
+	     TESTBIT(seleFlags[iTrkP1],kBitPionCompat) ) pidLcStatus+=2;
+	}
+      }
+
+      Double_t dcap2n1 = postrack2->GetDCA(negtrack1,fBzkG,xdummy,ydummy);
+      if(dcap2n1>dcaMax) continue;
+      Double_t dcap1p2 = postrack2->GetDCA(postrack1,fBzkG,xdummy,ydummy);
+      if(dcap1p2>dcaMax) continue;
+
+      Bool_t massCutOK=kTRUE;
+      if(f3Prong && fMassCutBeforeVertexing) {
+	postrack2->GetPxPyPz(mompos2);
+	Double_t pxDau[3]={mompos1[0],momneg1[0],mompos2[0]};
+	Double_t pyDau[3]={mompos1[1],momneg1[1],mompos2[1]};
+	Double_t pzDau[3]={mompos1[2],momneg1[2],mompos2[2]};
+	massCutOK = SelectInvMassAndPt3prong(massCalc,pxDau,pyDau,pzDau,pidLcStatus,okDplus,okDs,okLc);
+      }
+      Bool_t need3Prong = f3Prong && massCutOK;
+      Bool_t need4Prong = f4Prong && !isLikeSign2Prong && !isLikeSign3Prong &&
+	dcap1n1 < fCutsD0toKpipipi->GetDCACut() && dcap2n1 < fCutsD0toKpipipi->GetDCACut();
+      if(!need3Prong && !need4Prong) continue;
+
+      trkArray.Clear();
+      trkArray.AddAt(postrack1,0);
+      trkArray.AddAt(negtrack1,1);
+      trkArray.AddAt(postrack2,2);
+      fit.fTrkN1=iTrkN1; fit.fLoop=1; fit.fTrk3=iTrkP2;
+      fit.fOK=FitSecondaryVertex(vertexer,&trkArray,fit.fPos,fit.fCov,fit.fChi2perNDF,fit.fDispersion);
+      fits.push_back(fit);
+    }
+
+    // triplets of the 2nd loop on negative tracks (-+-, or ---)
+    if(!f3Prong || skipLoopN2) continue;
+    for(Int_t iTrkN2=iTrkN1+1; iTrkN2<nSeleTrks; iTrkN2++) {
+
+      if(iTrkN2==iTrkP1) continue;
+      AliESDtrack *negtrack2 = (AliESDtrack*)tracks.UncheckedAt(iTrkN2);
+      if(negtrack2->Charge()>0) continue;
+      if(!TESTBIT(seleFlags[iTrkN2],kBitDispl)) continue;
+      if(!TESTBIT(seleFlags[iTrkN2],kBit3Prong)) continue;
+      if(fMixEvent && (evtNumber[iTrkP1]==evtNumber[iTrkN2] || evtNumber[iTrkN1]==evtNumber[iTrkN2])) continue;
+
+      if(isLikeSign2Prong && (!fLikeSign3prong || postrack1->Charge()>0)) continue;
+      if(fUseKaonPIDfor3Prong && !TESTBIT(seleFlags[iTrkP1],kBitKaonCompat)) continue;
+
+      Int_t pidLcStatus=3;
+      if(fUsePIDforLc>0){
+	if(!TESTBIT(seleFlags[iTrkN1],kBitProtonCompat) &&
+	   !TESTBIT(seleFlags[iTrkN2],kBitProtonCompat) ) pidLcStatus=0;
+	else if(fUsePIDforLc>1){
+	  pidLcStatus=0;
+	  if(TESTBIT(seleFlags[iTrkN1],kBitProtonCompat) &&
+	     TESTBIT(seleFlags[iTrkN2],kBitPionCompat) ) pidLcStatus+=1;
+	  if(TESTBIT(seleFlags[iTrkN2],kBitProtonCompat) &&
+	     TESTBIT(seleFlags[iTrkN1],kBitPionCompat) ) pidLcStatus+=2;
+	}
+      }
+
+      Double_t dcap1n2 = postrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+      if(dcap1n2>dcaMax) continue;
+      Double_t dcan1n2 = negtrack1->GetDCA(negtrack2,fBzkG,xdummy,ydummy);
+      if(dcan1n2>dcaMax) continue;
+
+      if(fMassCutBeforeVertexing) {
+	negtrack2->GetPxPyPz(momneg2);
+	Double_t pxDau[3]={momneg1[0],mompos1[0],momneg2[0]};
+	Double_t pyDau[3]={momneg1[1],mompos1[1],momneg2[1]};
+	Double_t pzDau[3]={momneg1[2],mompos1[2],momneg2[2]};
+	if(!SelectInvMassAndPt3prong(massCalc,pxDau,pyDau,pzDau,pidLcStatus,okDplus,okDs,okLc)) continue;
+      }
+
+      trkArray.Clear();
+      trkArray.AddAt(negtrack1,0);
+      trkArray.AddAt(postrack1,1);
+      trkArray.AddAt(negtrack2,2);
+      fit.fTrkN1=iTrkN1; fit.fLoop=2; fit.fTrk3=iTrkN2;
+      fit.fOK=FitSecondaryVertex(vertexer,&trkArray,fit.fPos,fit.fCov,fit.fChi2perNDF,fit.fDispersion);
+      fits.push_back(fit);
+    }
+  }
 }
 //-----------------------------------------------------------------------------
 Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt3prong(TObjArray *trkArray){
@@ -3193,6 +3713,20 @@ Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt3prong(Double_t *px,
   /// Check invariant mass cut and pt candidate cut
   //AliCodeTimerAuto("",0);
 
+  return SelectInvMassAndPt3prong(fMassCalc3,px,py,pz,pidLcStatus,fOKInvMassDplus,fOKInvMassDs,fOKInvMassLc);
+}
+//-----------------------------------------------------------------------------
+Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt3prong(AliAODRecoDecay *massCalc,
+							Double_t *px,
+							Double_t *py,
+							Double_t *pz,
+							Int_t pidLcStatus,
+							Bool_t &okDplus,
+							Bool_t &okDs,
+							Bool_t &okLc) const {
+  /// Check invariant mass cut and pt candidate cut with the given mass
+  /// calculator, the result per species is returned in okDplus, okDs, okLc
+
   UInt_t pdg3[3];
   Int_t nprongs=3;
   Double_t minv2,mrange;
@@ -3200,12 +3734,12 @@ Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt3prong(Double_t *px,
   Bool_t retval=kFALSE;
 
 
-  fMassCalc3->SetPxPyPzProngs(nprongs,px,py,pz);
-  fOKInvMassDplus=kFALSE;
-  fOKInvMassDs=kFALSE;
-  fOKInvMassLc=kFALSE;
+  massCalc->SetPxPyPzProngs(nprongs,px,py,pz);
+  okDplus=kFALSE;
+  okDs=kFALSE;
+  okLc=kFALSE;
   // pt cut
-  Double_t ptcand=TMath::Sqrt(fMassCalc3->Pt2());
+  Double_t ptcand=TMath::Sqrt(massCalc->Pt2());
   if(fMinPt3Prong>0.1)
     if(ptcand < fMinPt3Prong) return retval;
   
@@ -3216,10 +3750,10 @@ Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt3prong(Double_t *px,
   lolim=fMassDplus-mrange;
   hilim=fMassDplus+mrange;
   pdg3[0]=211; pdg3[1]=321; pdg3[2]=211;
-  minv2 = fMassCalc3->InvMass2(nprongs,pdg3);
+  minv2 = massCalc->InvMass2(nprongs,pdg3);
   if(minv2>lolim*lolim && minv2<hilim*hilim ){
     retval=kTRUE;
-    fOKInvMassDplus=kTRUE;
+    okDplus=kTRUE;
   }
   
   // Ds+->KKpi
@@ -3232,21 +3766,21 @@ Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt3prong(Double_t *px,
   Double_t lolimphi=fMassPhi-mphirange;
   Double_t hilimphi=fMassPhi+mphirange;
   for(Int_t ih=0; ih<2; ih++){
-    if(fOKInvMassDs) break;
+    if(okDs) break;
     Int_t k=ih*2;
     pdg3[k]=321; pdg3[1]=321; pdg3[2-k]=211; 
-    minv2 = fMassCalc3->InvMass2(nprongs,pdg3);
+    minv2 = massCalc->InvMass2(nprongs,pdg3);
     if(minv2>lolim*lolim && minv2<hilim*hilim ){
       if(ptcand < 4){ // check KK mass for Ds with pt<4 GeV/c
 	Double_t ee = TMath::Sqrt(fMassK*fMassK+px[k]*px[k]+py[k]*py[k]+pz[k]*pz[k])+TMath::Sqrt(fMassK*fMassK+px[1]*px[1]+py[1]*py[1]+pz[1]*pz[1]);
 	Double_t mKK2=ee*ee-((px[k]+px[1])*(px[k]+px[1])+(py[k]+py[1])*(py[k]+py[1])+(pz[k]+pz[1])*(pz[k]+pz[1]));
 	if(mKK2>lolimphi*lolimphi && mKK2<hilimphi*hilimphi){
 	  retval=kTRUE;
-	  fOKInvMassDs=kTRUE;
+	  okDs=kTRUE;
 	}
       }else{
 	retval=kTRUE;
-	fOKInvMassDs=kTRUE;
+	okDs=kTRUE;
       }
     }
   }
@@ -3260,24 +3794,73 @@ Bool_t AliAnalysisVertexingHF::SelectInvMassAndPt3prong(Double_t *px,
     hilim=fMassLambdaC+mrange;
     if(pidLcStatus&1){
       pdg3[0]=2212; pdg3[1]=321; pdg3[2]=211;
-      minv2 = fMassCalc3->InvMass2(nprongs,pdg3);
+      minv2 = massCalc->InvMass2(nprongs,pdg3);
       if(minv2>lolim*lolim && minv2<hilim*hilim ){
 	retval=kTRUE;
-	fOKInvMassLc=kTRUE;
+	okLc=kTRUE;
       }
     }
-    if(pidLcStatus&2 && !fOKInvMassLc){
+    if(pidLcStatus&2 && !okLc){
       pdg3[0]=211; pdg3[1]=321; pdg3[2]=2212;
-      minv2 = fMassCalc3->InvMass2(nprongs,pdg3);
+      minv2 = massCalc->InvMass2(nprongs,pdg3);
       if(minv2>lolim*lolim && minv2<hilim*hilim ){
 	retval=kTRUE;
-	fOKInvMassLc=kTRUE;
+	okLc=kTRUE;
       }
     }
   }
   return retval;
 }
 
+//-----------------------------------------------------------------------------
+Double_t AliAnalysisVertexingHF::GetMaxMass3Prong() const {
+  /// Upper edge of the widest invariant mass window of SelectInvMassAndPt3prong
+  /// (D+, Ds and Lc), over all pt bins of the cuts
+
+  Double_t maxMass=0.;
+  Int_t nPtBins=TMath::Max(1,fCutsDplustoKpipi->GetNPtBins());
+  for(Int_t jPtBin=0; jPtBin<nPtBins; jPtBin++)
+    maxMass=TMath::Max(maxMass,fMassDplus+fCutsDplustoKpipi->GetMassCut(jPtBin));
+  nPtBins=TMath::Max(1,fCutsDstoKKpi->GetNPtBins());
+  for(Int_t jPtBin=0; jPtBin<nPtBins; jPtBin++)
+    maxMass=TMath::Max(maxMass,fMassDs+fCutsDstoKKpi->GetMassCut(jPtBin));
+  nPtBins=TMath::Max(1,fCutsLctopKpi->GetNPtBins());
+  for(Int_t jPtBin=0; jPtBin<nPtBins; jPtBin++)
+    maxMass=TMath::Max(maxMass,fMassLambdaC+fCutsLctopKpi->GetMassCut(jPtBin));
+  return maxMass;
+}
+//-----------------------------------------------------------------------------
+Bool_t AliAnalysisVertexingHF::Pass3ProngPairPrefilter(const Double_t *momPi,
+						       const Double_t *momK,
+						       Double_t maxMass3Prong,
+						       Double_t maxPtThird) const {
+  /// Check if a track pair can give a triplet passing SelectInvMassAndPt3prong
+  /// with any third track. momPi is the momentum of the first prong (pion, kaon
+  /// or proton: the pion is the lightest hypothesis), momK the one of the second
+  /// prong (always a kaon). The invariant mass of the triplet is at least the
+  /// pion-kaon mass of the pair plus the pion mass, and its pt is at most the pt
+  /// of the pair plus maxPtThird. A margin protects against rounding.
+
+  const Double_t margin=0.001; // GeV
+
+  Double_t px=momPi[0]+momK[0];
+  Double_t py=momPi[1]+momK[1];
+  Double_t pz=momPi[2]+momK[2];
+
+  if(fMinPt3Prong>0.1){
+    Double_t ptPair=TMath::Sqrt(px*px+py*py);
+    if(ptPair+maxPtThird < fMinPt3Prong-margin) return kFALSE;
+  }
+
+  Double_t ePi=TMath::Sqrt(fMassPi*fMassPi+momPi[0]*momPi[0]+momPi[1]*momPi[1]+momPi[2]*momPi[2]);
+  Double_t eK=TMath::Sqrt(fMassK*fMassK+momK[0]*momK[0]+momK[1]*momK[1]+momK[2]*momK[2]);
+  Double_t mPair2=(ePi+eK)*(ePi+eK)-(px*px+py*py+pz*pz);
+  Double_t minMass3Prong=TMath::Sqrt(TMath::Max(mPair2,0.))+fMassPi;
+  if(minMass3Prong > maxMass3Prong+margin) return kFALSE;
+
+  return kTRUE;
+}
+
 //-----------------------------------------------------------------------------
 Bool_t AliAnalysisVertexingHF::SelectInvMassAndPtDstarD0pi(Double_t *px,
 							   Double_t *py,
@@ -3775,6 +4358,21 @@ void AliAnalysisVertexingHF::SetParametersAtVertex(AliESDtrack* esdt, const AliE
   return;
 }
 //-----------------------------------------------------------------------------
+Double_t AliAnalysisVertexingHF::GetTrackPairDCA(AliESDtrack *trk1,Int_t iTrk1,AliESDtrack *trk2,Int_t iTrk2){
+  /// DCA of trk1 (selected track iTrk1) to trk2 (selected track iTrk2).
+  /// Both tracks must be at their parameters at the primary vertex, so that
+  /// the DCA of a given pair is the same in all combinations and is computed
+  /// only once per event if fUseTrackPairDCACache is set
+
+  Double_t xdummy,ydummy;
+  if(!fUseTrackPairDCACache || iTrk1>=fNTrksDCACache || iTrk2>=fNTrksDCACache)
+    return trk1->GetDCA(trk2,fBzkG,xdummy,ydummy);
+
+  Double_t &dca=fTrackPairDCA[(size_t)iTrk1*fNTrksDCACache+iTrk2];
+  if(dca<0.) dca=trk1->GetDCA(trk2,fBzkG,xdummy,ydummy);
+  return dca;
+}
+//-----------------------------------------------------------------------------
 void AliAnalysisVertexingHF::SetMasses(){
   /// Set the hadron mass values from TDatabasePDG
 
@@ -3786,6 +4384,7 @@ void AliAnalysisVertexingHF::SetMasses(){
   fMassJpsi=TDatabasePDG::Instance()->GetParticle(443)->Mass();
   fMassPhi=TDatabasePDG::Instance()->GetParticle(333)->Mass();
   fMassK=TDatabasePDG::Instance()->GetParticle(321)->Mass();
+  fMassPi=TDatabasePDG::Instance()->GetParticle(211)->Mass();
 }
 //-----------------------------------------------------------------------------
 Bool_t AliAnalysisVertexingHF::CheckCutsConsistency(){
@@ -15,6 +15,7 @@
 
 #include <TNamed.h>
 #include <TList.h>
+#include <vector>
 
 #include "AliAnalysisFilter.h"
 #include "AliESDtrackCuts.h"
@@ -45,6 +46,8 @@ class AliAODVertex;
 class AliVertexerTracks;
 class AliESDv0;
 class AliAODv0;
+class AliAnalysisVertexingHFWorkers;
+struct AliAnalysisVertexingHFVertexFit;
 
 //-----------------------------------------------------------------------------
 class AliAnalysisVertexingHF : public TNamed {
@@ -179,6 +182,20 @@ class AliAnalysisVertexingHF : public TNamed {
   void SetCutsDStartoKpipi(AliRDHFCutsDStartoKpipi* cuts) { fCutsDStartoKpipi = cuts; }
   AliRDHFCutsDStartoKpipi* GetCutsDStartoKpipi() const { return fCutsDStartoKpipi; }
   void SetMassCutBeforeVertexing(Bool_t flag) { fMassCutBeforeVertexing=flag; }
+  /// Compute the DCA of each pair of selected tracks only once per event.
+  /// Needs nSelectedTracks^2 doubles of memory, the candidates are unchanged.
+  void SetUseTrackPairDCACache(Bool_t flag) { fUseTrackPairDCACache=flag; }
+  /// Fit the secondary vertices of the track pairs and of the 3 prong triplets
+  /// with n worker threads (n<=1: no threads). The candidates are still created
+  /// in the loops, in the same order, and are identical to the ones without threads.
+  /// Not used with the KF vertexer.
+  void SetNWorkerThreads(Int_t n) { fNWorkerThreads=n; }
+  Int_t GetNWorkerThreads() const { return fNWorkerThreads; }
+  /// Skip the 3 prong loops for track pairs which cannot give a triplet passing
+  /// the single-track flags and (with SetMassCutBeforeVertexing) the mass and pt cuts
+  void SetUse3ProngPairPrefilter(Bool_t flag) { fUse3ProngPairPrefilter=flag; }
+  Long64_t GetNPairsSkipped3ProngFlags() const { return fnPairsSkipped3ProngFlags; }
+  Long64_t GetNPairsSkipped3ProngKine() const { return fnPairsSkipped3ProngKine; }
 
   void SetMasses();
   Bool_t CheckCutsConsistency();
@@ -249,6 +266,8 @@ class AliAnalysisVertexingHF : public TNamed {
   //
  private:
   //
+  friend class AliAnalysisVertexingHFWorkers;
+
   enum { kBitDispl = 0, kBitSoftPi = 1, kBit3Prong = 2, kBitPionCompat = 3, kBitKaonCompat = 4, kBitProtonCompat = 5, kBitBachelor = 6};
 
   Bool_t fInputAOD; /// input from AOD (kTRUE) or ESD (kFALSE)
@@ -328,6 +347,12 @@ class AliAnalysisVertexingHF : public TNamed {
   Bool_t fFindVertexForCascades;  /// reconstruct a secondary vertex or assume it's from the primary vertex
   Int_t  fV0TypeForCascadeVertex;  /// Select which V0 type we want to use for the cascas
   Bool_t fMassCutBeforeVertexing; /// to go faster in PbPb
+  Bool_t fUseTrackPairDCACache; /// cache the track-to-track DCAs within the event (to go faster in PbPb)
+  Int_t  fNTrksDCACache; //!<! number of selected tracks in the DCA cache
+  std::vector<Double_t> fTrackPairDCA; //!<! DCA of track i to track j at index i*fNTrksDCACache+j, negative if not yet computed
+  Bool_t fUse3ProngPairPrefilter; /// skip the 3 prong loops for pairs which cannot give a candidate (to go faster in PbPb)
+  Int_t  fNWorkerThreads; /// number of threads for the secondary vertex fits (to go faster in PbPb)
+  AliAnalysisVertexingHFWorkers *fWorkers; //!<! worker threads for the secondary vertex fits
   // dummies for invariant mass calculation
   AliAODRecoDecay *fMassCalc2; /// for 2 prong
   AliAODRecoDecay *fMassCalc3; /// for 3 prong
@@ -344,6 +369,8 @@ class AliAnalysisVertexingHF : public TNamed {
 
   Int_t  fnTrksTotal;
   Int_t  fnSeleTrksTotal;
+  Long64_t fnPairsSkipped3ProngFlags; /// pairs with 3 prong loops skipped because of the single-track flags
+  Long64_t fnPairsSkipped3ProngKine; /// 3 prong loops skipped because of the mass and pt bounds of the pair
   Bool_t fMakeReducedRHF;// switch the reduction of dAOD size on/off
 
   Double_t fMassDzero;
@@ -354,6 +381,7 @@ class AliAnalysisVertexingHF : public TNamed {
   Double_t fMassJpsi;
   Double_t fMassPhi;
   Double_t fMassK;
+  Double_t fMassPi;
 
   //
   void AddRefs(AliAODVertex *v,AliAODRecoDecayHF *rd,const AliVEvent *event,
@@ -401,8 +429,19 @@ class AliAnalysisVertexingHF : public TNamed {
   void MapAODtracks(AliVEvent *aod);
   AliAODVertex* PrimaryVertex(const TObjArray *trkArray=0x0,AliVEvent *event=0x0) const;
   AliAODVertex* ReconstructSecondaryVertex(TObjArray *trkArray,Double_t &dispersion,Bool_t useTRefArray=kTRUE) const;
+  Bool_t FitSecondaryVertex(AliVertexerTracks *vertexer,TObjArray *trkArray,
+			    Double_t *pos,Double_t *cov,Double_t &chi2perNDF,Double_t &dispersion) const;
+  AliAODVertex* GetSecondaryVertex(TObjArray *trkArray,Double_t &dispersion,
+				   Int_t iTrkP1,Int_t iTrkN1,Int_t loop,Int_t iTrk3) const;
+  void FitSecondaryVertices(Int_t iTrkP1,const TObjArray &tracks,
+			    const UChar_t *seleFlags,const Int_t *evtNumber,
+			    Double_t dcaMax,Double_t maxMass3Prong,Double_t maxPt3ProngTrk,
+			    AliVertexerTracks *vertexer,AliAODRecoDecay *massCalc,
+			    std::vector<AliAnalysisVertexingHFVertexFit> &fits) const;
 
   Bool_t SelectInvMassAndPt3prong(Double_t *px,Double_t *py,Double_t *pz, Int_t pidLcStatus=3);
+  Bool_t SelectInvMassAndPt3prong(AliAODRecoDecay *massCalc,Double_t *px,Double_t *py,Double_t *pz,Int_t pidLcStatus,
+				  Bool_t &okDplus,Bool_t &okDs,Bool_t &okLc) const;
   Bool_t SelectInvMassAndPt4prong(Double_t *px,Double_t *py,Double_t *pz);
   Bool_t SelectInvMassAndPtD0Kpi(Double_t *px,Double_t *py,Double_t *pz);
   Bool_t SelectInvMassAndPtJpsiee(Double_t *px,Double_t *py,Double_t *pz);
@@ -410,6 +449,8 @@ class AliAnalysisVertexingHF : public TNamed {
   Bool_t SelectInvMassAndPtCascade(Double_t *px,Double_t *py,Double_t *pz);
 
   Bool_t SelectInvMassAndPt3prong(TObjArray *trkArray);
+  Bool_t Pass3ProngPairPrefilter(const Double_t *momPi,const Double_t *momK,Double_t maxMass3Prong,Double_t maxPtThird) const;
+  Double_t GetMaxMass3Prong() const;
   Bool_t SelectInvMassAndPt4prong(TObjArray *trkArray);
   Bool_t SelectInvMassAndPtDstarD0pi(TObjArray *trkArray);
   Bool_t SelectInvMassAndPtCascade(TObjArray *trkArray);
@@ -420,6 +461,7 @@ class AliAnalysisVertexingHF : public TNamed {
 				   Int_t &nSeleTrks,
 				   UChar_t *seleFlags,Int_t *evtNumber);
   void SetParametersAtVertex(AliESDtrack* esdt, const AliExternalTrackParam* extpar) const;
+  Double_t GetTrackPairDCA(AliESDtrack *trk1,Int_t iTrk1,AliESDtrack *trk2,Int_t iTrk2);
 
   Bool_t SingleTrkCuts(AliESDtrack *trk,Float_t centralityperc, Bool_t &okDisplaced,Bool_t &okSoftPi, Bool_t &ok3prong, Bool_t &okBachelor) const;
 
@@ -429,7 +471,7 @@ class AliAnalysisVertexingHF : public TNamed {
 				  TObjArray *twoTrackArrayV0);
 
   /// \cond CLASSIMP
-  ClassDef(AliAnalysisVertexingHF,30);  // Reconstruction of HF decay candidates
+  ClassDef(AliAnalysisVertexingHF,33);  // Reconstruction of HF decay candidates
   /// \endcond
 };
 
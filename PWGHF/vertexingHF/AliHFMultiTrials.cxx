@@ -26,10 +26,40 @@
 #include "AliHFMassFitterVAR.h"
 #include "AliHFMultiTrials.h"
 
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
 /// \cond CLASSIMP
 ClassImp(AliHFMultiTrials);
 /// \endcond
 
+//_________________________________________________________________________
+static Bool_t WriteToPipe(Int_t fd, const Double_t* buf, size_t nBytes){
+  // write nBytes to the pipe, return kFALSE on error
+  const char* p=reinterpret_cast<const char*>(buf);
+  while(nBytes>0){
+    ssize_t n=write(fd,p,nBytes);
+    if(n<=0) return kFALSE;
+    p+=n;
+    nBytes-=n;
+  }
+  return kTRUE;
+}
+
+//_________________________________________________________________________
+static Bool_t ReadFromPipe(Int_t fd, Double_t* buf, size_t nBytes){
+  // read nBytes from the pipe, return kFALSE on error or end of file
+  char* p=reinterpret_cast<char*>(buf);
+  while(nBytes>0){
+    ssize_t n=read(fd,p,nBytes);
+    if(n<=0) return kFALSE;
+    p+=n;
+    nBytes-=n;
+  }
+  return kTRUE;
+}
+
 
 //_________________________________________________________________________
 AliHFMultiTrials::AliHFMultiTrials() : 
@@ -65,6 +95,7 @@ AliHFMultiTrials::AliHFMultiTrials() :
   fUseFixSigFixMean(kTRUE),
   fSaveBkgVal(kFALSE),
   fDrawIndividualFits(kFALSE),
+  fNumOfProcesses(1),
   fHistoRawYieldDistAll(0x0),
   fHistoRawYieldTrialAll(0x0),
   fHistoSigmaTrialAll(0x0),
@@ -193,8 +224,6 @@ Bool_t AliHFMultiTrials::DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad){
   Bool_t hOK=CreateHistos();
   if(!hOK) return kFALSE;
 
-  Int_t itrial=0;
-  Int_t types=0;
   Int_t itrialBC=0;
   Int_t totTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps;
 
@@ -202,18 +231,24 @@ Bool_t AliHFMultiTrials::DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad){
   fMaxYieldGlob=0.;
   Float_t xnt[15];
 
+  // rebinned histograms, shared by all the fits with the same (rebin, first bin)
+  std::vector<TH1F*> hRebinned(fNumOfRebinSteps*fNumOfFirstBinSteps,0x0);
   for(Int_t ir=0; ir<fNumOfRebinSteps; ir++){
     Int_t rebin=fRebinSteps[ir];
     for(Int_t iFirstBin=1; iFirstBin<=fNumOfFirstBinSteps; iFirstBin++) {
-      TH1F* hRebinned=0x0;
-      if(fNumOfFirstBinSteps==1) hRebinned=RebinHisto(hInvMassHisto,rebin,-1);
-      else hRebinned=RebinHisto(hInvMassHisto,rebin,iFirstBin);
+      Int_t iHisto=ir*fNumOfFirstBinSteps+iFirstBin-1;
+      if(fNumOfFirstBinSteps==1) hRebinned[iHisto]=RebinHisto(hInvMassHisto,rebin,-1);
+      else hRebinned[iHisto]=RebinHisto(hInvMassHisto,rebin,iFirstBin);
+    }
+  }
+
+  // list of the fits, in the order in which they are stored in the output
+  std::vector<MultiTrialFit_t> fits;
+  Int_t itrial=0;
+  for(Int_t ir=0; ir<fNumOfRebinSteps; ir++){
+    for(Int_t iFirstBin=1; iFirstBin<=fNumOfFirstBinSteps; iFirstBin++) {
       for(Int_t iMinMass=0; iMinMass<fNumOfLowLimFitSteps; iMinMass++){
-        Double_t minMassForFit=fLowLimFitSteps[iMinMass];
-        Double_t hmin=TMath::Max(minMassForFit,hRebinned->GetBinLowEdge(2));
         for(Int_t iMaxMass=0; iMaxMass<fNumOfUpLimFitSteps; iMaxMass++){
-          Double_t maxMassForFit=fUpLimFitSteps[iMaxMass];
-          Double_t hmax=TMath::Min(maxMassForFit,hRebinned->GetBinLowEdge(hRebinned->GetNbinsX()));
           ++itrial;
           for(Int_t typeb=0; typeb<kNBkgFuncCases; typeb++){
             if(typeb==kExpoBkg && !fUseExpoBkg) continue;
@@ -231,219 +266,375 @@ Bool_t AliHFMultiTrials::DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad){
               if (igs==kFreeSigFreeMean  && !fUseFreeS) continue;
               if (igs==kFixSigFreeMean  && !fUseFixSigFreeMean) continue;
               if (igs==kFixSigFixMean   && !fUseFixSigFixMean) continue;
-              Int_t theCase=igs*kNBkgFuncCases+typeb;
-              Int_t globBin=itrial+theCase*totTrials;
-              for(Int_t j=0; j<15; j++) xnt[j]=0.;
-
-              Bool_t mustDeleteFitter = kTRUE;
-              AliHFMassFitterVAR*  fitter=0x0;
-              //if D0 Reflection
-              if(fhTemplRefl){
-                fitter=new AliHFMassFitterVAR(hRebinned,hmin,hmax,1,typeb,2);
-                fitter->SetTemplateReflections(fhTemplRefl);
-                fitter->SetFixReflOverS(fFixRefloS,kTRUE);
-              }
-              else {
-                if(typeb<=kPol2Bkg){
-                  fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,typeb,types);
-                }else if(typeb==kPowBkg){
-                  fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,4,types);
-                }else if(typeb==kPowTimesExpoBkg){
-                  fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,5,types);
-                }else{
-                  fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,6,types);
-                  if(typeb==kPol3Bkg) fitter->SetBackHighPolDegree(3);
-                  if(typeb==kPol4Bkg) fitter->SetBackHighPolDegree(4);
-                  if(typeb==kPol5Bkg) fitter->SetBackHighPolDegree(5);
-                }
-                fitter->SetReflectionSigmaFactor(0);
-              }
-              if(fFitOption==0) {
-                fitter->SetUseLikelihoodFit();
-                Printf("Using likelihood fit");
-              }
-              else if(fFitOption==1) {
-                fitter->SetUseChi2Fit();
-                Printf("Using chi2 fit");
-              }
-              else if (fFitOption==2) {
-                fitter->SetUseLikelihoodWithWeightsFit();
-                Printf("Using likelihood fit with weights");
-              }
-              fitter->SetInitialGaussianMean(fMassD);
-              fitter->SetInitialGaussianSigma(fSigmaGausMC);
-              xnt[0]=rebin;
-              xnt[1]=iFirstBin;
-              xnt[2]=minMassForFit;
-              xnt[3]=maxMassForFit;
-              xnt[4]=typeb;
-              xnt[6]=0;
-              if(igs==kFixSigFreeMean){
-                fitter->SetFixGaussianSigma(fSigmaGausMC,kTRUE);
-                xnt[5]=1;
-              }else if(igs==kFixSigUpFreeMean){
-                fitter->SetFixGaussianSigma(fSigmaGausMC*(1.+fSigmaMCVariation),kTRUE);
-                xnt[5]=2;
-              }else if(igs==kFixSigDownFreeMean){
-                fitter->SetFixGaussianSigma(fSigmaGausMC*(1.-fSigmaMCVariation),kTRUE);
-                xnt[5]=3;
-              }else if(igs==kFreeSigFreeMean){
-                xnt[5]=0;
-              }else if(igs==kFixSigFixMean){
-                fitter->SetFixGaussianSigma(fSigmaGausMC,kTRUE);
-                fitter->SetFixGaussianMean(fMassD,kTRUE);
-                xnt[5]=1;
-                xnt[6]=1;
-              }else if(igs==kFreeSigFixMean){
-                fitter->SetFixGaussianMean(fMassD,kTRUE);
-                xnt[5]=0;
-                xnt[6]=1;
-              }
-              Bool_t out=kFALSE;
-              Double_t chisq=-1.;
-              Double_t sigma=0.;
-              Double_t esigma=0.;
-              Double_t pos=.0;
-              Double_t epos=.0;
-              Double_t ry=.0;
-              Double_t ery=.0;
-              Double_t significance=0.;
-              Double_t erSignif=0.;
-              Double_t bkg=0.;
-              Double_t erbkg=0.;
-              Double_t bkgBEdge=0;
-              Double_t erbkgBEdge=0;
-              TF1* fB1=0x0;
-              if(typeb<kNBkgFuncCases){
-                printf("****** START FIT OF HISTO %s WITH REBIN %d FIRST BIN %d MASS RANGE %f-%f BACKGROUND FIT FUNCTION=%d CONFIG SIGMA/MEAN=%d\n",hInvMassHisto->GetName(),rebin,iFirstBin,minMassForFit,maxMassForFit,typeb,igs);
-                out=fitter->MassFitter(0);
-                chisq=fitter->GetReducedChiSquare();
-                fitter->Significance(fnSigmaForBkgEval,significance,erSignif);
-                sigma=fitter->GetSigma();
-                pos=fitter->GetMean();
-                esigma=fitter->GetSigmaUncertainty();
-                if(esigma<0.00001) esigma=0.0001;
-                epos=fitter->GetMeanUncertainty();
-                if(epos<0.00001) epos=0.0001;
-                ry=fitter->GetRawYield();
-                ery=fitter->GetRawYieldError();
-                fB1=fitter->GetBackgroundFullRangeFunc();
-                fitter->Background(fnSigmaForBkgEval,bkg,erbkg);
-                Double_t minval = hInvMassHisto->GetXaxis()->GetBinLowEdge(hInvMassHisto->FindBin(pos-fnSigmaForBkgEval*sigma));
-                Double_t maxval = hInvMassHisto->GetXaxis()->GetBinUpEdge(hInvMassHisto->FindBin(pos+fnSigmaForBkgEval*sigma));
-                fitter->Background(minval,maxval,bkgBEdge,erbkgBEdge);
-                if(out && fDrawIndividualFits && thePad){
-                  thePad->Clear();
-                  fitter->DrawHere(thePad, fnSigmaForBkgEval);
-                  fMassFitters.push_back(fitter);
-                  mustDeleteFitter = kFALSE;
-                  for (auto format : fInvMassFitSaveAsFormats) {
-                    thePad->SaveAs(Form("FitOutput_%s_Trial%d.%s",hInvMassHisto->GetName(),globBin, format.c_str()));
-                  }
-                }
-              }
-              // else{
-              //   out=DoFitWithPol3Bkg(hRebinned,hmin,hmax,igs);
-              //   if(out && thePad){
-              // 	thePad->Clear();
-              // 	hRebinned->Draw();
-              // 	TF1* fSB=(TF1*)hRebinned->GetListOfFunctions()->FindObject("fSB");
-              // 	fB1=new TF1("fB1","[0]+[1]*x+[2]*x*x+[3]*x*x*x",hmin,hmax);
-              // 	for(Int_t j=0; j<4; j++) fB1->SetParameter(j,fSB->GetParameter(3+j));
-              // 	fB1->SetLineColor(2);
-              // 	fB1->Draw("same");
-              // 	fSB->SetLineColor(4);
-              // 	fSB->Draw("same");
-              // 	thePad->Update();
-              // 	chisq=fSB->GetChisquare()/fSB->GetNDF();;
-              // 	sigma=fSB->GetParameter(2);
-              // 	esigma=fSB->GetParError(2);
-              // 	if(esigma<0.00001) esigma=0.0001;
-              // 	pos=fSB->GetParameter(1);
-              // 	epos=fSB->GetParError(1);
-              // 	if(epos<0.00001) epos=0.0001;
-              // 	ry=fSB->GetParameter(0)/hRebinned->GetBinWidth(1);
-              // 	ery=fSB->GetParError(0)/hRebinned->GetBinWidth(1);
-              //   }
-              // }
-              xnt[7]=chisq;
-              if(out && chisq>0. && sigma>0.5*fSigmaGausMC && sigma<2.0*fSigmaGausMC){
-                xnt[8]=significance;
-                xnt[9]=pos;
-                xnt[10]=epos;
-                xnt[11]=sigma;
-                xnt[12]=esigma;
-                xnt[13]=ry;
-                xnt[14]=ery;
-                fHistoRawYieldDistAll->Fill(ry);
-                fHistoRawYieldTrialAll->SetBinContent(globBin,ry);
-                fHistoRawYieldTrialAll->SetBinError(globBin,ery);
-                fHistoSigmaTrialAll->SetBinContent(globBin,sigma);
-                fHistoSigmaTrialAll->SetBinError(globBin,esigma);
-                fHistoMeanTrialAll->SetBinContent(globBin,pos);
-                fHistoMeanTrialAll->SetBinError(globBin,epos);
-                fHistoChi2TrialAll->SetBinContent(globBin,chisq);
-                fHistoChi2TrialAll->SetBinError(globBin,0.00001);
-                fHistoSignifTrialAll->SetBinContent(globBin,significance);
-                fHistoSignifTrialAll->SetBinError(globBin,erSignif);
-                if(fSaveBkgVal) {
-                  fHistoBkgTrialAll->SetBinContent(globBin,bkg);
-                  fHistoBkgTrialAll->SetBinError(globBin,erbkg);
-                  fHistoBkgInBinEdgesTrialAll->SetBinContent(globBin,bkgBEdge);
-                  fHistoBkgInBinEdgesTrialAll->SetBinError(globBin,erbkgBEdge);
-                }
-
-                if(ry<fMinYieldGlob) fMinYieldGlob=ry;
-                if(ry>fMaxYieldGlob) fMaxYieldGlob=ry;
-                fHistoRawYieldDist[theCase]->Fill(ry);
-                fHistoRawYieldTrial[theCase]->SetBinContent(itrial,ry);
-                fHistoRawYieldTrial[theCase]->SetBinError(itrial,ery);
-                fHistoSigmaTrial[theCase]->SetBinContent(itrial,sigma);
-                fHistoSigmaTrial[theCase]->SetBinError(itrial,esigma);
-                fHistoMeanTrial[theCase]->SetBinContent(itrial,pos);
-                fHistoMeanTrial[theCase]->SetBinError(itrial,epos);
-                fHistoChi2Trial[theCase]->SetBinContent(itrial,chisq);
-                fHistoChi2Trial[theCase]->SetBinError(itrial,0.00001);
-                fHistoSignifTrial[theCase]->SetBinContent(itrial,significance);
-                fHistoSignifTrial[theCase]->SetBinError(itrial,erSignif);
-                if(fSaveBkgVal) {
-                  fHistoBkgTrial[theCase]->SetBinContent(itrial,bkg);
-                  fHistoBkgTrial[theCase]->SetBinError(itrial,erbkg);
-                  fHistoBkgInBinEdgesTrial[theCase]->SetBinContent(itrial,bkgBEdge);
-                  fHistoBkgInBinEdgesTrial[theCase]->SetBinError(itrial,erbkgBEdge);
-                }
-
-                for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
-                  Double_t minMassBC=fMassD-fnSigmaBinCSteps[iStepBC]*sigma;
-                  Double_t maxMassBC=fMassD+fnSigmaBinCSteps[iStepBC]*sigma;
-                  if(minMassBC>minMassForFit &&
-                      maxMassBC<maxMassForFit &&
-                      minMassBC>(hRebinned->GetXaxis()->GetXmin()) &&
-                      maxMassBC<(hRebinned->GetXaxis()->GetXmax())){
-                    Double_t cnts,ecnts;
-                    BinCount(hRebinned,fB1,1,minMassBC,maxMassBC,cnts,ecnts);
-                    ++itrialBC;
-                    fHistoRawYieldDistBinCAll->Fill(cnts);
-                    fHistoRawYieldTrialBinCAll->SetBinContent(globBin,iStepBC+1,cnts);
-                    fHistoRawYieldTrialBinCAll->SetBinError(globBin,iStepBC+1,ecnts);
-                    fHistoRawYieldTrialBinC[theCase]->SetBinContent(itrial,iStepBC+1,cnts);
-                    fHistoRawYieldTrialBinC[theCase]->SetBinError(itrial,iStepBC+1,ecnts);
-                    fHistoRawYieldDistBinC[theCase]->Fill(cnts);
-                  }
-                }
-              }
-              if (mustDeleteFitter) delete fitter;
-              fNtupleMultiTrials->Fill(xnt);
+              MultiTrialFit_t fit;
+              fit.fIRebin=ir;
+              fit.fFirstBin=iFirstBin;
+              fit.fIMinMass=iMinMass;
+              fit.fIMaxMass=iMaxMass;
+              fit.fBkgFunc=typeb;
+              fit.fFitConf=igs;
+              fit.fTrial=itrial;
+              fits.push_back(fit);
             }
           }
         }
       }
-      delete hRebinned;
     }
   }
+
+  // do the fits
+  Int_t nFits=fits.size();
+  Int_t nValues=kNFitValues+3*fNumOfnSigmaBinCSteps;
+  std::vector<Double_t> values(nFits*nValues,0.);
+  Bool_t drawFits=(fDrawIndividualFits && thePad);
+  if(fNumOfProcesses>1 && drawFits) Printf("AliHFMultiTrials: individual fits are drawn, all fits are done in this process");
+  if(fNumOfProcesses>1 && !drawFits){
+    DoFitsInProcesses(fits,hInvMassHisto,hRebinned,values,nValues);
+  }else{
+    for(Int_t ifit=0; ifit<nFits; ifit++){
+      const MultiTrialFit_t& fit=fits[ifit];
+      DoFit(fit,hInvMassHisto,hRebinned[fit.fIRebin*fNumOfFirstBinSteps+fit.fFirstBin-1],thePad,&values[ifit*nValues]);
+    }
+  }
+
+  // fill the output, in the order of the fits
+  for(Int_t ifit=0; ifit<nFits; ifit++){
+    const MultiTrialFit_t& fit=fits[ifit];
+    const Double_t* val=&values[ifit*nValues];
+    Int_t typeb=fit.fBkgFunc;
+    Int_t igs=fit.fFitConf;
+    itrial=fit.fTrial;
+    Int_t theCase=igs*kNBkgFuncCases+typeb;
+    Int_t globBin=itrial+theCase*totTrials;
+    for(Int_t j=0; j<15; j++) xnt[j]=0.;
+    xnt[0]=fRebinSteps[fit.fIRebin];
+    xnt[1]=fit.fFirstBin;
+    xnt[2]=fLowLimFitSteps[fit.fIMinMass];
+    xnt[3]=fUpLimFitSteps[fit.fIMaxMass];
+    xnt[4]=typeb;
+    xnt[6]=0;
+    if(igs==kFixSigFreeMean){
+      xnt[5]=1;
+    }else if(igs==kFixSigUpFreeMean){
+      xnt[5]=2;
+    }else if(igs==kFixSigDownFreeMean){
+      xnt[5]=3;
+    }else if(igs==kFreeSigFreeMean){
+      xnt[5]=0;
+    }else if(igs==kFixSigFixMean){
+      xnt[5]=1;
+      xnt[6]=1;
+    }else if(igs==kFreeSigFixMean){
+      xnt[5]=0;
+      xnt[6]=1;
+    }
+    Double_t chisq=val[kFitChi2];
+    Double_t sigma=val[kFitSigma];
+    Double_t esigma=val[kFitErrSigma];
+    Double_t pos=val[kFitMean];
+    Double_t epos=val[kFitErrMean];
+    Double_t ry=val[kFitRawYield];
+    Double_t ery=val[kFitErrRawYield];
+    Double_t significance=val[kFitSignif];
+    Double_t erSignif=val[kFitErrSignif];
+    Double_t bkg=val[kFitBkg];
+    Double_t erbkg=val[kFitErrBkg];
+    Double_t bkgBEdge=val[kFitBkgBinEdges];
+    Double_t erbkgBEdge=val[kFitErrBkgBinEdges];
+    xnt[7]=chisq;
+    if(val[kFitOK]>0.5){
+      xnt[8]=significance;
+      xnt[9]=pos;
+      xnt[10]=epos;
+      xnt[11]=sigma;
+      xnt[12]=esigma;
+      xnt[13]=ry;
+      xnt[14]=ery;
+      fHistoRawYieldDistAll->Fill(ry);
+      fHistoRawYieldTrialAll->SetBinContent(globBin,ry);
+      fHistoRawYieldTrialAll->SetBinError(globBin,ery);
+      fHistoSigmaTrialAll->SetBinContent(globBin,sigma);
+      fHistoSigmaTrialAll->SetBinError(globBin,esigma);
+      fHistoMeanTrialAll->SetBinContent(globBin,pos);
+      fHistoMeanTrialAll->SetBinError(globBin,epos);
+      fHistoChi2TrialAll->SetBinContent(globBin,chisq);
+      fHistoChi2TrialAll->SetBinError(globBin,0.00001);
+      fHistoSignifTrialAll->SetBinContent(globBin,significance);
+      fHistoSignifTrialAll->SetBinError(globBin,erSignif);
+      if(fSaveBkgVal) {
+        fHistoBkgTrialAll->SetBinContent(globBin,bkg);
+        fHistoBkgTrialAll->SetBinError(globBin,erbkg);
+        fHistoBkgInBinEdgesTrialAll->SetBinContent(globBin,bkgBEdge);
+        fHistoBkgInBinEdgesTrialAll->SetBinError(globBin,erbkgBEdge);
+      }
+
+      if(ry<fMinYieldGlob) fMinYieldGlob=ry;
+      if(ry>fMaxYieldGlob) fMaxYieldGlob=ry;
+      fHistoRawYieldDist[theCase]->Fill(ry);
+      fHistoRawYieldTrial[theCase]->SetBinContent(itrial,ry);
+      fHistoRawYieldTrial[theCase]->SetBinError(itrial,ery);
+      fHistoSigmaTrial[theCase]->SetBinContent(itrial,sigma);
+      fHistoSigmaTrial[theCase]->SetBinError(itrial,esigma);
+      fHistoMeanTrial[theCase]->SetBinContent(itrial,pos);
+      fHistoMeanTrial[theCase]->SetBinError(itrial,epos);
+      fHistoChi2Trial[theCase]->SetBinContent(itrial,chisq);
+      fHistoChi2Trial[theCase]->SetBinError(itrial,0.00001);
+      fHistoSignifTrial[theCase]->SetBinContent(itrial,significance);
+      fHistoSignifTrial[theCase]->SetBinError(itrial,erSignif);
+      if(fSaveBkgVal) {
+        fHistoBkgTrial[theCase]->SetBinContent(itrial,bkg);
+        fHistoBkgTrial[theCase]->SetBinError(itrial,erbkg);
+        fHistoBkgInBinEdgesTrial[theCase]->SetBinContent(itrial,bkgBEdge);
+        fHistoBkgInBinEdgesTrial[theCase]->SetBinError(itrial,erbkgBEdge);
+      }
+
+      for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
+        const Double_t* valBC=&val[kNFitValues+3*iStepBC];
+        if(valBC[0]>0.5){
+          Double_t cnts=valBC[1];
+          Double_t ecnts=valBC[2];
+          ++itrialBC;
+          fHistoRawYieldDistBinCAll->Fill(cnts);
+          fHistoRawYieldTrialBinCAll->SetBinContent(globBin,iStepBC+1,cnts);
+          fHistoRawYieldTrialBinCAll->SetBinError(globBin,iStepBC+1,ecnts);
+          fHistoRawYieldTrialBinC[theCase]->SetBinContent(itrial,iStepBC+1,cnts);
+          fHistoRawYieldTrialBinC[theCase]->SetBinError(itrial,iStepBC+1,ecnts);
+          fHistoRawYieldDistBinC[theCase]->Fill(cnts);
+        }
+      }
+    }
+    fNtupleMultiTrials->Fill(xnt);
+  }
+  for(UInt_t iHisto=0; iHisto<hRebinned.size(); iHisto++) delete hRebinned[iHisto];
   return kTRUE;
 }
 
+//________________________________________________________________________
+void AliHFMultiTrials::DoFit(const MultiTrialFit_t& fit, TH1D* hInvMassHisto, TH1F* hRebinned, TPad* thePad, Double_t* values){
+  // perform one fit of the grid and store the results in values (layout given by EFitValues)
+  // the fitter is drawn and kept in fMassFitters if thePad is given and fDrawIndividualFits is set
+
+  for(Int_t j=0; j<kNFitValues+3*fNumOfnSigmaBinCSteps; j++) values[j]=0.;
+
+  Int_t types=0;
+  Int_t totTrials=fNumOfRebinSteps*fNumOfFirstBinSteps*fNumOfLowLimFitSteps*fNumOfUpLimFitSteps;
+  Int_t rebin=fRebinSteps[fit.fIRebin];
+  Int_t iFirstBin=fit.fFirstBin;
+  Double_t minMassForFit=fLowLimFitSteps[fit.fIMinMass];
+  Double_t hmin=TMath::Max(minMassForFit,hRebinned->GetBinLowEdge(2));
+  Double_t maxMassForFit=fUpLimFitSteps[fit.fIMaxMass];
+  Double_t hmax=TMath::Min(maxMassForFit,hRebinned->GetBinLowEdge(hRebinned->GetNbinsX()));
+  Int_t typeb=fit.fBkgFunc;
+  Int_t igs=fit.fFitConf;
+  Int_t theCase=igs*kNBkgFuncCases+typeb;
+  Int_t globBin=fit.fTrial+theCase*totTrials;
+
+  Bool_t mustDeleteFitter = kTRUE;
+  AliHFMassFitterVAR*  fitter=0x0;
+  //if D0 Reflection
+  if(fhTemplRefl){
+    fitter=new AliHFMassFitterVAR(hRebinned,hmin,hmax,1,typeb,2);
+    fitter->SetTemplateReflections(fhTemplRefl);
+    fitter->SetFixReflOverS(fFixRefloS,kTRUE);
+  }
+  else {
+    if(typeb<=kPol2Bkg){
+      fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,typeb,types);
+    }else if(typeb==kPowBkg){
+      fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,4,types);
+    }else if(typeb==kPowTimesExpoBkg){
+      fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,5,types);
+    }else{
+      fitter=new AliHFMassFitterVAR(hRebinned,hmin, hmax,1,6,types);
+      if(typeb==kPol3Bkg) fitter->SetBackHighPolDegree(3);
+      if(typeb==kPol4Bkg) fitter->SetBackHighPolDegree(4);
+      if(typeb==kPol5Bkg) fitter->SetBackHighPolDegree(5);
+    }
+    fitter->SetReflectionSigmaFactor(0);
+  }
+  if(fFitOption==0) {
+    fitter->SetUseLikelihoodFit();
+    Printf("Using likelihood fit");
+  }
+  else if(fFitOption==1) {
+    fitter->SetUseChi2Fit();
+    Printf("Using chi2 fit");
+  }
+  else if (fFitOption==2) {
+    fitter->SetUseLikelihoodWithWeightsFit();
+    Printf("Using likelihood fit with weights");
+  }
+  fitter->SetInitialGaussianMean(fMassD);
+  fitter->SetInitialGaussianSigma(fSigmaGausMC);
+  if(igs==kFixSigFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC,kTRUE);
+  }else if(igs==kFixSigUpFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC*(1.+fSigmaMCVariation),kTRUE);
+  }else if(igs==kFixSigDownFreeMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC*(1.-fSigmaMCVariation),kTRUE);
+  }else if(igs==kFixSigFixMean){
+    fitter->SetFixGaussianSigma(fSigmaGausMC,kTRUE);
+    fitter->SetFixGaussianMean(fMassD,kTRUE);
+  }else if(igs==kFreeSigFixMean){
+    fitter->SetFixGaussianMean(fMassD,kTRUE);
+  }
+  Bool_t out=kFALSE;
+  Double_t chisq=-1.;
+  Double_t sigma=0.;
+  Double_t esigma=0.;
+  Double_t pos=.0;
+  Double_t epos=.0;
+  Double_t ry=.0;
+  Double_t ery=.0;
+  Double_t significance=0.;
+  Double_t erSignif=0.;
+  Double_t bkg=0.;
+  Double_t erbkg=0.;
+  Double_t bkgBEdge=0;
+  Double_t erbkgBEdge=0;
+  TF1* fB1=0x0;
+  if(typeb<kNBkgFuncCases){
+    printf("****** START FIT OF HISTO %s WITH REBIN %d FIRST BIN %d MASS RANGE %f-%f BACKGROUND FIT FUNCTION=%d CONFIG SIGMA/MEAN=%d\n",hInvMassHisto->GetName(),rebin,iFirstBin,minMassForFit,maxMassForFit,typeb,igs);
+    out=fitter->MassFitter(0);
+    chisq=fitter->GetReducedChiSquare();
+    fitter->Significance(fnSigmaForBkgEval,significance,erSignif);
+    sigma=fitter->GetSigma();
+    pos=fitter->GetMean();
+    esigma=fitter->GetSigmaUncertainty();
+    if(esigma<0.00001) esigma=0.0001;
+    epos=fitter->GetMeanUncertainty();
+    if(epos<0.00001) epos=0.0001;
+    ry=fitter->GetRawYield();
+    ery=fitter->GetRawYieldError();
+    fB1=fitter->GetBackgroundFullRangeFunc();
+    fitter->Background(fnSigmaForBkgEval,bkg,erbkg);
+    Double_t minval = hInvMassHisto->GetXaxis()->GetBinLowEdge(hInvMassHisto->FindBin(pos-fnSigmaForBkgEval*sigma));
+    Double_t maxval = hInvMassHisto->GetXaxis()->GetBinUpEdge(hInvMassHisto->FindBin(pos+fnSigmaForBkgEval*sigma));
+    fitter->Background(minval,maxval,bkgBEdge,erbkgBEdge);
+    if(out && fDrawIndividualFits && thePad){
+      thePad->Clear();
+      fitter->DrawHere(thePad, fnSigmaForBkgEval);
+      fMassFitters.push_back(fitter);
+      mustDeleteFitter = kFALSE;
+      for (auto format : fInvMassFitSaveAsFormats) {
+        thePad->SaveAs(Form("FitOutput_%s_Trial%d.%s",hInvMassHisto->GetName(),globBin, format.c_str()));
+      }
+    }
+  }
+  // else{
+  //   out=DoFitWithPol3Bkg(hRebinned,hmin,hmax,igs);
+  //   if(out && thePad){
+  // 	thePad->Clear();
+  // 	hRebinned->Draw();
+  // 	TF1* fSB=(TF1*)hRebinned->GetListOfFunctions()->FindObject("fSB");
+  // 	fB1=new TF1("fB1","[0]+[1]*x+[2]*x*x+[3]*x*x*x",hmin,hmax);
+  // 	for(Int_t j=0; j<4; j++) fB1->SetParameter(j,fSB->GetParameter(3+j));
+  // 	fB1->SetLineColor(2);
+  // 	fB1->Draw("same");
+  // 	fSB->SetLineColor(4);
+  // 	fSB->Draw("same");
+  // 	thePad->Update();
+  // 	chisq=fSB->GetChisquare()/fSB->GetNDF();;
+  // 	sigma=fSB->GetParameter(2);
+  // 	esigma=fSB->GetParError(2);
+  // 	if(esigma<0.00001) esigma=0.0001;
+  // 	pos=fSB->GetParameter(1);
+  // 	epos=fSB->GetParError(1);
+  // 	if(epos<0.00001) epos=0.0001;
+  // 	ry=fSB->GetParameter(0)/hRebinned->GetBinWidth(1);
+  // 	ery=fSB->GetParError(0)/hRebinned->GetBinWidth(1);
+  //   }
+  // }
+  values[kFitChi2]=chisq;
+  if(out && chisq>0. && sigma>0.5*fSigmaGausMC && sigma<2.0*fSigmaGausMC){
+    values[kFitOK]=1.;
+    values[kFitSignif]=significance;
+    values[kFitErrSignif]=erSignif;
+    values[kFitMean]=pos;
+    values[kFitErrMean]=epos;
+    values[kFitSigma]=sigma;
+    values[kFitErrSigma]=esigma;
+    values[kFitRawYield]=ry;
+    values[kFitErrRawYield]=ery;
+    values[kFitBkg]=bkg;
+    values[kFitErrBkg]=erbkg;
+    values[kFitBkgBinEdges]=bkgBEdge;
+    values[kFitErrBkgBinEdges]=erbkgBEdge;
+    for(Int_t iStepBC=0; iStepBC<fNumOfnSigmaBinCSteps; iStepBC++){
+      Double_t minMassBC=fMassD-fnSigmaBinCSteps[iStepBC]*sigma;
+      Double_t maxMassBC=fMassD+fnSigmaBinCSteps[iStepBC]*sigma;
+      if(minMassBC>minMassForFit &&
+          maxMassBC<maxMassForFit &&
+          minMassBC>(hRebinned->GetXaxis()->GetXmin()) &&
+          maxMassBC<(hRebinned->GetXaxis()->GetXmax())){
+        Double_t cnts,ecnts;
+        BinCount(hRebinned,fB1,1,minMassBC,maxMassBC,cnts,ecnts);
+        values[kNFitValues+3*iStepBC]=1.;
+        values[kNFitValues+3*iStepBC+1]=cnts;
+        values[kNFitValues+3*iStepBC+2]=ecnts;
+      }
+    }
+  }
+  if (mustDeleteFitter) delete fitter;
+}
+
+//________________________________________________________________________
+void AliHFMultiTrials::DoFitsInProcesses(const std::vector<MultiTrialFit_t>& fits, TH1D* hInvMassHisto, const std::vector<TH1F*>& hRebinned,
+                                         std::vector<Double_t>& values, Int_t nValues){
+  // distribute the fits over fNumOfProcesses forked processes: process ip does the fits ip, ip+n, ip+2n, ...
+  // Separate processes are used since the mass fitter uses TMinuit, which is not thread safe.
+  // The values of each fit are sent back through a pipe and stored at the position of the fit,
+  // so that the output does not depend on the number of processes. Fits of a process which
+  // could not be started or did not return its values are done in this process.
+
+  Int_t nFits=fits.size();
+  Int_t nProc=TMath::Min(fNumOfProcesses,nFits);
+  std::vector<pid_t> pids(nProc,-1);
+  std::vector<Int_t> fds(nProc,-1);
+  size_t nBytes=nValues*sizeof(Double_t);
+  fflush(stdout);
+  fflush(stderr);
+  for(Int_t ip=0; ip<nProc; ip++){
+    Int_t fd[2];
+    if(pipe(fd)!=0) continue;
+    pid_t pid=fork();
+    if(pid<0){
+      close(fd[0]);
+      close(fd[1]);
+      continue;
+    }
+    if(pid==0){
+      close(fd[0]);
+      std::vector<Double_t> buf(nValues);
+      for(Int_t ifit=ip; ifit<nFits; ifit+=nProc){
+        const MultiTrialFit_t& fit=fits[ifit];
+        DoFit(fit,hInvMassHisto,hRebinned[fit.fIRebin*fNumOfFirstBinSteps+fit.fFirstBin-1],0x0,buf.data());
+        if(!WriteToPipe(fd[1],buf.data(),nBytes)) break;
+      }
+      close(fd[1]);
+      fflush(stdout);
+      fflush(stderr);
+      _exit(0);
+    }
+    close(fd[1]);
+    pids[ip]=pid;
+    fds[ip]=fd[0];
+  }
+  for(Int_t ip=0; ip<nProc; ip++){
+    Bool_t ok=(fds[ip]>=0);
+    if(!ok) Printf("AliHFMultiTrials: could not start process %d, its fits are done in this process",ip);
+    for(Int_t ifit=ip; ifit<nFits; ifit+=nProc){
+      if(ok) ok=ReadFromPipe(fds[ip],&values[ifit*nValues],nBytes);
+      if(!ok){
+        const MultiTrialFit_t& fit=fits[ifit];
+        DoFit(fit,hInvMassHisto,hRebinned[fit.fIRebin*fNumOfFirstBinSteps+fit.fFirstBin-1],0x0,&values[ifit*nValues]);
+      }
+    }
+    if(fds[ip]>=0) close(fds[ip]);
+    if(pids[ip]>0) waitpid(pids[ip],0x0,0);
+  }
+}
+
 //________________________________________________________________________
 void AliHFMultiTrials::SaveToRoot(TString fileName, TString option) const{
   // save histos in a root file for further analysis
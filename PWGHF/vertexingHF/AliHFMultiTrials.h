@@ -86,6 +86,7 @@ class AliHFMultiTrials : public TNamed {
   void SetSaveBkgValue(Bool_t opt=kTRUE, Double_t nsigma=3) {fSaveBkgVal=opt; fnSigmaForBkgEval=nsigma;}
 
   void SetDrawIndividualFits(Bool_t opt=kTRUE){fDrawIndividualFits=opt;}
+  void SetNumberOfProcesses(Int_t nproc){fNumOfProcesses=nproc;}
 
   Bool_t DoMultiTrials(TH1D* hInvMassHisto, TPad* thePad=0x0);
   void SaveToRoot(TString fileName, TString option="recreate") const;
@@ -103,7 +104,24 @@ class AliHFMultiTrials : public TNamed {
 
  private:
 
+  /// one fit of the grid of trials
+  struct MultiTrialFit_t {
+    Int_t fIRebin;   /// index of the rebin step
+    Int_t fFirstBin; /// first bin step (from 1)
+    Int_t fIMinMass; /// index of the low limit for the fit
+    Int_t fIMaxMass; /// index of the up limit for the fit
+    Int_t fBkgFunc;  /// background function (EBkgFuncCases)
+    Int_t fFitConf;  /// configuration of sigma and mean (EFitParamCases)
+    Int_t fTrial;    /// trial number, bin in the trial histograms
+  };
+  /// values of one fit, followed by (computed, count, error) for each bin counting step
+  enum EFitValues{ kFitOK, kFitChi2, kFitSignif, kFitErrSignif, kFitMean, kFitErrMean, kFitSigma, kFitErrSigma,
+                   kFitRawYield, kFitErrRawYield, kFitBkg, kFitErrBkg, kFitBkgBinEdges, kFitErrBkgBinEdges, kNFitValues };
+
   Bool_t CreateHistos();
+  void DoFit(const MultiTrialFit_t& fit, TH1D* hInvMassHisto, TH1F* hRebinned, TPad* thePad, Double_t* values);
+  void DoFitsInProcesses(const std::vector<MultiTrialFit_t>& fits, TH1D* hInvMassHisto, const std::vector<TH1F*>& hRebinned,
+                         std::vector<Double_t>& values, Int_t nValues);
   TH1F* RebinHisto(TH1D* hOrig, Int_t reb, Int_t firstUse) const;
   void BinCount(TH1F* h, TF1* fB, Int_t rebin, Double_t minMass, Double_t maxMass, Double_t& count, Double_t& ecount) const;
   Bool_t DoFitWithPol3Bkg(TH1F* histoToFit, Double_t  hmin, Double_t  hmax,
@@ -147,6 +165,7 @@ class AliHFMultiTrials : public TNamed {
   Bool_t fSaveBkgVal;		/// switch for saving bkg values in nsigma
 
   Bool_t fDrawIndividualFits; /// flag for drawing fits
+  Int_t fNumOfProcesses;      /// number of processes for the fits (1 = no additional process)
 
   TH1F* fHistoRawYieldDistAll;  /// histo with yield from all trials
   TH1F* fHistoRawYieldTrialAll; /// histo with yield from all trials
@@ -181,7 +200,7 @@ class AliHFMultiTrials : public TNamed {
   std::vector<AliHFMassFitterVAR*> fMassFitters; //!<! Mass fitters
 
   /// \cond CLASSIMP
-  ClassDef(AliHFMultiTrials,5); /// class for multiple trials of invariant mass fit
+  ClassDef(AliHFMultiTrials,6); /// class for multiple trials of invariant mass fit
   /// \endcond
 };
 
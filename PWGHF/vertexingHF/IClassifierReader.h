@@ -12,6 +12,16 @@ class IClassifierReader {
    // return classifier response
    virtual double GetMvaValue( const std::vector<double>& inputValues ) const = 0;
 
+   // return classifier response for a batch of candidates, "inputValues" contains
+   // nVars values per candidate, stored candidate by candidate
+   virtual void GetMvaValues( int nCandidates, int nVars, const double* inputValues, double* responses ) const {
+      std::vector<double> values(nVars);
+      for (int icand = 0; icand < nCandidates; icand++) {
+         values.assign(inputValues + icand * nVars, inputValues + (icand + 1) * nVars);
+         responses[icand] = GetMvaValue(values);
+      }
+   }
+
    // returns classifier status
    bool IsStatusClean() const { return fStatusIsClean; }
 
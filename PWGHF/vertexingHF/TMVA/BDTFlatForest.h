@@ -0,0 +1,266 @@
+#ifndef BDTFlatForest__def
+#define BDTFlatForest__def
+
+#include <vector>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <iostream>
+
+#include "BDTNode.h"
+
+// Compact, pointer-free representation of a boosted decision tree forest.
+//
+// All nodes of all trees are stored in one contiguous array. The two daughters
+// of an intermediate node are stored next to each other (left, right), so that
+// descending the tree only needs the index of the first daughter and the
+// result of the cut. Leaves store the boost weight of the tree times the node
+// type, and the sum of the boost weights is computed once when the forest is
+// built.
+//
+// The response is bit-identical to the one of the generated TMVA classes
+// (ReadBDT_*::GetMvaValue__): trees are evaluated in the same order and the
+// same cut convention is used (goes right if value > cut for cut type true).
+class BDTFlatForest {
+
+public:
+
+  BDTFlatForest() : fNodes(), fRoots(), fNorm(0) {}
+  virtual ~BDTFlatForest() {}
+
+  // Build the flat forest from the forest of the generated TMVA classes. The
+  // original trees are not modified and can be deleted afterwards.
+  void Build( const std::vector<BDTNode*>& forest, const std::vector<double>& boostWeights );
+
+  // Build the flat forest from a TMVA weights file (BDT method, classification).
+  // Cut values are read in full precision from the weights file, while the
+  // generated classes contain rounded cut values, therefore the response can
+  // differ in the last digits from the one of the generated class of the same
+  // training. Returns false if the file could not be read.
+  bool LoadFromXML( const std::string& filename );
+
+  // response for a single candidate, inputValues has the same order as
+  // the variables given to the generated class
+  inline double Evaluate( const double* inputValues ) const;
+
+  // responses for nCandidates candidates at once. Input values are stored
+  // row-wise (nVars values per candidate), output has to have space for
+  // nCandidates values. Each response is identical to the one of Evaluate.
+  void EvaluateBatch( int nCandidates, int nVars, const double* inputValues, double* responses ) const;
+
+  size_t GetNTrees() const { return fRoots.size(); }
+  size_t GetNNodes() const { return fNodes.size(); }
+  bool   IsEmpty()   const { return fRoots.empty(); }
+  void   Reset()           { fNodes.clear(); fRoots.clear(); fNorm = 0; }
+
+private:
+
+  struct FlatNode {
+    double fCutValue;    // cut value (intermediate node), boost weight x node type (leaf)
+    int    fSelector;    // index of the variable used in the cut, -1 for leaves
+    int    fDaughters;   // index of the left daughter, the right daughter follows
+    bool   fCutType;     // true: value > cut goes right, false: value <= cut goes right
+  };
+
+  // temporary node used when reading from xml
+  struct XMLNode {
+    int    fSelector;
+    double fCutValue;
+    bool   fCutType;
+    int    fNodeType;
+    int    fLeft;
+    int    fRight;
+  };
+
+  void AddTree( const BDTNode* root, double boostWeight );
+  void AddXMLTree( const std::vector<XMLNode>& nodes, double boostWeight );
+  static bool ReadAttribute( const std::string& tag, const char* name, std::string& value );
+
+  std::vector<FlatNode> fNodes; // nodes of all trees
+  std::vector<int>      fRoots; // index of the root node for each tree
+  double                fNorm;  // sum of the boost weights
+};
+
+//_______________________________________________________________________
+inline double BDTFlatForest::Evaluate( const double* inputValues ) const
+{
+   const FlatNode* nodes = fNodes.data();
+   double myMVA = 0;
+   for (size_t itree=0; itree<fRoots.size(); itree++){
+      const FlatNode* current = nodes + fRoots[itree];
+      while (current->fSelector >= 0) { //intermediate node
+         bool goesRight = (inputValues[current->fSelector] > current->fCutValue) == current->fCutType;
+         current = nodes + current->fDaughters + goesRight;
+      }
+      myMVA += current->fCutValue;
+   }
+   return myMVA /= fNorm;
+}
+
+//_______________________________________________________________________
+inline void BDTFlatForest::EvaluateBatch( int nCandidates, int nVars, const double* inputValues, double* responses ) const
+{
+   // loop over trees outside, so that the nodes of a tree stay in cache for
+   // all candidates. The sum over trees is done in the same order as in Evaluate.
+   const FlatNode* nodes = fNodes.data();
+   for (int icand=0; icand<nCandidates; icand++) responses[icand] = 0;
+   for (size_t itree=0; itree<fRoots.size(); itree++){
+      const FlatNode* root = nodes + fRoots[itree];
+      const double* values = inputValues;
+      for (int icand=0; icand<nCandidates; icand++, values += nVars){
+         const FlatNode* current = root;
+         while (current->fSelector >= 0) {
+            bool goesRight = (values[current->fSelector] > current->fCutValue) == current->fCutType;
+            current = nodes + current->fDaughters + goesRight;
+         }
+         responses[icand] += current->fCutValue;
+      }
+   }
+   for (int icand=0; icand<nCandidates; icand++) responses[icand] /= fNorm;
+}
+
+//_______________________________________________________________________
+inline void BDTFlatForest::Build( const std::vector<BDTNode*>& forest, const std::vector<double>& boostWeights )
+{
+   Reset();
+   for (size_t itree=0; itree<forest.size(); itree++){
+      AddTree(forest[itree], boostWeights[itree]);
+      fNorm += boostWeights[itree];
+   }
+}
+
+//_______________________________________________________________________
+inline void BDTFlatForest::AddTree( const BDTNode* root, double boostWeight )
+{
+   // breadth-first copy, daughters of a node are appended as a pair
+   std::vector<const BDTNode*> source(1, root);
+   size_t first = fNodes.size();
+   fRoots.push_back(first);
+   fNodes.push_back(FlatNode());
+   for (size_t inode=0; inode<source.size(); inode++){
+      const BDTNode* node = source[inode];
+      FlatNode& flat = fNodes[first + inode];
+      if (node->GetNodeType() == 0) {
+         flat.fCutValue  = node->GetCutValue();
+         flat.fSelector  = node->GetSelector();
+         flat.fCutType   = node->GetCutType();
+         flat.fDaughters = fNodes.size();
+         source.push_back(node->GetLeft());
+         source.push_back(node->GetRight());
+         fNodes.resize(fNodes.size() + 2);
+      }
+      else {
+         // the generated classes compute weight * node type for each leaf reached
+         flat.fCutValue  = boostWeight * node->GetNodeType();
+         flat.fSelector  = -1;
+         flat.fCutType   = false;
+         flat.fDaughters = -1;
+      }
+   }
+}
+
+//_______________________________________________________________________
+inline bool BDTFlatForest::ReadAttribute( const std::string& tag, const char* name, std::string& value )
+{
+   std::string key = std::string(" ") + name + "=\"";
+   size_t start = tag.find(key);
+   if (start == std::string::npos) return false;
+   start += key.size();
+   size_t end = tag.find('"', start);
+   if (end == std::string::npos) return false;
+   value = tag.substr(start, end - start);
+   return true;
+}
+
+//_______________________________________________________________________
+inline bool BDTFlatForest::LoadFromXML( const std::string& filename )
+{
+   Reset();
+   std::ifstream in(filename.c_str());
+   if (!in.good()) {
+      std::cout << "BDTFlatForest: cannot open weights file " << filename << std::endl;
+      return false;
+   }
+
+   std::vector<XMLNode> treeNodes;
+   std::vector<int> parents;     // open (not yet closed) nodes of the current tree
+   double boostWeight = 0;
+   bool inTree = false;
+   std::string line, value;
+   while (std::getline(in, line)) {
+      size_t start = line.find_first_not_of(" \t");
+      if (start == std::string::npos) continue;
+      std::string tag = line.substr(start);
+      if (tag.compare(0, 11, "<BinaryTree") == 0) {
+         if (!ReadAttribute(tag, "boostWeight", value)) return false;
+         boostWeight = std::strtod(value.c_str(), 0);
+         treeNodes.clear();
+         parents.clear();
+         inTree = true;
+      }
+      else if (tag.compare(0, 13, "</BinaryTree>") == 0) {
+         if (!inTree || treeNodes.empty()) return false;
+         AddXMLTree(treeNodes, boostWeight);
+         fNorm += boostWeight;
+         inTree = false;
+      }
+      else if (inTree && tag.compare(0, 5, "<Node") == 0) {
+         XMLNode node;
+         std::string pos;
+         if (!(ReadAttribute(tag, "pos", pos) && ReadAttribute(tag, "IVar", value))) return false;
+         node.fSelector = std::atoi(value.c_str());
+         if (!ReadAttribute(tag, "Cut", value)) return false;
+         node.fCutValue = std::strtod(value.c_str(), 0);
+         if (!ReadAttribute(tag, "cType", value)) return false;
+         node.fCutType = std::atoi(value.c_str()) != 0;
+         if (!ReadAttribute(tag, "nType", value)) return false;
+         node.fNodeType = std::atoi(value.c_str());
+         node.fLeft = node.fRight = -1;
+         int index = treeNodes.size();
+         if (!parents.empty()) {
+            XMLNode& parent = treeNodes[parents.back()];
+            if (pos == "l") parent.fLeft = index;
+            else parent.fRight = index;
+         }
+         treeNodes.push_back(node);
+         // nodes without daughters are closed in the same tag
+         if (tag.find("/>") == std::string::npos) parents.push_back(index);
+      }
+      else if (inTree && tag.compare(0, 7, "</Node>") == 0) {
+         if (parents.empty()) return false;
+         parents.pop_back();
+      }
+   }
+   return !fRoots.empty();
+}
+
+//_______________________________________________________________________
+inline void BDTFlatForest::AddXMLTree( const std::vector<XMLNode>& nodes, double boostWeight )
+{
+   // same layout as AddTree, node 0 is the root node
+   std::vector<int> source(1, 0);
+   size_t first = fNodes.size();
+   fRoots.push_back(first);
+   fNodes.push_back(FlatNode());
+   for (size_t inode=0; inode<source.size(); inode++){
+      const XMLNode& node = nodes[source[inode]];
+      FlatNode& flat = fNodes[first + inode];
+      if (node.fNodeType == 0 && node.fLeft >= 0 && node.fRight >= 0) {
+         flat.fCutValue  = node.fCutValue;
+         flat.fSelector  = node.fSelector;
+         flat.fCutType   = node.fCutType;
+         flat.fDaughters = fNodes.size();
+         source.push_back(node.fLeft);
+         source.push_back(node.fRight);
+         fNodes.resize(fNodes.size() + 2);
+      }
+      else {
+         flat.fCutValue  = boostWeight * node.fNodeType;
+         flat.fSelector  = -1;
+         flat.fCutType   = false;
+         flat.fDaughters = -1;
+      }
+   }
+}
+
+#endif
@@ -31,10 +31,12 @@ public:
    // test event if it decends the tree at this node to the right
    virtual bool GoesRight( const std::vector<double>& inputValues ) const;
    BDTNode* GetRight( void )  {return fRight; };
+   const BDTNode* GetRight( void ) const {return fRight; };
 
    // test event if it decends the tree at this node to the left 
    virtual bool GoesLeft ( const std::vector<double>& inputValues ) const;
    BDTNode* GetLeft( void ) { return fLeft; };   
+   const BDTNode* GetLeft( void ) const { return fLeft; };
 
    // return  S/(S+B) (purity) at this node (from  training)
 
@@ -43,6 +45,11 @@ public:
    int    GetNodeType( void ) const { return fNodeType; }
    double GetResponse(void) const {return fResponse;}
 
+   // cut applied at this node (used to convert the forest into a BDTFlatForest)
+   int    GetSelector( void ) const { return fSelector; }
+   double GetCutValue( void ) const { return fCutValue; }
+   bool   GetCutType( void ) const { return fCutType; }
+
 private:
 
    BDTNode*   fLeft;     // pointer to the left daughter node
@@ -2,18 +2,8 @@
 
 double ReadBDT_LHC19c2a_12_25_noNsigma::GetMvaValue__( const std::vector<double>& inputValues ) const
 {
-   double myMVA = 0;
-   double norm  = 0;
-   for (unsigned int itree=0; itree<fForest.size(); itree++){
-      BDTNode *current = fForest[itree];
-      while (current->GetNodeType() == 0) { //intermediate node
-         if (current->GoesRight(inputValues)) current=(BDTNode*)current->GetRight();
-         else current=(BDTNode*)current->GetLeft();
-      }
-      myMVA += fBoostWeights[itree] *  current->GetNodeType();
-      norm  += fBoostWeights[itree];
-   }
-   return myMVA /= norm;
+   // evaluated on the flat copy of the forest built in Initialize (identical response)
+   return fFlatForest.Evaluate( inputValues.data() );
 };
 
 void ReadBDT_LHC19c2a_12_25_noNsigma::Initialize()
@@ -26680,6 +26670,12 @@ NN(
 -1, 2.36718, 0, -1, 0.466623,-99) , 
 3, 0.893819, 1, 0, 0.48347,-99) , 
 5, 0.619039, 0, 0, 0.503761,-99)    );
+
+   // convert the forest to the flat representation used in the evaluation,
+   // the nodes are not needed anymore afterwards (added by ALICE analyzers)
+   fFlatForest.Build(fForest, fBoostWeights);
+   Clear();
+   fForest.clear();
    return;
 };
 
@@ -26708,6 +26704,18 @@ inline void ReadBDT_LHC19c2a_12_25_noNsigma::Clear()
       return retval;
    }
 
+// Added by ALICE analyzer
+   void ReadBDT_LHC19c2a_12_25_noNsigma::GetMvaValues( int nCandidates, int nVars, const double* inputValues, double* responses ) const
+   {
+      if (!IsStatusClean() || nVars != (int)fNvars) {
+         std::cout << "Problem in class \"" << fClassName << "\": cannot return classifier response"
+                   << " because status is dirty or number of variables does not match" << std::endl;
+         for (int icand = 0; icand < nCandidates; icand++) responses[icand] = 0;
+         return;
+      }
+      fFlatForest.EvaluateBatch( nCandidates, nVars, inputValues, responses );
+   }
+
 // Added by ALICE analyzer
 extern "C"
 {
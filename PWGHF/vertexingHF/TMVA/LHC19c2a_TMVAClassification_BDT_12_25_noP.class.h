@@ -111,6 +111,7 @@ centrality                    centrality                    centrality
 #include <iostream>
 #include "IClassifierReader.h"
 #include "BDTNode.h"
+#include "BDTFlatForest.h"
 
 class ReadBDT_LHC19c2a_12_25_noP : public IClassifierReader
 {
@@ -215,6 +216,10 @@ class ReadBDT_LHC19c2a_12_25_noP : public IClassifierReader
   // variables given to the constructor
   double GetMvaValue(const std::vector<double> &inputValues) const;
 
+  // classifier response for a batch of candidates (added by ALICE analyzers)
+  // "inputValues" contains nVars values per candidate, stored candidate by candidate
+  void GetMvaValues(int nCandidates, int nVars, const double* inputValues, double* responses) const;
+
  private:
 
    // method-specific destructor
@@ -247,6 +252,7 @@ class ReadBDT_LHC19c2a_12_25_noP : public IClassifierReader
   // private members (method specific)
   std::vector<BDTNode *> fForest; // i.e. root nodes of decision trees
   std::vector<double> fBoostWeights;      // the weights applied in the individual boosts
+  BDTFlatForest fFlatForest;              //! flat copy of the forest used for the evaluation (added by ALICE analyzers)
 };
 
 #endif
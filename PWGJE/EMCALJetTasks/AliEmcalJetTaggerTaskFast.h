@@ -48,7 +48,8 @@ namespace EMCALJetTasks {
  * @since Nov 8, 2017
  *
  * Class based on AliAnalysisTaskEmcalJetTagger. Navigation finding closest neighbor
- * however is based on a kd-tree.
+ * however is based on a spatial index of the jets in \f$\eta\f$-\f$\phi\f$
+ * (see PWG::JETFW::AliEmcalJetMatcher).
  *
  */
 class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
@@ -183,7 +184,7 @@ class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
    * @brief Match the full jets to the corresponding charged jets
    *
    * For all jets, at both base and tag level, finding the nearest neighbor
-   * in distance in the \$\eta\f$-\f$\phi\$ space, accepting only pairs
+   * in distance in the \$\eta\f$-\f$\phi\$ space (periodic in \f$\phi\f$), accepting only pairs
    * with a distance smaller maxDistance. True jet pairs are accepted only
    * if the base jet is the closest neighbor to the tag jet and vice versa
    * at the same time.
@@ -226,10 +227,10 @@ class AliEmcalJetTaggerTaskFast : public AliAnalysisTaskEmcalJet {
   TH3             *fh3PtJetAreaDRConst;          //!<! \f$ p_{t}\f$ jet vs Area vs delta R of constituents
   TH1             *fNAccJets;                    //!<! number of jets per event
 #ifdef JETTAGGERFAST_TEST
-  TH1             *fIndexErrorRateBase;          //!<! Monitoring number of errors between index in kd-tree and data block for base jets
-  TH1             *fIndexErrorRateTag;           //!<! Monitoring number of errors between index in kd-tree and data block for tag jets
-  TH1             *fContainerErrorRateBase;      //!<! Monitoring number of errors between index in kd-tree and jet vector for base jets
-  TH1             *fContainerErrorRateTag;       //!<! Monitoring number of errors between index in kd-tree and jet vector for tag jets
+  TH1             *fIndexErrorRateBase;          //!<! Monitoring number of matched base jets which are not the closest jet of the tag jet
+  TH1             *fIndexErrorRateTag;           //!<! Monitoring number of matched tag jets which are not the closest jet of the base jet
+  TH1             *fContainerErrorRateBase;      //!<! Monitoring number of matched pairs with inconsistent match indices (base jets)
+  TH1             *fContainerErrorRateTag;       //!<! Monitoring number of matched pairs with inconsistent match indices (tag jets)
 #endif
   AliEmcalJetTaggerTaskFast(const AliEmcalJetTaggerTaskFast&);            // not implemented
   AliEmcalJetTaggerTaskFast &operator=(const AliEmcalJetTaggerTaskFast&); // not implemented
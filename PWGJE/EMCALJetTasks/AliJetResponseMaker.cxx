@@ -59,6 +59,12 @@ AliJetResponseMaker::AliJetResponseMaker() :
   fPtgAxis(0),
   fDBCAxis(0),
   fJetRelativeEPAngle(0),
+  fJetMatcher(),
+  fJets2(),
+  fJet2Candidates(),
+  fJet1Tracks(),
+  fJet1Clusters(),
+  fJet1MCParticles(),
   fIsJet1Rho(kFALSE),
   fIsJet2Rho(kFALSE),
   fHistRejectionReason1(0),
@@ -148,6 +154,12 @@ AliJetResponseMaker::AliJetResponseMaker(const char *name) :
   fPtgAxis(0),
   fDBCAxis(0),
   fJetRelativeEPAngle(0),
+  fJetMatcher(),
+  fJets2(),
+  fJet2Candidates(),
+  fJet1Tracks(),
+  fJet1Clusters(),
+  fJet1MCParticles(),
   fIsJet1Rho(kFALSE),
   fIsJet2Rho(kFALSE),
   fHistRejectionReason1(0),
@@ -1426,8 +1438,21 @@ void AliJetResponseMaker::DoJetLoop()
   AliEmcalJet* jet1 = 0;
   AliEmcalJet* jet2 = 0;
 
+  fJets2.clear();
   jets2->ResetCurrentID();
-  while ((jet2 = jets2->GetNextJet())) jet2->ResetMatching();
+  while ((jet2 = jets2->GetNextJet())) {
+    jet2->ResetMatching();
+    fJets2.push_back(jet2);
+  }
+
+  // the constituent maps may still contain jets of the previous event
+  fJet1Tracks.Clear();
+  fJet1Clusters.Clear();
+  fJet1MCParticles.Clear();
+
+  // for the geometrical matching only jets 2 in the neighbourhood of jet 1 can be matched
+  // (closest jet within the matching distance), all others are skipped
+  if (fMatching == kGeometrical) fJetMatcher.SetJets(fJets2, TMath::Max(fMatchingPar1, fMatchingPar2));
 
   jets1->ResetCurrentID();
   while ((jet1 = jets1->GetNextJet())) {
@@ -1435,10 +1460,17 @@ void AliJetResponseMaker::DoJetLoop()
 
     if (jet1->MCPt() < fMinJetMCPt) continue;
 
-    jets2->ResetCurrentID();
-    while ((jet2 = jets2->GetNextJet())) {
-      SetMatchingLevel(jet1, jet2, fMatching);
-    } // jet2 loop
+    if (fMatching == kGeometrical) {
+      fJetMatcher.FindCandidates(jet1, fJet2Candidates);
+      for (auto ijet2 : fJet2Candidates) {
+        SetMatchingLevel(jet1, fJets2[ijet2], fMatching);
+      }
+    }
+    else {
+      for (auto jet : fJets2) {
+        SetMatchingLevel(jet1, jet, fMatching);
+      }
+    }
   } // jet1 loop
 }
 
@@ -1534,11 +1566,11 @@ void AliJetResponseMaker::GetMCLabelMatchingLevel(AliEmcalJet *jet1, AliEmcalJet
     }
   }
 
-  for (Int_t iTrack2 = 0; iTrack2 < jet2->GetNumberOfTracks(); iTrack2++) {
-    Bool_t track2Found = kFALSE;
-    Int_t index2 = jet2->TrackAt(iTrack2);
+  // MC particles associated to the tracks and clusters of jet1, the map is filled only once per jet1
+  if (tracks2 && !fJet1MCParticles.IsJet(jet1)) {
+    fJet1MCParticles.Clear();
+    fJet1MCParticles.SetJet(jet1);
 
-    // now look for common particles in the track array
     for (Int_t iTrack = 0; iTrack < jet1->GetNumberOfTracks(); iTrack++) {
       AliVParticle *track = jet1->Track(iTrack);
       if (!track) {
@@ -1546,7 +1578,7 @@ void AliJetResponseMaker::GetMCLabelMatchingLevel(AliEmcalJet *jet1, AliEmcalJet
         continue;
       }
       Int_t MClabel = TMath::Abs(track->GetLabel());
-      MClabel -= fMCLabelShift;	  
+      MClabel -= fMCLabelShift;
       if (MClabel <= 0) continue;
 
       Int_t index = -1;
@@ -1556,22 +1588,9 @@ void AliJetResponseMaker::GetMCLabelMatchingLevel(AliEmcalJet *jet1, AliEmcalJet
         continue;
       }
 
-      if (index2 != index) continue;
-
-      // found common particle
-      d1 -= track->Pt();
-
-      if (!track2Found) {
-        AliVParticle *MCpart = jet2->Track(iTrack2);
-        AliDebug(3,Form("Track %d (pT = %f, eta = %f, phi = %f) is associated with the MC particle %d (pT = %f, eta = %f, phi = %f)!",
-            iTrack,track->Pt(),track->Eta(),track->Phi(),MClabel,MCpart->Pt(),MCpart->Eta(),MCpart->Phi()));
-        d2 -= MCpart->Pt();
-      }
-
-      track2Found = kTRUE;
+      fJet1MCParticles.Add(index, track->Pt());
     }
 
-    // now look for common particles in the cluster array
     if (fUseCellsToMatch && fCaloCells) { // if the cell colection is available, look for cells with a matched MC particle
       for (Int_t iClus = 0; iClus < jet1->GetNumberOfClusters(); iClus++) {
         AliVCluster *clus = jet1->Cluster(iClus);
@@ -1597,23 +1616,11 @@ void AliJetResponseMaker::GetMCLabelMatchingLevel(AliEmcalJet *jet1, AliEmcalJet
             continue;
           }
 
-          if (index2 != index1) continue;
-
-          // found common particle
-          d1 -= part.Pt() * cellFrac;
-
-          if (!track2Found) { // only if it is not already found among charged tracks (charged particles are most likely already found)
-            AliVParticle *MCpart = jet2->Track(iTrack2);
-            AliDebug(3,Form("Cell %d belonging to cluster %d (pT = %f, eta = %f, phi = %f) is associated with the MC particle %d (pT = %f, eta = %f, phi = %f)!",
-                iCell,iClus,part.Pt(),part.Eta(),part.Phi_0_2pi(),MClabel,MCpart->Pt(),MCpart->Eta(),MCpart->Phi()));
-            d2 -= MCpart->Pt() * cellFrac;
-          }
-
-          track2Found = kTRUE;
+          fJet1MCParticles.Add(index1, part.Pt() * cellFrac, cellFrac);
         }
       }
     }
-    else { //otherwise look for the first contributor to the cluster, and if matched to a MC label remove it
+    else { //otherwise look for the first contributor to the cluster
       for (Int_t iClus = 0; iClus < jet1->GetNumberOfClusters(); iClus++) {
         AliVCluster *clus = jet1->Cluster(iClus);
         if (!clus) {
@@ -1629,27 +1636,32 @@ void AliJetResponseMaker::GetMCLabelMatchingLevel(AliEmcalJet *jet1, AliEmcalJet
 
         Int_t index = -1;
         index = tracks2->GetIndexFromLabel(MClabel);
-
         if (index < 0) {
           AliDebug(3,Form("Cluster %d (pT = %f) does not have an associated MC particle (MClabel = %d)!",iClus,part.Pt(),MClabel));
           continue;
         }
 
-        if (index2 != index) continue;
-
-        // found common particle
-        d1 -= part.Pt();
+        fJet1MCParticles.Add(index, part.Pt());
+      }
+    }
+  }
 
-        if (!track2Found) { // only if it is not already found among charged tracks (charged particles are most likely already found)
-          AliVParticle *MCpart = jet2->Track(iTrack2);
-          AliDebug(3,Form("Cluster %d (pT = %f, eta = %f, phi = %f) is associated with the MC particle %d (pT = %f, eta = %f, phi = %f)!",
-              iClus,part.Pt(),part.Eta(),part.Phi_0_2pi(),MClabel,MCpart->Pt(),MCpart->Eta(),MCpart->Phi()));
+  for (Int_t iTrack2 = 0; iTrack2 < jet2->GetNumberOfTracks(); iTrack2++) {
+    Bool_t track2Found = kFALSE;
+    Int_t index2 = jet2->TrackAt(iTrack2);
 
-          d2 -= MCpart->Pt();
-        }
+    // common particles in the track and cluster (cell) arrays, in the order of the constituents of jet1
+    for (Int_t entry = fJet1MCParticles.Find(index2); entry >= 0; entry = fJet1MCParticles.Next(entry)) {
+      d1 -= fJet1MCParticles.GetPt(entry);
 
-        track2Found = kTRUE;
+      if (!track2Found) { // only if it is not already found among the previous constituents (charged particles are most likely already found)
+        AliVParticle *MCpart = jet2->Track(iTrack2);
+        AliDebug(3,Form("Constituent with pT = %f is associated with the MC particle %d (pT = %f, eta = %f, phi = %f)!",
+            fJet1MCParticles.GetPt(entry),index2,MCpart->Pt(),MCpart->Eta(),MCpart->Phi()));
+        d2 -= MCpart->Pt() * fJet1MCParticles.GetFraction(entry);
       }
+
+      track2Found = kTRUE;
     }
   }
 
@@ -1690,29 +1702,37 @@ void AliJetResponseMaker::GetSameCollectionsMatchingLevel(AliEmcalJet *jet1, Ali
 
   if (tracks1 && tracks2) {
 
-    for (Int_t iTrack2 = 0; iTrack2 < jet2->GetNumberOfTracks(); iTrack2++) {
-      Int_t index2 = jet2->TrackAt(iTrack2);
+    // track indices of jet1, the map is filled only once per jet1
+    if (!fJet1Tracks.IsJet(jet1)) {
+      fJet1Tracks.Clear();
+      fJet1Tracks.SetJet(jet1);
       for (Int_t iTrack1 = 0; iTrack1 < jet1->GetNumberOfTracks(); iTrack1++) {
         Int_t index1 = jet1->TrackAt(iTrack1);
-        if (index2 == index1) { // found common particle
-          AliVParticle *part1 = jet1->Track(iTrack1);
-          if (!part1) {
-            AliWarning(Form("Could not find track %d!", index1));
-            continue;
-          }
-          AliVParticle *part2 = jet2->Track(iTrack2);
-          if (!part2) {
-            AliWarning(Form("Could not find track %d!", index2));
-            continue;
-          }
-
-          d1 -= part1->Pt();
-          d2 -= part2->Pt();
-          break;
+        AliVParticle *part1 = jet1->Track(iTrack1);
+        if (!part1) {
+          AliWarning(Form("Could not find track %d!", index1));
+          continue;
         }
+        fJet1Tracks.Add(index1, part1->Pt());
       }
     }
 
+    for (Int_t iTrack2 = 0; iTrack2 < jet2->GetNumberOfTracks(); iTrack2++) {
+      Int_t index2 = jet2->TrackAt(iTrack2);
+      Int_t entry = fJet1Tracks.Find(index2);
+      if (entry < 0) continue;
+
+      // found common particle
+      AliVParticle *part2 = jet2->Track(iTrack2);
+      if (!part2) {
+        AliWarning(Form("Could not find track %d!", index2));
+        continue;
+      }
+
+      d1 -= fJet1Tracks.GetPt(entry);
+      d2 -= part2->Pt();
+    }
+
   }
 
   if (clusters1 && clusters2) {
@@ -1820,30 +1840,39 @@ void AliJetResponseMaker::GetSameCollectionsMatchingLevel(AliEmcalJet *jet1, Ali
       }
     }
     else {
-      for (Int_t iClus2 = 0; iClus2 < jet2->GetNumberOfClusters(); iClus2++) {
-        Int_t index2 = jet2->ClusterAt(iClus2);
+      // cluster indices of jet1, the map is filled only once per jet1
+      if (!fJet1Clusters.IsJet(jet1)) {
+        fJet1Clusters.Clear();
+        fJet1Clusters.SetJet(jet1);
         for (Int_t iClus1 = 0; iClus1 < jet1->GetNumberOfClusters(); iClus1++) {
           Int_t index1 = jet1->ClusterAt(iClus1);
-          if (index2 == index1) { // found common particle
-            AliVCluster *clus1 = jet1->Cluster(iClus1);
-            if (!clus1) {
-              AliWarning(Form("Could not find cluster %d!", index1));
-              continue;
-            }
-            AliVCluster *clus2 =  jet2->Cluster(iClus2);
-            if (!clus2) {
-              AliWarning(Form("Could not find cluster %d!", index2));
-              continue;
-            }
-            TLorentzVector part1, part2;
-            clus1->GetMomentum(part1, fVertex);
-            clus2->GetMomentum(part2, fVertex);
-
-            d1 -= part1.Pt();
-            d2 -= part2.Pt();
-            break;
+          AliVCluster *clus1 = jet1->Cluster(iClus1);
+          if (!clus1) {
+            AliWarning(Form("Could not find cluster %d!", index1));
+            continue;
           }
+          TLorentzVector part1;
+          clus1->GetMomentum(part1, fVertex);
+          fJet1Clusters.Add(index1, part1.Pt());
+        }
+      }
+
+      for (Int_t iClus2 = 0; iClus2 < jet2->GetNumberOfClusters(); iClus2++) {
+        Int_t index2 = jet2->ClusterAt(iClus2);
+        Int_t entry = fJet1Clusters.Find(index2);
+        if (entry < 0) continue;
+
+        // found common particle
+        AliVCluster *clus2 =  jet2->Cluster(iClus2);
+        if (!clus2) {
+          AliWarning(Form("Could not find cluster %d!", index2));
+          continue;
         }
+        TLorentzVector part2;
+        clus2->GetMomentum(part2, fVertex);
+
+        d1 -= fJet1Clusters.GetPt(entry);
+        d2 -= part2.Pt();
       }
     }
   }
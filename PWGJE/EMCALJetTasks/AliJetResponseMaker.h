@@ -24,9 +24,13 @@ class TH2;
 class THnSparse;
 class AliNamedArrayI;
 
+#include <vector>
+
 #include "AliEmcalJet.h"
 #include "AliAnalysisTaskEmcalJet.h"
 #include "AliEmcalEmbeddingQA.h"
+#include "AliEmcalJetConstituentMap.h"
+#include "AliEmcalJetMatcher.h"
 
 class AliJetResponseMaker : public AliAnalysisTaskEmcalJet {
  public:
@@ -125,6 +129,13 @@ class AliJetResponseMaker : public AliAnalysisTaskEmcalJet {
   Int_t                       fDBCAxis;                                // add DBC (number of soft dropped branches) axis in matching THnSparse (default=0)
   Int_t                       fJetRelativeEPAngle;                     ///< add jet angle relative to the EP in matching THnSparse (default=0)
 
+  PWG::JETFW::AliEmcalJetMatcher fJetMatcher;                          //!<! spatial index of jets 2 for the geometrical matching
+  std::vector<AliEmcalJet*>   fJets2;                                  //!<! jets 2 of the current event
+  std::vector<Int_t>          fJet2Candidates;                         //!<! jets 2 in the neighbourhood of jet 1
+  mutable PWG::JETFW::AliEmcalJetConstituentMap fJet1Tracks;           //!<! tracks of jet 1 (matching with same collections)
+  mutable PWG::JETFW::AliEmcalJetConstituentMap fJet1Clusters;         //!<! clusters of jet 1 (matching with same collections)
+  mutable PWG::JETFW::AliEmcalJetConstituentMap fJet1MCParticles;      //!<! MC particles associated to the constituents of jet 1 (MC label matching)
+
   Bool_t                      fIsJet1Rho;                              //!whether the jet1 collection has to be average subtracted
   Bool_t                      fIsJet2Rho;                              //!whether the jet2 collection has to be average subtracted
 
@@ -204,6 +215,6 @@ class AliJetResponseMaker : public AliAnalysisTaskEmcalJet {
   AliJetResponseMaker(const AliJetResponseMaker&);            // not implemented
   AliJetResponseMaker &operator=(const AliJetResponseMaker&); // not implemented
 
-  ClassDef(AliJetResponseMaker, 29) // Jet response matrix producing task
+  ClassDef(AliJetResponseMaker, 30) // Jet response matrix producing task
 };
 #endif
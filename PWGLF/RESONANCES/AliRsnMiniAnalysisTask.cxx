@@ -13,6 +13,8 @@
 // Developers: F. Bellini (fbellini@cern.ch)
 
 #include <Riostream.h>
+#include <algorithm>
+#include <map>
 
 #include <TH1.h>
 #include <TList.h>
@@ -107,7 +109,11 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask() :
    fComputeSpherocity(kFALSE),
    fTrackFilter(0x0),
    fSpherocity(-10),
-   fResonanceFinders(0)
+   fResonanceFinders(0),
+   fUseEventStore(kFALSE),
+   fEventStoreMaxSize(0),
+   fEventStoreSize(0),
+   fEventStore()
 {
 //
 // Dummy constructor ALWAYS needed for I/O.
@@ -175,7 +181,11 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask(const char *name, Bool_t useMC,Bo
    fComputeSpherocity(kFALSE),
    fTrackFilter(0x0),
    fSpherocity(-10),
-   fResonanceFinders(0)
+   fResonanceFinders(0),
+   fUseEventStore(kFALSE),
+   fEventStoreMaxSize(0),
+   fEventStoreSize(0),
+   fEventStore()
 {
 //
 // Default constructor.
@@ -244,7 +254,11 @@ AliRsnMiniAnalysisTask::AliRsnMiniAnalysisTask(const AliRsnMiniAnalysisTask &cop
    fComputeSpherocity(copy.fComputeSpherocity),
    fTrackFilter(copy.fTrackFilter),
    fSpherocity(copy.fSpherocity),
-   fResonanceFinders(copy.fResonanceFinders)
+   fResonanceFinders(copy.fResonanceFinders),
+   fUseEventStore(copy.fUseEventStore),
+   fEventStoreMaxSize(copy.fEventStoreMaxSize),
+   fEventStoreSize(0),
+   fEventStore()
 {
 //
 // Copy constructor.
@@ -315,6 +329,8 @@ AliRsnMiniAnalysisTask &AliRsnMiniAnalysisTask::operator=(const AliRsnMiniAnalys
    fTrackFilter = copy.fTrackFilter;
    fSpherocity = copy.fSpherocity;
    fResonanceFinders = copy.fResonanceFinders;
+   fUseEventStore = copy.fUseEventStore;
+   fEventStoreMaxSize = copy.fEventStoreMaxSize;
 
    return (*this);
 }
@@ -332,6 +348,7 @@ AliRsnMiniAnalysisTask::~AliRsnMiniAnalysisTask()
       delete fOutput;
       delete fEvBuffer;
    }
+   ClearEventStore();
 }
 
 //__________________________________________________________________________________________________
@@ -541,6 +558,7 @@ void AliRsnMiniAnalysisTask::UserExec(Option_t *)
       AliDebugClass(2, Form("Adding event #%d with ID = %d", fEvNum, id));
       fMiniEvent->ID() = id;
       fEvBuffer->Fill();
+      if (fUseEventStore) StoreMiniEvent();
    }
 
    // post data for computed stuff
@@ -578,14 +596,28 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
       else printNum = 0;
    }
 
+   // the stored copies get the references of the cursor,
+   // as the events read from the buffer (these are not streamed)
+   for (ievt = 0; ievt < (Int_t)fEventStore.size(); ievt++) {
+      fEventStore[ievt]->SetRef(fMiniEvent->GetRef());
+      fEventStore[ievt]->SetRefMC(fMiniEvent->GetRefMC());
+      fEventStore[ievt]->SetQnVector(fMiniEvent->GetQnVector());
+   }
+
    // loop on events, and for each one fill all outputs
    // using the appropriate procedure depending on its type
    // only mother-related histograms are filled in UserExec,
    // since they require direct access to MC event
+   // the event variables used for the mixing are stored while reading the
+   // events, so that the search for mixing partners needs no further reading
+   std::vector<Float_t> evVz(nEvents), evMult(nEvents), evAngle(nEvents);
    timer.Start();
    for (ievt = 0; ievt < nEvents; ievt++) {
       // get next entry
-      fEvBuffer->GetEntry(ievt);
+      AliRsnMiniEvent *event = GetMiniEvent(ievt);
+      evVz[ievt] = event->Vz();
+      evMult[ievt] = event->Mult();
+      evAngle[ievt] = event->Angle();
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] Std.Event %d/%d",GetName(), ievt,nEvents));
          timer.Stop(); timer.Print(); fflush(stdout); timer.Start(kFALSE);
@@ -600,23 +632,23 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
             case AliRsnMiniOutput::kEventOnly:
                //AliDebugClass(1, Form("Event %d, def '%s': event-value histogram filling", ievt, def->GetName()));
                ifill = 1;
-               def->FillEvent(fMiniEvent, &fValues);
+               def->FillEvent(event, &fValues);
                break;
             case AliRsnMiniOutput::kTruePair:
                //AliDebugClass(1, Form("Event %d, def '%s': true-pair histogram filling", ievt, def->GetName()));
-               ifill = def->FillPair(fMiniEvent, fMiniEvent, &fValues);
+               ifill = def->FillPair(event, event, &fValues);
                break;
             case AliRsnMiniOutput::kTrackPair:
                //AliDebugClass(1, Form("Event %d, def '%s': pair-value histogram filling", ievt, def->GetName()));
-               ifill = def->FillPair(fMiniEvent, fMiniEvent, &fValues);
+               ifill = def->FillPair(event, event, &fValues);
                break;
             case AliRsnMiniOutput::kTrackPairRotated1:
                //AliDebugClass(1, Form("Event %d, def '%s': rotated (1) background histogram filling", ievt, def->GetName()));
-               ifill = def->FillPair(fMiniEvent, fMiniEvent, &fValues);
+               ifill = def->FillPair(event, event, &fValues);
                break;
             case AliRsnMiniOutput::kTrackPairRotated2:
                //AliDebugClass(1, Form("Event %d, def '%s': rotated (2) background histogram filling", ievt, def->GetName()));
-               ifill = def->FillPair(fMiniEvent, fMiniEvent, &fValues);
+               ifill = def->FillPair(event, event, &fValues);
                break;
             default:
                // other kinds are processed elsewhere
@@ -631,89 +663,54 @@ void AliRsnMiniAnalysisTask::FinishTaskOutput()
    // if no mixing is required, stop here and post the output
    if (fNMix < 1) {
       AliDebugClass(2, "Stopping here, since no mixing is required");
+      ClearEventStore();
       PostData(1, fOutput);
       return;
    }
 
-   // initialize mixing counter
-   Int_t    nmatched[nEvents];
-   TString *smatched = new TString[nEvents];
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      smatched[ievt] = "|";
-      nmatched[ievt] = 0;
-   }
-
-
    AliInfo(Form("[%s] Std.Event %d/%d",GetName(), nEvents,nEvents));
    timer.Stop(); timer.Print(); timer.Start(); fflush(stdout);
 
    // search for good matchings
-   for (ievt = 0; ievt < nEvents; ievt++) {
-      if (printNum&&(ievt%printNum==0)) {
-         AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),ievt,nEvents));
-         timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
-      }
-      if (nmatched[ievt] >= fNMix) continue;
-      fEvBuffer->GetEntry(ievt);
-      AliRsnMiniEvent evMain(*fMiniEvent);
-      for (iloop = 1; iloop < nEvents; iloop++) {
-         imix = ievt + iloop;
-         if (imix >= nEvents) imix -= nEvents;
-         if (imix == ievt) continue;
-         // text next entry
-         fEvBuffer->GetEntry(imix);
-         // skip if events are not matched
-         if (!EventsMatch(&evMain, fMiniEvent)) continue;
-         // check that the array of good matches for mixed does not already contain main event
-         if (smatched[imix].Contains(Form("|%d|", ievt))) continue;
-         // check that the found good events has not enough matches already
-         if (nmatched[imix] >= fNMix) continue;
-         // add new mixing candidate
-         smatched[ievt].Append(Form("%d|", imix));
-         nmatched[ievt]++;
-         nmatched[imix]++;
-         if (nmatched[ievt] >= fNMix) break;
-      }
-      AliDebugClass(1, Form("Matches for event %5d = %d [%s] (missing are declared above)", evMain.ID(), nmatched[ievt], smatched[ievt].Data()));
-   }
+   std::vector< std::vector<Int_t> > partners;
+   FindMixingPartners(evVz, evMult, evAngle, partners, printNum);
 
    AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout); timer.Start();
 
    // perform mixing
-   TObjArray *list = 0x0;
-   TObjString *os = 0x0;
    for (ievt = 0; ievt < nEvents; ievt++) {
       if (printNum&&(ievt%printNum==0)) {
          AliInfo(Form("[%s] EventMixing %d/%d",GetName(),ievt,nEvents));
          timer.Stop(); timer.Print(); timer.Start(kFALSE); fflush(stdout);
       }
       ifill = 0;
-      fEvBuffer->GetEntry(ievt);
-      AliRsnMiniEvent evMain(*fMiniEvent);
-      list = smatched[ievt].Tokenize("|");
-      TObjArrayIter next(list);
-      while ( (os = (TObjString *)next()) ) {
-         imix = os->GetString().Atoi();
-         fEvBuffer->GetEntry(imix);
+      // an event read from the buffer is copied, since the cursor is reused for the partners
+      AliRsnMiniEvent *evMain = GetMiniEvent(ievt);
+      AliRsnMiniEvent evMainCopy;
+      if (evMain == fMiniEvent) {
+         evMainCopy = *fMiniEvent;
+         evMain = &evMainCopy;
+      }
+      for (iloop = 0; iloop < (Int_t)partners[ievt].size(); iloop++) {
+         imix = partners[ievt][iloop];
+         AliRsnMiniEvent *evMix = GetMiniEvent(imix);
          for (idef = 0; idef < nDefs; idef++) {
             def = (AliRsnMiniOutput *)fHistograms[idef];
             if (!def) continue;
             if (!def->IsTrackPairMix()) continue;
-            ifill += def->FillPair(&evMain, fMiniEvent, &fValues, kTRUE);
+            ifill += def->FillPair(evMain, evMix, &fValues, kTRUE);
             if (!def->IsSymmetric()) {
                AliDebugClass(2, "Reflecting non symmetric pair");
-               ifill += def->FillPair(fMiniEvent, &evMain, &fValues, kFALSE);
+               ifill += def->FillPair(evMix, evMain, &fValues, kFALSE);
             }
          }
       }
-      delete list;
    }
 
-   delete [] smatched;
-
    AliInfo(Form("[%s] EventMixing %d/%d",GetName(),nEvents,nEvents));
    timer.Stop(); timer.Print(); fflush(stdout);
+   ClearEventStore();
 
    // post computed data
    PostData(1, fOutput);
@@ -1619,33 +1616,39 @@ void AliRsnMiniAnalysisTask::SetDselection(UShort_t originDselection)
 Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEvent *event2)
 {
    if (!event1 || !event2) return kFALSE;
+   return EventsMatch(event1->Vz(), event1->Mult(), event1->Angle(), event2->Vz(), event2->Mult(), event2->Angle());
+}
+
+//__________________________________________________________________________________________________
+/// Check if two events are compatible for mixing, given their vertex z, multiplicity and angle.
+/// \return Flag = 1 if events are compatible
+///
+Bool_t AliRsnMiniAnalysisTask::EventsMatch(Float_t vz1, Float_t mult1, Float_t angle1, Float_t vz2, Float_t mult2, Float_t angle2) const
+{
    Int_t ivz1, ivz2, imult1, imult2, iangle1, iangle2;
    Double_t dv, dm, da;
 
    if (fContinuousMix) {
-      dv = TMath::Abs(event1->Vz()    - event2->Vz()   );
-      dm = TMath::Abs(event1->Mult()  - event2->Mult() );
-      da = TMath::Abs(event1->Angle() - event2->Angle());
+      dv = TMath::Abs(vz1    - vz2   );
+      dm = TMath::Abs(mult1  - mult2 );
+      da = TMath::Abs(angle1 - angle2);
       if (dv > fMaxDiffVz) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Vz = %f", event1->ID(), event2->ID(), dv));
          return kFALSE;
       }
       if (dm > fMaxDiffMult ) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Mult = %f", event1->ID(), event2->ID(), dm));
          return kFALSE;
       }
       if (da > fMaxDiffAngle) {
-         //AliDebugClass(2, Form("Events #%4d and #%4d don't match due to a too large diff in Angle = %f", event1->ID(), event2->ID(), da));
          return kFALSE;
       }
       return kTRUE;
    } else {
-      ivz1 = (Int_t)(event1->Vz() / fMaxDiffVz);
-      ivz2 = (Int_t)(event2->Vz() / fMaxDiffVz);
-      imult1 = (Int_t)(event1->Mult() / fMaxDiffMult);
-      imult2 = (Int_t)(event2->Mult() / fMaxDiffMult);
-      iangle1 = (Int_t)(event1->Angle() / fMaxDiffAngle);
-      iangle2 = (Int_t)(event2->Angle() / fMaxDiffAngle);
+      ivz1 = (Int_t)(vz1 / fMaxDiffVz);
+      ivz2 = (Int_t)(vz2 / fMaxDiffVz);
+      imult1 = (Int_t)(mult1 / fMaxDiffMult);
+      imult2 = (Int_t)(mult2 / fMaxDiffMult);
+      iangle1 = (Int_t)(angle1 / fMaxDiffAngle);
+      iangle2 = (Int_t)(angle2 / fMaxDiffAngle);
       if (ivz1 != ivz2) return kFALSE;
       if (imult1 != imult2) return kFALSE;
       if (iangle1 != iangle2) return kFALSE;
@@ -1653,6 +1656,151 @@ Bool_t AliRsnMiniAnalysisTask::EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEv
    }
 }
 
+//__________________________________________________________________________________________________
+/// Keep a copy of the current mini-event in memory, for the loops in FinishTaskOutput.
+/// The store contains the first entries of the buffer: once an event does not fit
+/// into the memory budget, it and all the following events are read from the buffer.
+///
+void AliRsnMiniAnalysisTask::StoreMiniEvent()
+{
+   if ((Int_t)fEventStore.size() != fMiniEvent->ID()) return;
+
+   Long64_t size = sizeof(AliRsnMiniEvent) + fMiniEvent->Particles().GetEntriesFast() * sizeof(AliRsnMiniParticle);
+   if (fEventStoreMaxSize > 0 && fEventStoreSize + size > fEventStoreMaxSize) {
+      AliInfo(Form("[%s] Mini-event store full after %d events (%lld bytes), the next events are read from the buffer",
+                   GetName(), (Int_t)fEventStore.size(), fEventStoreSize));
+      return;
+   }
+   fEventStore.push_back(new AliRsnMiniEvent(*fMiniEvent));
+   fEventStoreSize += size;
+}
+
+//__________________________________________________________________________________________________
+/// Mini-event with the given ID: the stored copy if there is one,
+/// otherwise the cursor after reading the entry from the buffer.
+///
+AliRsnMiniEvent *AliRsnMiniAnalysisTask::GetMiniEvent(Int_t ievt)
+{
+   if (ievt < (Int_t)fEventStore.size()) return fEventStore[ievt];
+   fEvBuffer->GetEntry(ievt);
+   return fMiniEvent;
+}
+
+//__________________________________________________________________________________________________
+/// Delete the stored mini-events.
+///
+void AliRsnMiniAnalysisTask::ClearEventStore()
+{
+   for (UInt_t i = 0; i < fEventStore.size(); i++) delete fEventStore[i];
+   fEventStore.clear();
+   fEventStoreSize = 0;
+}
+
+//__________________________________________________________________________________________________
+/// Search the mixing partners of all buffered events.
+///
+/// Events are sorted into buckets of (vz, multiplicity, angle). In binned mixing
+/// the buckets are the mixing bins, and all events in a bucket match. In continuous
+/// mixing the bucket size is the maximum allowed difference, therefore matching
+/// events can only be found in the same or in a neighbouring bucket.
+/// For each event the candidates are tested in the same order as in a scan over all
+/// buffered events starting from the following event (wrapping around at the end),
+/// so that the partners are the same as with the full O(N^2) search.
+///
+/// \param vz Vertex z of the buffered events
+/// \param mult Multiplicity of the buffered events
+/// \param angle Angle of the buffered events
+/// \param partners Output: for each event the list of events it is mixed with
+/// \param printNum Print progress every printNum events (0 = no printout)
+///
+void AliRsnMiniAnalysisTask::FindMixingPartners(const std::vector<Float_t> &vz, const std::vector<Float_t> &mult, const std::vector<Float_t> &angle,
+                                                std::vector< std::vector<Int_t> > &partners, Int_t printNum) const
+{
+   Int_t nEvents = vz.size();
+   partners.assign(nEvents, std::vector<Int_t>());
+   std::vector<Int_t> nmatched(nEvents, 0);
+
+   // fill buckets, events inside a bucket are sorted by construction
+   typedef std::map<MixBucketKey_t, std::vector<Int_t> > BucketMap_t;
+   BucketMap_t buckets;
+   std::vector<MixBucketKey_t> eventKeys(nEvents);
+   for (Int_t ievt = 0; ievt < nEvents; ievt++) {
+      eventKeys[ievt] = GetMixBucketKey(vz[ievt], mult[ievt], angle[ievt]);
+      buckets[eventKeys[ievt]].push_back(ievt);
+   }
+
+   std::vector<Int_t> candidates;
+   for (Int_t ievt = 0; ievt < nEvents; ievt++) {
+      if (printNum&&(ievt%printNum==0)) AliInfo(Form("[%s] EventMixing searching %d/%d",GetName(),ievt,nEvents));
+      if (nmatched[ievt] >= fNMix) continue;
+
+      // collect candidates from the bucket(s) which can contain matching events
+      candidates.clear();
+      const MixBucketKey_t &key = eventKeys[ievt];
+      Int_t range = fContinuousMix ? 1 : 0;
+      for (Int_t dvz = -range; dvz <= range; dvz++) {
+         for (Int_t dmult = -range; dmult <= range; dmult++) {
+            for (Int_t dangle = -range; dangle <= range; dangle++) {
+               MixBucketKey_t neighbour(key.fVz + dvz, key.fMult + dmult, key.fAngle + dangle);
+               BucketMap_t::const_iterator found = buckets.find(neighbour);
+               if (found == buckets.end()) continue;
+               candidates.insert(candidates.end(), found->second.begin(), found->second.end());
+            }
+         }
+      }
+      // order of the full scan: ievt+1, ..., nEvents-1, 0, ..., ievt-1
+      for (UInt_t icand = 0; icand < candidates.size(); icand++) {
+         if (candidates[icand] <= ievt) candidates[icand] += nEvents;
+      }
+      std::sort(candidates.begin(), candidates.end());
+
+      for (UInt_t icand = 0; icand < candidates.size(); icand++) {
+         Int_t imix = candidates[icand];
+         if (imix >= nEvents) imix -= nEvents;
+         if (imix == ievt) continue;
+         // skip if events are not matched
+         if (fContinuousMix && !EventsMatch(vz[ievt], mult[ievt], angle[ievt], vz[imix], mult[imix], angle[imix])) continue;
+         // check that the list of good matches for mixed does not already contain main event
+         if (std::find(partners[imix].begin(), partners[imix].end(), ievt) != partners[imix].end()) continue;
+         // check that the found good events has not enough matches already
+         if (nmatched[imix] >= fNMix) continue;
+         // add new mixing candidate
+         partners[ievt].push_back(imix);
+         nmatched[ievt]++;
+         nmatched[imix]++;
+         if (nmatched[ievt] >= fNMix) break;
+      }
+      AliDebugClass(1, Form("Matches for event %5d = %d (missing are declared above)", ievt, nmatched[ievt]));
+   }
+}
+
+//__________________________________________________________________________________________________
+/// Bucket of an event for the search of mixing partners.
+/// In binned mixing this is the mixing bin (same convention as in EventsMatch),
+/// in continuous mixing the bucket size is (slightly above) the maximum allowed difference,
+/// so that matching events are at most one bucket apart also with rounding.
+///
+AliRsnMiniAnalysisTask::MixBucketKey_t AliRsnMiniAnalysisTask::GetMixBucketKey(Float_t vz, Float_t mult, Float_t angle) const
+{
+   if (fContinuousMix) {
+      return MixBucketKey_t(GetMixBucket(vz, fMaxDiffVz), GetMixBucket(mult, fMaxDiffMult), GetMixBucket(angle, fMaxDiffAngle));
+   }
+   return MixBucketKey_t((Int_t)(vz / fMaxDiffVz), (Int_t)(mult / fMaxDiffMult), (Int_t)(angle / fMaxDiffAngle));
+}
+
+//__________________________________________________________________________________________________
+/// Bucket index of a value for continuous mixing.
+/// If the maximum difference is not a usable bucket size, all events are put in the same bucket
+/// and the partners are found by the full check in EventsMatch.
+///
+Int_t AliRsnMiniAnalysisTask::GetMixBucket(Double_t value, Double_t maxDiff) const
+{
+   if (maxDiff <= 0.) return 0;
+   Double_t bucket = TMath::Floor(value / (maxDiff * (1. + 1E-6)));
+   if (!(TMath::Abs(bucket) < 1E9)) return 0;
+   return (Int_t)bucket;
+}
+
 //---------------------------------------------------------------------
 /// Patch to be used with 2011 Pb-Pb data for flat centrality distribution
 ///
@@ -15,6 +15,8 @@
 #ifndef ALIRSNMINIANALYSISTASK_H
 #define ALIRSNMINIANALYSISTASK_H
 
+#include <vector>
+
 #include <TString.h>
 #include <TClonesArray.h>
 
@@ -76,6 +78,7 @@ public:
    void                SetMotherAcceptanceCutMaxEta(Float_t maxEta){fMotherAcceptanceCutMaxEta = maxEta;}
    void                KeepMotherInAcceptance(Bool_t keepMotherInAcceptance) {fKeepMotherInAcceptance = keepMotherInAcceptance;}
    void                SaveRsnTreeInFile(Bool_t saveInFile=kTRUE) {fRsnTreeInFile = saveInFile;}
+   void                SetUseEventStore(Bool_t use=kTRUE, Long64_t maxSize=0) {fUseEventStore = use; fEventStoreMaxSize = maxSize;}
    void                SetComputeSpherocity(Bool_t doit=kTRUE) {fComputeSpherocity = doit;}
    void                SetTrackCuts(AliAnalysisFilter* fTrackFilter);
 
@@ -115,6 +118,27 @@ private:
    void     FillTrueMotherAOD(AliRsnMiniEvent *event);
    void     StoreTrueMother(AliRsnMiniPair *pair, AliRsnMiniEvent *event);
    Bool_t   EventsMatch(AliRsnMiniEvent *event1, AliRsnMiniEvent *event2);
+   void     StoreMiniEvent();
+   AliRsnMiniEvent *GetMiniEvent(Int_t ievt);
+   void     ClearEventStore();
+   Bool_t   EventsMatch(Float_t vz1, Float_t mult1, Float_t angle1, Float_t vz2, Float_t mult2, Float_t angle2) const;
+
+   /// Bucket (vz, multiplicity, angle) used in the search of mixing partners
+   struct MixBucketKey_t {
+      MixBucketKey_t(Int_t vz = 0, Int_t mult = 0, Int_t angle = 0) : fVz(vz), fMult(mult), fAngle(angle) {}
+      bool operator<(const MixBucketKey_t &other) const {
+         if (fVz != other.fVz) return fVz < other.fVz;
+         if (fMult != other.fMult) return fMult < other.fMult;
+         return fAngle < other.fAngle;
+      }
+      Int_t fVz;      ///< vertex z bucket
+      Int_t fMult;    ///< multiplicity bucket
+      Int_t fAngle;   ///< angle bucket
+   };
+   MixBucketKey_t GetMixBucketKey(Float_t vz, Float_t mult, Float_t angle) const;
+   Int_t    GetMixBucket(Double_t value, Double_t maxDiff) const;
+   void     FindMixingPartners(const std::vector<Float_t> &vz, const std::vector<Float_t> &mult, const std::vector<Float_t> &angle,
+                               std::vector< std::vector<Int_t> > &partners, Int_t printNum) const;
    AliQnCorrectionsQnVector * GetQnVectorFromList(const TList *list, const char *subdetector, const char *expectedstep) const;
 
    Bool_t               fUseMC;           ///<  use or not MC info
@@ -173,9 +197,13 @@ private:
    AliAnalysisFilter   *fTrackFilter;       //!<! track filter for spherocity estimator 
    Double_t             fSpherocity;        ///< stores value of spherocity
    TObjArray            fResonanceFinders;  ///< list of AliRsnMiniResonanceFinder objects
+   Bool_t               fUseEventStore;     ///< keep a copy of the mini-events in memory for FinishTaskOutput
+   Long64_t             fEventStoreMaxSize; ///< memory budget of the mini-event store in bytes (0 = no limit)
+   Long64_t             fEventStoreSize;    //!<! estimated size of the stored mini-events
+   std::vector<AliRsnMiniEvent*> fEventStore; //!<! copies of the first mini-events of the buffer
 
 /// \cond CLASSIMP
-   ClassDef(AliRsnMiniAnalysisTask, 20);     
+   ClassDef(AliRsnMiniAnalysisTask, 21);     
 /// \endcond
 };
 
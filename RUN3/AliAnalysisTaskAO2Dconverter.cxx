@@ -21,6 +21,9 @@
 #include <TChain.h>
 #include <TTree.h>
 #include <TMath.h>
+#include <TROOT.h>
+#include <TBranch.h>
+#include <TLeaf.h>
 #include "AliAnalysisTask.h"
 #include "AliAnalysisManager.h"
 #include "AliESDEvent.h"
@@ -58,6 +61,14 @@
 #include "AliGenPythiaEventHeader.h"
 #include "AliGenToyEventHeader.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 ClassImp(AliAnalysisTaskAO2Dconverter);
 
 namespace
@@ -81,6 +92,134 @@ ULong64_t GetEventIdAsLong(AliVHeader *header)
 
 } // namespace
 
+// Background writer of the output trees
+//
+// The entries of each event are added to a buffer in memory (copies of the data structure
+// the branches of the tree point to). The buffered entries are handed to a thread that copies them
+// one by one into a private copy of the data structure, to which the branches are
+// redirected, and fills the tree. All trees are filled by the same thread, since the
+// output file must not be written concurrently; the baskets of each cluster are
+// compressed in parallel if the ROOT implicit multi-threading is enabled.
+class AliAO2DTreeWriter
+{
+public:
+  AliAO2DTreeWriter(Long64_t maxBufferSize) : fMaxBufferSize(maxBufferSize) {}
+  ~AliAO2DTreeWriter() { Stop(); }
+
+  // Redirect the branches of tree t, which point into data[0..size), to the writer
+  void AddTree(Int_t t, TTree* tree, void* data, size_t size)
+  {
+    fTree[t] = tree;
+    fData[t] = (const char*)data;
+    fStaging[t].assign(size, 0);
+    TObjArray* branches = tree->GetListOfBranches();
+    for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+      TBranch* branch = (TBranch*)branches->UncheckedAt(i);
+      char* address = branch->GetAddress();
+      if (address < fData[t] || address >= fData[t] + size)
+        ::Fatal("AliAO2DTreeWriter::AddTree", "Branch %s of tree %s does not point to the data structure", branch->GetName(), tree->GetName());
+      branch->SetAddress(fStaging[t].data() + (address - fData[t]));
+    }
+  }
+
+  void Start() { fThread = std::thread(&AliAO2DTreeWriter::Run, this); }
+
+  // Buffer n entries of tree t
+  void Fill(Int_t t, const char* entries, Int_t n)
+  {
+    const size_t bytes = n * fStaging[t].size();
+    fPending[t].insert(fPending[t].end(), entries, entries + bytes);
+    fPendingBytes += bytes;
+  }
+
+  // Hand the buffered entries to the writer thread (at the end of an event), waits while
+  // the entries not yet written exceed the maximum buffer size
+  void Commit(Bool_t force = kFALSE)
+  {
+    if (fPendingBytes == 0 || (!force && fPendingBytes < kChunkSize))
+      return;
+    Chunk* chunk = new Chunk;
+    for (Int_t t = 0; t < AliAnalysisTaskAO2Dconverter::kTrees; t++)
+      chunk->fEntries[t].swap(fPending[t]);
+    chunk->fBytes = fPendingBytes;
+    fPendingBytes = 0;
+
+    std::unique_lock<std::mutex> lock(fMutex);
+    fQueue.push_back(chunk);
+    fQueuedBytes += chunk->fBytes;
+    fCondition.notify_all();
+    fCondition.wait(lock, [this] { return fQueuedBytes <= fMaxBufferSize; });
+  }
+
+  // Write all buffered entries and stop the writer thread
+  void Stop()
+  {
+    if (!fThread.joinable())
+      return;
+    Commit(kTRUE);
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = kTRUE;
+      fCondition.notify_all();
+    }
+    fThread.join();
+    if (fErrors > 0)
+      ::Error("AliAO2DTreeWriter::Stop", "%lld entries could not be written", fErrors);
+  }
+
+private:
+  enum { kChunkSize = 4000000 }; // Minimum size in bytes of the entries handed to the writer thread at once
+
+  struct Chunk {
+    std::vector<char> fEntries[AliAnalysisTaskAO2Dconverter::kTrees]; // Entries per tree
+    Long64_t fBytes = 0;                                              // Total size of the entries
+  };
+
+  void Run()
+  {
+    while (true) {
+      Chunk* chunk = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fCondition.wait(lock, [this] { return fStop || !fQueue.empty(); });
+        if (fQueue.empty())
+          break;
+        chunk = fQueue.front();
+        fQueue.pop_front();
+      }
+      for (Int_t t = 0; t < AliAnalysisTaskAO2Dconverter::kTrees; t++) {
+        const size_t size = fStaging[t].size();
+        const std::vector<char>& entries = chunk->fEntries[t];
+        for (size_t offset = 0; offset < entries.size(); offset += size) {
+          memcpy(fStaging[t].data(), entries.data() + offset, size);
+          if (fTree[t]->Fill() < 0)
+            fErrors++;
+        }
+      }
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fQueuedBytes -= chunk->fBytes;
+        fCondition.notify_all();
+      }
+      delete chunk;
+    }
+  }
+
+  TTree* fTree[AliAnalysisTaskAO2Dconverter::kTrees] = { nullptr };       // Trees filled by the writer (not owned)
+  const char* fData[AliAnalysisTaskAO2Dconverter::kTrees] = { nullptr };  // Data structures filled in UserExec
+  std::vector<char> fStaging[AliAnalysisTaskAO2Dconverter::kTrees];       // Copies of the data structures the branches point to
+  std::vector<char> fPending[AliAnalysisTaskAO2Dconverter::kTrees];       // Entries not yet handed to the writer thread
+  Long64_t fPendingBytes = 0;  // Size of the entries in fPending
+  Long64_t fMaxBufferSize;     // Maximum size of the entries waiting for the writer thread
+  Long64_t fQueuedBytes = 0;   // Size of the entries waiting for the writer thread
+  Long64_t fErrors = 0;        // Number of entries which could not be written
+  Bool_t fStop = kFALSE;       // Stop the writer thread when the queue is empty
+  std::deque<Chunk*> fQueue;   // Entries waiting for the writer thread
+  std::mutex fMutex;
+  std::condition_variable fCondition;
+  std::thread fThread;
+};
+
 AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter(const char* name)
     : AliAnalysisTaskSE(name)
     , fTrackFilter(Form("AO2Dconverter%s", name), Form("fTrackFilter%s", name))
@@ -95,6 +234,7 @@ AliAnalysisTaskAO2Dconverter::AliAnalysisTaskAO2Dconverter(const char* name)
 
 AliAnalysisTaskAO2Dconverter::~AliAnalysisTaskAO2Dconverter()
 {
+  delete fWriter;
   for (Int_t i = 0; i < kTrees; i++)
     if (fTree[i])
       delete fTree[i];
@@ -125,7 +265,185 @@ void AliAnalysisTaskAO2Dconverter::FillTree(TreeIndex t)
 {
   if (!fTreeStatus[t])
     return;
-  fTree[t]->Fill();
+  if (!fWriter && fTruncatedColumns[t].empty()) {
+    // Nothing to do on the entry: the branches read it from the data structure
+    fTree[t]->Fill();
+    return;
+  }
+  // The entry is written with the other entries of the event in FlushEntries
+  size_t size = 0;
+  const char* data = (const char*)GetTreeData(t, size);
+  fEventEntries[t].insert(fEventEntries[t].end(), data, data + size);
+}
+
+void* AliAnalysisTaskAO2Dconverter::GetTreeData(TreeIndex t, size_t& size)
+{
+  switch (t) {
+  case kEvents: size = sizeof(vtx); return &vtx;
+  case kTracks: size = sizeof(tracks); return &tracks;
+  case kCalo: size = sizeof(calo); return &calo;
+  case kCaloTrigger: size = sizeof(calotrigger); return &calotrigger;
+  case kMuon: size = sizeof(muons); return &muons;
+  case kMuonCls: size = sizeof(mucls); return &mucls;
+  case kZdc: size = sizeof(zdc); return &zdc;
+  case kVzero: size = sizeof(vzero); return &vzero;
+  case kV0s: size = sizeof(v0s); return &v0s;
+  case kCascades: size = sizeof(cascs); return &cascs;
+#ifdef USE_TOF_CLUST
+  case kTOF: size = sizeof(tofClusters); return &tofClusters;
+#endif
+  case kKinematics: size = sizeof(mcparticle); return &mcparticle;
+  case kMCvtx: size = sizeof(mcvtx); return &mcvtx;
+  case kRange: size = sizeof(range); return &range;
+  case kLabels: size = sizeof(labels); return &labels;
+  case kTrigger: size = sizeof(trigger); return &trigger;
+  default: break;
+  }
+  size = 0;
+  return nullptr;
+}
+
+void AliAnalysisTaskAO2Dconverter::FlushEntries()
+{
+  // Write the entries of the current event which were kept by FillTree (trees
+  // with truncated columns or with the background writer), tree by tree. The
+  // truncation of the Float_t columns is applied column by column to all
+  // entries of the event. The entries are still written one by one with
+  // TTree::Fill, here or in the writer thread.
+  for (Int_t i = 0; i < kTrees; i++) {
+    std::vector<char>& entries = fEventEntries[i];
+    if (entries.empty())
+      continue;
+    size_t size = 0;
+    char* data = (char*)GetTreeData((TreeIndex)i, size);
+    const Int_t n = entries.size() / size;
+
+    for (const TruncatedColumn& column : fTruncatedColumns[i]) {
+      for (Int_t ientry = 0; ientry < n; ientry++) {
+        UInt_t* values = (UInt_t*)(entries.data() + ientry * size + column.fOffset);
+        for (Int_t j = 0; j < column.fLength; j++)
+          values[j] &= column.fMask;
+      }
+    }
+
+    if (fWriter) {
+      fWriter->Fill(i, entries.data(), n);
+    } else {
+      // The branches point to the data structure: copy the entries one by one into it
+      std::vector<char> current(data, data + size);
+      for (Int_t ientry = 0; ientry < n; ientry++) {
+        memcpy(data, entries.data() + ientry * size, size);
+        fTree[i]->Fill();
+      }
+      memcpy(data, current.data(), size);
+    }
+    entries.clear();
+  }
+}
+
+void AliAnalysisTaskAO2Dconverter::Truncate(TString columns, UInt_t mask)
+{
+  TObjArray* arr = columns.Tokenize(" ");
+  for (Int_t i = 0; i < arr->GetEntries(); i++)
+    fTruncateList += TString::Format(" %s:0x%08x", arr->At(i)->GetName(), mask);
+  delete arr;
+}
+
+void AliAnalysisTaskAO2Dconverter::SetupTruncation()
+{
+  for (Int_t i = 0; i < kTrees; i++)
+    fTruncatedColumns[i].clear();
+  if (fTruncateList.IsNull() || fTruncateList.IsWhitespace())
+    return;
+  TObjArray* arr = fTruncateList.Tokenize(" ");
+  for (Int_t i = 0; i < arr->GetEntries(); i++) {
+    TString token = arr->At(i)->GetName();
+    Int_t colon = token.Last(':');
+    if (colon < 0)
+      AliFatal(Form("Invalid truncation %s", token.Data()));
+    TString column = token(0, colon);
+    UInt_t mask = strtoul(token.Data() + colon + 1, nullptr, 0);
+    TString treeName = "";
+    Int_t slash = column.First('/');
+    if (slash >= 0) {
+      treeName = column(0, slash);
+      column = column(slash + 1, column.Length());
+    }
+
+    Bool_t found = kFALSE;
+    for (Int_t j = 0; j < kTrees; j++) {
+      if (!fTree[j] || !fTreeStatus[j])
+        continue;
+      if (!treeName.IsNull() && !treeName.EqualTo(TreeName[j]))
+        continue;
+      TBranch* branch = fTree[j]->GetBranch(column);
+      if (!branch)
+        continue;
+      TLeaf* leaf = (TLeaf*)branch->GetListOfLeaves()->At(0);
+      if (!leaf || !TString(leaf->GetTypeName()).EqualTo("Float_t"))
+        AliFatal(Form("Branch %s of %s is not of type Float_t, it cannot be truncated", column.Data(), TreeName[j].Data()));
+      size_t size = 0;
+      char* data = (char*)GetTreeData((TreeIndex)j, size);
+      TruncatedColumn truncated;
+      truncated.fOffset = branch->GetAddress() - data;
+      truncated.fLength = leaf->GetLen();
+      truncated.fMask = mask;
+      fTruncatedColumns[j].push_back(truncated);
+      found = kTRUE;
+    }
+    if (!found)
+      AliFatal(Form("Did not find Branch %s", column.Data()));
+  }
+  delete arr;
+}
+
+void AliAnalysisTaskAO2Dconverter::PrintColumnSizes()
+{
+  if (fEventCount == 0)
+    return;
+  Printf("AliAnalysisTaskAO2Dconverter: bytes per event and column (uncompressed, compressed) for %d events", fEventCount);
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fTree[i] || !fTreeStatus[i])
+      continue;
+    fTree[i]->FlushBaskets();
+    Printf("%s: %.1f, %.1f", TreeName[i].Data(), (Double_t)fTree[i]->GetTotBytes() / fEventCount, (Double_t)fTree[i]->GetZipBytes() / fEventCount);
+    TObjArray* branches = fTree[i]->GetListOfBranches();
+    for (Int_t k = 0; k < branches->GetEntries(); k++) {
+      TBranch* branch = (TBranch*)branches->At(k);
+      Printf("  %-32s %10.1f %10.1f", branch->GetName(), (Double_t)branch->GetTotBytes() / fEventCount, (Double_t)branch->GetZipBytes() / fEventCount);
+    }
+  }
+}
+
+void AliAnalysisTaskAO2Dconverter::StartWriter()
+{
+  // Hand the active trees to the background writer, together with the data structures their branches point to
+  fWriter = new AliAO2DTreeWriter(fWriterMaxBufferSize);
+  for (Int_t i = 0; i < kTrees; i++) {
+    if (!fTreeStatus[i] || !fTree[i])
+      continue;
+    size_t size = 0;
+    void* data = GetTreeData((TreeIndex)i, size);
+    fTree[i]->SetImplicitMT(kTRUE);
+    fWriter->AddTree(i, fTree[i], data, size);
+  }
+  fWriter->Start();
+}
+
+void AliAnalysisTaskAO2Dconverter::FinishTaskOutput()
+{
+  // Write the entries still buffered by the background writer before the trees are saved
+  delete fWriter;
+  fWriter = nullptr;
+
+  // The implicit multi-threading is process-wide, switch it off again if it was switched on here
+  if (fEnabledImplicitMT) {
+    ROOT::DisableImplicitMT();
+    fEnabledImplicitMT = kFALSE;
+  }
+
+  if (fReportColumnSizes)
+    PrintColumnSizes();
 }
 
 void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
@@ -145,6 +463,12 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
   fOffsetV0ID = 0;
   fOffsetLabel = 0;
 
+  // The trees created below compress their baskets in parallel if the implicit multi-threading is enabled
+  if (fUseBackgroundWriter && fNumberOfCompressionThreads > 0 && !ROOT::IsImplicitMTEnabled()) {
+    ROOT::EnableImplicitMT(fNumberOfCompressionThreads);
+    fEnabledImplicitMT = kTRUE;
+  }
+
   // create output objects
   OpenFile(1); // Necessary for large outputs
 
@@ -416,6 +740,10 @@ void AliAnalysisTaskAO2Dconverter::UserCreateOutputObjects()
 
 
   Prune(); //Removing all unwanted branches (if any)
+  SetupTruncation();
+
+  if (fUseBackgroundWriter)
+    StartWriter();
 }
 
 void AliAnalysisTaskAO2Dconverter::Prune()
@@ -998,6 +1326,11 @@ void AliAnalysisTaskAO2Dconverter::UserExec(Option_t *)
   // We can fill now the vertex + indexing data
   FillTree(kEvents);
 
+  // Write the entries kept by FillTree for this event
+  FlushEntries();
+  if (fWriter)
+    fWriter->Commit();
+
   //---------------------------------------------------------------------------
   //Posting data
   for (Int_t i = 0; i < kTrees; i++)
@@ -11,11 +11,14 @@
 
 #include <TString.h>
 
+#include <vector>
+
 #include "TClass.h"
 
 #include <Rtypes.h>
 
 class AliESDEvent;
+class AliAO2DTreeWriter;
 
 class AliAnalysisTaskAO2Dconverter : public AliAnalysisTaskSE
 {
@@ -33,8 +36,20 @@ public:
   virtual void UserCreateOutputObjects();
   virtual void UserExec(Option_t *option);
   virtual void Terminate(Option_t *option);
+  virtual void FinishTaskOutput();
 
   void SetNumberOfEventsPerCluster(int n) { fNumberOfEventsPerCluster = n; }
+  // Fill the trees in a background thread. The baskets are compressed in parallel by
+  // nCompressionThreads threads of the ROOT implicit multi-threading pool (0 = compressed
+  // by the writer thread). The implicit multi-threading is process-wide: while it is on,
+  // all tasks and trees of the process can use the pool. It is only enabled if it is not
+  // already on, and is then disabled again in FinishTaskOutput.
+  // UserExec waits when more than maxBufferSize bytes of entries are not yet written.
+  void SetUseBackgroundWriter(Bool_t use = kTRUE, Int_t nCompressionThreads = 2, Long64_t maxBufferSize = 200000000) {
+    fUseBackgroundWriter = use;
+    fNumberOfCompressionThreads = nCompressionThreads;
+    fWriterMaxBufferSize = maxBufferSize;
+  }
 
   static AliAnalysisTaskAO2Dconverter* AddTask(TString suffix = "");
   enum TreeIndex { // Index of the output trees
@@ -85,6 +100,11 @@ public:
   static const TString TreeTitle[kTrees]; //! Titles of the TTree containers
 
   void Prune(TString p) { fPruneList = p; }; // Setter of the pruning list
+  // Reduce the precision of Float_t columns: only the bits set in mask are kept (e.g. 0xFFFFFF00
+  // keeps 15 of the 23 mantissa bits). Columns are given as "branch" (in all trees) or "tree/branch",
+  // separated by spaces
+  void Truncate(TString columns, UInt_t mask);
+  void SetReportColumnSizes(Bool_t report = kTRUE) { fReportColumnSizes = report; } // Print the bytes per column and event at the end
   void SetMCMode() { fTaskMode = kMC; };     // Setter of the MC running mode
 
   AliAnalysisFilter fTrackFilter; // Standard track filter object
@@ -100,11 +120,32 @@ private:
   TTree* fTree[kTrees] = { nullptr }; //! Array with all the output trees
   void Prune();                       // Function to perform tree pruning
   void FillTree(TreeIndex t);         // Function to fill the trees (only the active ones)
+  void* GetTreeData(TreeIndex t, size_t& size); // Data structure the branches of a tree point to
+  void SetupTruncation();             // Function to find the truncated columns
+  void FlushEntries();                // Function to write the entries of the current event
+  void PrintColumnSizes();            // Function to print the bytes per column and event
+
+  struct TruncatedColumn {
+    Int_t fOffset;  // Offset of the column in the data structure of the tree
+    Int_t fLength;  // Number of Float_t values of the column
+    UInt_t fMask;   // Bits kept
+  };
+  std::vector<char> fEventEntries[kTrees];              //! Entries of the current event for each tree
+  std::vector<TruncatedColumn> fTruncatedColumns[kTrees]; //! Truncated columns of each tree
 
   // Task configuration variables
   TString fPruneList = "";                // Names of the branches that will not be saved to output file
+  TString fTruncateList = "";             // Truncated columns, as "column:mask" separated by spaces
+  Bool_t fReportColumnSizes = kFALSE;     // Print the bytes per column and event at the end
   Bool_t fTreeStatus[kTrees] = { kTRUE }; // Status of the trees i.e. kTRUE (enabled) or kFALSE (disabled)
   int fNumberOfEventsPerCluster = 1000;   // Maximum basket size of the trees
+  Bool_t fUseBackgroundWriter = kFALSE;   // Fill the trees in a background thread
+  Int_t fNumberOfCompressionThreads = 2;  // Size of the implicit multi-threading pool used with the background writer (0 = not used)
+  Long64_t fWriterMaxBufferSize = 200000000; // Maximum size in bytes of the entries waiting for the background writer
+
+  AliAO2DTreeWriter* fWriter = nullptr; //! Background writer of the trees (if used)
+  Bool_t fEnabledImplicitMT = kFALSE;   //! The implicit multi-threading was enabled by this task
+  void StartWriter();                   // Function to hand the trees to the background writer
 
   TaskModes fTaskMode = kStandard; // Running mode of the task. Useful to set for e.g. MC mode
 
@@ -393,7 +434,7 @@ private:
   Int_t fOffsetV0ID = 0;      ///! Offset of track IDs (used in cascades)
   Int_t fOffsetLabel = 0;      ///! Offset of track IDs (used in cascades)
 
-  ClassDef(AliAnalysisTaskAO2Dconverter, 7);
+  ClassDef(AliAnalysisTaskAO2Dconverter, 10);
 };
 
 #endif